@@ -1,47 +1,159 @@
 #include "App.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <sstream>
 
-App::App()
+App::App(unsigned short metricsPort, const StressScene::Settings* pStressSettings)
 	:
-	wnd(800, 600, "The Donkey Fart Box")
-{}
+	pWnd(PlatformWindow::Create(800, 600, "The Donkey Fart Box")),
+	gfx(static_cast<HWND>(pWnd->GetNativeHandle())),
+	stressSettings(pStressSettings ? *pStressSettings : StressScene::Settings{}),
+	pStress(pStressSettings ? std::make_unique<StressScene>(*pStressSettings) : nullptr),
+	pMetrics(metricsPort != 0u ? std::make_unique<MetricsServer>(metricsPort, &gfx.GetTelemetry()) : nullptr),
+	frameLoop(gfx, gfx.GetJobSystem(), [this](FrameInput& input) { ReadInput(input); })
+{
+	PROFILE_THREAD("main");
+	// no frame has been handed to the render thread yet, so this is ordered before its first EndFrame
+	gfx.SetMetricsServer(pMetrics.get());
+	frameLoop.SetStressScene(pStress.get());
+	// startup is not a frame
+	frameTimer.Mark();
+}
 
 int App::Go()
 {
 	while (true)
 	{
 		// process all messages pending, but to not block for new messages
-		if (const auto ecode = Window::ProcessMessages())
+		pumpTimer.Mark();
+		const auto ecode = pWnd->ProcessMessages();
+		gfx.GetTelemetry().Record(FrameTelemetry::Channel::MessagePump, pumpTimer.MarkNs());
+		if (ecode)
 		{
 			// if return optional has value, means we're quitting so return exit code
+			WriteTelemetry();
 			return *ecode;
 		}
 		DoFrame();
 	}
 }
 
-void App::DoFrame()
+void App::ReadInput(FrameInput& input)
 {
-	const float c = static_cast<float>(sin(timer.Peek()) / 2.0f + 0.5f);
-	const float speed = 1.0f / 3000.f;
-	if (wnd.kbd.KeyIsPressed('A'))
+	FrameLoop::ReadControls(*pWnd, input);
+	EngineClock& clock = frameLoop.GetClock();
+	const bool pauseKey = pWnd->kbd.KeyIsPressed('P');
+	if (pauseKey && !pauseKeyHeld)
+	{
+		clock.SetPaused(!clock.IsPaused());
+	}
+	pauseKeyHeld = pauseKey;
+	const bool scaleKey = pWnd->kbd.KeyIsPressed('T');
+	if (scaleKey && !scaleKeyHeld)
+	{
+		// real time > quarter speed > four times speed > real time
+		const double scale = clock.GetTimeScale();
+		clock.SetTimeScale(scale == 1.0 ? 0.25 : scale < 1.0 ? 4.0 : 1.0);
+	}
+	scaleKeyHeld = scaleKey;
+	// C dumps the profiler rings, open the file in chrome://tracing
+	const bool captureKey = pWnd->kbd.KeyIsPressed('C');
+	if (captureKey && !captureKeyHeld)
+	{
+		Profiler::WriteChromeTrace("trace.json");
+	}
+	captureKeyHeld = captureKey;
+	const bool telemetryKey = pWnd->kbd.KeyIsPressed('M');
+	if (telemetryKey && !telemetryKeyHeld)
+	{
+		WriteTelemetry();
+	}
+	telemetryKeyHeld = telemetryKey;
+	// R captures the next 60 frames of API calls, replay them with HeadlessBench --replay
+	const bool recordKey = pWnd->kbd.KeyIsPressed('R');
+	if (recordKey && !recordKeyHeld)
+	{
+		gfx.RequestCapture(60u, "capture.cfc");
+	}
+	recordKeyHeld = recordKey;
+	// 1k > 10k > 100k > 1M cubes > test scene > 1k
+	const bool stressKey = pWnd->kbd.KeyIsPressed('N');
+	if (stressKey && !stressKeyHeld)
+	{
+		const size_t count = pStress ? pStress->GetCount() : 0u;
+		pendingStressCount = count == 0u ? 1000u : count >= 1000000u ? 0u : std::min<size_t>(count * 10u, 1000000u);
+		stressChangePending = true;
+	}
+	stressKeyHeld = stressKey;
+	// 1..4 pick the pacing mode: uncapped, 60 fps, vsync, low latency
+	const FramePacer::Mode modes[] = {
+		FramePacer::Mode::Uncapped,FramePacer::Mode::TargetFps,FramePacer::Mode::VSync,FramePacer::Mode::LowLatency };
+	for (int i = 0; i < 4; i++)
 	{
-		wnd.Gfx().xPos += speed;
+		if (pWnd->kbd.KeyIsPressed((unsigned char)('1' + i)))
+		{
+			gfx.GetFramePacer().SetMode(modes[i]);
+		}
 	}
-	if (wnd.kbd.KeyIsPressed('D'))
+}
+
+void App::DoFrame()
+{
+	PROFILE_ZONE("DoFrame");
+	FrameTelemetry& telemetry = gfx.GetTelemetry();
+	telemetry.Record(FrameTelemetry::Channel::Frame, frameTimer.MarkNs());
+	if (stressChangePending)
 	{
-		wnd.Gfx().xPos -= speed;
+		stressChangePending = false;
+		SetStressCount(pendingStressCount);
 	}
+	frameLoop.DoFrame();
 
-	if (wnd.kbd.KeyIsPressed('W'))
+	// what bounds the frame, refreshed once a second
+	if (reportTimer.Peek() > 1.0f)
 	{
-		wnd.Gfx().zPos += speed;
+		reportTimer.Mark();
+		const RenderThread::Stats render = frameLoop.GetRenderStats();
+		std::ostringstream oss;
+		oss << "The Donkey Fart Box - critical path: ";
+		frameLoop.GetFrameGraph().ReportCriticalPath(oss);
+		oss << ", render " << render.renderMs << "ms, sim waited " << render.waitMs << "ms";
+		const RendererStats& drawn = render.renderer;
+		if (pStress)
+		{
+			oss << ", stress " << pStress->GetCount() << ' '
+				<< StressScene::GetDistributionName(stressSettings.distribution);
+		}
+		oss << ", " << drawn.visible << '/' << drawn.objects << " visible, " << drawn.draws << " draws "
+			<< drawn.triangles << " tris, cull " << drawn.cullMs << "ms build " << drawn.buildMs
+			<< "ms submit " << drawn.submitMs << "ms";
+		FramePacer& pacer = gfx.GetFramePacer();
+		const FramePacer::Stats pacing = pacer.GetStats();
+		oss << ", " << FramePacer::GetModeName(pacing.mode) << " pacing error " << pacing.meanAbsErrorMs
+			<< "ms avg " << pacing.worstErrorMs << "ms worst";
+		const FrameTelemetry::Summary frames = telemetry.GetSummary(FrameTelemetry::Channel::Frame);
+		oss << ", frame p50 " << frames.p50Ms << "ms p99 " << frames.p99Ms << "ms p99.9 " << frames.p999Ms << "ms";
+		pacer.ResetStats();
+		pWnd->SetTitle(oss.str());
 	}
-	if (wnd.kbd.KeyIsPressed('S'))
+}
+
+void App::SetStressCount(size_t count)
+{
+	// snapshots hold copies of the transforms, nothing in flight on the render thread points into the old scene
+	frameLoop.SetStressScene(nullptr);
+	pStress.reset();
+	if (count != 0u)
 	{
-		wnd.Gfx().zPos -= speed;
+		stressSettings.count = count;
+		pStress = std::make_unique<StressScene>(stressSettings);
 	}
+	frameLoop.SetStressScene(pStress.get());
+}
 
-	wnd.Gfx().ClearBuffer(c, c, 1.0f);
-	wnd.Gfx().DrawTestTriangle(((float)wnd.mouse.GetPosX() / 400) - 1, -((float)wnd.mouse.GetPosY() / 300) + 1);
-	wnd.Gfx().EndFrame();
+void App::WriteTelemetry()
+{
+	const FrameTelemetry& telemetry = gfx.GetTelemetry();
+	telemetry.WriteCsv("telemetry.csv");
+	telemetry.WriteJson("telemetry.json");
 }
\ No newline at end of file
@@ -1,16 +1,46 @@
 #pragma once
-#include "Window.hpp"
+#include "PlatformWindow.hpp"
+#include "Graphics.hpp"
 #include "ChiliTimer.hpp"
+#include "FrameLoop.hpp"
 
 class App
 {
 public:
-	App();
+	// metricsPort != 0 streams live counters on 127.0.0.1:metricsPort (see MetricsServer),
+	// pStressSettings starts on a StressScene instead of the test scene
+	App(unsigned short metricsPort = 0u, const StressScene::Settings* pStressSettings = nullptr);
 	// master frame / message loop
 	int Go();
 private:
+	// the input task of the frame loop: camera controls from the keyboard and mouse plus the app keys
+	void ReadInput(FrameInput& input);
 	void DoFrame();
+	// telemetry.csv / telemetry.json next to the executable
+	void WriteTelemetry();
+	// 0 goes back to the test scene; between frames only
+	void SetStressCount(size_t count);
 private:
-	Window wnd;
-	ChiliTimer timer;
+	std::unique_ptr<PlatformWindow> pWnd;
+	Graphics gfx;
+	ChiliTimer reportTimer;
+	// frame to frame and message pump times for the telemetry histograms
+	ChiliTimer frameTimer;
+	ChiliTimer pumpTimer;
+	// P toggles pause, T cycles the time scale, C writes a profiler trace, M the telemetry,
+	// R an API capture, N steps the stress scene size; held state for edge detection
+	bool pauseKeyHeld = false;
+	bool scaleKeyHeld = false;
+	bool captureKeyHeld = false;
+	bool telemetryKeyHeld = false;
+	bool recordKeyHeld = false;
+	bool stressKeyHeld = false;
+	// N is read in the input task, the scene is swapped before the next frame starts
+	bool stressChangePending = false;
+	size_t pendingStressCount = 0u;
+	StressScene::Settings stressSettings;
+	std::unique_ptr<StressScene> pStress;
+	// optional, outlives the render thread that publishes to it
+	std::unique_ptr<MetricsServer> pMetrics;
+	FrameLoop frameLoop;
 };
\ No newline at end of file
@@ -0,0 +1,1134 @@
+#include "Benchmarks.hpp"
+#include "RenderQueue.hpp"
+#include "Mesh.hpp"
+#include "VertexQuantization.hpp"
+#include "FrustumCuller.hpp"
+#include "OcclusionCuller.hpp"
+#include "JobSystem.hpp"
+#include "FrameGraph.hpp"
+#include "RenderThread.hpp"
+#include "FramePacer.hpp"
+#include "FixedTimestep.hpp"
+#include "EngineClock.hpp"
+#include "Profiler.hpp"
+#include "FrameTelemetry.hpp"
+#include "MetricsServer.hpp"
+#include "StressScene.hpp"
+#include "SoftwareGraphics.hpp"
+#include "NullGraphics.hpp"
+#include "HeadlessWindow.hpp"
+#include "Geometry.hpp"
+#include "CpuFeatures.hpp"
+#include "ChiliTimer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iterator>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+void Benchmarks::RenderQueueSort(std::ostream& out, size_t count)
+{
+	constexpr int reps = 10;
+	std::mt19937_64 rng(1234u);
+	std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+	std::uniform_int_distribution<unsigned int> id(0u, 4095u);
+
+	// realistic spread: few passes and shaders, many depths and buffers
+	std::vector<SortEntry> source(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const bool translucent = (i % 8u) == 0u;
+		const unsigned int pass = id(rng) % 3u;
+		const uint64_t key = translucent ?
+			SortKey::Translucent(pass, depth(rng), id(rng) % 64u, id(rng) % 8u, id(rng)) :
+			SortKey::Opaque(pass, depth(rng), id(rng) % 64u, id(rng) % 8u, id(rng));
+		source[i] = { key,uint32_t(i) };
+	}
+
+	std::vector<SortEntry> entries(count);
+	std::vector<SortEntry> scratch(count);
+	float radixBest = 1e9f;
+	float stdBest = 1e9f;
+	for (int r = 0; r < reps; r++)
+	{
+		entries = source;
+		ChiliTimer timer;
+		RadixSort(entries.data(), scratch.data(), count);
+		radixBest = std::min(radixBest, timer.Mark());
+
+		scratch = source;
+		timer.Mark();
+		std::stable_sort(scratch.begin(), scratch.end(), [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+		stdBest = std::min(stdBest, timer.Mark());
+	}
+
+	out << "[RenderQueueSort] keys=" << count
+		<< " radix_ms=" << radixBest * 1000.0f
+		<< " std_stable_sort_ms=" << stdBest * 1000.0f
+		<< " mkeys_per_s=" << float(count) / radixBest / 1e6f << std::endl;
+}
+
+void Benchmarks::MeshOptimize(std::ostream& out, unsigned int rings)
+{
+	struct Vertex
+	{
+		Float3 pos;
+		uint8_t color[4];
+	};
+	// uv sphere exported the worst possible way: triangle soup in random order
+	const unsigned int segments = rings * 2u;
+	std::vector<Float3> points;
+	for (unsigned int r = 0; r <= rings; r++)
+	{
+		for (unsigned int s = 0; s <= segments; s++)
+		{
+			const float theta = PI * float(r) / float(rings);
+			const float phi = 2.0f * PI * float(s) / float(segments);
+			points.push_back({ std::sin(theta) * std::cos(phi),std::cos(theta),std::sin(theta) * std::sin(phi) });
+		}
+	}
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (unsigned int r = 0; r < rings; r++)
+	{
+		for (unsigned int s = 0; s < segments; s++)
+		{
+			const uint32_t a = r * (segments + 1u) + s;
+			const uint32_t c = a + segments + 1u;
+			triangles.push_back({ a,c,a + 1u });
+			triangles.push_back({ a + 1u,c,c + 1u });
+		}
+	}
+	std::mt19937 rng(1234u);
+	std::shuffle(triangles.begin(), triangles.end(), rng);
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	for (const auto& t : triangles)
+	{
+		for (const uint32_t v : t)
+		{
+			indices.push_back(uint32_t(vertices.size()));
+			vertices.push_back({ points[v],{ 255,255,255,255 } });
+		}
+	}
+
+	Mesh mesh(vertices.data(), vertices.size(), sizeof(Vertex), indices.data(), indices.size());
+	ChiliTimer timer;
+	const Mesh::Report report = mesh.Optimize();
+	const float seconds = timer.Mark();
+
+	out << "[MeshOptimize] triangles=" << triangles.size()
+		<< " vertices=" << report.verticesBefore << "->" << report.verticesAfter
+		<< " acmr=" << report.before.acmr << "->" << report.after.acmr
+		<< " atvr=" << report.before.atvr << "->" << report.after.atvr
+		<< " index_bits=" << (report.indexFormat == IndexFormat::Uint16 ? 16 : 32)
+		<< " ms=" << seconds * 1000.0f << std::endl;
+}
+
+void Benchmarks::VertexQuantize(std::ostream& out, size_t count)
+{
+	namespace vq = VertexQuantization;
+	constexpr int reps = 5;
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<Float3> positions(count);
+	std::vector<Float3> normals(count);
+	std::vector<Float2> uvs(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		positions[i] = { coord(rng),coord(rng),coord(rng) };
+		normals[i] = Normalize({ unit(rng),unit(rng),unit(rng) });
+		uvs[i] = { unit(rng) * 4.0f,unit(rng) * 4.0f };
+	}
+	vq::VertexStreams streams;
+	streams.pPositions = positions.data();
+	streams.pNormals = normals.data();
+	streams.pUVs = uvs.data();
+	streams.count = count;
+	const vq::VertexFormat full = { vq::PositionEncoding::Float32,vq::NormalEncoding::Float32,vq::UVEncoding::Float32,false };
+	const vq::VertexFormat compact = { vq::PositionEncoding::Unorm16,vq::NormalEncoding::Octahedral16,vq::UVEncoding::Half16,false };
+	const vq::Bounds bounds = vq::ComputeBounds(positions.data(), count);
+	const vq::Layout layout = vq::GetLayout(compact);
+
+	// every kernel must produce the scalar reference bytes
+	const vq::Kernel best = vq::GetKernel();
+	std::vector<uint8_t> reference;
+	const char* const names[] = { "scalar","sse2","avx2" };
+	for (int k = 0; k <= int(best); k++)
+	{
+		vq::SetKernel(vq::Kernel(k));
+		std::vector<uint8_t> encoded;
+		float bestTime = 1e9f;
+		for (int r = 0; r < reps; r++)
+		{
+			ChiliTimer timer;
+			encoded = vq::Encode(streams, compact, bounds);
+			bestTime = std::min(bestTime, timer.Mark());
+		}
+		if (k == 0)
+		{
+			reference = encoded;
+		}
+		out << "[VertexQuantize] kernel=" << names[k]
+			<< " vertices=" << count
+			<< " encode_ms=" << bestTime * 1000.0f
+			<< " mverts_per_s=" << float(count) / bestTime / 1e6f
+			<< " matches_scalar=" << (encoded == reference ? "yes" : "NO") << std::endl;
+	}
+	vq::SetKernel(best);
+
+	std::vector<Float3> decodedPositions(count);
+	std::vector<Float3> decodedNormals(count);
+	std::vector<Float2> decodedUVs(count);
+	vq::DecodePositionsUnorm16(reference.data() + layout.positionOffset, layout.stride, count, bounds, decodedPositions.data());
+	vq::DecodeNormalsOctahedral16(reference.data() + layout.normalOffset, layout.stride, count, decodedNormals.data());
+	vq::DecodeUVsHalf(reference.data() + layout.uvOffset, layout.stride, count, decodedUVs.data());
+	float positionError = 0.0f;
+	float normalErrorDegrees = 0.0f;
+	float uvError = 0.0f;
+	for (size_t i = 0; i < count; i++)
+	{
+		positionError = std::max({ positionError,
+			std::abs(decodedPositions[i].x - positions[i].x),
+			std::abs(decodedPositions[i].y - positions[i].y),
+			std::abs(decodedPositions[i].z - positions[i].z) });
+		const float cosine = std::min(Dot(decodedNormals[i], normals[i]), 1.0f);
+		normalErrorDegrees = std::max(normalErrorDegrees, std::acos(cosine) * 180.0f / PI);
+		uvError = std::max({ uvError,std::abs(decodedUVs[i].x - uvs[i].x),std::abs(decodedUVs[i].y - uvs[i].y) });
+	}
+	out << "[VertexQuantize] bytes_per_vertex=" << vq::GetLayout(full).stride << "->" << layout.stride
+		<< " max_position_error=" << positionError
+		<< " max_normal_error_deg=" << normalErrorDegrees
+		<< " max_uv_error=" << uvError << std::endl;
+}
+
+void Benchmarks::FrustumCull(std::ostream& out, size_t count)
+{
+	constexpr int reps = 10;
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float> coord(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> size(0.1f, 4.0f);
+	SphereBounds spheres;
+	BoxBounds boxes;
+	spheres.Reserve(count);
+	boxes.Reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Float3 center = { coord(rng),coord(rng),coord(rng) };
+		spheres.Add(center, size(rng));
+		boxes.Add(center, { size(rng),size(rng),size(rng) });
+	}
+	const Matrix4 viewProj =
+		Matrix4::LookAtLH({ 0.0f,0.0f,-50.0f }, { 10.0f,5.0f,0.0f }, { 0.0f,1.0f,0.0f }) *
+		Matrix4::PerspectiveFovLH(PI / 3.0f, 16.0f / 9.0f, 0.5f, 300.0f);
+	const Frustum frustum = Frustum::FromViewProjection(viewProj);
+
+	JobSystem jobs;
+	struct Config
+	{
+		bool simd;
+		bool parallel;
+	};
+	const Config configs[] = {
+		{ false,false },
+		{ true,false },
+		{ true,true }
+	};
+	const auto run = [&](const char* shape, const auto& bounds)
+	{
+		std::vector<uint32_t> reference;
+		for (const Config& c : configs)
+		{
+			FrustumCuller::SetSimdEnabled(c.simd);
+			FrustumCuller culler(c.parallel ? &jobs : nullptr);
+			std::vector<uint32_t> visible;
+			float bestTime = 1e9f;
+			for (int r = 0; r < reps; r++)
+			{
+				ChiliTimer timer;
+				culler.Cull(frustum, bounds, visible);
+				bestTime = std::min(bestTime, timer.Mark());
+			}
+			if (reference.empty())
+			{
+				reference = visible;
+			}
+			// fused multiply-add in the vector kernels can flip a test that lands exactly on a plane
+			std::vector<uint32_t> difference;
+			std::set_symmetric_difference(visible.begin(), visible.end(), reference.begin(), reference.end(), std::back_inserter(difference));
+			out << "[FrustumCull] shape=" << shape
+				<< " kernel=" << (c.simd && CpuFeatures::HasAvx2() ? "avx2" : "scalar")
+				<< " threads=" << culler.GetThreadCount()
+				<< " objects=" << count
+				<< " visible=" << visible.size()
+				<< " cull_ms=" << bestTime * 1000.0f
+				<< " mobjects_per_s=" << float(count) / bestTime / 1e6f
+				<< " differs_from_scalar=" << difference.size() << std::endl;
+		}
+		FrustumCuller::SetSimdEnabled(true);
+	};
+	run("sphere", spheres);
+	run("box", boxes);
+}
+
+void Benchmarks::OcclusionCull(std::ostream& out, size_t count, unsigned int frames)
+{
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	// two rows of building fronts along the z axis, boxes scattered behind and between them
+	std::vector<Matrix4> walls;
+	for (int side = -1; side <= 1; side += 2)
+	{
+		for (int i = 0; i < 40; i++)
+		{
+			const float height = 6.0f + unit(rng) * 14.0f;
+			walls.push_back(
+				Matrix4::Scaling(1.0f, height, 9.0f) *
+				Matrix4::Translation(float(side) * 8.0f, height * 0.5f - 0.5f, float(i) * 10.0f));
+		}
+	}
+	BoxBounds boxes;
+	boxes.Reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const float side = unit(rng) < 0.5f ? -1.0f : 1.0f;
+		boxes.Add({ side * (9.0f + unit(rng) * 60.0f),unit(rng) * 8.0f,unit(rng) * 400.0f }, { 0.5f,0.5f,0.5f });
+	}
+
+	// the frustum pass runs first as it would in a frame, occlusion only sees what is in view
+	JobSystem jobs;
+	FrustumCuller frustumCuller(&jobs);
+	OcclusionCuller culler(320u, 192u, &jobs);
+	const Mesh& cube = Geometry::ColoredCube();
+	BoxBounds candidates;
+	std::vector<uint32_t> inFrustum;
+	std::vector<uint32_t> visible;
+	float totalRaster = 0.0f;
+	float totalTest = 0.0f;
+	size_t totalTested = 0u;
+	size_t totalCulled = 0u;
+	for (unsigned int f = 0; f < frames; f++)
+	{
+		const float z = float(f) * 300.0f / float(frames);
+		const Matrix4 viewProj =
+			Matrix4::LookAtLH({ 0.0f,2.0f,z }, { 0.0f,2.0f,z + 10.0f }, { 0.0f,1.0f,0.0f }) *
+			Matrix4::PerspectiveFovLH(PI / 3.0f, 16.0f / 9.0f, 0.5f, 500.0f);
+		frustumCuller.Cull(Frustum::FromViewProjection(viewProj), boxes, inFrustum);
+		candidates.Clear();
+		for (const uint32_t i : inFrustum)
+		{
+			candidates.Add({ boxes.centerX[i],boxes.centerY[i],boxes.centerZ[i] }, { boxes.extentX[i],boxes.extentY[i],boxes.extentZ[i] });
+		}
+
+		ChiliTimer timer;
+		culler.BeginFrame(viewProj);
+		for (const Matrix4& w : walls)
+		{
+			culler.AddOccluder(cube, w);
+		}
+		culler.RenderOccluders();
+		const float rasterTime = timer.Mark();
+		culler.TestBoxes(candidates, visible);
+		const float testTime = timer.Mark();
+		const OcclusionCuller::Stats& stats = culler.GetStats();
+		out << "[OcclusionCull] frame=" << f
+			<< " occluder_tris=" << stats.occluderTriangles
+			<< " in_frustum=" << stats.tested
+			<< " visible=" << visible.size()
+			<< " culled_pct=" << stats.CulledPercent()
+			<< " raster_ms=" << rasterTime * 1000.0f
+			<< " test_ms=" << testTime * 1000.0f << std::endl;
+		totalRaster += rasterTime;
+		totalTest += testTime;
+		totalTested += stats.tested;
+		totalCulled += stats.culled;
+	}
+	out << "[OcclusionCull] threads=" << culler.GetThreadCount()
+		<< " resolution=" << culler.GetWidth() << "x" << culler.GetHeight()
+		<< " boxes=" << count
+		<< " mean_culled_pct=" << (totalTested != 0u ? 100.0f * float(totalCulled) / float(totalTested) : 0.0f)
+		<< " mean_raster_ms=" << totalRaster * 1000.0f / float(frames)
+		<< " mean_test_ms=" << totalTest * 1000.0f / float(frames) << std::endl;
+}
+
+void Benchmarks::JobScaling(std::ostream& out, unsigned int maxThreads)
+{
+	if (maxThreads == 0u)
+	{
+		maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	constexpr int reps = 5;
+	constexpr size_t pointCount = 1u << 21;
+	constexpr size_t tinyJobs = 50u * JobSystem::jobsPerThread;
+	std::vector<Float3> points(pointCount);
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+	for (Float3& p : points)
+	{
+		p = { coord(rng),coord(rng),coord(rng) };
+	}
+	std::vector<Float4> transformed(pointCount);
+	const Matrix4 m = Matrix4::RotationY(0.3f) * Matrix4::Translation(1.0f, 2.0f, 3.0f) *
+		Matrix4::PerspectiveFovLH(PI / 3.0f, 16.0f / 9.0f, 0.5f, 100.0f);
+
+	float baseline = 0.0f;
+	for (unsigned int n = 1; n <= maxThreads; n++)
+	{
+		JobSystem jobs(n);
+		// transform update: a parallel_for over a flat array
+		float transformTime = 1e9f;
+		for (int r = 0; r < reps; r++)
+		{
+			ChiliTimer timer;
+			jobs.ParallelFor(0u, pointCount, 4096u, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					transformed[i] = m.TransformPoint(points[i]);
+				}
+			});
+			transformTime = std::min(transformTime, timer.Mark());
+		}
+		// scheduling overhead: empty jobs submitted from one thread and stolen by the rest,
+		// in batches that fit the submitting thread's job ring so none of them runs inline
+		float tinyTime = 1e9f;
+		for (int r = 0; r < reps; r++)
+		{
+			ChiliTimer timer;
+			for (size_t submitted = 0; submitted < tinyJobs; submitted += JobSystem::jobsPerThread / 2u)
+			{
+				JobCounter counter;
+				for (size_t i = 0; i < JobSystem::jobsPerThread / 2u; i++)
+				{
+					jobs.Run(counter, []() {});
+				}
+				jobs.Wait(counter);
+			}
+			tinyTime = std::min(tinyTime, timer.Mark());
+		}
+		if (n == 1u)
+		{
+			baseline = transformTime;
+		}
+		out << "[JobScaling] threads=" << n
+			<< " transform_points=" << pointCount
+			<< " transform_ms=" << transformTime * 1000.0f
+			<< " speedup=" << baseline / transformTime
+			<< " empty_jobs_per_s=" << float(tinyJobs) / tinyTime << std::endl;
+	}
+}
+
+void Benchmarks::FrameSchedule(std::ostream& out, size_t count, unsigned int frames)
+{
+	JobSystem jobs;
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float> coord(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> speed(-1.0f, 1.0f);
+	std::vector<Float3> positions(count);
+	std::vector<Float3> velocities(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		positions[i] = { coord(rng),coord(rng),coord(rng) };
+		velocities[i] = { speed(rng),speed(rng),speed(rng) };
+	}
+	SphereBounds bounds;
+	bounds.Reserve(count);
+	FrustumCuller culler(&jobs);
+	std::vector<uint32_t> visible;
+	visible.reserve(count);
+	RenderQueue queue;
+	queue.Reserve(count);
+	float yaw = 0.0f;
+	Matrix4 viewProj;
+	float checksum = 0.0f;
+
+	::FrameGraph graph;
+	const auto camera = graph.AddResource("camera");
+	const auto scene = graph.AddResource("scene");
+	const auto visibleSet = graph.AddResource("visible");
+	const auto draws = graph.AddResource("draws");
+	const auto backBuffer = graph.AddResource("back buffer");
+	graph.AddTask("input", {}, { camera }, [&]()
+	{
+		yaw += 0.01f;
+		viewProj = Matrix4::RotationY(yaw) * Matrix4::PerspectiveFovLH(PI / 3.0f, 16.0f / 9.0f, 0.5f, 400.0f);
+	}, ::FrameGraph::Affinity::MainThread);
+	graph.AddTask("simulate", {}, { scene }, [&]()
+	{
+		jobs.ParallelFor(0u, count, 4096u, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				positions[i].x += velocities[i].x * 0.016f;
+				positions[i].y += velocities[i].y * 0.016f;
+				positions[i].z += velocities[i].z * 0.016f;
+			}
+		});
+		bounds.Clear();
+		for (const Float3& p : positions)
+		{
+			bounds.Add(p, 1.0f);
+		}
+	});
+	graph.AddTask("cull", { camera,scene }, { visibleSet }, [&]()
+	{
+		culler.Cull(Frustum::FromViewProjection(viewProj), bounds, visible);
+	});
+	graph.AddTask("build draws", { camera,visibleSet }, { draws }, [&]()
+	{
+		queue.Clear();
+		for (const uint32_t i : visible)
+		{
+			const Float4 clip = viewProj.TransformPoint(positions[i]);
+			queue.Push(SortKey::Opaque(0u, clip.w / 400.0f, 0u, 0u, 0u), i);
+		}
+		queue.Sort();
+	});
+	// stands in for the device context work, which can only happen on one thread
+	graph.AddTask("clear", {}, { backBuffer }, [&]()
+	{
+		checksum = 0.0f;
+	}, ::FrameGraph::Affinity::MainThread);
+	graph.AddTask("submit", { draws,backBuffer }, { backBuffer }, [&]()
+	{
+		for (const SortEntry& e : queue)
+		{
+			checksum += positions[e.item].x;
+		}
+	}, ::FrameGraph::Affinity::MainThread);
+	graph.AddTask("present", { backBuffer }, {}, [&]() {}, ::FrameGraph::Affinity::MainThread);
+	graph.Compile();
+
+	float frameMs = 0.0f;
+	float pathMs = 0.0f;
+	for (unsigned int f = 0; f < frames; f++)
+	{
+		graph.Execute(jobs);
+		frameMs += graph.GetFrameMs();
+		pathMs += graph.GetCriticalPathMs();
+	}
+	out << "[FrameSchedule] objects=" << count
+		<< " threads=" << jobs.GetThreadCount()
+		<< " frames=" << frames
+		<< " frame_ms=" << frameMs / float(frames)
+		<< " critical_path_ms=" << pathMs / float(frames)
+		<< " drawn=" << queue.Size() << std::endl;
+	out << "[FrameSchedule] critical path: ";
+	graph.ReportCriticalPath(out);
+	out << std::endl;
+	graph.Report(out);
+}
+
+namespace
+{
+	// busy work for a fixed time, standing in for CPU bound simulation or submission
+	void Spin(float ms) noexcept
+	{
+		ChiliTimer timer;
+		volatile float sink = 0.0f;
+		while (timer.Peek() * 1000.0f < ms)
+		{
+			sink = sink + 1.0f;
+		}
+	}
+
+	class SpinRenderer : public IFrameRenderer
+	{
+	public:
+		explicit SpinRenderer(float ms) noexcept
+			:
+			ms(ms)
+		{}
+		void SetCamera(float, float, float) override
+		{}
+		void ClearBuffer(float, float, float) override
+		{}
+		void DrawScene(const FrameSnapshot& scene) override
+		{
+			drawn += scene.cubes.size();
+			Spin(ms);
+		}
+		void EndFrame() override
+		{}
+		size_t drawn = 0u;
+	private:
+		float ms;
+	};
+
+	void SimulateFrame(FrameSnapshot& scene, unsigned int frame, float ms)
+	{
+		for (unsigned int i = 0; i < 64u; i++)
+		{
+			scene.QueueCube(Matrix4::RotationY(float(frame + i) * 0.01f) * Matrix4::Translation(float(i), 0.0f, 10.0f));
+		}
+		Spin(ms);
+	}
+}
+
+void Benchmarks::RenderThreadOverlap(std::ostream& out, unsigned int frames, float simMs, float renderMs)
+{
+	// everything on one thread: frame time is sim + render
+	float serialMs = 0.0f;
+	{
+		SpinRenderer renderer(renderMs);
+		FrameSnapshot scene;
+		ChiliTimer timer;
+		for (unsigned int f = 0; f < frames; f++)
+		{
+			scene.Clear();
+			SimulateFrame(scene, f, simMs);
+			renderer.SetCamera(0.0f, 0.0f, -5.0f);
+			renderer.ClearBuffer(0.0f, 0.0f, 1.0f);
+			renderer.DrawScene(scene);
+			renderer.EndFrame();
+		}
+		serialMs = timer.Mark() * 1000.0f / float(frames);
+	}
+	// render thread: frame N is drawn while N+1 is simulated
+	float pipelinedMs = 0.0f;
+	RenderThread::Stats stats;
+	{
+		SpinRenderer renderer(renderMs);
+		RenderThread renderThread(renderer);
+		ChiliTimer timer;
+		for (unsigned int f = 0; f < frames; f++)
+		{
+			SimulateFrame(renderThread.BeginFrame(), f, simMs);
+			renderThread.SetCamera(0.0f, 0.0f, -5.0f);
+			renderThread.ClearBuffer(0.0f, 0.0f, 1.0f);
+			renderThread.EndFrame();
+		}
+		renderThread.Flush();
+		pipelinedMs = timer.Mark() * 1000.0f / float(frames);
+		stats = renderThread.GetStats();
+	}
+	out << "[RenderThreadOverlap] frames=" << frames
+		<< " sim_ms=" << simMs
+		<< " render_ms=" << renderMs
+		<< " hardware_threads=" << std::thread::hardware_concurrency()
+		<< " serial_frame_ms=" << serialMs
+		<< " pipelined_frame_ms=" << pipelinedMs
+		<< " ideal_frame_ms=" << std::max(simMs, renderMs)
+		<< " last_wait_ms=" << stats.waitMs
+		<< " last_idle_ms=" << stats.idleMs << std::endl;
+}
+
+void Benchmarks::FramePacing(std::ostream& out, unsigned int frames, float targetFps)
+{
+	const int64_t period = int64_t(1e9 / double(targetFps));
+	// frame work between 10% and 80% of the period, same sequence for every run
+	const auto work = [period](unsigned int frame)
+	{
+		return period / 10 + int64_t((frame * 2654435761u) % 700u) * period / 1000;
+	};
+	// sleep straight to the deadline, the granularity and jitter land in the frame time
+	{
+		SimulatedClock clock;
+		int64_t deadline = clock.Now();
+		int64_t last = 0;
+		double absError = 0.0;
+		double worst = 0.0;
+		for (unsigned int f = 0; f < frames; f++)
+		{
+			clock.Advance(work(f));
+			deadline += period;
+			clock.Sleep(deadline - clock.Now());
+			const int64_t now = clock.Now();
+			if (f > 0u)
+			{
+				const double error = double(now - last - period) * 1e-6;
+				absError += std::abs(error);
+				worst = std::max(worst, std::abs(error));
+			}
+			last = now;
+		}
+		out << "[FramePacing] clock=simulated pacing=sleep target_fps=" << targetFps
+			<< " mean_abs_error_ms=" << absError / double(frames - 1u)
+			<< " worst_error_ms=" << worst << std::endl;
+	}
+	const auto runPacer = [&](IClock& clock, SimulatedClock* pSimulated, const char* name)
+	{
+		FramePacer pacer(clock, FramePacer::Mode::TargetFps, targetFps);
+		for (unsigned int f = 0; f < frames; f++)
+		{
+			if (pSimulated)
+			{
+				pSimulated->Advance(work(f));
+			}
+			else
+			{
+				Spin(float(work(f)) * 1e-6f);
+			}
+			pacer.WaitForDeadline();
+			pacer.MarkPresented();
+		}
+		const FramePacer::Stats stats = pacer.GetStats();
+		out << "[FramePacing] clock=" << name << " pacing=sleep+spin target_fps=" << targetFps
+			<< " mean_abs_error_ms=" << stats.meanAbsErrorMs
+			<< " worst_error_ms=" << std::abs(stats.worstErrorMs) << std::endl;
+	};
+	SimulatedClock simulated;
+	runPacer(simulated, &simulated, "simulated");
+	SystemClock system;
+	runPacer(system, nullptr, "system");
+}
+
+void Benchmarks::FixedStep(std::ostream& out, float seconds)
+{
+	struct Pattern
+	{
+		const char* name;
+		float frameMs;
+		// every Nth frame takes stallMs instead, 0 for none
+		unsigned int stallEvery;
+		float stallMs;
+		bool jitter;
+	};
+	const Pattern patterns[] = {
+		{ "1000fps",1.0f,0u,0.0f,false },
+		{ "144fps",1000.0f / 144.0f,0u,0.0f,false },
+		{ "60fps",1000.0f / 60.0f,0u,0.0f,false },
+		{ "20fps",50.0f,0u,0.0f,false },
+		{ "60fps_jitter",1000.0f / 60.0f,0u,0.0f,true },
+		{ "60fps_stalls",1000.0f / 60.0f,120u,250.0f,false }
+	};
+	for (const Pattern& p : patterns)
+	{
+		FixedTimestep timestep;
+		std::mt19937 rng(1234u);
+		std::uniform_real_distribution<float> jitter(0.5f, 1.5f);
+		double elapsed = 0.0;
+		unsigned long long frames = 0u;
+		unsigned long long steps = 0u;
+		unsigned int maxSteps = 0u;
+		while (elapsed < double(seconds))
+		{
+			float frameMs = p.jitter ? p.frameMs * jitter(rng) : p.frameMs;
+			if (p.stallEvery && frames % p.stallEvery == p.stallEvery - 1u)
+			{
+				frameMs = p.stallMs;
+			}
+			elapsed += frameMs * 1e-3;
+			const unsigned int n = timestep.Advance(frameMs * 1e-3f);
+			steps += n;
+			maxSteps = std::max(maxSteps, n);
+			frames++;
+		}
+		out << "[FixedStep] frames=" << p.name
+			<< " step_hz=" << 1.0f / timestep.GetStep()
+			<< " steps_per_s=" << double(steps) / elapsed
+			<< " max_steps_per_frame=" << maxSteps
+			<< " simulated_s=" << timestep.GetSimulatedSeconds()
+			<< " dropped_s=" << timestep.GetDroppedSeconds()
+			<< " wall_s=" << elapsed << std::endl;
+	}
+}
+
+void Benchmarks::ClockRead(std::ostream& out, size_t reads)
+{
+	// every read feeds a running sum and a monotonicity check so none of them can be optimized out
+	const auto measure = [&](const char* name, auto&& read)
+	{
+		int64_t previous = read();
+		int64_t sum = 0;
+		size_t backwards = 0u;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < reads; i++)
+		{
+			const int64_t t = read();
+			backwards += t < previous ? 1u : 0u;
+			sum += t - previous;
+			previous = t;
+		}
+		const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		out << "[ClockRead] clock=" << name
+			<< " ns_per_read=" << ns / double(reads)
+			<< " backwards=" << backwards
+			<< " span_ms=" << double(sum) * 1e-6 << std::endl;
+	};
+	measure("steady_clock", []()
+	{
+		return int64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+	});
+	measure("high_precision", []()
+	{
+		return HighPrecisionClock::Now();
+	});
+	// what a profiler zone pays per timestamp; span is in ticks here
+	measure("high_precision_ticks", []()
+	{
+		return HighPrecisionClock::Ticks();
+	});
+	ChiliTimer timer;
+	measure("chili_timer", [&timer]()
+	{
+		return timer.PeekNs();
+	});
+	EngineClock clock;
+	measure("engine_wall", [&clock]()
+	{
+		return clock.GetWallTime();
+	});
+	const float tenHours = 36000.0f;
+	out << "[ClockRead] uses_tsc=" << HighPrecisionClock::UsesTsc()
+		<< " frequency_mhz=" << HighPrecisionClock::GetFrequency() * 1e-6
+		<< " float_seconds_step_after_10h_ms=" << (std::nextafter(tenHours, 1e9f) - tenHours) * 1000.0f
+		<< " int64_ns_step_ms=" << 1e-6 << std::endl;
+}
+
+void Benchmarks::ProfilerOverhead(std::ostream& out, size_t zones, unsigned int threads)
+{
+	// a few dependent multiplies per iteration stand in for the code inside the zone
+	const auto loop = [zones](bool zoned)
+	{
+		uint64_t x = 1u;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < zones; i++)
+		{
+			if (zoned)
+			{
+				PROFILE_ZONE("bench zone");
+				x = x * 6364136223846793005ull + i;
+			}
+			else
+			{
+				x = x * 6364136223846793005ull + i;
+			}
+		}
+		const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		return std::make_pair(ns / double(zones), x);
+	};
+	PROFILE_THREAD("bench");
+	uint64_t sink = 0u;
+	const auto bare = loop(false);
+	// zones inside a frame are nested and read the clock once, an outermost zone reads it twice
+	const auto outermost = loop(true);
+	std::pair<double, uint64_t> zoned;
+	{
+		PROFILE_ZONE("bench loop");
+		zoned = loop(true);
+	}
+	sink += bare.second + outermost.second + zoned.second;
+	out << "[ProfilerOverhead] enabled=" << CHILI_PROFILING
+		<< " threads=1 ns_per_iteration=" << bare.first
+		<< " ns_per_zoned_iteration=" << zoned.first
+		<< " ns_per_zone=" << zoned.first - bare.first
+		<< " ns_per_outermost_zone=" << outermost.first - bare.first << std::endl;
+
+	// every thread owns its ring, so more threads should not make a zone more expensive
+	std::vector<std::thread> workers;
+	std::vector<double> perThread(threads);
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&, t]()
+		{
+			PROFILE_THREAD("bench " + std::to_string(t));
+			PROFILE_ZONE("bench loop");
+			perThread[t] = loop(true).first;
+		});
+	}
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+	out << "[ProfilerOverhead] enabled=" << CHILI_PROFILING
+		<< " threads=" << threads
+		<< " ns_per_zoned_iteration=" << *std::max_element(perThread.begin(), perThread.end()) << std::endl;
+
+	std::ostringstream trace;
+	const auto start = std::chrono::steady_clock::now();
+	Profiler::WriteChromeTrace(trace);
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	out << "[ProfilerOverhead] export_bytes=" << trace.str().size()
+		<< " export_ms=" << ms
+		<< " sink=" << (sink & 1u) << std::endl;
+}
+
+void Benchmarks::FrameTimePercentiles(std::ostream& out, size_t frames)
+{
+	// 16.7ms give or take a millisecond, one frame in 500 hitches for 30..100ms
+	std::mt19937_64 rng(19u);
+	std::normal_distribution<double> jitter(16.7e6, 1e6);
+	std::uniform_real_distribution<double> hitch(30e6, 100e6);
+	std::uniform_int_distribution<int> hitchChance(0, 499);
+	std::vector<int64_t> samples(frames);
+	for (auto& s : samples)
+	{
+		s = int64_t(hitchChance(rng) == 0 ? hitch(rng) : std::max(jitter(rng), 1e6));
+	}
+
+	FrameTelemetry telemetry;
+	const auto start = std::chrono::steady_clock::now();
+	for (const int64_t s : samples)
+	{
+		telemetry.Record(FrameTelemetry::Channel::Frame, s);
+	}
+	const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	const FrameTelemetry::Summary summary = telemetry.GetSummary(FrameTelemetry::Channel::Frame);
+
+	std::vector<int64_t> sorted = samples;
+	std::sort(sorted.begin(), sorted.end());
+	const auto exactMs = [&sorted](double percentile)
+	{
+		const size_t rank = std::max<size_t>(size_t(std::ceil(percentile / 100.0 * double(sorted.size()))), 1u);
+		return double(sorted[rank - 1u]) * 1e-6;
+	};
+	const double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / double(frames) * 1e-6;
+	const std::pair<const char*, std::pair<double, double>> rows[] = {
+		{ "p50",{ summary.p50Ms,exactMs(50.0) } },
+		{ "p95",{ summary.p95Ms,exactMs(95.0) } },
+		{ "p99",{ summary.p99Ms,exactMs(99.0) } },
+		{ "p99.9",{ summary.p999Ms,exactMs(99.9) } },
+		{ "max",{ summary.maxMs,exactMs(100.0) } }
+	};
+	out << "[FrameTimePercentiles] frames=" << frames << " mean_ms=" << summary.meanMs
+		<< " exact_mean_ms=" << mean << " ns_per_record=" << ns / double(frames) << std::endl;
+	for (const auto& r : rows)
+	{
+		out << "[FrameTimePercentiles] " << r.first << "_ms=" << r.second.first
+			<< " exact_ms=" << r.second.second
+			<< " rel_error=" << std::abs(r.second.first - r.second.second) / r.second.second << std::endl;
+	}
+	const std::vector<FrameTelemetry::WorstFrame> worst = telemetry.GetWorst(FrameTelemetry::Channel::Frame);
+	out << "[FrameTimePercentiles] worst_frames=" << worst.size()
+		<< " worst_ms=" << worst.front().ms << " frame=" << worst.front().frame
+		<< " matches_exact=" << (int64_t(worst.front().ms * 1e6 + 0.5) == sorted.back()) << std::endl;
+}
+
+void Benchmarks::MetricsPublish(std::ostream& out, size_t frames)
+{
+	FrameTelemetry telemetry;
+	// port 0: whatever is free, so this never collides with a running engine
+	MetricsServer server(0u, &telemetry, 1u);
+	MetricsSnapshot snapshot;
+	int64_t total = 0;
+	int64_t worst = 0;
+	for (size_t i = 0; i < frames; i++)
+	{
+		snapshot.frame = i;
+		snapshot.draws = unsigned(i & 1023u);
+		telemetry.Record(FrameTelemetry::Channel::Frame, 16000000 + int64_t(i & 4095u) * 1000);
+		const int64_t start = HighPrecisionClock::Now();
+		server.Publish(snapshot);
+		const int64_t ns = HighPrecisionClock::Now() - start;
+		total += ns;
+		worst = std::max(worst, ns);
+	}
+	out << "[MetricsPublish] frames=" << frames << " port=" << server.GetPort()
+		<< " ns_per_publish=" << double(total) / double(frames)
+		<< " worst_publish_us=" << double(worst) * 1e-3
+		<< " working_set_mb=" << double(MetricsServer::GetWorkingSetBytes()) / (1024.0 * 1024.0) << std::endl;
+}
+
+void Benchmarks::StressScaling(std::ostream& out, size_t maxCount, unsigned int frames)
+{
+	// small target, the point is the per object cost of submission rather than fill rate
+	SoftwareGraphics gfx(320u, 240u);
+	JobSystem& jobs = gfx.GetJobSystem();
+	FrustumCuller culler(&jobs);
+	SphereBounds bounds;
+	std::vector<uint32_t> visible;
+	RenderQueue queue;
+	FrameSnapshot scene;
+	FrameSnapshot drawn;
+	for (size_t count = 1000u; count <= maxCount; count *= 10u)
+	{
+		StressScene::Settings settings;
+		settings.count = count;
+		settings.distribution = StressScene::Distribution::Sphere;
+		const StressScene stress(settings);
+		const Matrix4 viewProj = gfx.GetViewProjection();
+		const Frustum frustum = Frustum::FromViewProjection(viewProj);
+		float buildMs = 0.0f, cullMs = 0.0f, sortMs = 0.0f, submitMs = 0.0f;
+		ChiliTimer timer;
+		for (unsigned int f = 0; f < frames; f++)
+		{
+			timer.Mark();
+			scene.Clear();
+			stress.Build(scene, double(f) * 0.016, jobs);
+			buildMs += timer.Mark() * 1000.0f;
+
+			// same bounding sphere as Graphics::CullQueue: mesh center and the longest basis row
+			bounds.Clear();
+			for (const Matrix4& w : scene.cubes)
+			{
+				const Float4 center = w.TransformPoint({ 0.0f,0.0f,0.5f });
+				const float scale = std::sqrt(std::max({
+					w.m[0][0] * w.m[0][0] + w.m[0][1] * w.m[0][1] + w.m[0][2] * w.m[0][2],
+					w.m[1][0] * w.m[1][0] + w.m[1][1] * w.m[1][1] + w.m[1][2] * w.m[1][2],
+					w.m[2][0] * w.m[2][0] + w.m[2][1] * w.m[2][1] + w.m[2][2] * w.m[2][2] }));
+				bounds.Add({ center.x,center.y,center.z }, 0.8660254f * scale);
+			}
+			culler.Cull(frustum, bounds, visible);
+			cullMs += timer.Mark() * 1000.0f;
+
+			queue.Clear();
+			for (const uint32_t i : visible)
+			{
+				const Matrix4& w = scene.cubes[i];
+				const Float4 origin = viewProj.TransformPoint({ w.m[3][0],w.m[3][1],w.m[3][2] });
+				queue.Push(SortKey::Opaque(0u, origin.w / 100.0f, 0u, 0u, scene.materials[i]), i);
+			}
+			queue.Sort();
+			sortMs += timer.Mark() * 1000.0f;
+
+			drawn.Clear();
+			for (const SortEntry& e : queue)
+			{
+				drawn.QueueCube(scene.cubes[e.item], false, scene.materials[e.item]);
+			}
+			gfx.ClearBuffer(0.0f, 0.0f, 0.0f);
+			gfx.DrawScene(drawn);
+			gfx.EndFrame();
+			submitMs += timer.Mark() * 1000.0f;
+		}
+		const RendererStats stats = gfx.GetFrameStats();
+		const float n = float(frames);
+		const auto perCube = [count, n](float ms)
+		{
+			return double(ms) * 1e6 / (double(count) * double(n));
+		};
+		out << "[StressScaling] cubes=" << count
+			<< " visible=" << visible.size()
+			<< " draws=" << stats.draws
+			<< " triangles=" << stats.triangles
+			<< " build_ms=" << buildMs / n << " (" << perCube(buildMs) << " ns/cube)"
+			<< " cull_ms=" << cullMs / n << " (" << perCube(cullMs) << ")"
+			<< " sort_ms=" << sortMs / n << " (" << perCube(sortMs) << ")"
+			<< " submit_ms=" << submitMs / n << " (" << perCube(submitMs) << ")" << std::endl;
+	}
+}
+
+void Benchmarks::NullSubmission(std::ostream& out, size_t count, unsigned int frames)
+{
+	StressScene::Settings settings;
+	settings.count = count;
+	settings.distribution = StressScene::Distribution::Sphere;
+	const StressScene stress(settings);
+	NullGraphics plain;
+	NullGraphics recorded(true);
+	RecordingRenderContext& recording = recorded.GetRecording();
+	FrameSnapshot scene;
+	float plainMs = 0.0f, recordMs = 0.0f, replayMs = 0.0f;
+	size_t bytes = 0u, calls = 0u;
+	ChiliTimer timer;
+	for (unsigned int f = 0; f < frames; f++)
+	{
+		scene.Clear();
+		stress.Build(scene, double(f) * 0.016, plain.GetJobSystem());
+
+		timer.Mark();
+		plain.ClearBuffer(0.0f, 0.0f, 0.0f);
+		plain.DrawScene(scene);
+		plain.EndFrame();
+		plainMs += timer.Mark() * 1000.0f;
+
+		recording.Clear();
+		timer.Mark();
+		recorded.ClearBuffer(0.0f, 0.0f, 0.0f);
+		recorded.DrawScene(scene);
+		recorded.EndFrame();
+		recordMs += timer.Mark() * 1000.0f;
+		bytes += recording.GetBytes().size();
+		calls += recording.GetCallCount();
+
+		// the handles are the recorded context's own, so the frame replays into it
+		timer.Mark();
+		recording.Replay(recorded.GetContext());
+		replayMs += timer.Mark() * 1000.0f;
+	}
+	const float n = float(frames);
+	const RendererStats stats = plain.GetFrameStats();
+	out << "[NullSubmission] cubes=" << count
+		<< " visible=" << stats.visible
+		<< " draws=" << stats.draws
+		<< " null_ms=" << plainMs / n
+		<< " recording_ms=" << recordMs / n
+		<< " replay_ms=" << replayMs / n
+		<< " calls=" << calls / frames
+		<< " bytes=" << bytes / frames
+		<< " bytes_per_call=" << double(bytes) / double(std::max<size_t>(calls, 1u)) << std::endl;
+}
+
+void Benchmarks::WindowEvents(std::ostream& out, size_t events, unsigned int eventsPerFrame)
+{
+	HeadlessWindow wnd(800, 600, "WindowEvents");
+	int64_t postNs = 0, pumpNs = 0;
+	size_t keyEvents = 0u, mouseEvents = 0u;
+	ChiliTimer timer;
+	for (size_t posted = 0u; posted < events; )
+	{
+		// a frame's worth of input: a key going down and up, the rest pointer moves with a click
+		timer.Mark();
+		const unsigned int batch = unsigned(std::min<size_t>(eventsPerFrame, events - posted));
+		for (unsigned int i = 0; i < batch; i++)
+		{
+			const size_t n = posted + i;
+			switch (n % 8u)
+			{
+			case 0u:
+				wnd.PostKeyDown((unsigned char)('A' + n % 26u));
+				break;
+			case 4u:
+				wnd.PostKeyUp((unsigned char)('A' + (n - 4u) % 26u));
+				break;
+			case 6u:
+				wnd.PostLeftDown(int(n % 800u), int(n % 600u));
+				break;
+			case 7u:
+				wnd.PostLeftUp(int(n % 800u), int(n % 600u));
+				break;
+			default:
+				wnd.PostMouseMove(int(n % 800u), int(n % 600u));
+				break;
+			}
+		}
+		postNs += timer.MarkNs();
+		wnd.ProcessMessages();
+		pumpNs += timer.MarkNs();
+		// the app side drains its queues every frame
+		while (wnd.kbd.ReadKey().IsValid())
+		{
+			keyEvents++;
+		}
+		while (!wnd.mouse.IsEmpty())
+		{
+			wnd.mouse.Read();
+			mouseEvents++;
+		}
+		posted += batch;
+	}
+	const double n = double(std::max<size_t>(events, 1u));
+	out << "[WindowEvents] events=" << events
+		<< " per_frame=" << eventsPerFrame
+		<< " post_ns=" << double(postNs) / n
+		<< " pump_ns=" << double(pumpNs) / n
+		<< " key_events=" << keyEvents
+		<< " mouse_events=" << mouseEvents << std::endl;
+}
+
+void Benchmarks::RunAll(std::ostream& out)
+{
+	RenderQueueSort(out);
+	MeshOptimize(out);
+	VertexQuantize(out);
+	FrustumCull(out);
+	OcclusionCull(out);
+	JobScaling(out);
+	FrameSchedule(out);
+	RenderThreadOverlap(out);
+	FramePacing(out);
+	FixedStep(out);
+	ClockRead(out);
+	ProfilerOverhead(out);
+	FrameTimePercentiles(out);
+	MetricsPublish(out);
+	StressScaling(out);
+	NullSubmission(out);
+	WindowEvents(out);
+}
\ No newline at end of file
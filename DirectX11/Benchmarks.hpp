@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+// self-contained CPU micro benchmarks, each one prints its own result lines
+namespace Benchmarks
+{
+	// radix sort of random 64 bit draw keys against std::sort on the same data
+	void RenderQueueSort(std::ostream& out, size_t count = 1000000u);
+	// import pipeline on an unwelded, shuffled sphere: ACMR / ATVR before and after plus the time taken
+	void MeshOptimize(std::ostream& out, unsigned int rings = 256u);
+	// encode throughput of every supported kernel, size reduction and round-trip error of the compact formats
+	void VertexQuantize(std::ostream& out, size_t count = 1000000u);
+	// spheres and boxes scattered around a camera: scalar vs avx2 kernels, one thread vs all of them
+	void FrustumCull(std::ostream& out, size_t count = 1000000u);
+	// camera flying down a street of occluder walls with boxes behind them: culled percentage,
+	// occluder raster time and box test time for every frame
+	void OcclusionCull(std::ostream& out, size_t count = 100000u, unsigned int frames = 8u);
+	// job system at 1..maxThreads threads (0 = every hardware thread): parallel_for transform
+	// update time and speedup over one thread, plus empty job throughput
+	void JobScaling(std::ostream& out, unsigned int maxThreads = 0u);
+	// headless frame of the same shape as App's frame graph (simulate > cull > build draws > submit),
+	// per task timings of the last frame and the mean frame / critical path time
+	void FrameSchedule(std::ostream& out, size_t count = 200000u, unsigned int frames = 30u);
+	// simulation and submission of simMs / renderMs of busy work each: one thread doing both
+	// against the render thread pipeline, whose frame time should approach the larger of the two
+	void RenderThreadOverlap(std::ostream& out, unsigned int frames = 120u, float simMs = 4.0f, float renderMs = 4.0f);
+	// target fps pacing error: plain sleeps against the hybrid sleep+spin pacer on a simulated clock
+	// with 1ms sleep granularity (deterministic), then the pacer on the system clock
+	void FramePacing(std::ostream& out, unsigned int frames = 240u, float targetFps = 144.0f);
+	// fixed 120Hz simulation under render rates from 1000 to 20 fps plus jittered and stalling frames:
+	// steps per second and simulated time stay put whatever the frame rate, stalls drop time instead
+	void FixedStep(std::ostream& out, float seconds = 10.0f);
+	// cost of one clock read: steady_clock against HighPrecisionClock (TSC path when available),
+	// ChiliTimer and EngineClock, plus how coarse float seconds get after hours of uptime
+	void ClockRead(std::ostream& out, size_t reads = 10000000u);
+	// cost of one profiler zone on a loop of trivial work (with and without the zone) on one and on
+	// several threads, then the size and time of a Chrome trace export of everything recorded
+	void ProfilerOverhead(std::ostream& out, size_t zones = 1000000u, unsigned int threads = 4u);
+	// synthetic 60 fps frame times with rare stutters through FrameTelemetry: percentiles against an
+	// exact sort of the same samples, the worst frames found and the cost of one Record
+	void FrameTimePercentiles(std::ostream& out, size_t frames = 1000000u);
+	// MetricsServer::Publish from a frame loop while the server thread formats and streams lines
+	// every millisecond: mean and worst publish time, which must stay flat whatever the socket does
+	void MetricsPublish(std::ostream& out, size_t frames = 200000u);
+	// StressScene at 1k, 10k, 100k and 1M cubes through the steps of a frame: animating the transforms,
+	// frustum culling, building and sorting draw keys and software submission of what is visible;
+	// ms per frame and ns per cube of each step, so the point where one stops scaling stands out
+	void StressScaling(std::ostream& out, size_t maxCount = 1000000u, unsigned int frames = 3u);
+	// Graphics' submission path on NullGraphics: plain, under a RecordingRenderContext, and the
+	// recorded calls replayed into the null context; reports the recording size per frame and per call
+	void NullSubmission(std::ostream& out, size_t count = 100000u, unsigned int frames = 10u);
+	// HeadlessWindow event pump: posting and delivering keyboard / mouse events in per frame batches
+	// into Keyboard and Mouse, the cost the message pump adds to a frame without the OS part
+	void WindowEvents(std::ostream& out, size_t events = 1000000u, unsigned int eventsPerFrame = 64u);
+	void RunAll(std::ostream& out);
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include <cmath>
+
+constexpr float PI = 3.14159265f;
+
+// small float vector / matrix types for code that has to run without DirectXMath (headless builds)
+// conventions match DirectXMath: row vectors, v * M, left handed projections
+struct Float2
+{
+	float x;
+	float y;
+};
+
+struct Float3
+{
+	float x;
+	float y;
+	float z;
+};
+
+struct Float4
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+inline float Dot(const Float3& a, const Float3& b) noexcept
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Float3 Cross(const Float3& a, const Float3& b) noexcept
+{
+	return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline Float3 Normalize(const Float3& v) noexcept
+{
+	const float len = std::sqrt(Dot(v, v));
+	return len > 0.0f ? Float3{ v.x / len, v.y / len, v.z / len } : v;
+}
+
+struct Matrix4
+{
+	float m[4][4];
+
+	static Matrix4 Identity() noexcept
+	{
+		return { {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f }
+		} };
+	}
+	static Matrix4 RotationX(float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f,    c,    s, 0.0f },
+			{ 0.0f,   -s,    c, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f }
+		} };
+	}
+	static Matrix4 RotationY(float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { {
+			{    c, 0.0f,   -s, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{    s, 0.0f,    c, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f }
+		} };
+	}
+	static Matrix4 RotationZ(float angle) noexcept
+	{
+		const float s = std::sin(angle);
+		const float c = std::cos(angle);
+		return { {
+			{    c,    s, 0.0f, 0.0f },
+			{   -s,    c, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f }
+		} };
+	}
+	static Matrix4 Translation(float x, float y, float z) noexcept
+	{
+		Matrix4 r = Identity();
+		r.m[3][0] = x;
+		r.m[3][1] = y;
+		r.m[3][2] = z;
+		return r;
+	}
+	static Matrix4 Scaling(float x, float y, float z) noexcept
+	{
+		Matrix4 r = Identity();
+		r.m[0][0] = x;
+		r.m[1][1] = y;
+		r.m[2][2] = z;
+		return r;
+	}
+	static Matrix4 LookAtLH(const Float3& eye, const Float3& focus, const Float3& up) noexcept
+	{
+		const Float3 zAxis = Normalize({ focus.x - eye.x, focus.y - eye.y, focus.z - eye.z });
+		const Float3 xAxis = Normalize(Cross(up, zAxis));
+		const Float3 yAxis = Cross(zAxis, xAxis);
+		return { {
+			{ xAxis.x, yAxis.x, zAxis.x, 0.0f },
+			{ xAxis.y, yAxis.y, zAxis.y, 0.0f },
+			{ xAxis.z, yAxis.z, zAxis.z, 0.0f },
+			{ -Dot(xAxis, eye), -Dot(yAxis, eye), -Dot(zAxis, eye), 1.0f }
+		} };
+	}
+	static Matrix4 PerspectiveLH(float viewWidth, float viewHeight, float nearZ, float farZ) noexcept
+	{
+		const float range = farZ / (farZ - nearZ);
+		return { {
+			{ 2.0f * nearZ / viewWidth, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 2.0f * nearZ / viewHeight, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, range, 1.0f },
+			{ 0.0f, 0.0f, -range * nearZ, 0.0f }
+		} };
+	}
+	static Matrix4 PerspectiveFovLH(float fovAngleY, float aspect, float nearZ, float farZ) noexcept
+	{
+		const float yScale = 1.0f / std::tan(fovAngleY * 0.5f);
+		const float range = farZ / (farZ - nearZ);
+		return { {
+			{ yScale / aspect, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, yScale, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, range, 1.0f },
+			{ 0.0f, 0.0f, -range * nearZ, 0.0f }
+		} };
+	}
+	Matrix4 operator*(const Matrix4& rhs) const noexcept
+	{
+		Matrix4 r;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				r.m[i][j] = m[i][0] * rhs.m[0][j] + m[i][1] * rhs.m[1][j] + m[i][2] * rhs.m[2][j] + m[i][3] * rhs.m[3][j];
+			}
+		}
+		return r;
+	}
+	Float4 Transform(const Float4& v) const noexcept
+	{
+		return {
+			v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + v.w * m[3][0],
+			v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + v.w * m[3][1],
+			v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + v.w * m[3][2],
+			v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + v.w * m[3][3]
+		};
+	}
+	Float4 TransformPoint(const Float3& p) const noexcept
+	{
+		return Transform({ p.x, p.y, p.z, 1.0f });
+	}
+};
\ No newline at end of file
@@ -1,21 +1,29 @@
 #include "ChiliTimer.hpp"
-
-using namespace std::chrono;
+#include "Clock.hpp"
 
 ChiliTimer::ChiliTimer() noexcept
 {
-	last = steady_clock::now();
+	last = HighPrecisionClock::Now();
 }
 
 float ChiliTimer::Mark() noexcept
 {
-	const auto old = last;
-	last = steady_clock::now();
-	const duration<float> frameTime = last - old;
-	return frameTime.count();
+	return float(MarkNs()) * 1e-9f;
 }
 
 float ChiliTimer::Peek() const noexcept
 {
-	return duration<float>(steady_clock::now() - last).count();
+	return float(PeekNs()) * 1e-9f;
+}
+
+int64_t ChiliTimer::MarkNs() noexcept
+{
+	const int64_t old = last;
+	last = HighPrecisionClock::Now();
+	return last - old;
 }
+
+int64_t ChiliTimer::PeekNs() const noexcept
+{
+	return HighPrecisionClock::Now() - last;
+}
\ No newline at end of file
@@ -1,12 +1,16 @@
 #pragma once
-#include <chrono>
+#include <cstdint>
 
+// interval timer on HighPrecisionClock; intervals come back as float seconds, the
+// timestamps stay int64 nanoseconds so long uptimes do not eat into the resolution
 class ChiliTimer
 {
 public:
 	ChiliTimer() noexcept;
 	float Mark() noexcept;
 	float Peek() const noexcept;
+	int64_t MarkNs() noexcept;
+	int64_t PeekNs() const noexcept;
 private:
-	std::chrono::steady_clock::time_point last;
+	int64_t last;
 };
\ No newline at end of file
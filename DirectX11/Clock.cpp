@@ -0,0 +1,191 @@
+#include "Clock.hpp"
+#include "CpuFeatures.hpp"
+#include <chrono>
+#include <thread>
+#ifdef _WIN32
+#include "ChiliWin.hpp"
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+#if defined(CHILI_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(CHILI_X86)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+	int64_t SteadyNow() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	struct Calibration
+	{
+		bool tsc = false;
+		uint64_t tscOrigin = 0u;
+		int64_t steadyOrigin = 0;
+		// nanoseconds per tick in 32.32 fixed point
+		uint64_t scale = 0u;
+		double frequency = 1e9;
+	};
+
+#ifdef CHILI_X86
+	uint64_t ReadTsc() noexcept
+	{
+		return __rdtsc();
+	}
+
+	// (ticks * scale) >> 32 without losing the high bits of the product
+	int64_t ScaleTicks(uint64_t ticks, uint64_t scale) noexcept
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		uint64_t high = 0u;
+		const uint64_t low = _umul128(ticks, scale, &high);
+		return int64_t((high << 32) | (low >> 32));
+#elif defined(__SIZEOF_INT128__)
+		return int64_t((unsigned __int128)ticks * scale >> 32);
+#else
+		// 32 bit targets: schoolbook product of the halves, only the low 64 bits of the result are kept
+		const uint64_t tHigh = ticks >> 32, tLow = ticks & 0xFFFFFFFFu;
+		const uint64_t sHigh = scale >> 32, sLow = scale & 0xFFFFFFFFu;
+		return int64_t((tHigh * sHigh << 32) + tHigh * sLow + tLow * sHigh + (tLow * sLow >> 32));
+#endif
+	}
+#endif
+
+	Calibration Calibrate() noexcept
+	{
+		Calibration c;
+		c.steadyOrigin = SteadyNow();
+#ifdef CHILI_X86
+		if (!CpuFeatures::HasInvariantTsc())
+		{
+			return c;
+		}
+		// each end is bracketed by two counter reads so a preemption between them cannot skew the rate
+		const auto sample = [](int64_t& steady, uint64_t& tsc)
+		{
+			const uint64_t before = ReadTsc();
+			steady = SteadyNow();
+			tsc = before + (ReadTsc() - before) / 2u;
+		};
+		int64_t steady0 = 0, steady1 = 0;
+		uint64_t tsc0 = 0u, tsc1 = 0u;
+		sample(steady0, tsc0);
+		do
+		{
+			sample(steady1, tsc1);
+		} while (steady1 - steady0 < 10000000);
+		c.frequency = double(tsc1 - tsc0) * 1e9 / double(steady1 - steady0);
+		c.scale = uint64_t(1e9 / c.frequency * 4294967296.0);
+		c.tscOrigin = tsc0;
+		c.steadyOrigin = steady0;
+		c.tsc = c.scale != 0u;
+#endif
+		return c;
+	}
+
+	// read on every Now, so a plain global filled in during static initialization rather than a function
+	// local static with its guard check; clocks read by other static initializers before it see steady_clock
+	const Calibration calibration = Calibrate();
+}
+
+int64_t HighPrecisionClock::Now() noexcept
+{
+	return TicksToNanoseconds(Ticks());
+}
+
+int64_t HighPrecisionClock::Ticks() noexcept
+{
+#ifdef CHILI_X86
+	if (calibration.tsc)
+	{
+		return int64_t(ReadTsc());
+	}
+#endif
+	return SteadyNow();
+}
+
+int64_t HighPrecisionClock::TicksToNanoseconds(int64_t ticks) noexcept
+{
+#ifdef CHILI_X86
+	if (calibration.tsc)
+	{
+		const uint64_t t = uint64_t(ticks);
+		return t >= calibration.tscOrigin ?
+			ScaleTicks(t - calibration.tscOrigin, calibration.scale) :
+			-ScaleTicks(calibration.tscOrigin - t, calibration.scale);
+	}
+#endif
+	return ticks - calibration.steadyOrigin;
+}
+
+bool HighPrecisionClock::UsesTsc() noexcept
+{
+	return calibration.tsc;
+}
+
+double HighPrecisionClock::GetFrequency() noexcept
+{
+	return calibration.frequency;
+}
+
+SystemClock::SystemClock() noexcept
+{
+#ifdef _WIN32
+	timeBeginPeriod(1u);
+#endif
+}
+
+SystemClock::~SystemClock()
+{
+#ifdef _WIN32
+	timeEndPeriod(1u);
+#endif
+}
+
+int64_t SystemClock::Now() noexcept
+{
+	return HighPrecisionClock::Now();
+}
+
+void SystemClock::Sleep(int64_t ns) noexcept
+{
+	if (ns > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+	}
+}
+
+SimulatedClock::SimulatedClock(int64_t readCost, int64_t sleepGranularity, int64_t maxJitter) noexcept
+	:
+	readCost(readCost),
+	sleepGranularity(sleepGranularity > 0 ? sleepGranularity : 1),
+	maxJitter(maxJitter)
+{}
+
+int64_t SimulatedClock::Now() noexcept
+{
+	now += readCost;
+	return now;
+}
+
+void SimulatedClock::Sleep(int64_t ns) noexcept
+{
+	if (ns <= 0)
+	{
+		return;
+	}
+	// xorshift keeps the jitter pattern identical from run to run
+	jitterState ^= jitterState << 13;
+	jitterState ^= jitterState >> 17;
+	jitterState ^= jitterState << 5;
+	const int64_t jitter = maxJitter > 0 ? int64_t(jitterState % uint32_t(maxJitter + 1)) : 0;
+	now += (ns + sleepGranularity - 1) / sleepGranularity * sleepGranularity + jitter;
+}
+
+void SimulatedClock::Advance(int64_t ns) noexcept
+{
+	now += ns;
+}
\ No newline at end of file
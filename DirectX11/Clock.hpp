@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+// engine time base, int64 nanoseconds since first use: the invariant TSC scaled by a rate measured
+// once against steady_clock (over ~10ms, good to about 1e-5) when the cpu has one, steady_clock otherwise
+class HighPrecisionClock
+{
+public:
+	static int64_t Now() noexcept;
+	// the raw counter behind Now (TSC ticks, or steady_clock nanoseconds without a TSC), for hot paths
+	// that store timestamps and convert them later
+	static int64_t Ticks() noexcept;
+	static int64_t TicksToNanoseconds(int64_t ticks) noexcept;
+	static bool UsesTsc() noexcept;
+	// ticks per second of the source Now reads
+	static double GetFrequency() noexcept;
+};
+
+// time source for code that waits on time (frame pacing), so it can run against a simulated clock
+class IClock
+{
+public:
+	virtual ~IClock() = default;
+	// monotonic nanoseconds from an arbitrary origin
+	virtual int64_t Now() noexcept = 0;
+	// blocks for about ns, may overshoot by the scheduler granularity
+	virtual void Sleep(int64_t ns) noexcept = 0;
+};
+
+// HighPrecisionClock and the OS sleep; on windows the timer resolution is raised to 1ms while one exists
+class SystemClock : public IClock
+{
+public:
+	SystemClock() noexcept;
+	SystemClock(const SystemClock&) = delete;
+	SystemClock& operator=(const SystemClock&) = delete;
+	~SystemClock();
+	int64_t Now() noexcept override;
+	void Sleep(int64_t ns) noexcept override;
+};
+
+// deterministic clock: time only moves by readCost on every Now and by sleeps, which are rounded up
+// to the next multiple of sleepGranularity and then overshoot by a repeating pattern of jitter
+class SimulatedClock : public IClock
+{
+public:
+	SimulatedClock(int64_t readCost = 20, int64_t sleepGranularity = 1000000, int64_t maxJitter = 500000) noexcept;
+	int64_t Now() noexcept override;
+	void Sleep(int64_t ns) noexcept override;
+	// stands in for work done between two reads
+	void Advance(int64_t ns) noexcept;
+private:
+	int64_t now = 0;
+	int64_t readCost;
+	int64_t sleepGranularity;
+	int64_t maxJitter;
+	uint32_t jitterState = 1u;
+};
\ No newline at end of file
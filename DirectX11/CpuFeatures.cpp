@@ -0,0 +1,81 @@
+#include "CpuFeatures.hpp"
+#if defined(CHILI_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(CHILI_X86)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+	struct Features
+	{
+		bool sse2 = false;
+		bool avx2 = false;
+		bool invariantTsc = false;
+	};
+
+	Features Detect() noexcept
+	{
+		Features f;
+#ifdef CHILI_X86
+#ifdef _MSC_VER
+		int leaf0[4] = {};
+		int leaf1[4] = {};
+		__cpuid(leaf0, 0);
+		__cpuid(leaf1, 1);
+		f.sse2 = (leaf1[3] & (1 << 26)) != 0;
+		if (leaf0[0] >= 7)
+		{
+			int leaf7[4] = {};
+			__cpuidex(leaf7, 7, 0);
+			const bool osxsave = (leaf1[2] & (1 << 27)) != 0;
+			const bool fma = (leaf1[2] & (1 << 12)) != 0;
+			const bool f16c = (leaf1[2] & (1 << 29)) != 0;
+			const bool avx2 = (leaf7[1] & (1 << 5)) != 0;
+			// the os has to save ymm state as well
+			f.avx2 = osxsave && fma && f16c && avx2 && (_xgetbv(0) & 0x6u) == 0x6u;
+		}
+		int extended[4] = {};
+		__cpuid(extended, 0x80000000);
+		if (unsigned(extended[0]) >= 0x80000007u)
+		{
+			int power[4] = {};
+			__cpuid(power, 0x80000007);
+			f.invariantTsc = (power[3] & (1 << 8)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		f.sse2 = __builtin_cpu_supports("sse2");
+		f.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+		unsigned int a = 0u, b = 0u, c = 0u, d = 0u;
+		if (__get_cpuid(0x80000007u, &a, &b, &c, &d))
+		{
+			f.invariantTsc = (d & (1u << 8)) != 0u;
+		}
+#endif
+#endif
+		return f;
+	}
+
+	const Features& Get() noexcept
+	{
+		static const Features features = Detect();
+		return features;
+	}
+}
+
+bool CpuFeatures::HasSse2() noexcept
+{
+	return Get().sse2;
+}
+
+bool CpuFeatures::HasAvx2() noexcept
+{
+	return Get().avx2;
+}
+
+bool CpuFeatures::HasInvariantTsc() noexcept
+{
+	return Get().invariantTsc;
+}
\ No newline at end of file
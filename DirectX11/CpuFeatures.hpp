@@ -0,0 +1,21 @@
+#pragma once
+
+// x86 instruction set detection for the runtime dispatched simd kernels
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CHILI_X86 1
+#ifdef _MSC_VER
+// msvc emits any intrinsic regardless of /arch, the runtime checks guard the avx2 paths
+#define CHILI_TARGET_AVX2
+#else
+#define CHILI_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#endif
+#endif
+
+namespace CpuFeatures
+{
+	bool HasSse2() noexcept;
+	// avx2 together with f16c and os support for the ymm state
+	bool HasAvx2() noexcept;
+	// time stamp counter ticking at a constant rate through power states, in sync across cores
+	bool HasInvariantTsc() noexcept;
+}
\ No newline at end of file
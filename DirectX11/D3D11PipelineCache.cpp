@@ -0,0 +1,123 @@
+#include "D3D11PipelineCache.hpp"
+#include "Graphics.hpp"
+#include <vector>
+
+namespace wrl = Microsoft::WRL;
+
+namespace
+{
+	D3D11_DEPTH_STENCILOP_DESC ToD3D11(const StencilOpDesc& op) noexcept
+	{
+		D3D11_DEPTH_STENCILOP_DESC d3dOp;
+		d3dOp.StencilFailOp = static_cast<D3D11_STENCIL_OP>(op.stencilFailOp);
+		d3dOp.StencilDepthFailOp = static_cast<D3D11_STENCIL_OP>(op.stencilDepthFailOp);
+		d3dOp.StencilPassOp = static_cast<D3D11_STENCIL_OP>(op.stencilPassOp);
+		d3dOp.StencilFunc = static_cast<D3D11_COMPARISON_FUNC>(op.stencilFunc);
+		return d3dOp;
+	}
+}
+
+#define CACHE_THROW_FAILED(hrcall) if( FAILED( hr = (hrcall) ) ) throw Graphics::HrException( __LINE__,__FILE__,hr )
+
+D3D11PipelineCache::D3D11PipelineCache(wrl::ComPtr<ID3D11Device> pDevice)
+	:
+	pDevice(std::move(pDevice))
+{}
+
+std::shared_ptr<const D3D11PipelineCache::Pipeline> D3D11PipelineCache::GetPipeline(const PipelineDesc& desc)
+{
+	return pipelines.GetOrCreate(MakeKey(desc), [&]()
+	{
+		auto pPipeline = std::make_shared<Pipeline>();
+		pPipeline->vertexShader = GetVertexShader(desc.vertexShader);
+		pPipeline->pixelShader = GetPixelShader(desc.pixelShader);
+		pPipeline->inputLayout = GetInputLayout(desc.pInputElements, desc.inputElementCount, desc.vertexShader);
+		pPipeline->depthStencilState = GetDepthStencilState(desc.depthStencil);
+		return std::shared_ptr<const Pipeline>(std::move(pPipeline));
+	});
+}
+
+wrl::ComPtr<ID3D11VertexShader> D3D11PipelineCache::GetVertexShader(const ShaderBytecode& code)
+{
+	return vertexShaders.GetOrCreate(MakeKey(code), [&]()
+	{
+		HRESULT hr;
+		wrl::ComPtr<ID3D11VertexShader> pShader;
+		CACHE_THROW_FAILED(pDevice->CreateVertexShader(code.pData, code.size, nullptr, &pShader));
+		return pShader;
+	});
+}
+
+wrl::ComPtr<ID3D11PixelShader> D3D11PipelineCache::GetPixelShader(const ShaderBytecode& code)
+{
+	return pixelShaders.GetOrCreate(MakeKey(code), [&]()
+	{
+		HRESULT hr;
+		wrl::ComPtr<ID3D11PixelShader> pShader;
+		CACHE_THROW_FAILED(pDevice->CreatePixelShader(code.pData, code.size, nullptr, &pShader));
+		return pShader;
+	});
+}
+
+wrl::ComPtr<ID3D11InputLayout> D3D11PipelineCache::GetInputLayout(const InputElementDesc* pElements, size_t count, const ShaderBytecode& vertexShader)
+{
+	return inputLayouts.GetOrCreate(MakeKey(pElements, count, vertexShader), [&]()
+	{
+		std::vector<D3D11_INPUT_ELEMENT_DESC> ied(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const InputElementDesc& e = pElements[i];
+			ied[i].SemanticName = e.semanticName;
+			ied[i].SemanticIndex = e.semanticIndex;
+			ied[i].Format = static_cast<DXGI_FORMAT>(e.format);
+			ied[i].InputSlot = e.inputSlot;
+			ied[i].AlignedByteOffset = e.alignedByteOffset;
+			ied[i].InputSlotClass = e.perInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+			ied[i].InstanceDataStepRate = e.instanceDataStepRate;
+		}
+		HRESULT hr;
+		wrl::ComPtr<ID3D11InputLayout> pLayout;
+		CACHE_THROW_FAILED(pDevice->CreateInputLayout(ied.data(), UINT(count), vertexShader.pData, vertexShader.size, &pLayout));
+		return pLayout;
+	});
+}
+
+wrl::ComPtr<ID3D11DepthStencilState> D3D11PipelineCache::GetDepthStencilState(const DepthStencilDesc& desc)
+{
+	return depthStencilStates.GetOrCreate(MakeKey(desc), [&]()
+	{
+		D3D11_DEPTH_STENCIL_DESC dsDesc;
+		dsDesc.DepthEnable = desc.depthEnable ? TRUE : FALSE;
+		dsDesc.DepthWriteMask = static_cast<D3D11_DEPTH_WRITE_MASK>(desc.depthWriteMask);
+		dsDesc.DepthFunc = static_cast<D3D11_COMPARISON_FUNC>(desc.depthFunc);
+		dsDesc.StencilEnable = desc.stencilEnable ? TRUE : FALSE;
+		dsDesc.StencilReadMask = desc.stencilReadMask;
+		dsDesc.StencilWriteMask = desc.stencilWriteMask;
+		dsDesc.FrontFace = ToD3D11(desc.frontFace);
+		dsDesc.BackFace = ToD3D11(desc.backFace);
+		HRESULT hr;
+		wrl::ComPtr<ID3D11DepthStencilState> pState;
+		CACHE_THROW_FAILED(pDevice->CreateDepthStencilState(&dsDesc, &pState));
+		return pState;
+	});
+}
+
+D3D11PipelineCache::Stats D3D11PipelineCache::GetStats() const noexcept
+{
+	Stats s;
+	s.pipelines = pipelines.GetStats();
+	s.vertexShaders = vertexShaders.GetStats();
+	s.pixelShaders = pixelShaders.GetStats();
+	s.inputLayouts = inputLayouts.GetStats();
+	s.depthStencilStates = depthStencilStates.GetStats();
+	return s;
+}
+
+void D3D11PipelineCache::Clear() noexcept
+{
+	pipelines.Clear();
+	vertexShaders.Clear();
+	pixelShaders.Clear();
+	inputLayouts.Clear();
+	depthStencilStates.Clear();
+}
\ No newline at end of file
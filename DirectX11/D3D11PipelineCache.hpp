@@ -0,0 +1,46 @@
+#pragma once
+#include "ChiliWin.hpp"
+#include "PipelineCache.hpp"
+#include <d3d11.h>
+#include <wrl.h>
+#include <memory>
+
+// creates D3D11 state objects through hashed descriptor caches, so equal descriptors share one object
+class D3D11PipelineCache
+{
+public:
+	struct Pipeline
+	{
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilState> depthStencilState;
+	};
+	struct Stats
+	{
+		StateCache<std::shared_ptr<const Pipeline>>::Stats pipelines;
+		StateCache<Microsoft::WRL::ComPtr<ID3D11VertexShader>>::Stats vertexShaders;
+		StateCache<Microsoft::WRL::ComPtr<ID3D11PixelShader>>::Stats pixelShaders;
+		StateCache<Microsoft::WRL::ComPtr<ID3D11InputLayout>>::Stats inputLayouts;
+		StateCache<Microsoft::WRL::ComPtr<ID3D11DepthStencilState>>::Stats depthStencilStates;
+	};
+public:
+	D3D11PipelineCache(Microsoft::WRL::ComPtr<ID3D11Device> pDevice);
+	D3D11PipelineCache(const D3D11PipelineCache&) = delete;
+	D3D11PipelineCache& operator=(const D3D11PipelineCache&) = delete;
+	std::shared_ptr<const Pipeline> GetPipeline(const PipelineDesc& desc);
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> GetVertexShader(const ShaderBytecode& code);
+	Microsoft::WRL::ComPtr<ID3D11PixelShader> GetPixelShader(const ShaderBytecode& code);
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> GetInputLayout(const InputElementDesc* pElements, size_t count, const ShaderBytecode& vertexShader);
+	Microsoft::WRL::ComPtr<ID3D11DepthStencilState> GetDepthStencilState(const DepthStencilDesc& desc);
+	Stats GetStats() const noexcept;
+	// drops the cache's references, objects still held by callers stay alive
+	void Clear() noexcept;
+private:
+	Microsoft::WRL::ComPtr<ID3D11Device> pDevice;
+	StateCache<std::shared_ptr<const Pipeline>> pipelines;
+	StateCache<Microsoft::WRL::ComPtr<ID3D11VertexShader>> vertexShaders;
+	StateCache<Microsoft::WRL::ComPtr<ID3D11PixelShader>> pixelShaders;
+	StateCache<Microsoft::WRL::ComPtr<ID3D11InputLayout>> inputLayouts;
+	StateCache<Microsoft::WRL::ComPtr<ID3D11DepthStencilState>> depthStencilStates;
+};
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "D3D11RenderContext.hpp"
+#include "Graphics.hpp"
+
+namespace
+{
+	template<typename T, typename H>
+	T* FromHandle(H handle) noexcept
+	{
+		return reinterpret_cast<T*>(static_cast<uintptr_t>(handle));
+	}
+}
+
+D3D11RenderContext::D3D11RenderContext(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext)
+	:
+	pContext(std::move(pContext))
+{
+	this->pContext.As(&pContext1);
+}
+
+void D3D11RenderContext::IASetPrimitiveTopology(Topology topology)
+{
+	pContext->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(topology));
+}
+
+void D3D11RenderContext::IASetInputLayout(InputLayoutHandle layout)
+{
+	pContext->IASetInputLayout(FromHandle<ID3D11InputLayout>(layout));
+}
+
+void D3D11RenderContext::IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset)
+{
+	ID3D11Buffer* const pBuffer = FromHandle<ID3D11Buffer>(buffer);
+	pContext->IASetVertexBuffers(slot, 1u, &pBuffer, &stride, &offset);
+}
+
+void D3D11RenderContext::IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset)
+{
+	pContext->IASetIndexBuffer(FromHandle<ID3D11Buffer>(buffer), static_cast<DXGI_FORMAT>(format), offset);
+}
+
+void D3D11RenderContext::VSSetShader(VertexShaderHandle shader)
+{
+	pContext->VSSetShader(FromHandle<ID3D11VertexShader>(shader), nullptr, 0u);
+}
+
+void D3D11RenderContext::PSSetShader(PixelShaderHandle shader)
+{
+	pContext->PSSetShader(FromHandle<ID3D11PixelShader>(shader), nullptr, 0u);
+}
+
+void D3D11RenderContext::VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant, unsigned int numConstants)
+{
+	ID3D11Buffer* const pBuffer = FromHandle<ID3D11Buffer>(buffer);
+	if (numConstants != 0u && pContext1)
+	{
+		pContext1->VSSetConstantBuffers1(slot, 1u, &pBuffer, &firstConstant, &numConstants);
+	}
+	else
+	{
+		pContext->VSSetConstantBuffers(slot, 1u, &pBuffer);
+	}
+}
+
+void D3D11RenderContext::OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth)
+{
+	ID3D11RenderTargetView* const pTarget = FromHandle<ID3D11RenderTargetView>(target);
+	pContext->OMSetRenderTargets(pTarget ? 1u : 0u, &pTarget, FromHandle<ID3D11DepthStencilView>(depth));
+}
+
+void D3D11RenderContext::OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef)
+{
+	pContext->OMSetDepthStencilState(FromHandle<ID3D11DepthStencilState>(state), stencilRef);
+}
+
+void* D3D11RenderContext::Map(BufferHandle buffer, MapMode mode)
+{
+	HRESULT hr;
+	D3D11_MAPPED_SUBRESOURCE msr{};
+	if (FAILED(hr = pContext->Map(FromHandle<ID3D11Buffer>(buffer), 0u, static_cast<D3D11_MAP>(mode), 0u, &msr)))
+	{
+		throw Graphics::HrException(__LINE__, __FILE__, hr);
+	}
+	return msr.pData;
+}
+
+void D3D11RenderContext::Unmap(BufferHandle buffer)
+{
+	pContext->Unmap(FromHandle<ID3D11Buffer>(buffer), 0u);
+}
+
+void D3D11RenderContext::ClearRenderTarget(RenderTargetHandle target, const float color[4])
+{
+	pContext->ClearRenderTargetView(FromHandle<ID3D11RenderTargetView>(target), color);
+}
+
+void D3D11RenderContext::ClearDepth(DepthStencilViewHandle depth, float value)
+{
+	pContext->ClearDepthStencilView(FromHandle<ID3D11DepthStencilView>(depth), D3D11_CLEAR_DEPTH, value, 0u);
+}
+
+void D3D11RenderContext::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	pContext->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void D3D11RenderContext::DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+	unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	pContext->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
+}
\ No newline at end of file
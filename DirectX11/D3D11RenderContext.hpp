@@ -0,0 +1,63 @@
+#pragma once
+#include "ChiliWin.hpp"
+#include "RenderContext.hpp"
+#include <d3d11_1.h>
+#include <wrl.h>
+
+// IRenderContext backed by the immediate ID3D11DeviceContext, handles are raw interface pointers
+class D3D11RenderContext : public IRenderContext
+{
+public:
+	D3D11RenderContext(Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext);
+	D3D11RenderContext(const D3D11RenderContext&) = delete;
+	D3D11RenderContext& operator=(const D3D11RenderContext&) = delete;
+	void IASetPrimitiveTopology(Topology topology) override;
+	void IASetInputLayout(InputLayoutHandle layout) override;
+	void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) override;
+	void IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset) override;
+	void VSSetShader(VertexShaderHandle shader) override;
+	void PSSetShader(PixelShaderHandle shader) override;
+	void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant = 0u, unsigned int numConstants = 0u) override;
+	void OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth) override;
+	void OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef) override;
+	void* Map(BufferHandle buffer, MapMode mode) override;
+	void Unmap(BufferHandle buffer) override;
+	void ClearRenderTarget(RenderTargetHandle target, const float color[4]) override;
+	void ClearDepth(DepthStencilViewHandle depth, float value) override;
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) override;
+	void DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+		unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+private:
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext;
+	// only present on the 11.1 runtime, needed for constant buffer ranges
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> pContext1;
+};
+
+inline BufferHandle ToHandle(ID3D11Buffer* p) noexcept
+{
+	return BufferHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline InputLayoutHandle ToHandle(ID3D11InputLayout* p) noexcept
+{
+	return InputLayoutHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline VertexShaderHandle ToHandle(ID3D11VertexShader* p) noexcept
+{
+	return VertexShaderHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline PixelShaderHandle ToHandle(ID3D11PixelShader* p) noexcept
+{
+	return PixelShaderHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline RenderTargetHandle ToHandle(ID3D11RenderTargetView* p) noexcept
+{
+	return RenderTargetHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline DepthStencilViewHandle ToHandle(ID3D11DepthStencilView* p) noexcept
+{
+	return DepthStencilViewHandle(reinterpret_cast<uintptr_t>(p));
+}
+inline DepthStencilStateHandle ToHandle(ID3D11DepthStencilState* p) noexcept
+{
+	return DepthStencilStateHandle(reinterpret_cast<uintptr_t>(p));
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "EngineClock.hpp"
+#include <cmath>
+
+EngineClock::EngineClock(IClock* pSource) noexcept
+	:
+	pSource(pSource),
+	origin(ReadSource())
+{}
+
+void EngineClock::BeginFrame() noexcept
+{
+	const int64_t now = GetWallTime();
+	frameDelta = frameIndex == 0u ? 0 : now - frameTime;
+	frameTime = now;
+	frameIndex++;
+	if (paused)
+	{
+		simulationDelta = 0;
+		return;
+	}
+	const double scaled = double(frameDelta) * timeScale + scaleRemainder;
+	simulationDelta = int64_t(std::floor(scaled));
+	scaleRemainder = scaled - double(simulationDelta);
+	simulationTime += simulationDelta;
+}
+
+int64_t EngineClock::GetWallTime() const noexcept
+{
+	return ReadSource() - origin;
+}
+
+int64_t EngineClock::GetFrameTime() const noexcept
+{
+	return frameTime;
+}
+
+int64_t EngineClock::GetFrameDelta() const noexcept
+{
+	return frameDelta;
+}
+
+int64_t EngineClock::GetSimulationTime() const noexcept
+{
+	return simulationTime;
+}
+
+int64_t EngineClock::GetSimulationDelta() const noexcept
+{
+	return simulationDelta;
+}
+
+uint64_t EngineClock::GetFrameIndex() const noexcept
+{
+	return frameIndex;
+}
+
+void EngineClock::SetPaused(bool pause) noexcept
+{
+	paused = pause;
+}
+
+bool EngineClock::IsPaused() const noexcept
+{
+	return paused;
+}
+
+void EngineClock::SetTimeScale(double scale) noexcept
+{
+	timeScale = scale > 0.0 ? scale : 0.0;
+}
+
+double EngineClock::GetTimeScale() const noexcept
+{
+	return timeScale;
+}
+
+double EngineClock::ToSeconds(int64_t ns) noexcept
+{
+	return double(ns) * 1e-9;
+}
+
+int64_t EngineClock::FromSeconds(double seconds) noexcept
+{
+	return int64_t(std::llround(seconds * 1e9));
+}
+
+int64_t EngineClock::ReadSource() const noexcept
+{
+	return pSource ? pSource->Now() : HighPrecisionClock::Now();
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "Clock.hpp"
+#include <cstdint>
+
+// the engine's clocks, all int64 nanoseconds so hours of uptime keep full resolution:
+// wall time runs from construction and is never paused, frame time is wall time sampled once per
+// frame, simulation time advances by the frame delta times the time scale and stands still while paused
+class EngineClock
+{
+public:
+	// nullptr reads HighPrecisionClock, anything else (a SimulatedClock) makes the clock deterministic
+	explicit EngineClock(IClock* pSource = nullptr) noexcept;
+	// samples the frame time and advances the simulation clock, once at the top of every frame
+	void BeginFrame() noexcept;
+	// read live, not frozen at BeginFrame
+	int64_t GetWallTime() const noexcept;
+	int64_t GetFrameTime() const noexcept;
+	// wall time between the last two BeginFrame calls
+	int64_t GetFrameDelta() const noexcept;
+	int64_t GetSimulationTime() const noexcept;
+	// scaled frame delta, 0 while paused
+	int64_t GetSimulationDelta() const noexcept;
+	uint64_t GetFrameIndex() const noexcept;
+	void SetPaused(bool pause) noexcept;
+	bool IsPaused() const noexcept;
+	// 1 is real time; negative scales are clamped to 0
+	void SetTimeScale(double scale) noexcept;
+	double GetTimeScale() const noexcept;
+	static double ToSeconds(int64_t ns) noexcept;
+	static int64_t FromSeconds(double seconds) noexcept;
+private:
+	int64_t ReadSource() const noexcept;
+private:
+	IClock* pSource;
+	int64_t origin;
+	int64_t frameTime = 0;
+	int64_t frameDelta = 0;
+	int64_t simulationTime = 0;
+	int64_t simulationDelta = 0;
+	// sub nanosecond part of scaled deltas, carried so slow motion does not drift
+	double scaleRemainder = 0.0;
+	double timeScale = 1.0;
+	bool paused = false;
+	uint64_t frameIndex = 0u;
+};
\ No newline at end of file
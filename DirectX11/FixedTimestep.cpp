@@ -0,0 +1,45 @@
+#include "FixedTimestep.hpp"
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(float step, unsigned int maxSteps) noexcept
+	:
+	step(std::max(double(step), 1e-6)),
+	maxSteps(std::max(maxSteps, 1u))
+{}
+
+unsigned int FixedTimestep::Advance(float frameSeconds) noexcept
+{
+	accumulator += std::max(double(frameSeconds), 0.0);
+	unsigned int steps = unsigned(accumulator / step);
+	if (steps > maxSteps)
+	{
+		// keep the fractional part so interpolation stays continuous after the drop
+		const double excess = double(steps - maxSteps) * step;
+		accumulator -= excess;
+		dropped += excess;
+		steps = maxSteps;
+	}
+	accumulator -= double(steps) * step;
+	simulated += double(steps) * step;
+	return steps;
+}
+
+float FixedTimestep::GetAlpha() const noexcept
+{
+	return float(std::min(accumulator / step, 1.0));
+}
+
+float FixedTimestep::GetStep() const noexcept
+{
+	return float(step);
+}
+
+double FixedTimestep::GetSimulatedSeconds() const noexcept
+{
+	return simulated;
+}
+
+double FixedTimestep::GetDroppedSeconds() const noexcept
+{
+	return dropped;
+}
\ No newline at end of file
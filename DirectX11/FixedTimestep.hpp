@@ -0,0 +1,25 @@
+#pragma once
+
+// fixed step accumulator: frame time goes in, a whole number of simulation steps comes out and the
+// remainder becomes the blend factor between the last two simulated states. a frame never runs more
+// than maxSteps steps, time beyond that is dropped so a long stall cannot snowball into longer frames
+class FixedTimestep
+{
+public:
+	explicit FixedTimestep(float step = 1.0f / 120.0f, unsigned int maxSteps = 8u) noexcept;
+	// seconds since the previous frame (ChiliTimer::Mark), returns the steps to simulate this frame
+	unsigned int Advance(float frameSeconds) noexcept;
+	// how far between the previous and the current state the rendered frame is, in [0,1)
+	float GetAlpha() const noexcept;
+	float GetStep() const noexcept;
+	// simulated and dropped time since construction
+	double GetSimulatedSeconds() const noexcept;
+	double GetDroppedSeconds() const noexcept;
+private:
+	double step;
+	unsigned int maxSteps;
+	// double so hours of small frame times do not lose precision
+	double accumulator = 0.0;
+	double simulated = 0.0;
+	double dropped = 0.0;
+};
\ No newline at end of file
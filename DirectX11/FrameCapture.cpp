@@ -0,0 +1,441 @@
+#include "FrameCapture.hpp"
+#include "ChiliTimer.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+#define FRAME_CAPTURE_EXCEPT(note) FrameCapture::Exception( __LINE__,__FILE__,(note) )
+
+namespace
+{
+	// file layout, all integers LEB128 varints after the magic:
+	// magic, version, resource count, per resource { kind byte, handle, size, data size, data },
+	// frame count, per frame { stream size, RecordingRenderContext stream }
+	constexpr char magic[4] = { 'C','F','C','P' };
+	constexpr uint64_t version = 1u;
+
+	using Op = RecordingRenderContext::Op;
+	using ResourceTable = std::unordered_map<uint64_t, const FrameCapture::Resource*>;
+
+	ResourceTable MakeResourceTable(const std::vector<FrameCapture::Resource>& resources)
+	{
+		ResourceTable table;
+		for (const FrameCapture::Resource& r : resources)
+		{
+			table[r.handle] = &r;
+		}
+		return table;
+	}
+
+	// why a frame's calls cannot be replayed against these resources, empty when they can: every
+	// handle has to be null or one of the resources, and every upload has to fit its buffer
+	std::string CheckCalls(const ResourceTable& table, const std::vector<RecordingRenderContext::Call>& calls)
+	{
+		for (const RecordingRenderContext::Call& c : calls)
+		{
+			for (unsigned int a = 0; a < RecordingRenderContext::GetArgCount(c.op); a++)
+			{
+				if (RecordingRenderContext::IsHandleArg(c.op, a) && c.args[a] != 0u && table.count(c.args[a]) == 0u)
+				{
+					std::ostringstream oss;
+					oss << RecordingRenderContext::GetOpName(c.op) << " uses handle 0x" << std::hex << c.args[a]
+						<< " that is not a captured resource";
+					return oss.str();
+				}
+			}
+			if (c.op == Op::UpdateBuffer)
+			{
+				const auto it = table.find(c.args[0]);
+				const FrameCapture::Resource* const pBuffer = it != table.end() ? it->second : nullptr;
+				const uint64_t offset = c.args[2];
+				if (!pBuffer || pBuffer->kind != FrameCapture::ResourceKind::Buffer ||
+					offset > pBuffer->size || c.size > pBuffer->size - offset)
+				{
+					std::ostringstream oss;
+					oss << "UpdateBuffer writes " << c.size << " bytes at " << offset << " of a "
+						<< (pBuffer ? pBuffer->size : 0u) << " byte buffer";
+					return oss.str();
+				}
+			}
+		}
+		return {};
+	}
+}
+
+void FrameCapture::AddResource(BufferHandle buffer, size_t size, const void* pInitialData)
+{
+	Resource r;
+	r.kind = ResourceKind::Buffer;
+	r.handle = uint64_t(buffer);
+	r.size = size;
+	if (pInitialData)
+	{
+		const uint8_t* const p = static_cast<const uint8_t*>(pInitialData);
+		r.data.assign(p, p + size);
+	}
+	resources.push_back(std::move(r));
+}
+
+void FrameCapture::AddResource(InputLayoutHandle layout)
+{
+	AddResource(ResourceKind::InputLayout, uint64_t(layout));
+}
+
+void FrameCapture::AddResource(VertexShaderHandle shader)
+{
+	AddResource(ResourceKind::VertexShader, uint64_t(shader));
+}
+
+void FrameCapture::AddResource(PixelShaderHandle shader)
+{
+	AddResource(ResourceKind::PixelShader, uint64_t(shader));
+}
+
+void FrameCapture::AddResource(RenderTargetHandle target)
+{
+	AddResource(ResourceKind::RenderTarget, uint64_t(target));
+}
+
+void FrameCapture::AddResource(DepthStencilViewHandle depth)
+{
+	AddResource(ResourceKind::DepthStencilView, uint64_t(depth));
+}
+
+void FrameCapture::AddResource(DepthStencilStateHandle state)
+{
+	AddResource(ResourceKind::DepthStencilState, uint64_t(state));
+}
+
+void FrameCapture::AddResource(ResourceKind kind, uint64_t handle)
+{
+	Resource r;
+	r.kind = kind;
+	r.handle = handle;
+	resources.push_back(std::move(r));
+}
+
+void FrameCapture::AddFrame(RecordingRenderContext& recording)
+{
+	const std::vector<uint8_t>& bytes = recording.GetBytes();
+	stream.insert(stream.end(), bytes.begin(), bytes.end());
+	frameEnds.push_back(stream.size());
+	recording.Clear();
+}
+
+void FrameCapture::ClearFrames() noexcept
+{
+	stream.clear();
+	frameEnds.clear();
+}
+
+const std::vector<FrameCapture::Resource>& FrameCapture::GetResources() const noexcept
+{
+	return resources;
+}
+
+size_t FrameCapture::GetFrameCount() const noexcept
+{
+	return frameEnds.size();
+}
+
+std::vector<RecordingRenderContext::Call> FrameCapture::DecodeFrame(size_t i) const
+{
+	const size_t begin = i == 0u ? 0u : frameEnds[i - 1u];
+	std::vector<RecordingRenderContext::Call> calls;
+	RecordingRenderContext::Decode(stream.data() + begin, frameEnds[i] - begin, calls);
+	return calls;
+}
+
+size_t FrameCapture::GetByteSize() const noexcept
+{
+	return stream.size();
+}
+
+bool FrameCapture::Save(const std::string& path) const
+{
+	std::vector<uint8_t> bytes(std::begin(magic), std::end(magic));
+	RecordingRenderContext::PutVarint(bytes, version);
+	RecordingRenderContext::PutVarint(bytes, resources.size());
+	for (const Resource& r : resources)
+	{
+		bytes.push_back(uint8_t(r.kind));
+		RecordingRenderContext::PutVarint(bytes, r.handle);
+		RecordingRenderContext::PutVarint(bytes, r.size);
+		RecordingRenderContext::PutVarint(bytes, r.data.size());
+		bytes.insert(bytes.end(), r.data.begin(), r.data.end());
+	}
+	RecordingRenderContext::PutVarint(bytes, frameEnds.size());
+	size_t begin = 0u;
+	for (const size_t end : frameEnds)
+	{
+		RecordingRenderContext::PutVarint(bytes, end - begin);
+		bytes.insert(bytes.end(), stream.begin() + begin, stream.begin() + end);
+		begin = end;
+	}
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+	return bool(file);
+}
+
+FrameCapture FrameCapture::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw FRAME_CAPTURE_EXCEPT("cannot open " + path);
+	}
+	const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	const uint8_t* p = bytes.data();
+	const uint8_t* const pEnd = p + bytes.size();
+	if (bytes.size() < sizeof(magic) || !std::equal(std::begin(magic), std::end(magic), p))
+	{
+		throw FRAME_CAPTURE_EXCEPT(path + " is not a frame capture");
+	}
+	p += sizeof(magic);
+	const auto get = [&p, pEnd, &path]()
+	{
+		uint64_t value = 0u;
+		if (!RecordingRenderContext::GetVarint(p, pEnd, value))
+		{
+			throw FRAME_CAPTURE_EXCEPT(path + " is truncated");
+		}
+		return value;
+	};
+	const auto getBytes = [&p, pEnd, &path](uint64_t size)
+	{
+		if (size > uint64_t(pEnd - p))
+		{
+			throw FRAME_CAPTURE_EXCEPT(path + " is truncated");
+		}
+		const uint8_t* const pData = p;
+		p += size;
+		return pData;
+	};
+	if (get() != version)
+	{
+		throw FRAME_CAPTURE_EXCEPT(path + " has an unsupported version");
+	}
+
+	FrameCapture capture;
+	const uint64_t resourceCount = get();
+	for (uint64_t i = 0; i < resourceCount; i++)
+	{
+		Resource r;
+		const uint8_t kind = *getBytes(1u);
+		if (kind >= uint8_t(ResourceKind::Count))
+		{
+			throw FRAME_CAPTURE_EXCEPT(path + " has a resource of unknown kind");
+		}
+		r.kind = ResourceKind(kind);
+		r.handle = get();
+		r.size = get();
+		const uint64_t dataSize = get();
+		const uint8_t* const pData = getBytes(dataSize);
+		r.data.assign(pData, pData + dataSize);
+		capture.resources.push_back(std::move(r));
+	}
+	const ResourceTable table = MakeResourceTable(capture.resources);
+	const uint64_t frameCount = get();
+	for (uint64_t i = 0; i < frameCount; i++)
+	{
+		const uint64_t size = get();
+		const uint8_t* const pData = getBytes(size);
+		// frames are decoded once here so a damaged stream fails the load rather than the replay
+		std::vector<RecordingRenderContext::Call> calls;
+		if (!RecordingRenderContext::Decode(pData, size_t(size), calls))
+		{
+			throw FRAME_CAPTURE_EXCEPT(path + " has a damaged frame");
+		}
+		const std::string error = CheckCalls(table, calls);
+		if (!error.empty())
+		{
+			throw FRAME_CAPTURE_EXCEPT(path + " frame " + std::to_string(i) + ": " + error);
+		}
+		capture.stream.insert(capture.stream.end(), pData, pData + size);
+		capture.frameEnds.push_back(capture.stream.size());
+	}
+	return capture;
+}
+
+FrameCapture::ReplayStats FrameCapture::Replay(IRenderContext& target, const ResourceFactory& create, bool timeCalls) const
+{
+	// checked before anything is created on the target
+	const ResourceTable table = MakeResourceTable(resources);
+	std::vector<std::vector<RecordingRenderContext::Call>> frames(GetFrameCount());
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		frames[i] = DecodeFrame(i);
+		const std::string error = CheckCalls(table, frames[i]);
+		if (!error.empty())
+		{
+			throw FRAME_CAPTURE_EXCEPT("frame " + std::to_string(i) + ": " + error);
+		}
+	}
+	std::unordered_map<uint64_t, uint64_t> remap;
+	for (const Resource& r : resources)
+	{
+		remap[r.handle] = create(r);
+	}
+	for (auto& calls : frames)
+	{
+		for (RecordingRenderContext::Call& c : calls)
+		{
+			for (unsigned int a = 0; a < RecordingRenderContext::GetArgCount(c.op); a++)
+			{
+				// null stays null, everything else is in the table
+				if (RecordingRenderContext::IsHandleArg(c.op, a) && c.args[a] != 0u)
+				{
+					c.args[a] = remap[c.args[a]];
+				}
+			}
+		}
+	}
+
+	ReplayStats stats;
+	stats.frameNs.reserve(frames.size());
+	ChiliTimer frameTimer;
+	ChiliTimer callTimer;
+	for (const auto& calls : frames)
+	{
+		frameTimer.Mark();
+		if (timeCalls)
+		{
+			callTimer.Mark();
+			for (const RecordingRenderContext::Call& c : calls)
+			{
+				RecordingRenderContext::Replay(c, target);
+				stats.callNs[size_t(c.op)] += callTimer.MarkNs();
+			}
+		}
+		else
+		{
+			for (const RecordingRenderContext::Call& c : calls)
+			{
+				RecordingRenderContext::Replay(c, target);
+			}
+		}
+		stats.frameNs.push_back(frameTimer.MarkNs());
+		for (const RecordingRenderContext::Call& c : calls)
+		{
+			stats.calls[size_t(c.op)]++;
+		}
+	}
+	return stats;
+}
+
+FrameCapture::ResourceFactory FrameCapture::NullFactory(NullRenderContext& context)
+{
+	return [&context](const Resource& r) -> uint64_t
+	{
+		if (r.kind == ResourceKind::Buffer)
+		{
+			return uint64_t(context.CreateBuffer(size_t(r.size), r.data.empty() ? nullptr : r.data.data()));
+		}
+		// the null context draws every kind of id from one counter
+		return uint64_t(context.CreateHandle<InputLayoutHandle>());
+	};
+}
+
+const char* FrameCapture::GetResourceKindName(ResourceKind kind) noexcept
+{
+	switch (kind)
+	{
+	case ResourceKind::Buffer:
+		return "Buffer";
+	case ResourceKind::InputLayout:
+		return "InputLayout";
+	case ResourceKind::VertexShader:
+		return "VertexShader";
+	case ResourceKind::PixelShader:
+		return "PixelShader";
+	case ResourceKind::RenderTarget:
+		return "RenderTarget";
+	case ResourceKind::DepthStencilView:
+		return "DepthStencilView";
+	case ResourceKind::DepthStencilState:
+		return "DepthStencilState";
+	case ResourceKind::Count:
+		break;
+	}
+	return "Unknown";
+}
+
+
+// frame capture exception stuff
+FrameCapture::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* FrameCapture::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* FrameCapture::Exception::GetType() const noexcept
+{
+	return "Frame Capture Exception";
+}
+
+const std::string& FrameCapture::Exception::GetNote() const noexcept
+{
+	return note;
+}
+
+
+FrameCapturer::FrameCapturer(RecordingRenderContext& recording) noexcept
+	:
+	recording(recording)
+{}
+
+FrameCapture& FrameCapturer::GetCapture() noexcept
+{
+	return capture;
+}
+
+void FrameCapturer::Request(unsigned int frames, std::string path_in)
+{
+	std::lock_guard<std::mutex> lock(requestMutex);
+	requestedFrames = frames;
+	requestedPath = std::move(path_in);
+	requested.store(true, std::memory_order_release);
+}
+
+bool FrameCapturer::EndFrame()
+{
+	if (framesLeft > 0u)
+	{
+		capture.AddFrame(recording);
+		if (--framesLeft == 0u)
+		{
+			recording.SetEnabled(false);
+			savedPath = capture.Save(path) ? path : std::string();
+			capture.ClearFrames();
+		}
+	}
+	// a request starts at a frame boundary, so the first captured frame is complete
+	if (framesLeft == 0u && requested.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		requested.store(false, std::memory_order_relaxed);
+		framesLeft = requestedFrames;
+		path = std::move(requestedPath);
+		recording.Clear();
+		recording.SetEnabled(framesLeft > 0u);
+		return framesLeft > 0u;
+	}
+	return false;
+}
+
+const std::string& FrameCapturer::GetSavedPath() const noexcept
+{
+	return savedPath;
+}
\ No newline at end of file
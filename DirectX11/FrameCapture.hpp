@@ -0,0 +1,130 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "RecordingRenderContext.hpp"
+#include "NullRenderContext.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// a renderer's calls over a run of frames plus the resources they use, saved to a compact binary file
+// and replayed later on any IRenderContext. resources are recorded at creation with their handle, size
+// and (for buffers with initial data) contents; each frame is a RecordingRenderContext stream. on replay
+// every resource gets a counterpart on the target and the handles of the stream are remapped to them
+class FrameCapture
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	enum class ResourceKind : uint8_t
+	{
+		Buffer,
+		InputLayout,
+		VertexShader,
+		PixelShader,
+		RenderTarget,
+		DepthStencilView,
+		DepthStencilState,
+		Count
+	};
+	struct Resource
+	{
+		ResourceKind kind = ResourceKind::Buffer;
+		// the handle as the capturing context knew it
+		uint64_t handle = 0u;
+		// buffer size in bytes, 0 for the other kinds
+		uint64_t size = 0u;
+		// initial contents, empty for dynamic buffers and everything that is not a buffer
+		std::vector<uint8_t> data;
+	};
+	// makes the target's counterpart of a captured resource and returns its handle
+	using ResourceFactory = std::function<uint64_t(const Resource& resource)>;
+	struct ReplayStats
+	{
+		// wall time of every replayed frame
+		std::vector<int64_t> frameNs;
+		// per op calls and, when replayed with timeCalls, their summed time
+		std::array<unsigned long long, size_t(RecordingRenderContext::Op::Count)> calls{};
+		std::array<int64_t, size_t(RecordingRenderContext::Op::Count)> callNs{};
+	};
+public:
+	// creation of the resources a capture may refer to; a frame that uses any other handle than these
+	// and null does not load or replay
+	void AddResource(BufferHandle buffer, size_t size, const void* pInitialData = nullptr);
+	void AddResource(InputLayoutHandle layout);
+	void AddResource(VertexShaderHandle shader);
+	void AddResource(PixelShaderHandle shader);
+	void AddResource(RenderTargetHandle target);
+	void AddResource(DepthStencilViewHandle depth);
+	void AddResource(DepthStencilStateHandle state);
+	// takes the calls recording has made since it was last cleared as the next frame, and clears it
+	void AddFrame(RecordingRenderContext& recording);
+	// drops the frames, keeps the resources
+	void ClearFrames() noexcept;
+	const std::vector<Resource>& GetResources() const noexcept;
+	size_t GetFrameCount() const noexcept;
+	// calls of frame i, pData of UpdateBuffer points into the capture
+	std::vector<RecordingRenderContext::Call> DecodeFrame(size_t i) const;
+	size_t GetByteSize() const noexcept;
+	// false when the file cannot be written
+	bool Save(const std::string& path) const;
+	// throws FrameCapture::Exception on a missing, foreign or truncated file, and on frames that use
+	// unknown handles or upload past the end of a buffer
+	static FrameCapture Load(const std::string& path);
+	// creates the resources through create, then replays every frame in order. the frames are decoded
+	// and remapped before the clock starts, so the times are the target's alone; timeCalls also times
+	// each call, which adds the timer read to every one of them. throws FrameCapture::Exception like Load
+	// on frames that do not fit the resources
+	ReplayStats Replay(IRenderContext& target, const ResourceFactory& create, bool timeCalls = false) const;
+	// counterparts on a NullRenderContext: buffers with the captured size and contents, ids for the rest
+	static ResourceFactory NullFactory(NullRenderContext& context);
+	static const char* GetResourceKindName(ResourceKind kind) noexcept;
+private:
+	void AddResource(ResourceKind kind, uint64_t handle);
+private:
+	std::vector<Resource> resources;
+	// every frame's stream back to back, frameEnds[i] is where frame i stops
+	std::vector<uint8_t> stream;
+	std::vector<size_t> frameEnds;
+};
+
+// runs captures of a renderer on request: the renderer keeps a disabled RecordingRenderContext in its
+// chain and registers its resources with GetCapture(); Request may be called from any thread, EndFrame
+// on the thread that renders, after the last call of every frame
+class FrameCapturer
+{
+public:
+	FrameCapturer(RecordingRenderContext& recording) noexcept;
+	FrameCapturer(const FrameCapturer&) = delete;
+	FrameCapturer& operator=(const FrameCapturer&) = delete;
+	FrameCapture& GetCapture() noexcept;
+	// captures the next frames frames into path, starting with the frame after the current one
+	void Request(unsigned int frames, std::string path_in);
+	// true when a capture starts with the next frame: the caller then invalidates whatever caches state
+	// above the recorder (a StateFilter), so the capture binds everything it draws with
+	bool EndFrame();
+	// where the last finished capture went, empty before the first one or when writing failed
+	const std::string& GetSavedPath() const noexcept;
+private:
+	RecordingRenderContext& recording;
+	FrameCapture capture;
+	std::mutex requestMutex;
+	std::atomic<bool> requested{ false };
+	unsigned int requestedFrames = 0u;
+	std::string requestedPath;
+	// render thread only
+	unsigned int framesLeft = 0u;
+	std::string path;
+	std::string savedPath;
+};
\ No newline at end of file
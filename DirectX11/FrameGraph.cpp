@@ -0,0 +1,351 @@
+#include "FrameGraph.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#define FRAME_GRAPH_EXCEPT(note) FrameGraph::Exception( __LINE__,__FILE__,(note) )
+
+namespace
+{
+	constexpr FrameGraph::TaskId noTask = ~FrameGraph::TaskId(0);
+}
+
+FrameGraph::ResourceId FrameGraph::AddResource(std::string name)
+{
+	resources.push_back(std::move(name));
+	compiled = false;
+	return ResourceId(resources.size() - 1u);
+}
+
+FrameGraph::TaskId FrameGraph::AddTask(std::string name, std::vector<ResourceId> reads, std::vector<ResourceId> writes,
+	std::function<void()> work, Affinity affinity)
+{
+	for (const ResourceId r : reads)
+	{
+		if (r >= resources.size())
+		{
+			throw FRAME_GRAPH_EXCEPT("task " + name + " reads an unknown resource");
+		}
+	}
+	for (const ResourceId r : writes)
+	{
+		if (r >= resources.size())
+		{
+			throw FRAME_GRAPH_EXCEPT("task " + name + " writes an unknown resource");
+		}
+	}
+	const char* const pZoneName = Profiler::Intern(name);
+	tasks.push_back({ std::move(name),pZoneName,std::move(reads),std::move(writes),std::move(work),affinity,{},{} });
+	compiled = false;
+	return TaskId(tasks.size() - 1u);
+}
+
+void FrameGraph::Compile()
+{
+	// per resource: the task that wrote it last and the tasks that read it since
+	std::vector<TaskId> lastWriter(resources.size(), noTask);
+	std::vector<std::vector<TaskId>> readers(resources.size());
+	for (Task& t : tasks)
+	{
+		t.predecessors.clear();
+		t.successors.clear();
+	}
+	const auto link = [this](TaskId from, TaskId to)
+	{
+		auto& predecessors = tasks[to].predecessors;
+		if (from == noTask || from == to || std::find(predecessors.begin(), predecessors.end(), from) != predecessors.end())
+		{
+			return;
+		}
+		predecessors.push_back(from);
+		tasks[from].successors.push_back(to);
+	};
+	for (TaskId id = 0; id < tasks.size(); id++)
+	{
+		const Task& t = tasks[id];
+		for (const ResourceId r : t.reads)
+		{
+			link(lastWriter[r], id);
+			readers[r].push_back(id);
+		}
+		for (const ResourceId r : t.writes)
+		{
+			link(lastWriter[r], id);
+			for (const TaskId reader : readers[r])
+			{
+				link(reader, id);
+			}
+			lastWriter[r] = id;
+			readers[r].clear();
+		}
+	}
+
+	// Kahn's algorithm, ties broken by declaration order
+	std::vector<uint32_t> inDegree(tasks.size());
+	schedule.clear();
+	for (TaskId id = 0; id < tasks.size(); id++)
+	{
+		inDegree[id] = uint32_t(tasks[id].predecessors.size());
+		if (inDegree[id] == 0u)
+		{
+			schedule.push_back(id);
+		}
+	}
+	for (size_t i = 0; i < schedule.size(); i++)
+	{
+		for (const TaskId s : tasks[schedule[i]].successors)
+		{
+			if (--inDegree[s] == 0u)
+			{
+				schedule.push_back(s);
+			}
+		}
+	}
+	if (schedule.size() != tasks.size())
+	{
+		throw FRAME_GRAPH_EXCEPT("dependency cycle");
+	}
+
+	pendingPredecessors = std::make_unique<std::atomic<uint32_t>[]>(tasks.size());
+	timings.assign(tasks.size(), {});
+	pathMs.assign(tasks.size(), 0.0f);
+	pathPrevious.assign(tasks.size(), noTask);
+	criticalPath.clear();
+	criticalPath.reserve(tasks.size());
+	mainReady.clear();
+	mainReady.reserve(tasks.size());
+	compiled = true;
+}
+
+void FrameGraph::Execute(JobSystem& jobs)
+{
+	if (!compiled)
+	{
+		throw FRAME_GRAPH_EXCEPT("Execute before Compile");
+	}
+	pJobs = &jobs;
+	frameStart = Clock::now();
+	for (TaskId id = 0; id < tasks.size(); id++)
+	{
+		pendingPredecessors[id].store(uint32_t(tasks[id].predecessors.size()), std::memory_order_relaxed);
+	}
+	mainReady.clear();
+	failed.store(false, std::memory_order_relaxed);
+	pError = nullptr;
+	tasksLeft.store(uint32_t(tasks.size()), std::memory_order_release);
+	for (const TaskId id : schedule)
+	{
+		if (tasks[id].predecessors.empty())
+		{
+			MakeReady(id);
+		}
+	}
+
+	// this thread owns the main thread tasks and helps with jobs in between
+	size_t mainTaken = 0u;
+	while (tasksLeft.load(std::memory_order_acquire) != 0u)
+	{
+		TaskId next = noTask;
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			if (mainTaken < mainReady.size())
+			{
+				next = mainReady[mainTaken++];
+			}
+		}
+		if (next != noTask)
+		{
+			RunTask(next);
+		}
+		else if (!jobs.RunPendingJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+	// the last job may still be on its way out of RunTask
+	jobs.Wait(frameJobs);
+	frameMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+	FindCriticalPath();
+	if (pError)
+	{
+		std::rethrow_exception(pError);
+	}
+}
+
+void FrameGraph::RunTask(TaskId id)
+{
+	const Task& t = tasks[id];
+	PROFILE_ZONE(t.pZoneName);
+	const Clock::time_point start = Clock::now();
+	if (!failed.load(std::memory_order_relaxed))
+	{
+		try
+		{
+			t.work();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			if (!pError)
+			{
+				pError = std::current_exception();
+			}
+			failed.store(true, std::memory_order_relaxed);
+		}
+	}
+	const Clock::time_point end = Clock::now();
+	TaskTiming& timing = timings[id];
+	timing.startMs = std::chrono::duration<float, std::milli>(start - frameStart).count();
+	timing.durationMs = std::chrono::duration<float, std::milli>(end - start).count();
+	timing.thread = pJobs->GetThreadIndex();
+	for (const TaskId s : t.successors)
+	{
+		if (pendingPredecessors[s].fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+		{
+			MakeReady(s);
+		}
+	}
+	tasksLeft.fetch_sub(1u, std::memory_order_acq_rel);
+}
+
+void FrameGraph::MakeReady(TaskId id)
+{
+	if (tasks[id].affinity == Affinity::MainThread)
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		mainReady.push_back(id);
+		return;
+	}
+	pJobs->Run(frameJobs, [this, id]()
+	{
+		RunTask(id);
+	});
+}
+
+void FrameGraph::FindCriticalPath()
+{
+	// longest path by duration over the dependency DAG, walked in schedule order
+	criticalPath.clear();
+	criticalPathMs = 0.0f;
+	TaskId end = noTask;
+	for (const TaskId id : schedule)
+	{
+		float longest = 0.0f;
+		TaskId previous = noTask;
+		for (const TaskId p : tasks[id].predecessors)
+		{
+			if (previous == noTask || pathMs[p] > longest)
+			{
+				longest = pathMs[p];
+				previous = p;
+			}
+		}
+		pathMs[id] = longest + timings[id].durationMs;
+		pathPrevious[id] = previous;
+		if (end == noTask || pathMs[id] > criticalPathMs)
+		{
+			criticalPathMs = pathMs[id];
+			end = id;
+		}
+	}
+	for (TaskId id = end; id != noTask; id = pathPrevious[id])
+	{
+		criticalPath.push_back(id);
+	}
+	std::reverse(criticalPath.begin(), criticalPath.end());
+}
+
+const std::vector<FrameGraph::TaskId>& FrameGraph::GetSchedule() const noexcept
+{
+	return schedule;
+}
+
+const std::vector<FrameGraph::TaskId>& FrameGraph::GetPredecessors(TaskId task) const noexcept
+{
+	return tasks[task].predecessors;
+}
+
+const std::string& FrameGraph::GetTaskName(TaskId task) const noexcept
+{
+	return tasks[task].name;
+}
+
+const FrameGraph::TaskTiming& FrameGraph::GetTiming(TaskId task) const noexcept
+{
+	return timings[task];
+}
+
+const std::vector<FrameGraph::TaskId>& FrameGraph::GetCriticalPath() const noexcept
+{
+	return criticalPath;
+}
+
+float FrameGraph::GetCriticalPathMs() const noexcept
+{
+	return criticalPathMs;
+}
+
+float FrameGraph::GetFrameMs() const noexcept
+{
+	return frameMs;
+}
+
+void FrameGraph::Report(std::ostream& out) const
+{
+	float workMs = 0.0f;
+	for (const TaskTiming& t : timings)
+	{
+		workMs += t.durationMs;
+	}
+	out << "[FrameGraph] tasks=" << tasks.size()
+		<< " frame_ms=" << frameMs
+		<< " critical_path_ms=" << criticalPathMs
+		<< " work_ms=" << workMs << std::endl;
+	for (const TaskId id : schedule)
+	{
+		const bool critical = std::find(criticalPath.begin(), criticalPath.end(), id) != criticalPath.end();
+		const TaskTiming& t = timings[id];
+		out << (critical ? " * " : "   ") << tasks[id].name
+			<< " thread=" << t.thread
+			<< " start_ms=" << t.startMs
+			<< " ms=" << t.durationMs << std::endl;
+	}
+}
+
+void FrameGraph::ReportCriticalPath(std::ostream& out) const
+{
+	for (size_t i = 0; i < criticalPath.size(); i++)
+	{
+		out << (i ? " > " : "") << tasks[criticalPath[i]].name;
+	}
+	out << " " << criticalPathMs << "ms of " << frameMs << "ms";
+}
+
+
+// FrameGraph exception stuff
+FrameGraph::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* FrameGraph::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* FrameGraph::Exception::GetType() const noexcept
+{
+	return "Frame Graph Exception";
+}
+
+const std::string& FrameGraph::Exception::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// static graph of the CPU tasks of a frame: tasks declare the resources they read and write,
+// Compile derives the dependencies once (in declaration order: read after write, write after
+// read, write after write) and Execute replays the schedule every frame without allocating.
+// tasks run as jobs, main thread tasks (window, device context) on the thread calling Execute.
+// an exception thrown by a task skips the work of every task not started yet and is rethrown by Execute
+class FrameGraph
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	enum class Affinity
+	{
+		Any,
+		MainThread
+	};
+	using ResourceId = uint32_t;
+	using TaskId = uint32_t;
+	// measured by the last Execute, milliseconds from the start of the frame
+	struct TaskTiming
+	{
+		float startMs = 0.0f;
+		float durationMs = 0.0f;
+		int thread = -1;
+	};
+public:
+	ResourceId AddResource(std::string name);
+	TaskId AddTask(std::string name, std::vector<ResourceId> reads, std::vector<ResourceId> writes,
+		std::function<void()> work, Affinity affinity = Affinity::Any);
+	void Compile();
+	// runs every task once, returns when all have finished
+	void Execute(JobSystem& jobs);
+	// topological order the tasks were compiled into
+	const std::vector<TaskId>& GetSchedule() const noexcept;
+	const std::vector<TaskId>& GetPredecessors(TaskId task) const noexcept;
+	const std::string& GetTaskName(TaskId task) const noexcept;
+	const TaskTiming& GetTiming(TaskId task) const noexcept;
+	// longest chain of dependent task durations of the last frame, in execution order;
+	// no amount of extra threads makes the frame shorter than this
+	const std::vector<TaskId>& GetCriticalPath() const noexcept;
+	float GetCriticalPathMs() const noexcept;
+	float GetFrameMs() const noexcept;
+	// per task table of the last frame, critical path tasks marked with '*'
+	void Report(std::ostream& out) const;
+	// "a > b > c 4.2ms of 5.0ms" on one line
+	void ReportCriticalPath(std::ostream& out) const;
+private:
+	struct Task
+	{
+		std::string name;
+		// interned, profiler zones outlive the graph
+		const char* pZoneName;
+		std::vector<ResourceId> reads;
+		std::vector<ResourceId> writes;
+		std::function<void()> work;
+		Affinity affinity;
+		std::vector<TaskId> predecessors;
+		std::vector<TaskId> successors;
+	};
+private:
+	void RunTask(TaskId task);
+	void MakeReady(TaskId task);
+	void FindCriticalPath();
+private:
+	using Clock = std::chrono::steady_clock;
+	std::vector<std::string> resources;
+	std::vector<Task> tasks;
+	std::vector<TaskId> schedule;
+	bool compiled = false;
+	// per frame state, sized by Compile
+	std::unique_ptr<std::atomic<uint32_t>[]> pendingPredecessors;
+	std::vector<TaskTiming> timings;
+	std::vector<float> pathMs;
+	std::vector<TaskId> pathPrevious;
+	std::vector<TaskId> criticalPath;
+	float criticalPathMs = 0.0f;
+	float frameMs = 0.0f;
+	JobSystem* pJobs = nullptr;
+	JobCounter frameJobs;
+	std::atomic<uint32_t> tasksLeft{ 0u };
+	std::atomic<bool> failed{ false };
+	std::exception_ptr pError;
+	std::mutex stateMutex;
+	// main thread tasks that became ready, reserved to the task count so pushing never allocates
+	std::vector<TaskId> mainReady;
+	Clock::time_point frameStart;
+};
\ No newline at end of file
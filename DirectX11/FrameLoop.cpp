@@ -0,0 +1,157 @@
+#include "FrameLoop.hpp"
+#include "PlatformWindow.hpp"
+#include "Profiler.hpp"
+#include <cmath>
+
+namespace
+{
+	constexpr float twoPi = 6.28318530718f;
+
+	float WrapAngle(float angle) noexcept
+	{
+		return angle - twoPi * std::floor(angle / twoPi);
+	}
+
+	// takes the short way round, so a step that wrapped past 2pi still blends forward
+	float BlendAngle(float a, float b, float alpha) noexcept
+	{
+		float delta = b - a;
+		if (delta > twoPi / 2.0f)
+		{
+			delta -= twoPi;
+		}
+		else if (delta < -twoPi / 2.0f)
+		{
+			delta += twoPi;
+		}
+		return a + delta * alpha;
+	}
+}
+
+FrameLoop::FrameLoop(IFrameRenderer& renderer, JobSystem& jobs, InputSource readInput)
+	:
+	jobs(jobs),
+	readInput(std::move(readInput)),
+	renderThread(renderer, &jobs)
+{
+	BuildFrameGraph();
+}
+
+void FrameLoop::DoFrame()
+{
+	// blocks only while the render thread is still two frames behind
+	pScene = &renderThread.BeginFrame();
+	clock.BeginFrame();
+	stepsThisFrame = timestep.Advance(float(EngineClock::ToSeconds(clock.GetSimulationDelta())));
+	frameGraph.Execute(jobs);
+}
+
+void FrameLoop::Flush()
+{
+	renderThread.Flush();
+}
+
+EngineClock& FrameLoop::GetClock() noexcept
+{
+	return clock;
+}
+
+const FrameGraph& FrameLoop::GetFrameGraph() const noexcept
+{
+	return frameGraph;
+}
+
+RenderThread::Stats FrameLoop::GetRenderStats() const noexcept
+{
+	return renderThread.GetStats();
+}
+
+void FrameLoop::SetStressScene(const StressScene* pStress_in) noexcept
+{
+	pStress = pStress_in;
+}
+
+void FrameLoop::DrawTestTriangle(FrameSnapshot& scene, float x, float y, float theta, float theta2)
+{
+	PROFILE_ZONE("DrawTestTriangle");
+	// 1
+	scene.QueueCube(
+		Matrix4::RotationZ(theta) *
+		Matrix4::Translation(x, y, 0.0f),
+		true
+	);
+
+	// 2
+	scene.QueueCube(
+		Matrix4::RotationZ(theta2) *
+		Matrix4::RotationX(theta2) *
+		Matrix4::Scaling(0.1f, 0.1f, 0.1f) *
+		Matrix4::Translation(0.0f, 0.0f, 6.0f)
+	);
+}
+
+void FrameLoop::ReadControls(const PlatformWindow& wnd, FrameInput& input) noexcept
+{
+	input.moveX = (wnd.kbd.KeyIsPressed('A') ? 1.0f : 0.0f) - (wnd.kbd.KeyIsPressed('D') ? 1.0f : 0.0f);
+	input.moveZ = (wnd.kbd.KeyIsPressed('W') ? 1.0f : 0.0f) - (wnd.kbd.KeyIsPressed('S') ? 1.0f : 0.0f);
+	input.pointerX = ((float)wnd.mouse.GetPosX() / (wnd.GetWidth() / 2)) - 1;
+	input.pointerY = -((float)wnd.mouse.GetPosY() / (wnd.GetHeight() / 2)) + 1;
+}
+
+void FrameLoop::BuildFrameGraph()
+{
+	using Affinity = FrameGraph::Affinity;
+	const auto controls = frameGraph.AddResource("controls");
+	const auto pointer = frameGraph.AddResource("pointer");
+	const auto camera = frameGraph.AddResource("camera");
+	const auto scene = frameGraph.AddResource("scene");
+
+	// input devices belong to the thread running the frame loop
+	frameGraph.AddTask("input", {}, { controls,pointer }, [this]()
+	{
+		readInput(input);
+	}, Affinity::MainThread);
+	// whole fixed steps first, then the frame is built from a blend of the last two states
+	frameGraph.AddTask("simulate", { controls,pointer }, { camera,scene }, [this]()
+	{
+		for (unsigned int i = 0; i < stepsThisFrame; i++)
+		{
+			Step(timestep.GetStep());
+		}
+		const float alpha = timestep.GetAlpha();
+		const auto blend = [alpha](float a, float b)
+		{
+			return a + (b - a) * alpha;
+		};
+		cameraX = blend(previousState.cameraX, currentState.cameraX);
+		cameraZ = blend(previousState.cameraZ, currentState.cameraZ);
+		if (pStress)
+		{
+			const int64_t time = previousState.time + int64_t(double(currentState.time - previousState.time) * alpha);
+			pStress->Build(*pScene, EngineClock::ToSeconds(time), jobs);
+			return;
+		}
+		DrawTestTriangle(*pScene, input.pointerX, input.pointerY,
+			BlendAngle(previousState.theta, currentState.theta, alpha),
+			BlendAngle(previousState.theta2, currentState.theta2, alpha));
+	});
+	// the command ring has a single producer, so the hand off stays on this thread
+	frameGraph.AddTask("submit", { camera,scene }, {}, [this]()
+	{
+		const float c = static_cast<float>(sin(EngineClock::ToSeconds(clock.GetFrameTime())) / 2.0f + 0.5f);
+		renderThread.SetCamera(cameraX, cameraY, cameraZ);
+		renderThread.ClearBuffer(c, c, 1.0f);
+		renderThread.EndFrame();
+	}, Affinity::MainThread);
+	frameGraph.Compile();
+}
+
+void FrameLoop::Step(float dt) noexcept
+{
+	previousState = currentState;
+	currentState.cameraX += input.moveX * cameraSpeed * dt;
+	currentState.cameraZ += input.moveZ * cameraSpeed * dt;
+	currentState.theta = WrapAngle(currentState.theta + spinRate * dt);
+	currentState.theta2 = WrapAngle(currentState.theta2 + spinRate2 * dt);
+	currentState.time += EngineClock::FromSeconds(dt);
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "EngineClock.hpp"
+#include "FixedTimestep.hpp"
+#include "FrameGraph.hpp"
+#include "RenderThread.hpp"
+#include "StressScene.hpp"
+#include <functional>
+
+class PlatformWindow;
+
+// controls of one frame, filled by whoever owns the input devices
+struct FrameInput
+{
+	// camera keys held this frame, -1..1 per axis
+	float moveX = 0.0f;
+	float moveZ = 0.0f;
+	// pointer position in normalized device coordinates
+	float pointerX = 0.0f;
+	float pointerY = 0.0f;
+};
+
+// the platform free part of the frame: input > simulate > submit as a frame graph, a fixed step
+// simulation rendered as a blend of its last two states, culling and presenting on a render thread.
+// App runs it against the Win32 window and Graphics, the headless benchmark against a HeadlessWindow
+// fed by a script and SoftwareGraphics
+class FrameLoop
+{
+public:
+	// called from the input task on the thread running DoFrame, once per frame
+	using InputSource = std::function<void(FrameInput& input)>;
+public:
+	FrameLoop(IFrameRenderer& renderer, JobSystem& jobs, InputSource readInput);
+	FrameLoop(const FrameLoop&) = delete;
+	FrameLoop& operator=(const FrameLoop&) = delete;
+	void DoFrame();
+	// blocks until every frame so far is presented
+	void Flush();
+	EngineClock& GetClock() noexcept;
+	const FrameGraph& GetFrameGraph() const noexcept;
+	RenderThread::Stats GetRenderStats() const noexcept;
+	// draws pStress in place of the test scene, nullptr goes back to it; the scene has to outlive the
+	// loop or the next SetStressScene, set it between frames from the thread that calls DoFrame
+	void SetStressScene(const StressScene* pStress) noexcept;
+	// the test scene, a cube following the pointer and a small spinning one behind it; touches nothing
+	// but the snapshot, the spin angles come from the simulation so they advance with time rather than frames
+	static void DrawTestTriangle(FrameSnapshot& scene, float x, float y, float theta, float theta2);
+	// camera controls from a window's keyboard and mouse: A/D and W/S move, the pointer position
+	// maps onto the client area, (-1,1) top left to (1,-1) bottom right
+	static void ReadControls(const PlatformWindow& wnd, FrameInput& input) noexcept;
+private:
+	void BuildFrameGraph();
+	// one fixed simulation step of dt seconds
+	void Step(float dt) noexcept;
+private:
+	// everything the fixed step advances; frames render a blend of the last two states
+	struct SimState
+	{
+		float cameraX = 0.0f;
+		float cameraZ = -5.0f;
+		// kept in [0,2pi) so a long run does not eat the float's precision
+		float theta = 0.0f;
+		float theta2 = 0.0f;
+		// simulated nanoseconds, animates the stress scene
+		int64_t time = 0;
+	};
+	// rates per second, about what the old per frame increments gave at a few thousand frames per second
+	static constexpr float cameraSpeed = 1.0f;
+	static constexpr float spinRate = 1.0f;
+	static constexpr float spinRate2 = 1.3f;
+private:
+	JobSystem& jobs;
+	InputSource readInput;
+	EngineClock clock;
+	FrameGraph frameGraph;
+	FixedTimestep timestep;
+	unsigned int stepsThisFrame = 0u;
+	SimState previousState;
+	SimState currentState;
+	FrameInput input;
+	// interpolated camera of the frame being built, the render thread gets a copy every frame
+	float cameraX = 0.0f;
+	float cameraY = 0.0f;
+	float cameraZ = -5.0f;
+	// snapshot being filled by the current frame
+	FrameSnapshot* pScene = nullptr;
+	const StressScene* pStress = nullptr;
+	RenderThread renderThread;
+};
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+#include <cmath>
+
+FramePacer::FramePacer(IClock& clock, Mode mode, float targetFps) noexcept
+	:
+	clock(clock),
+	mode(mode),
+	targetFps(targetFps)
+{}
+
+void FramePacer::SetMode(Mode newMode) noexcept
+{
+	mode.store(newMode);
+}
+
+FramePacer::Mode FramePacer::GetMode() const noexcept
+{
+	return mode.load();
+}
+
+void FramePacer::SetTargetFps(float fps) noexcept
+{
+	targetFps.store(std::max(fps, 1.0f));
+}
+
+float FramePacer::GetTargetFps() const noexcept
+{
+	return targetFps.load();
+}
+
+void FramePacer::SetRefreshRate(float hz) noexcept
+{
+	refreshRate.store(std::max(hz, 1.0f));
+}
+
+void FramePacer::WaitForDeadline() noexcept
+{
+	if (mode.load() != Mode::TargetFps)
+	{
+		deadline = 0;
+		return;
+	}
+	const int64_t period = GetTargetPeriod(Mode::TargetFps);
+	int64_t now = clock.Now();
+	// deadlines follow each other a period apart so the error of one frame does not carry into the next,
+	// a frame that missed its deadline by more than a period starts the cadence over
+	deadline = deadline == 0 ? now : deadline + period;
+	if (now - deadline > period)
+	{
+		deadline = now;
+	}
+	while (deadline - now > sleepMargin)
+	{
+		const int64_t request = deadline - now - sleepMargin;
+		clock.Sleep(request);
+		const int64_t woke = clock.Now();
+		// envelope of the overshoot: jumps to a worse one at once, decays over ~1000 sleeps when they get better
+		const int64_t overshoot = woke - now - request;
+		sleepMargin = std::max({ overshoot,sleepMargin - sleepMargin / 1024,int64_t(50000) });
+		now = woke;
+	}
+	while (now < deadline)
+	{
+		now = clock.Now();
+	}
+}
+
+void FramePacer::MarkPresented() noexcept
+{
+	const int64_t now = clock.Now();
+	const int64_t interval = lastPresent == 0 ? 0 : now - lastPresent;
+	lastPresent = now;
+	if (interval == 0)
+	{
+		return;
+	}
+	const Mode current = mode.load();
+	const int64_t target = GetTargetPeriod(current);
+	const float errorMs = target ? float(interval - target) * 1e-6f : 0.0f;
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.mode = current;
+	stats.targetMs = float(target) * 1e-6f;
+	stats.intervalMs = float(interval) * 1e-6f;
+	stats.errorMs = errorMs;
+	stats.frames++;
+	absErrorSum += std::abs(errorMs);
+	stats.meanAbsErrorMs = float(absErrorSum / double(stats.frames));
+	if (std::abs(errorMs) > std::abs(stats.worstErrorMs))
+	{
+		stats.worstErrorMs = errorMs;
+	}
+}
+
+unsigned int FramePacer::GetSyncInterval() const noexcept
+{
+	const Mode current = mode.load();
+	return current == Mode::VSync || current == Mode::LowLatency ? 1u : 0u;
+}
+
+FramePacer::Stats FramePacer::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+void FramePacer::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.meanAbsErrorMs = 0.0f;
+	stats.worstErrorMs = 0.0f;
+	stats.frames = 0u;
+	absErrorSum = 0.0;
+}
+
+const char* FramePacer::GetModeName(Mode mode) noexcept
+{
+	switch (mode)
+	{
+	case Mode::Uncapped:
+		return "uncapped";
+	case Mode::TargetFps:
+		return "target fps";
+	case Mode::VSync:
+		return "vsync";
+	case Mode::LowLatency:
+		return "low latency";
+	}
+	return "?";
+}
+
+int64_t FramePacer::GetTargetPeriod(Mode current) const noexcept
+{
+	switch (current)
+	{
+	case Mode::TargetFps:
+		return int64_t(1e9 / double(targetFps.load()));
+	case Mode::VSync:
+	case Mode::LowLatency:
+		return int64_t(1e9 / double(refreshRate.load()));
+	default:
+		return 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "Clock.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// decides when a frame may be presented and measures how well that worked out.
+// control (mode, target) may change from any thread at any time, the frame calls
+// (WaitForDeadline, MarkPresented) belong to the thread that presents
+class FramePacer
+{
+public:
+	enum class Mode
+	{
+		// present immediately, tearing allowed
+		Uncapped,
+		// sleep then spin up to a fixed frame period, tearing allowed
+		TargetFps,
+		// present on the vertical blank
+		VSync,
+		// vsync with a single frame of queued latency, the presenter waits for the swap chain
+		LowLatency
+	};
+	// milliseconds; the error is the presented interval minus the target, 0 target when uncapped
+	struct Stats
+	{
+		Mode mode = Mode::Uncapped;
+		float targetMs = 0.0f;
+		float intervalMs = 0.0f;
+		float errorMs = 0.0f;
+		// since the last ResetStats
+		float meanAbsErrorMs = 0.0f;
+		float worstErrorMs = 0.0f;
+		unsigned long long frames = 0u;
+	};
+public:
+	explicit FramePacer(IClock& clock, Mode mode = Mode::Uncapped, float targetFps = 60.0f) noexcept;
+	void SetMode(Mode mode) noexcept;
+	Mode GetMode() const noexcept;
+	void SetTargetFps(float fps) noexcept;
+	float GetTargetFps() const noexcept;
+	// display refresh, the frame period of the vsync modes
+	void SetRefreshRate(float hz) noexcept;
+	// before Present; only TargetFps waits: it sleeps while the deadline is further away than the
+	// sleep overshoot seen so far and spins for the rest
+	void WaitForDeadline() noexcept;
+	// right after Present
+	void MarkPresented() noexcept;
+	// 0 presents immediately (and may tear), 1 waits for the vertical blank
+	unsigned int GetSyncInterval() const noexcept;
+	Stats GetStats() const;
+	void ResetStats();
+	static const char* GetModeName(Mode mode) noexcept;
+private:
+	int64_t GetTargetPeriod(Mode mode) const noexcept;
+private:
+	IClock& clock;
+	std::atomic<Mode> mode;
+	std::atomic<float> targetFps;
+	std::atomic<float> refreshRate{ 60.0f };
+	// presenting thread only
+	int64_t deadline = 0;
+	int64_t lastPresent = 0;
+	int64_t sleepMargin = 2000000;
+	mutable std::mutex statsMutex;
+	Stats stats;
+	double absErrorSum = 0.0;
+};
\ No newline at end of file
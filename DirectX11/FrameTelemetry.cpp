@@ -0,0 +1,174 @@
+#include "FrameTelemetry.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	double ToMs(int64_t ns) noexcept
+	{
+		return double(ns) * 1e-6;
+	}
+
+	constexpr FrameTelemetry::Channel allChannels[] = {
+		FrameTelemetry::Channel::Frame,
+		FrameTelemetry::Channel::Present,
+		FrameTelemetry::Channel::MessagePump
+	};
+}
+
+void FrameTelemetry::Record(Channel channel, int64_t ns) noexcept
+{
+	ChannelData& c = channels[size_t(channel)];
+	const uint64_t frame = c.frames.load(std::memory_order_relaxed);
+	c.frames.store(frame + 1u, std::memory_order_relaxed);
+	c.last.store(ns, std::memory_order_relaxed);
+	c.histogram.Record(ns);
+	if (ns > c.worst[c.mildest].ns.load(std::memory_order_relaxed))
+	{
+		c.worst[c.mildest].ns.store(ns, std::memory_order_relaxed);
+		c.worst[c.mildest].frame.store(frame, std::memory_order_relaxed);
+		// the next entry to give up its place
+		for (size_t i = 0; i < worstCount; i++)
+		{
+			if (c.worst[i].ns.load(std::memory_order_relaxed) < c.worst[c.mildest].ns.load(std::memory_order_relaxed))
+			{
+				c.mildest = i;
+			}
+		}
+	}
+}
+
+FrameTelemetry::Summary FrameTelemetry::GetSummary(Channel channel) const noexcept
+{
+	const HdrHistogram& h = channels[size_t(channel)].histogram;
+	Summary s;
+	s.count = h.GetCount();
+	s.minMs = ToMs(h.GetMin());
+	s.meanMs = h.GetMean() * 1e-6;
+	s.p50Ms = ToMs(h.GetValueAtPercentile(50.0));
+	s.p95Ms = ToMs(h.GetValueAtPercentile(95.0));
+	s.p99Ms = ToMs(h.GetValueAtPercentile(99.0));
+	s.p999Ms = ToMs(h.GetValueAtPercentile(99.9));
+	s.maxMs = ToMs(h.GetMax());
+	return s;
+}
+
+int64_t FrameTelemetry::GetLast(Channel channel) const noexcept
+{
+	return channels[size_t(channel)].last.load(std::memory_order_relaxed);
+}
+
+std::vector<FrameTelemetry::WorstFrame> FrameTelemetry::GetWorst(Channel channel) const
+{
+	const ChannelData& c = channels[size_t(channel)];
+	std::vector<WorstFrame> worst;
+	for (const Sample& s : c.worst)
+	{
+		const int64_t ns = s.ns.load(std::memory_order_relaxed);
+		// empty slots stay at 0
+		if (ns > 0)
+		{
+			worst.push_back({ s.frame.load(std::memory_order_relaxed),ToMs(ns) });
+		}
+	}
+	std::sort(worst.begin(), worst.end(), [](const WorstFrame& a, const WorstFrame& b)
+	{
+		return a.ms > b.ms;
+	});
+	return worst;
+}
+
+void FrameTelemetry::Reset() noexcept
+{
+	for (ChannelData& c : channels)
+	{
+		c.histogram.Reset();
+		c.frames.store(0u, std::memory_order_relaxed);
+		c.last.store(0, std::memory_order_relaxed);
+		for (Sample& s : c.worst)
+		{
+			s.ns.store(0, std::memory_order_relaxed);
+			s.frame.store(0u, std::memory_order_relaxed);
+		}
+		c.mildest = 0u;
+	}
+}
+
+void FrameTelemetry::WriteCsv(std::ostream& out) const
+{
+	out << "channel,count,min_ms,mean_ms,p50_ms,p95_ms,p99_ms,p99_9_ms,max_ms\n";
+	for (const Channel channel : allChannels)
+	{
+		const Summary s = GetSummary(channel);
+		out << GetChannelName(channel) << ',' << s.count << ',' << s.minMs << ',' << s.meanMs << ','
+			<< s.p50Ms << ',' << s.p95Ms << ',' << s.p99Ms << ',' << s.p999Ms << ',' << s.maxMs << '\n';
+	}
+	// second table, separated by an empty line
+	out << "\nchannel,rank,frame,ms\n";
+	for (const Channel channel : allChannels)
+	{
+		const std::vector<WorstFrame> worst = GetWorst(channel);
+		for (size_t i = 0; i < worst.size(); i++)
+		{
+			out << GetChannelName(channel) << ',' << i + 1u << ',' << worst[i].frame << ',' << worst[i].ms << '\n';
+		}
+	}
+}
+
+void FrameTelemetry::WriteJson(std::ostream& out) const
+{
+	out << "{\"channels\":[";
+	for (const Channel channel : allChannels)
+	{
+		const Summary s = GetSummary(channel);
+		out << (channel == allChannels[0] ? "\n" : ",\n")
+			<< "{\"name\":\"" << GetChannelName(channel) << "\",\"count\":" << s.count
+			<< ",\"min_ms\":" << s.minMs << ",\"mean_ms\":" << s.meanMs
+			<< ",\"p50_ms\":" << s.p50Ms << ",\"p95_ms\":" << s.p95Ms << ",\"p99_ms\":" << s.p99Ms
+			<< ",\"p99_9_ms\":" << s.p999Ms << ",\"max_ms\":" << s.maxMs << ",\"worst\":[";
+		const std::vector<WorstFrame> worst = GetWorst(channel);
+		for (size_t i = 0; i < worst.size(); i++)
+		{
+			out << (i == 0u ? "" : ",") << "{\"frame\":" << worst[i].frame << ",\"ms\":" << worst[i].ms << '}';
+		}
+		out << "]}";
+	}
+	out << "\n]}\n";
+}
+
+bool FrameTelemetry::WriteCsv(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		return false;
+	}
+	WriteCsv(file);
+	return bool(file);
+}
+
+bool FrameTelemetry::WriteJson(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		return false;
+	}
+	WriteJson(file);
+	return bool(file);
+}
+
+const char* FrameTelemetry::GetChannelName(Channel channel) noexcept
+{
+	switch (channel)
+	{
+	case Channel::Frame:
+		return "frame";
+	case Channel::Present:
+		return "present";
+	case Channel::MessagePump:
+		return "message_pump";
+	default:
+		return "unknown";
+	}
+}
\ No newline at end of file
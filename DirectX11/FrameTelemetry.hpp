@@ -0,0 +1,75 @@
+#pragma once
+#include "HdrHistogram.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// per frame timings (ChiliTimer::MarkNs) kept as HDR histograms plus the worst frames of each
+// channel, for percentiles instead of averages. Record never allocates; each channel must be
+// recorded by a single thread, summaries and exports may be taken from any thread at any time
+class FrameTelemetry
+{
+public:
+	enum class Channel
+	{
+		Frame,
+		Present,
+		MessagePump,
+		Count
+	};
+	struct Summary
+	{
+		uint64_t count = 0u;
+		double minMs = 0.0;
+		double meanMs = 0.0;
+		double p50Ms = 0.0;
+		double p95Ms = 0.0;
+		double p99Ms = 0.0;
+		double p999Ms = 0.0;
+		double maxMs = 0.0;
+	};
+	struct WorstFrame
+	{
+		// index of the sample within its channel, 0 = first recorded
+		uint64_t frame = 0u;
+		double ms = 0.0;
+	};
+	static constexpr size_t worstCount = 16u;
+	// 1us .. 10s at 3 significant digits
+	static constexpr int64_t lowestNs = 1000;
+	static constexpr int64_t highestNs = 10000000000;
+public:
+	void Record(Channel channel, int64_t ns) noexcept;
+	Summary GetSummary(Channel channel) const noexcept;
+	// most recent sample in nanoseconds
+	int64_t GetLast(Channel channel) const noexcept;
+	// worst first
+	std::vector<WorstFrame> GetWorst(Channel channel) const;
+	// only from the recording threads' side of a frame, or while nothing records
+	void Reset() noexcept;
+	void WriteCsv(std::ostream& out) const;
+	void WriteJson(std::ostream& out) const;
+	bool WriteCsv(const std::string& path) const;
+	bool WriteJson(const std::string& path) const;
+	static const char* GetChannelName(Channel channel) noexcept;
+private:
+	struct Sample
+	{
+		std::atomic<int64_t> ns{ 0 };
+		std::atomic<uint64_t> frame{ 0u };
+	};
+	struct ChannelData
+	{
+		HdrHistogram histogram{ lowestNs,highestNs,3u };
+		std::atomic<uint64_t> frames{ 0u };
+		std::atomic<int64_t> last{ 0 };
+		// unordered, the smallest is the one replaced by the next worse sample
+		Sample worst[worstCount];
+		size_t mildest = 0u;
+	};
+private:
+	ChannelData channels[size_t(Channel::Count)];
+};
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include "FrustumCuller.hpp"
+#include "CpuFeatures.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef CHILI_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	bool simdEnabled = true;
+
+	Plane MakePlane(float a, float b, float c, float d) noexcept
+	{
+		const float length = std::sqrt(a * a + b * b + c * c);
+		const float inv = length > 0.0f ? 1.0f / length : 0.0f;
+		return { a * inv,b * inv,c * inv,d * inv };
+	}
+
+	bool SphereVisible(const Frustum& frustum, float x, float y, float z, float r) noexcept
+	{
+		for (const Plane& p : frustum.planes)
+		{
+			if (p.a * x + p.b * y + p.c * z + p.d < -r)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool BoxVisible(const Frustum& frustum, float cx, float cy, float cz, float ex, float ey, float ez) noexcept
+	{
+		for (const Plane& p : frustum.planes)
+		{
+			// distance of the box corner furthest along the plane normal
+			const float reach = std::abs(p.a) * ex + std::abs(p.b) * ey + std::abs(p.c) * ez;
+			if (p.a * cx + p.b * cy + p.c * cz + p.d + reach < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+#ifdef CHILI_X86
+	CHILI_TARGET_AVX2 size_t CullSpheresAvx2(const Frustum& frustum, const SphereBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept
+	{
+		__m256 pa[6], pb[6], pc[6], pd[6];
+		for (int i = 0; i < 6; i++)
+		{
+			pa[i] = _mm256_set1_ps(frustum.planes[i].a);
+			pb[i] = _mm256_set1_ps(frustum.planes[i].b);
+			pc[i] = _mm256_set1_ps(frustum.planes[i].c);
+			pd[i] = _mm256_set1_ps(frustum.planes[i].d);
+		}
+		size_t n = 0u;
+		size_t i = begin;
+		for (; i + 8u <= end; i += 8u)
+		{
+			const __m256 x = _mm256_loadu_ps(bounds.x.data() + i);
+			const __m256 y = _mm256_loadu_ps(bounds.y.data() + i);
+			const __m256 z = _mm256_loadu_ps(bounds.z.data() + i);
+			const __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(bounds.radius.data() + i));
+			// lanes stay set while every plane distance is >= -r
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; p++)
+			{
+				const __m256 dist = _mm256_fmadd_ps(pa[p], x, _mm256_fmadd_ps(pb[p], y, _mm256_fmadd_ps(pc[p], z, pd[p])));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+			}
+			// compact: one index per set mask bit
+			unsigned int mask = unsigned(_mm256_movemask_ps(inside));
+			while (mask != 0u)
+			{
+				unsigned long bit;
+#ifdef _MSC_VER
+				_BitScanForward(&bit, mask);
+#else
+				bit = unsigned(__builtin_ctz(mask));
+#endif
+				pVisible[n++] = uint32_t(i + bit);
+				mask &= mask - 1u;
+			}
+		}
+		for (; i < end; i++)
+		{
+			if (SphereVisible(frustum, bounds.x[i], bounds.y[i], bounds.z[i], bounds.radius[i]))
+			{
+				pVisible[n++] = uint32_t(i);
+			}
+		}
+		return n;
+	}
+
+	CHILI_TARGET_AVX2 size_t CullBoxesAvx2(const Frustum& frustum, const BoxBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept
+	{
+		__m256 pa[6], pb[6], pc[6], pd[6], aa[6], ab[6], ac[6];
+		for (int i = 0; i < 6; i++)
+		{
+			pa[i] = _mm256_set1_ps(frustum.planes[i].a);
+			pb[i] = _mm256_set1_ps(frustum.planes[i].b);
+			pc[i] = _mm256_set1_ps(frustum.planes[i].c);
+			pd[i] = _mm256_set1_ps(frustum.planes[i].d);
+			aa[i] = _mm256_set1_ps(std::abs(frustum.planes[i].a));
+			ab[i] = _mm256_set1_ps(std::abs(frustum.planes[i].b));
+			ac[i] = _mm256_set1_ps(std::abs(frustum.planes[i].c));
+		}
+		const __m256 zero = _mm256_setzero_ps();
+		size_t n = 0u;
+		size_t i = begin;
+		for (; i + 8u <= end; i += 8u)
+		{
+			const __m256 cx = _mm256_loadu_ps(bounds.centerX.data() + i);
+			const __m256 cy = _mm256_loadu_ps(bounds.centerY.data() + i);
+			const __m256 cz = _mm256_loadu_ps(bounds.centerZ.data() + i);
+			const __m256 ex = _mm256_loadu_ps(bounds.extentX.data() + i);
+			const __m256 ey = _mm256_loadu_ps(bounds.extentY.data() + i);
+			const __m256 ez = _mm256_loadu_ps(bounds.extentZ.data() + i);
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; p++)
+			{
+				const __m256 dist = _mm256_fmadd_ps(pa[p], cx, _mm256_fmadd_ps(pb[p], cy, _mm256_fmadd_ps(pc[p], cz, pd[p])));
+				const __m256 reach = _mm256_fmadd_ps(aa[p], ex, _mm256_fmadd_ps(ab[p], ey, _mm256_mul_ps(ac[p], ez)));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, reach), zero, _CMP_GE_OQ));
+			}
+			unsigned int mask = unsigned(_mm256_movemask_ps(inside));
+			while (mask != 0u)
+			{
+				unsigned long bit;
+#ifdef _MSC_VER
+				_BitScanForward(&bit, mask);
+#else
+				bit = unsigned(__builtin_ctz(mask));
+#endif
+				pVisible[n++] = uint32_t(i + bit);
+				mask &= mask - 1u;
+			}
+		}
+		for (; i < end; i++)
+		{
+			if (BoxVisible(frustum, bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]))
+			{
+				pVisible[n++] = uint32_t(i);
+			}
+		}
+		return n;
+	}
+#endif
+}
+
+Frustum Frustum::FromViewProjection(const Matrix4& viewProj) noexcept
+{
+	// clip = v * M, so each clip component is v dotted with a column of M
+	const auto& m = viewProj.m;
+	const auto column = [&](int c, float sign, int base)
+	{
+		return MakePlane(
+			m[0][base] + sign * m[0][c],
+			m[1][base] + sign * m[1][c],
+			m[2][base] + sign * m[2][c],
+			m[3][base] + sign * m[3][c]);
+	};
+	Frustum f;
+	f.planes[0] = column(0, 1.0f, 3);
+	f.planes[1] = column(0, -1.0f, 3);
+	f.planes[2] = column(1, 1.0f, 3);
+	f.planes[3] = column(1, -1.0f, 3);
+	// near is z >= 0 on its own in D3D clip space
+	f.planes[4] = MakePlane(m[0][2], m[1][2], m[2][2], m[3][2]);
+	f.planes[5] = column(2, -1.0f, 3);
+	return f;
+}
+
+void SphereBounds::Clear() noexcept
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	radius.clear();
+}
+
+void SphereBounds::Reserve(size_t count)
+{
+	x.reserve(count);
+	y.reserve(count);
+	z.reserve(count);
+	radius.reserve(count);
+}
+
+void SphereBounds::Add(const Float3& center, float r)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	z.push_back(center.z);
+	radius.push_back(r);
+}
+
+size_t SphereBounds::Size() const noexcept
+{
+	return x.size();
+}
+
+void BoxBounds::Clear() noexcept
+{
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	extentX.clear();
+	extentY.clear();
+	extentZ.clear();
+}
+
+void BoxBounds::Reserve(size_t count)
+{
+	centerX.reserve(count);
+	centerY.reserve(count);
+	centerZ.reserve(count);
+	extentX.reserve(count);
+	extentY.reserve(count);
+	extentZ.reserve(count);
+}
+
+void BoxBounds::Add(const Float3& center, const Float3& extents)
+{
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	extentX.push_back(extents.x);
+	extentY.push_back(extents.y);
+	extentZ.push_back(extents.z);
+}
+
+size_t BoxBounds::Size() const noexcept
+{
+	return centerX.size();
+}
+
+FrustumCuller::FrustumCuller(JobSystem* pJobs)
+	:
+	pJobs(pJobs)
+{}
+
+void FrustumCuller::Cull(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visible)
+{
+	CullParallel(frustum, bounds, visible, &FrustumCuller::CullSpheres);
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, const BoxBounds& bounds, std::vector<uint32_t>& visible)
+{
+	CullParallel(frustum, bounds, visible, &FrustumCuller::CullBoxes);
+}
+
+template<typename Bounds, typename Kernel>
+void FrustumCuller::CullParallel(const Frustum& frustum, const Bounds& bounds, std::vector<uint32_t>& visible, Kernel kernel)
+{
+	const size_t count = bounds.Size();
+	visible.resize(count);
+	const size_t nRanges = pJobs ? std::max<size_t>(1u, std::min<size_t>(GetThreadCount() * rangesPerThread, count / minObjectsPerRange)) : 1u;
+	if (nRanges == 1u)
+	{
+		visible.resize(kernel(frustum, bounds, 0u, count, visible.data()));
+	}
+	else
+	{
+		// each range writes at its own start (it can never produce more than it tests), then the
+		// partial lists are slid together in range order
+		const auto rangeBegin = [&](size_t r)
+		{
+			// multiples of 8 so only the last range has a scalar tail
+			return r < nRanges ? (count * r / nRanges) & ~size_t(7u) : count;
+		};
+		found.resize(nRanges);
+		pJobs->ParallelFor(0u, nRanges, 1u, [&](size_t first, size_t last)
+		{
+			for (size_t r = first; r < last; r++)
+			{
+				found[r] = kernel(frustum, bounds, rangeBegin(r), rangeBegin(r + 1u), visible.data() + rangeBegin(r));
+			}
+		});
+		size_t n = found[0];
+		for (size_t r = 1; r < nRanges; r++)
+		{
+			std::memmove(visible.data() + n, visible.data() + rangeBegin(r), found[r] * sizeof(uint32_t));
+			n += found[r];
+		}
+		visible.resize(n);
+	}
+	stats.tested = count;
+	stats.visible = visible.size();
+}
+
+size_t FrustumCuller::CullSpheres(const Frustum& frustum, const SphereBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept
+{
+#ifdef CHILI_X86
+	if (simdEnabled && CpuFeatures::HasAvx2())
+	{
+		return CullSpheresAvx2(frustum, bounds, begin, end, pVisible);
+	}
+#endif
+	size_t n = 0u;
+	for (size_t i = begin; i < end; i++)
+	{
+		if (SphereVisible(frustum, bounds.x[i], bounds.y[i], bounds.z[i], bounds.radius[i]))
+		{
+			pVisible[n++] = uint32_t(i);
+		}
+	}
+	return n;
+}
+
+size_t FrustumCuller::CullBoxes(const Frustum& frustum, const BoxBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept
+{
+#ifdef CHILI_X86
+	if (simdEnabled && CpuFeatures::HasAvx2())
+	{
+		return CullBoxesAvx2(frustum, bounds, begin, end, pVisible);
+	}
+#endif
+	size_t n = 0u;
+	for (size_t i = begin; i < end; i++)
+	{
+		if (BoxVisible(frustum, bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]))
+		{
+			pVisible[n++] = uint32_t(i);
+		}
+	}
+	return n;
+}
+
+void FrustumCuller::SetSimdEnabled(bool enabled) noexcept
+{
+	simdEnabled = enabled;
+}
+
+unsigned int FrustumCuller::GetThreadCount() const noexcept
+{
+	return pJobs ? pJobs->GetThreadCount() : 1u;
+}
+
+const FrustumCuller::Stats& FrustumCuller::GetStats() const noexcept
+{
+	return stats;
+}
\ No newline at end of file
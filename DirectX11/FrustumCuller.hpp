@@ -0,0 +1,88 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// normalized plane, a * x + b * y + c * z + d >= 0 on the inside
+struct Plane
+{
+	float a;
+	float b;
+	float c;
+	float d;
+};
+
+struct Frustum
+{
+	// left, right, bottom, top, near, far
+	Plane planes[6];
+	// Gribb / Hartmann extraction for row vector matrices with D3D clip space (0 <= z <= w)
+	static Frustum FromViewProjection(const Matrix4& viewProj) noexcept;
+};
+
+// bounding volumes as flat structure-of-arrays so eight of them load with one vector read per component
+struct SphereBounds
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> radius;
+	void Clear() noexcept;
+	void Reserve(size_t count);
+	void Add(const Float3& center, float r);
+	size_t Size() const noexcept;
+};
+
+struct BoxBounds
+{
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> extentX;
+	std::vector<float> extentY;
+	std::vector<float> extentZ;
+	void Clear() noexcept;
+	void Reserve(size_t count);
+	// center and half extents of an axis aligned box
+	void Add(const Float3& center, const Float3& extents);
+	size_t Size() const noexcept;
+};
+
+// tests bounds against a frustum and writes the indices of the visible ones, in ascending order;
+// large inputs are split into contiguous ranges that run as jobs on pJobs
+class FrustumCuller
+{
+public:
+	struct Stats
+	{
+		size_t tested = 0u;
+		size_t visible = 0u;
+	};
+public:
+	// without a job system everything runs on the calling thread
+	FrustumCuller(JobSystem* pJobs = nullptr);
+	void Cull(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visible);
+	void Cull(const Frustum& frustum, const BoxBounds& bounds, std::vector<uint32_t>& visible);
+	// single threaded kernels over [begin, end), avx2 when available; return the number of indices written
+	static size_t CullSpheres(const Frustum& frustum, const SphereBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept;
+	static size_t CullBoxes(const Frustum& frustum, const BoxBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) noexcept;
+	// forces the scalar kernels, for comparison in benchmarks
+	static void SetSimdEnabled(bool enabled) noexcept;
+	unsigned int GetThreadCount() const noexcept;
+	const Stats& GetStats() const noexcept;
+private:
+	template<typename Bounds, typename Kernel>
+	void CullParallel(const Frustum& frustum, const Bounds& bounds, std::vector<uint32_t>& visible, Kernel kernel);
+private:
+	// below this many objects per range the job overhead outweighs the split
+	static constexpr size_t minObjectsPerRange = 16384u;
+	// ranges per thread, extra ranges let idle threads steal from slow ones
+	static constexpr size_t rangesPerThread = 4u;
+	JobSystem* pJobs;
+	// visible count of every range, reused between calls
+	std::vector<size_t> found;
+	Stats stats;
+};
\ No newline at end of file
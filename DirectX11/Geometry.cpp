@@ -0,0 +1,64 @@
+#include "Geometry.hpp"
+#include <algorithm>
+#include <cmath>
+
+const Mesh& Geometry::ColoredCube()
+{
+	static const Mesh cube = []()
+	{
+		const ColoredVertex vertices[] =
+		{
+			// pos						// color
+			{ {-0.5f, 0.5f,0.0f },		{ 255,   0,   0, 255 } },
+			{ { 0.5f,-0.5f,0.0f },		{	0, 255,   0, 255 } },
+			{ {-0.5f,-0.5f,0.0f },		{	0,	 0, 255, 255 } },
+			{ { 0.5f, 0.5f,0.0f },		{ 255,   0, 255, 255 } },
+
+			{ {-0.5f, 0.5f, 1.0f },		{ 255,   0,   0, 255 } },
+			{ { 0.5f,-0.5f, 1.0f },		{	0, 255,   0, 255 } },
+			{ {-0.5f,-0.5f, 1.0f },		{	0,	 0, 255, 255 } },
+			{ { 0.5f, 0.5f, 1.0f },		{ 255,   0, 255, 255 } },
+		};
+		const uint16_t indices[] =
+		{
+			0, 1, 2,
+			0, 3, 1,
+
+			1, 3, 5,
+			3, 7, 5,
+
+			5, 7, 6,
+			7, 4, 6,
+
+			6, 4, 2,
+			4, 0, 2,
+
+			0, 4, 3,
+			4, 7, 3,
+
+			1, 5, 2,
+			5, 6, 2
+		};
+		Mesh mesh = Mesh::FromArrays(vertices, sizeof(vertices) / sizeof(vertices[0]), indices, sizeof(indices) / sizeof(indices[0]));
+		mesh.Optimize();
+		return mesh;
+	}();
+	return cube;
+}
+
+Float4 Geometry::MaterialTint(unsigned int material) noexcept
+{
+	if (material == 0u)
+	{
+		return { 1.0f,1.0f,1.0f,1.0f };
+	}
+	// golden ratio steps spread any number of ids evenly, pastel so the vertex colors still show
+	const float hue = std::fmod(float(material - 1u) * 0.618034f, 1.0f) * 6.0f;
+	// hsv to rgb with value 1 and saturation 0.6
+	const auto channel = [hue](float n)
+	{
+		const float k = std::fmod(n + hue, 6.0f);
+		return 1.0f - 0.6f * std::fmax(0.0f, std::min({ k, 4.0f - k, 1.0f }));
+	};
+	return { channel(5.0f),channel(3.0f),channel(1.0f),1.0f };
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "Mesh.hpp"
+#include "VertexQuantization.hpp"
+
+// built-in meshes shared by the D3D11 and software backends
+namespace Geometry
+{
+	// layout of the cube shaders: float3 position + B8G8R8A8 color
+	struct ColoredVertex
+	{
+		Float3 pos;
+		uint8_t color[4];
+	};
+	constexpr VertexQuantization::VertexFormat coloredVertexFormat = {
+		VertexQuantization::PositionEncoding::Float32,
+		VertexQuantization::NormalEncoding::None,
+		VertexQuantization::UVEncoding::None,
+		true
+	};
+
+	// the test cube, already run through Mesh::Optimize
+	const Mesh& ColoredCube();
+	// rgba multiplier of the vertex colors for a material id, 0 is white (untinted) and the
+	// others walk around the hue wheel so neighbouring ids are easy to tell apart
+	Float4 MaterialTint(unsigned int material) noexcept;
+}
\ No newline at end of file
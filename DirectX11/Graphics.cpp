@@ -1,9 +1,30 @@
 #include "Graphics.hpp"
 #include "dxerr.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <sstream>
 
 namespace wrl = Microsoft::WRL;
 
+namespace
+{
+	Matrix4 ToMatrix4(const DirectX::XMFLOAT4X4& m) noexcept
+	{
+		Matrix4 r;
+		std::memcpy(r.m, m.m, sizeof(r.m));
+		return r;
+	}
+
+	Matrix4 ToMatrix4(DirectX::FXMMATRIX m) noexcept
+	{
+		DirectX::XMFLOAT4X4 rows;
+		DirectX::XMStoreFloat4x4(&rows, m);
+		return ToMatrix4(rows);
+	}
+}
+
 #pragma comment(lib,"d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -24,7 +45,8 @@ namespace wrl = Microsoft::WRL;
 
 Graphics::Graphics(HWND hWnd)
 	:
-	matrix(DirectX::XMMatrixIdentity())
+	pacer(clock),
+	jobs(0u, false, 1u)
 {
 	DXGI_SWAP_CHAIN_DESC sd = {};
 	sd.BufferDesc.Width = 0;
@@ -41,7 +63,7 @@ Graphics::Graphics(HWND hWnd)
 	sd.OutputWindow = hWnd;
 	sd.Windowed = TRUE;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING | DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
 	UINT swapCreateFlags = 0u;
 #ifndef NDEBUG
@@ -102,16 +124,6 @@ Graphics::Graphics(HWND hWnd)
 
 	GFX_THROW_INFO(pDevice->CreateTexture2D(&depthBuffer, nullptr, &depthTexture));
 
-	D3D11_DEPTH_STENCIL_DESC dsDesc{};
-	dsDesc.DepthEnable = TRUE;
-	dsDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	dsDesc.DepthFunc = D3D11_COMPARISON_LESS;
-	dsDesc.StencilEnable = FALSE;
-
-	GFX_THROW_INFO(pDevice->CreateDepthStencilState(&dsDesc, &pDSState));
-
-	pContext->OMSetDepthStencilState(pDSState.Get(), 0u);
-
 	D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
 	dsvDesc.Format = depthBuffer.Format;
 	dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
@@ -119,15 +131,88 @@ Graphics::Graphics(HWND hWnd)
 
 	GFX_THROW_INFO(pDevice->CreateDepthStencilView(depthTexture.Get(), &dsvDesc, &pDSV));
 
+	// the upload ring recycles a frame's constants framesInFlight frames later, which is only safe
+	// while the cpu never runs further ahead than that: EndFrame waits on the swap chain's latency
+	// object, whose limit is framesInFlight (1 in low latency mode)
+	GFX_THROW_INFO(pSwap.As(&pSwap2));
+	GFX_THROW_INFO(pSwap2->SetMaximumFrameLatency(frameLatency));
+	frameLatencyWaitable = pSwap2->GetFrameLatencyWaitableObject();
+
+	// vsync modes pace at the refresh rate of the primary display
+	DEVMODE displayMode{};
+	displayMode.dmSize = sizeof(displayMode);
+	if (EnumDisplaySettings(nullptr, ENUM_CURRENT_SETTINGS, &displayMode) && displayMode.dmDisplayFrequency > 1u)
+	{
+		pacer.SetRefreshRate(float(displayMode.dmDisplayFrequency));
+	}
+
+	// constant buffer offsetting + no-overwrite maps on constant buffers need the 11.1 runtime
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+	if (SUCCEEDED(pContext.As(&pContext1)) &&
+		SUCCEEDED(pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+		options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer)
+	{
+		D3D11_BUFFER_DESC ringDesc{};
+		ringDesc.ByteWidth = UINT(SceneSubmitter::constantRingSize);
+		ringDesc.Usage = D3D11_USAGE_DYNAMIC;
+		ringDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		ringDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		GFX_THROW_INFO(pDevice->CreateBuffer(&ringDesc, nullptr, &constantRingBuffer));
+	}
+	else
+	{
+		// fallback: one small buffer per constant slot, renamed on every update
+		pContext1.Reset();
+		D3D11_BUFFER_DESC cBuffer{};
+		cBuffer.ByteWidth = sizeof(DirectX::XMFLOAT4X4);
+		cBuffer.Usage = D3D11_USAGE_DYNAMIC;
+		cBuffer.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		cBuffer.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		for (auto& cb : fallbackConstantBuffers)
+		{
+			GFX_THROW_INFO(pDevice->CreateBuffer(&cBuffer, nullptr, &cb));
+		}
+	}
+
+	pPipelineCache = std::make_unique<D3D11PipelineCache>(pDevice);
+
+	// all binds and draws go through the state filter so redundant ones never reach the driver
+	pRenderContext = std::make_unique<D3D11RenderContext>(pContext);
+	pRecording = std::make_unique<RecordingRenderContext>(*pRenderContext, false);
+	pCapturer = std::make_unique<FrameCapturer>(*pRecording);
+	pStateFilter = std::make_unique<StateFilter>(*pRecording);
+
+	// shaders come from the mapped (or embedded) archive and pipelines are built here, not on the first frame
+	shaderArchive = ShaderArchive::LoadDefault();
+	InitCubePipeline();
+}
+
+Graphics::~Graphics()
+{
+	if (frameLatencyWaitable)
+	{
+		CloseHandle(frameLatencyWaitable);
+	}
 }
 
 void Graphics::EndFrame()
 {
+	PROFILE_ZONE("EndFrame");
+	FlushQueue();
 	HRESULT hr;
+	pacer.WaitForDeadline();
 #ifndef NDEBUG
 	infoManager.Set();
 #endif
-	if (FAILED(hr = pSwap->Present(0u, DXGI_PRESENT_ALLOW_TEARING)))
+	// tearing is only allowed when presenting immediately
+	const UINT syncInterval = pacer.GetSyncInterval();
+	{
+		PROFILE_ZONE("Present");
+		presentTimer.Mark();
+		hr = pSwap->Present(syncInterval, syncInterval == 0u ? DXGI_PRESENT_ALLOW_TEARING : 0u);
+		telemetry.Record(FrameTelemetry::Channel::Present, presentTimer.MarkNs());
+	}
+	if (FAILED(hr))
 	{
 		if (hr == DXGI_ERROR_DEVICE_REMOVED)
 		{
@@ -138,185 +223,242 @@ void Graphics::EndFrame()
 			throw GFX_EXCEPT(hr);
 		}
 	}
+	pacer.MarkPresented();
+	pSubmitter->EndFrame();
+	pStateFilter->EndFrame();
+	if (pCapturer->EndFrame())
+	{
+		pStateFilter->Invalidate();
+	}
+	framesPresented++;
+	if (pMetrics)
+	{
+		const StateFilter::Stats& state = pStateFilter->GetLastFrameStats();
+		const OcclusionCuller::Stats& occlusion = pSubmitter->GetOcclusionStats();
+		MetricsSnapshot snapshot;
+		snapshot.frame = framesPresented;
+		snapshot.draws = state.draws;
+		snapshot.triangles = state.triangles;
+		snapshot.stateCalls = state.TotalIssued();
+		snapshot.stateCallsElided = state.TotalElided();
+		snapshot.maps = state.maps;
+		snapshot.occludeesTested = unsigned(occlusion.tested);
+		snapshot.occludeesCulled = unsigned(occlusion.culled);
+		pMetrics->Publish(snapshot);
+	}
+	// on the render thread this is the start of the next frame's work
+	WaitForFrameLatency();
 }
 
-void Graphics::ClearBuffer(float red, float green, float blue) noexcept
+RendererStats Graphics::GetFrameStats() const
 {
-	const float color[] = { red,green,blue,1.0f };
-	pContext->ClearDepthStencilView(pDSV.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0u);
-	pContext->ClearRenderTargetView(pTarget.Get(), color);
+	RendererStats stats = pSubmitter->GetFrameStats();
+	stats.draws = pStateFilter->GetLastFrameStats().draws;
+	stats.triangles = pStateFilter->GetLastFrameStats().triangles;
+	return stats;
 }
 
-void Graphics::DrawTestTriangle(float x, float y)
+void Graphics::WaitForFrameLatency()
 {
-	static bool init = false;
+	PROFILE_ZONE("WaitForFrameLatency");
 	HRESULT hr;
-	struct Vertex
+	const UINT latency = pacer.GetMode() == FramePacer::Mode::LowLatency ? 1u : framesInFlight;
+	if (latency != frameLatency)
 	{
-		DirectX::XMFLOAT3 pos;
-		struct
-		{
-			BYTE col[4];
-		} color;
-	};
-
-	static float theta = 0.0f;
-	theta += 1.0f / 3000.f;
-	static float theta2 = 0.0f;
-	theta2 += 1.3f / 3000.f;
-
-	if (!init)
-	{
-		const Vertex vertices[] =
-		{
-			// pos						// color
-			{ {-0.5f, 0.5f,0.0f },		{ 255,   0,   0, 255 } },
-			{ { 0.5f,-0.5f,0.0f },		{	0, 255,   0, 255 } },
-			{ {-0.5f,-0.5f,0.0f },		{	0,	 0, 255, 255 } },
-			{ { 0.5f, 0.5f,0.0f },		{ 255,   0, 255, 255 } },
-
-			{ {-0.5f, 0.5f, 1.0f },		{ 255,   0,   0, 255 } },
-			{ { 0.5f,-0.5f, 1.0f },		{	0, 255,   0, 255 } },
-			{ {-0.5f,-0.5f, 1.0f },		{	0,	 0, 255, 255 } },
-			{ { 0.5f, 0.5f, 1.0f },		{ 255,   0, 255, 255 } },
-
-		};
-		const UINT16 indices[] =
-		{
-			0, 1, 2,
-			0, 3, 1,
-
-			1, 3, 5,
-			3, 7, 5,
-
-			5, 7, 6,
-			7, 4, 6,
-
-			6, 4, 2,
-			4, 0, 2,
-
-			0, 4, 3,
-			4, 7, 3,
-
-			1, 5, 2,
-			5, 6, 2
-		};
-
-		indicesCount = _countof(indices);
-		D3D11_BUFFER_DESC vertexBufferDesc{};
-		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		vertexBufferDesc.ByteWidth = sizeof(vertices);
-		vertexBufferDesc.StructureByteStride = sizeof(Vertex);
-		vertexBufferDesc.CPUAccessFlags = 0u;
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-		D3D11_SUBRESOURCE_DATA sd{};
-		sd.pSysMem = vertices;
+		GFX_THROW_INFO(pSwap2->SetMaximumFrameLatency(latency));
+		frameLatency = latency;
+	}
+	WaitForSingleObjectEx(frameLatencyWaitable, 1000u, TRUE);
+}
 
-		GFX_THROW_INFO(pDevice->CreateBuffer(&vertexBufferDesc, &sd, &vertexBuffer));
+void Graphics::ClearBuffer(float red, float green, float blue) noexcept
+{
+	const float color[] = { red,green,blue,1.0f };
+	pStateFilter->ClearDepth(ToHandle(pDSV.Get()), 1.0f);
+	pStateFilter->ClearRenderTarget(ToHandle(pTarget.Get()), color);
+}
 
-		D3D11_BUFFER_DESC indexBufferDesc{};
-		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		indexBufferDesc.StructureByteStride = sizeof(UINT16);
-		indexBufferDesc.ByteWidth = sizeof(indices);
-		indexBufferDesc.CPUAccessFlags = 0u;
-		sd = {};
-		sd.pSysMem = indices;
+void Graphics::SetCamera(float x, float y, float z) noexcept
+{
+	xPos = x;
+	yPos = y;
+	zPos = z;
+}
 
-		GFX_THROW_INFO(pDevice->CreateBuffer(&indexBufferDesc, &sd, &indexBuffer));
+void Graphics::DrawScene(const FrameSnapshot& scene)
+{
+	pSubmitter->QueueScene(scene);
+	FlushQueue();
+}
 
-		wrl::ComPtr<ID3DBlob> vertexShaderBlob;
-		{
-			wrl::ComPtr<ID3DBlob> pixelShaderBlob;
-			GFX_THROW_INFO(D3DReadFileToBlob(L"PixelShader.cso", &pixelShaderBlob));
-			pDevice->CreatePixelShader(pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize(), nullptr, &pixelShader);
-		}
+void Graphics::QueueCube(const DirectX::XMFLOAT4X4& world, bool occluder, uint16_t material)
+{
+	pSubmitter->QueueCube(ToMatrix4(world), occluder, material);
+}
 
-		GFX_THROW_INFO(D3DReadFileToBlob(L"VertexShader.cso", &vertexShaderBlob));
+void Graphics::FlushQueue()
+{
+	pSubmitter->Flush(ToMatrix4(GetViewProjection()));
+}
 
-		D3D11_PRIMITIVE_TOPOLOGY topology = { D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST };
-		pContext->IASetPrimitiveTopology(topology);
+DirectX::XMMATRIX Graphics::GetViewProjection() const noexcept
+{
+	const DirectX::XMVECTOR eyePosition = DirectX::XMVectorSet(xPos, yPos, zPos, 0.0f);
+	const DirectX::XMVECTOR focusPoint = DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
+	const DirectX::XMVECTOR upDirection = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	return DirectX::XMMatrixLookAtLH(eyePosition, focusPoint, upDirection) *
+		DirectX::XMMatrixPerspectiveLH(1.f, 3.f / 4.f, 0.5f, SceneSubmitter::farZ);
+}
 
-		pDevice->CreateVertexShader(vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize(), nullptr, &vertexShader);
+const StateFilter::Stats& Graphics::GetStateStats() const noexcept
+{
+	return pStateFilter->GetLastFrameStats();
+}
 
-		pContext->PSSetShader(pixelShader.Get(), nullptr, 0u);
-		pContext->VSSetShader(vertexShader.Get(), nullptr, 0u);
+D3D11PipelineCache::Stats Graphics::GetPipelineStats() const noexcept
+{
+	return pPipelineCache->GetStats();
+}
 
-		UINT stride = sizeof(Vertex);
-		UINT offset = 0;
+const OcclusionCuller::Stats& Graphics::GetOcclusionStats() const noexcept
+{
+	return pSubmitter->GetOcclusionStats();
+}
 
-		D3D11_BUFFER_DESC cBuffer{};
-		cBuffer.ByteWidth = sizeof(matrix);
-		cBuffer.Usage = D3D11_USAGE_DYNAMIC;
-		cBuffer.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		cBuffer.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		cBuffer.StructureByteStride = 0;
+JobSystem& Graphics::GetJobSystem() noexcept
+{
+	return jobs;
+}
 
-		D3D11_SUBRESOURCE_DATA cbsrd{};
-		cbsrd.pSysMem = &matrix;
+FramePacer& Graphics::GetFramePacer() noexcept
+{
+	return pacer;
+}
 
-		GFX_THROW_INFO(pDevice->CreateBuffer(&cBuffer, &cbsrd, &constantBuffer));
+FrameTelemetry& Graphics::GetTelemetry() noexcept
+{
+	return telemetry;
+}
 
-		pContext->VSSetConstantBuffers(0u, 1u, constantBuffer.GetAddressOf());
-		pContext->IASetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0u);
-		pContext->IASetVertexBuffers(0u, 1u, vertexBuffer.GetAddressOf(), &stride, &offset);
+void Graphics::SetMetricsServer(MetricsServer* pServer) noexcept
+{
+	pMetrics = pServer;
+}
 
-		D3D11_INPUT_ELEMENT_DESC ied[] =
-		{
-			{ "Position", 0u, DXGI_FORMAT_R32G32B32_FLOAT, 0u, 0u, D3D11_INPUT_PER_VERTEX_DATA, 0u },
-			{ "Color", 0u, DXGI_FORMAT_B8G8R8A8_UNORM, 0u, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0u }
-		};
+void Graphics::RequestCapture(unsigned int frames, std::string path)
+{
+	pCapturer->Request(frames, std::move(path));
+}
 
-		GFX_THROW_INFO(pDevice->CreateInputLayout(ied, _countof(ied), vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize(), &inputLayout));
+ShaderBytecode Graphics::LoadShader(const char* name, wrl::ComPtr<ID3DBlob>& pFallbackBlob)
+{
+	if (const auto code = shaderArchive.Find(name))
+	{
+		return *code;
+	}
+	// loose .cso from the working directory, only when no archive was packed
+	HRESULT hr;
+	const std::wstring path = std::wstring(name, name + std::strlen(name)) + L".cso";
+	GFX_THROW_INFO(D3DReadFileToBlob(path.c_str(), &pFallbackBlob));
+	return { pFallbackBlob->GetBufferPointer(),pFallbackBlob->GetBufferSize() };
+}
 
-		pContext->IASetInputLayout(inputLayout.Get());
-		init = true;
+void Graphics::InitCubePipeline()
+{
+	if (pSubmitter)
+	{
+		return;
+	}
+	HRESULT hr;
+	const Mesh& cube = Geometry::ColoredCube();
+	D3D11_BUFFER_DESC vertexBufferDesc{};
+	vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	vertexBufferDesc.ByteWidth = UINT(cube.GetVertexDataSize());
+	vertexBufferDesc.StructureByteStride = UINT(cube.GetVertexStride());
+	vertexBufferDesc.CPUAccessFlags = 0u;
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+	D3D11_SUBRESOURCE_DATA sd{};
+	sd.pSysMem = cube.GetVertexData();
+
+	GFX_THROW_INFO(pDevice->CreateBuffer(&vertexBufferDesc, &sd, &vertexBuffer));
+
+	D3D11_BUFFER_DESC indexBufferDesc{};
+	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.StructureByteStride = cube.GetIndexFormat() == IndexFormat::Uint16 ? sizeof(UINT16) : sizeof(UINT);
+	indexBufferDesc.ByteWidth = UINT(cube.GetIndexDataSize());
+	indexBufferDesc.CPUAccessFlags = 0u;
+	sd = {};
+	sd.pSysMem = cube.GetIndexData();
+
+	GFX_THROW_INFO(pDevice->CreateBuffer(&indexBufferDesc, &sd, &indexBuffer));
+
+	wrl::ComPtr<ID3DBlob> pixelShaderBlob;
+	const ShaderBytecode pixelShaderCode = LoadShader("PixelShader", pixelShaderBlob);
+	wrl::ComPtr<ID3DBlob> vertexShaderBlob;
+	const ShaderBytecode vertexShaderCode = LoadShader("VertexShader", vertexShaderBlob);
+
+	// single identity instance lets plain object draws go through the instanced input layout
+	DirectX::XMFLOAT4X4 identity;
+	DirectX::XMStoreFloat4x4(&identity, DirectX::XMMatrixIdentity());
+	D3D11_BUFFER_DESC identityDesc{};
+	identityDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	identityDesc.ByteWidth = sizeof(identity);
+	identityDesc.StructureByteStride = sizeof(identity);
+	identityDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	sd = {};
+	sd.pSysMem = &identity;
+
+	GFX_THROW_INFO(pDevice->CreateBuffer(&identityDesc, &sd, &identityInstanceBuffer));
+
+	// same-material runs of cubes stream their world matrices from here, written with no-overwrite maps
+	D3D11_BUFFER_DESC instanceRingDesc{};
+	instanceRingDesc.Usage = D3D11_USAGE_DYNAMIC;
+	instanceRingDesc.ByteWidth = UINT(SceneSubmitter::instanceRingSize);
+	instanceRingDesc.StructureByteStride = sizeof(DirectX::XMFLOAT4X4);
+	instanceRingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	instanceRingDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	GFX_THROW_INFO(pDevice->CreateBuffer(&instanceRingDesc, nullptr, &instanceRingBuffer));
+
+	// slot 0 streams cube vertices, slot 1 streams one row-major world matrix per instance
+	std::vector<InputElementDesc> ied = VertexQuantization::MakeInputElements(Geometry::coloredVertexFormat, 0u);
+	for (uint32_t row = 0; row < 4u; row++)
+	{
+		ied.push_back({ "World",row,DXGI_FORMAT_R32G32B32A32_FLOAT,1u,row * 16u,true,1u });
 	}
 
-	DirectX::XMVECTOR v = DirectX::XMVectorSet(3.0f, 3.0f, 0.0f, 0.0f);
-	DirectX::XMVECTOR scalar = DirectX::XMVector4Dot(v, v);
-	float res = DirectX::XMVectorGetX(scalar);
-	DirectX::XMVerifyCPUSupport();
-
-	// 1
-	DirectX::XMVECTOR eyePosition = DirectX::XMVectorSet(xPos, yPos, zPos, 0.0f);
-	DirectX::XMVECTOR focusPoint = DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
-	DirectX::XMVECTOR upDirection = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-	matrix = DirectX::XMMatrixTranspose(
-		DirectX::XMMatrixRotationZ(theta) *
-		DirectX::XMMatrixTranslation(x, y, 0.0f) *
-		DirectX::XMMatrixLookAtLH(eyePosition, focusPoint, upDirection) *
-		DirectX::XMMatrixPerspectiveLH(1.f, 3.f / 4.f, 0.5f, 10.f)
-	);
-
-	D3D11_MAPPED_SUBRESOURCE msr{};
-	pContext->Map(constantBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &msr);
-	memcpy(msr.pData, &matrix, sizeof(matrix));
-	pContext->Unmap(constantBuffer.Get(), 0u);
-
-	pContext->VSSetConstantBuffers(0u, 1u, constantBuffer.GetAddressOf());
-
-	pContext->OMSetRenderTargets(1u, pTarget.GetAddressOf(), pDSV.Get());
-
-	pContext->DrawIndexed(indicesCount, 0u, 0u);
-
-	// 2
-	matrix = DirectX::XMMatrixTranspose(
-		DirectX::XMMatrixRotationZ(theta2) *
-		DirectX::XMMatrixRotationX(theta2) *
-		DirectX::XMMatrixScaling(0.1f, 0.1f, 0.1f) *
-		DirectX::XMMatrixTranslation(0.0f, 0.0f, 6.0f) *
-		DirectX::XMMatrixPerspectiveFovLH(80.f, 800.f / 600.f, 0.1, 100.f)
-	);
-
-	pContext->Map(constantBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &msr);
-	memcpy(msr.pData, &matrix, sizeof(matrix));
-	pContext->Unmap(constantBuffer.Get(), 0u);
-
-	pContext->VSSetConstantBuffers(0u, 1u, constantBuffer.GetAddressOf());
-
-	pContext->DrawIndexed(indicesCount, 0u, 0u);
+	PipelineDesc pipelineDesc;
+	pipelineDesc.vertexShader = vertexShaderCode;
+	pipelineDesc.pixelShader = pixelShaderCode;
+	pipelineDesc.pInputElements = ied.data();
+	pipelineDesc.inputElementCount = ied.size();
+	// default depth state: depth test LESS with writes, no stencil
+	pCubePipeline = pPipelineCache->GetPipeline(pipelineDesc);
+
+	// everything from here on goes through the state filter by handle
+	SceneSubmitter::Resources resources;
+	resources.inputLayout = ToHandle(pCubePipeline->inputLayout.Get());
+	resources.vertexShader = ToHandle(pCubePipeline->vertexShader.Get());
+	resources.pixelShader = ToHandle(pCubePipeline->pixelShader.Get());
+	resources.depthStencilState = ToHandle(pCubePipeline->depthStencilState.Get());
+	resources.target = ToHandle(pTarget.Get());
+	resources.depth = ToHandle(pDSV.Get());
+	resources.vertexBuffer = ToHandle(vertexBuffer.Get());
+	resources.vertexStride = unsigned(cube.GetVertexStride());
+	resources.indexBuffer = ToHandle(indexBuffer.Get());
+	resources.indexFormat = cube.GetIndexFormat();
+	resources.indexCount = unsigned(cube.GetIndexCount());
+	resources.identityInstances = ToHandle(identityInstanceBuffer.Get());
+	resources.instanceRing = ToHandle(instanceRingBuffer.Get());
+	// null without the 11.1 runtime, the submitter then renames the per slot buffers instead
+	resources.constantRing = ToHandle(constantRingBuffer.Get());
+	for (unsigned int i = 0; i < SceneSubmitter::constantSlotCount; i++)
+	{
+		resources.constantSlots[i] = ToHandle(fallbackConstantBuffers[i].Get());
+	}
+	pSubmitter = std::make_unique<SceneSubmitter>(*pStateFilter, resources, &jobs);
+	pSubmitter->AddResources(pCapturer->GetCapture());
 }
 
 
@@ -387,4 +529,4 @@ std::string Graphics::HrException::GetErrorInfo() const noexcept
 const char* Graphics::DeviceRemovedException::GetType() const noexcept
 {
 	return "Chili Graphics Exception [Device Removed] (DXGI_ERROR_DEVICE_REMOVED)";
-}
+}
\ No newline at end of file
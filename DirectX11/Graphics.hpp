@@ -1,14 +1,30 @@
 #pragma once
 #include "ChiliWin.hpp"
 #include "ChiliException.hpp"
-#include <d3d11.h>
+#include <d3d11_1.h>
 #include <wrl.h>
 #include <vector>
 #include "DxgiInfoManager.hpp"
+#include "D3D11RenderContext.hpp"
+#include "D3D11PipelineCache.hpp"
+#include "ShaderArchive.hpp"
+#include "Geometry.hpp"
+#include "StateFilter.hpp"
+#include "RecordingRenderContext.hpp"
+#include "FrameCapture.hpp"
+#include "SceneSubmitter.hpp"
+#include "JobSystem.hpp"
+#include "RenderThread.hpp"
+#include "FramePacer.hpp"
+#include "FrameTelemetry.hpp"
+#include "ChiliTimer.hpp"
+#include "MetricsServer.hpp"
+#include <dxgi1_3.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
+#include <memory>
 
-class Graphics
+class Graphics : public IFrameRenderer
 {
 public:
 	class Exception : public ChiliException
@@ -41,31 +57,85 @@ public:
 	Graphics(HWND hWnd);
 	Graphics(const Graphics&) = delete;
 	Graphics& operator=(const Graphics&) = delete;
-	~Graphics() = default;
-	void EndFrame();
-	void ClearBuffer(float red, float green, float blue) noexcept;
-	void DrawTestTriangle(float x, float y);
+	~Graphics();
+	void EndFrame() override;
+	RendererStats GetFrameStats() const override;
+	void ClearBuffer(float red, float green, float blue) noexcept override;
+	void SetCamera(float x, float y, float z) noexcept override;
+	// queues every cube of the snapshot and flushes the queue
+	void DrawScene(const FrameSnapshot& scene) override;
+	// queued cubes are frustum and occlusion culled, sorted by draw key and drawn on FlushQueue
+	// (or at the latest in EndFrame); occluders are rasterized into the software depth buffer first.
+	// material is a Geometry::MaterialTint id
+	void QueueCube(const DirectX::XMFLOAT4X4& world, bool occluder = false, uint16_t material = 0u);
+	void FlushQueue();
+	DirectX::XMMATRIX GetViewProjection() const noexcept;
+	// issued vs. elided binds of the last presented frame
+	const StateFilter::Stats& GetStateStats() const noexcept;
+	// pipeline cache hits / misses since startup
+	D3D11PipelineCache::Stats GetPipelineStats() const noexcept;
+	// occludees tested / culled by the last FlushQueue
+	const OcclusionCuller::Stats& GetOcclusionStats() const noexcept;
+	// worker pool for frame work on the CPU side (culling, transforms, command building, asset work)
+	JobSystem& GetJobSystem() noexcept;
+	// pacing mode of EndFrame, safe to switch from any thread
+	FramePacer& GetFramePacer() noexcept;
+	// frame / present / message pump histograms; Present is recorded here by EndFrame, the other
+	// channels by whoever runs the frame loop
+	FrameTelemetry& GetTelemetry() noexcept;
+	// EndFrame publishes the counters of every presented frame to pServer (nullptr stops it);
+	// set it before the first frame or from the thread that calls EndFrame
+	void SetMetricsServer(MetricsServer* pServer) noexcept;
+	// writes the calls of the next frames frames, with the resources they use, to path as a
+	// FrameCapture for offline replay; safe from any thread
+	void RequestCapture(unsigned int frames, std::string path);
 
 	float xPos = 0.0f;
 	float yPos = 0.0f;
 	float zPos = -5.0f;
 private:
+	// archive view when the shader was packed, otherwise reads <name>.cso into pFallbackBlob
+	ShaderBytecode LoadShader(const char* name, Microsoft::WRL::ComPtr<ID3DBlob>& pFallbackBlob);
+	// creates the cube buffers and pipeline and hands them to the scene submitter
+	void InitCubePipeline();
+	// blocks until the swap chain can queue another frame, at the latency the pacing mode asks for
+	void WaitForFrameLatency();
+private:
+	// the constant ring recycles a frame's slices this many frames later, the swap chain latency must match
+	static constexpr UINT framesInFlight = SceneSubmitter::framesInFlight;
 #ifndef NDEBUG
 	DxgiInfoManager infoManager;
 #endif
 	Microsoft::WRL::ComPtr<ID3D11Device> pDevice;
 	Microsoft::WRL::ComPtr<IDXGISwapChain> pSwap;
+	Microsoft::WRL::ComPtr<IDXGISwapChain2> pSwap2;
+	HANDLE frameLatencyWaitable = nullptr;
+	UINT frameLatency = framesInFlight;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> pContext;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> pContext1;
 	Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pTarget;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
-	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader;
-	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> constantRingBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> fallbackConstantBuffers[SceneSubmitter::constantSlotCount];
+	Microsoft::WRL::ComPtr<ID3D11Buffer> instanceRingBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> identityInstanceBuffer;
 	Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDSV;
 	Microsoft::WRL::ComPtr<ID3D11Texture2D> depthTexture;
-	Microsoft::WRL::ComPtr<ID3D11DepthStencilState> pDSState;
-	DirectX::XMMATRIX matrix;
-	UINT indicesCount = 0;
+	std::unique_ptr<D3D11RenderContext> pRenderContext;
+	// between the state filter and the device, only records while a capture runs
+	std::unique_ptr<RecordingRenderContext> pRecording;
+	std::unique_ptr<FrameCapturer> pCapturer;
+	std::unique_ptr<StateFilter> pStateFilter;
+	std::unique_ptr<D3D11PipelineCache> pPipelineCache;
+	std::shared_ptr<const D3D11PipelineCache::Pipeline> pCubePipeline;
+	std::unique_ptr<SceneSubmitter> pSubmitter;
+	ShaderArchive shaderArchive;
+	SystemClock clock;
+	FramePacer pacer;
+	FrameTelemetry telemetry;
+	ChiliTimer presentTimer;
+	MetricsServer* pMetrics = nullptr;
+	uint64_t framesPresented = 0u;
+	JobSystem jobs;
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "HdrHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	unsigned int Log2Floor(uint64_t value) noexcept
+	{
+		unsigned int n = 0u;
+		while (value >>= 1u)
+		{
+			n++;
+		}
+		return n;
+	}
+
+	unsigned int Log2Ceil(uint64_t value) noexcept
+	{
+		const unsigned int floor = Log2Floor(value);
+		return (uint64_t(1) << floor) == value ? floor : floor + 1u;
+	}
+
+	// value is never 0 here, the sub bucket mask is or-ed in
+	unsigned int CountLeadingZeros(uint64_t value) noexcept
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index = 0u;
+		_BitScanReverse64(&index, value);
+		return 63u - unsigned(index);
+#elif defined(_MSC_VER)
+		// 32 bit targets only have the 32 bit scan, take the high half when it has a bit set
+		unsigned long index = 0u;
+		if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+		{
+			return 31u - unsigned(index);
+		}
+		_BitScanReverse(&index, static_cast<unsigned long>(value));
+		return 63u - unsigned(index);
+#else
+		return unsigned(__builtin_clzll(value));
+#endif
+	}
+}
+
+HdrHistogram::HdrHistogram(int64_t lowest, int64_t highest, unsigned int significantDigits)
+	:
+	lowest(std::max<int64_t>(lowest, 1)),
+	highest(std::max(highest, 2 * std::max<int64_t>(lowest, 1))),
+	min(std::numeric_limits<int64_t>::max())
+{
+	significantDigits = std::clamp(significantDigits, 1u, 5u);
+	// enough linear sub buckets per power of two to resolve one unit in 10^digits
+	uint64_t largestSingleUnitValue = 2u;
+	for (unsigned int i = 0; i < significantDigits; i++)
+	{
+		largestSingleUnitValue *= 10u;
+	}
+	const unsigned int subBucketCountMagnitude = Log2Ceil(largestSingleUnitValue);
+	subBucketHalfCountMagnitude = subBucketCountMagnitude - 1u;
+	unitMagnitude = Log2Floor(uint64_t(this->lowest));
+	const int64_t subBucketCount = int64_t(1) << subBucketCountMagnitude;
+	subBucketHalfCount = subBucketCount / 2;
+	subBucketMask = (subBucketCount - 1) << unitMagnitude;
+
+	// every further bucket covers twice the range of the one before
+	int64_t smallestUntrackable = subBucketCount << unitMagnitude;
+	size_t bucketCount = 1u;
+	while (smallestUntrackable <= this->highest)
+	{
+		if (smallestUntrackable > std::numeric_limits<int64_t>::max() / 2)
+		{
+			bucketCount++;
+			break;
+		}
+		smallestUntrackable <<= 1;
+		bucketCount++;
+	}
+	countsLength = (bucketCount + 1u) * size_t(subBucketHalfCount);
+	pCounts = std::make_unique<std::atomic<uint64_t>[]>(countsLength);
+	Reset();
+}
+
+void HdrHistogram::Record(int64_t value) noexcept
+{
+	value = std::clamp(value, lowest, highest);
+	Add(pCounts[CountsIndex(value)], 1u);
+	Add(total, 1u);
+	Add(sum, uint64_t(value));
+	if (value < min.load(std::memory_order_relaxed))
+	{
+		min.store(value, std::memory_order_relaxed);
+	}
+	if (value > max.load(std::memory_order_relaxed))
+	{
+		max.store(value, std::memory_order_relaxed);
+	}
+}
+
+void HdrHistogram::Reset() noexcept
+{
+	for (size_t i = 0; i < countsLength; i++)
+	{
+		pCounts[i].store(0u, std::memory_order_relaxed);
+	}
+	total.store(0u, std::memory_order_relaxed);
+	sum.store(0u, std::memory_order_relaxed);
+	min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t HdrHistogram::GetCount() const noexcept
+{
+	return total.load(std::memory_order_relaxed);
+}
+
+int64_t HdrHistogram::GetMin() const noexcept
+{
+	return GetCount() != 0u ? min.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t HdrHistogram::GetMax() const noexcept
+{
+	return max.load(std::memory_order_relaxed);
+}
+
+double HdrHistogram::GetMean() const noexcept
+{
+	const uint64_t n = GetCount();
+	return n != 0u ? double(sum.load(std::memory_order_relaxed)) / double(n) : 0.0;
+}
+
+int64_t HdrHistogram::GetValueAtPercentile(double percentile) const noexcept
+{
+	const uint64_t n = GetCount();
+	if (n == 0u)
+	{
+		return 0;
+	}
+	const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+	const uint64_t wanted = std::max<uint64_t>(uint64_t(std::ceil(fraction * double(n))), 1u);
+	uint64_t seen = 0u;
+	for (size_t i = 0; i < countsLength; i++)
+	{
+		seen += pCounts[i].load(std::memory_order_relaxed);
+		if (seen >= wanted)
+		{
+			// the top of the bucket, but never outside what was actually recorded
+			return std::clamp(HighestEquivalentValue(ValueFromIndex(i)), GetMin(), GetMax());
+		}
+	}
+	return GetMax();
+}
+
+size_t HdrHistogram::GetBucketCount() const noexcept
+{
+	return countsLength;
+}
+
+size_t HdrHistogram::CountsIndex(int64_t value) const noexcept
+{
+	const unsigned int pow2Ceiling = 64u - CountLeadingZeros(uint64_t(value | subBucketMask));
+	const unsigned int bucket = pow2Ceiling - unitMagnitude - (subBucketHalfCountMagnitude + 1u);
+	const int64_t subBucket = value >> (bucket + unitMagnitude);
+	return (size_t(bucket + 1u) << subBucketHalfCountMagnitude) + size_t(subBucket - subBucketHalfCount);
+}
+
+int64_t HdrHistogram::ValueFromIndex(size_t index) const noexcept
+{
+	int64_t bucket = int64_t(index >> subBucketHalfCountMagnitude) - 1;
+	int64_t subBucket = int64_t(index & size_t(subBucketHalfCount - 1)) + subBucketHalfCount;
+	if (bucket < 0)
+	{
+		subBucket -= subBucketHalfCount;
+		bucket = 0;
+	}
+	return subBucket << (bucket + unitMagnitude);
+}
+
+int64_t HdrHistogram::HighestEquivalentValue(int64_t value) const noexcept
+{
+	// bucket width at value: one unit in the first bucket, doubling with every bucket after it
+	const unsigned int pow2Ceiling = 64u - CountLeadingZeros(uint64_t(value | subBucketMask));
+	const unsigned int bucket = pow2Ceiling - unitMagnitude - (subBucketHalfCountMagnitude + 1u);
+	const int64_t width = int64_t(1) << (unitMagnitude + bucket);
+	return (value & ~(width - 1)) + width - 1;
+}
+
+void HdrHistogram::Add(std::atomic<uint64_t>& counter, uint64_t n) noexcept
+{
+	counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
\ No newline at end of file
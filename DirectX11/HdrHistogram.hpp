@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// high dynamic range histogram (log-linear buckets, after Gil Tene's HdrHistogram): every value from
+// lowest to highest is counted with a relative error below 10^-significantDigits, in fixed memory.
+// all storage is allocated by the constructor, Record never allocates. one thread records, any
+// thread may read; a read racing the writer sees a slightly stale but consistent enough view
+class HdrHistogram
+{
+public:
+	HdrHistogram(int64_t lowest, int64_t highest, unsigned int significantDigits = 3u);
+	// values outside [lowest, highest] are clamped into it
+	void Record(int64_t value) noexcept;
+	void Reset() noexcept;
+	uint64_t GetCount() const noexcept;
+	int64_t GetMin() const noexcept;
+	int64_t GetMax() const noexcept;
+	double GetMean() const noexcept;
+	// smallest recorded value that percentile percent of all values are at or below, percentile in [0,100]
+	int64_t GetValueAtPercentile(double percentile) const noexcept;
+	size_t GetBucketCount() const noexcept;
+private:
+	size_t CountsIndex(int64_t value) const noexcept;
+	int64_t ValueFromIndex(size_t index) const noexcept;
+	int64_t HighestEquivalentValue(int64_t value) const noexcept;
+	// single writer, so plain relaxed load + store instead of a locked add
+	static void Add(std::atomic<uint64_t>& counter, uint64_t n) noexcept;
+private:
+	int64_t lowest;
+	int64_t highest;
+	unsigned int unitMagnitude;
+	unsigned int subBucketHalfCountMagnitude;
+	int64_t subBucketHalfCount;
+	int64_t subBucketMask;
+	size_t countsLength;
+	std::unique_ptr<std::atomic<uint64_t>[]> pCounts;
+	std::atomic<uint64_t> total{ 0u };
+	std::atomic<uint64_t> sum{ 0u };
+	std::atomic<int64_t> min;
+	std::atomic<int64_t> max{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,485 @@
+#include "HeadlessBenchmark.hpp"
+#include "SoftwareGraphics.hpp"
+#include "NullGraphics.hpp"
+#include "FrameCapture.hpp"
+#include "FrameLoop.hpp"
+#include "InputScript.hpp"
+#include "HeadlessWindow.hpp"
+#include "HdrHistogram.hpp"
+#include "ChiliTimer.hpp"
+#include "Profiler.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#define HEADLESS_ARGUMENT_EXCEPT(note) HeadlessBenchmark::ArgumentException( __LINE__,__FILE__,(note) )
+
+namespace
+{
+	// 1ns .. 10s at 3 significant digits, the small tasks take less than a microsecond
+	struct Phase
+	{
+		explicit Phase(std::string name)
+			:
+			name(std::move(name))
+		{}
+		std::string name;
+		HdrHistogram histogram{ 1,10000000000,3u };
+	};
+
+	// metric name -> milliseconds, in the order they are reported and compared
+	std::vector<std::pair<const char*, double>> Metrics(const HdrHistogram& h)
+	{
+		return {
+			{ "min_ms",double(h.GetMin()) * 1e-6 },
+			{ "mean_ms",h.GetMean() * 1e-6 },
+			{ "p50_ms",double(h.GetValueAtPercentile(50.0)) * 1e-6 },
+			{ "p95_ms",double(h.GetValueAtPercentile(95.0)) * 1e-6 },
+			{ "p99_ms",double(h.GetValueAtPercentile(99.0)) * 1e-6 },
+			{ "p99_9_ms",double(h.GetValueAtPercentile(99.9)) * 1e-6 },
+			{ "max_ms",double(h.GetMax()) * 1e-6 }
+		};
+	}
+
+	// min and max are single samples and too noisy to gate on
+	bool IsGated(const std::string& metric)
+	{
+		return metric == "mean_ms" || metric == "p50_ms" || metric == "p95_ms" || metric == "p99_ms";
+	}
+
+	int64_t ToNs(float ms) noexcept
+	{
+		return int64_t(double(ms) * 1e6);
+	}
+
+	// writes and / or checks the baseline; 0 when nothing regressed beyond the tolerance
+	int CompareBaseline(const HeadlessBenchmark::Options& options, const std::map<std::string, double>& current, std::ostream& out)
+	{
+		if (!options.saveBaselinePath.empty())
+		{
+			// "phase metric value" per line
+			std::ofstream file(options.saveBaselinePath);
+			for (const auto& c : current)
+			{
+				file << c.first << ' ' << c.second << '\n';
+			}
+			out << "[Headless] baseline saved to " << options.saveBaselinePath << std::endl;
+		}
+
+		int result = 0;
+		if (!options.baselinePath.empty())
+		{
+			std::ifstream file(options.baselinePath);
+			if (!file)
+			{
+				out << "[Headless] cannot open baseline " << options.baselinePath << std::endl;
+				return 1;
+			}
+			std::string phase, metric;
+			double baseline = 0.0;
+			unsigned int compared = 0u;
+			while (file >> phase >> metric >> baseline)
+			{
+				const auto it = current.find(phase + ' ' + metric);
+				if (it == current.end() || !IsGated(metric))
+				{
+					continue;
+				}
+				compared++;
+				// sub 50us phases are timer noise, not something to fail a build over
+				const double limit = baseline * (1.0 + double(options.tolerance)) + 0.05;
+				if (it->second > limit)
+				{
+					out << "[Headless] regression phase=" << phase << " metric=" << metric
+						<< " baseline=" << baseline << " current=" << it->second
+						<< " change=" << (it->second / baseline - 1.0) * 100.0 << '%' << std::endl;
+					result = 1;
+				}
+			}
+			out << "[Headless] compared=" << compared << " tolerance=" << options.tolerance * 100.0f << "% "
+				<< (result == 0 ? "PASS" : "FAIL") << std::endl;
+		}
+		return result;
+	}
+
+	// the capture on every backend that runs without a device, each on fresh resources: the null
+	// context alone, behind a state filter and behind a recorder. the null pass is repeated with
+	// per call timing for the op breakdown
+	int ReplayCapture(const HeadlessBenchmark::Options& options, std::ostream& out)
+	{
+		const FrameCapture capture = FrameCapture::Load(options.replayPath);
+		const std::vector<FrameCapture::Resource>& resources = capture.GetResources();
+		size_t calls = 0u;
+		for (size_t i = 0; i < capture.GetFrameCount(); i++)
+		{
+			calls += capture.DecodeFrame(i).size();
+		}
+		out << "[Replay] file=" << options.replayPath
+			<< " frames=" << capture.GetFrameCount()
+			<< " resources=" << resources.size()
+			<< " calls=" << calls
+			<< " bytes=" << capture.GetByteSize() << std::endl;
+
+		std::map<std::string, double> current;
+		const auto report = [&out, &current](const char* backend, const FrameCapture::ReplayStats& stats)
+		{
+			HdrHistogram histogram(1, 10000000000, 3u);
+			for (const int64_t ns : stats.frameNs)
+			{
+				histogram.Record(ns);
+			}
+			out << "[Replay] backend=" << backend;
+			for (const auto& m : Metrics(histogram))
+			{
+				out << ' ' << m.first << '=' << m.second;
+				current[std::string("replay_") + backend + ' ' + m.first] = m.second;
+			}
+			out << std::endl;
+		};
+		{
+			NullRenderContext context;
+			report("null", capture.Replay(context, FrameCapture::NullFactory(context)));
+		}
+		{
+			NullRenderContext context;
+			StateFilter filter(context);
+			report("state_filter", capture.Replay(filter, FrameCapture::NullFactory(context)));
+		}
+		{
+			NullRenderContext context;
+			RecordingRenderContext recording(context);
+			report("recording", capture.Replay(recording, FrameCapture::NullFactory(context)));
+		}
+
+		NullRenderContext context;
+		const FrameCapture::ReplayStats timed = capture.Replay(context, FrameCapture::NullFactory(context), true);
+		for (size_t i = 0; i < timed.calls.size(); i++)
+		{
+			if (timed.calls[i] == 0u)
+			{
+				continue;
+			}
+			out << "[Replay] op=" << RecordingRenderContext::GetOpName(RecordingRenderContext::Op(i))
+				<< " calls=" << timed.calls[i]
+				<< " total_ms=" << double(timed.callNs[i]) * 1e-6
+				<< " ns_per_call=" << double(timed.callNs[i]) / double(timed.calls[i]) << std::endl;
+		}
+		return CompareBaseline(options, current, out);
+	}
+}
+
+HeadlessBenchmark::Options HeadlessBenchmark::ParseArguments(int argc, const char* const* argv)
+{
+	Options options;
+	for (int i = 0; i < argc; i++)
+	{
+		const char* const arg = argv[i];
+		if (std::strcmp(arg, "--headless") == 0)
+		{
+			continue;
+		}
+		// the stress options are read by StressScene::ParseArguments below
+		const int stressValues = StressScene::GetArgumentValueCount(arg);
+		if (stressValues >= 0)
+		{
+			if (i + stressValues >= argc)
+			{
+				throw HEADLESS_ARGUMENT_EXCEPT(std::string(arg) + " needs a value");
+			}
+			i += stressValues;
+			continue;
+		}
+		const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+		const auto option = [arg, value](const char* name)
+		{
+			if (std::strcmp(arg, name) != 0)
+			{
+				return false;
+			}
+			if (!value)
+			{
+				throw HEADLESS_ARGUMENT_EXCEPT(std::string(name) + " needs a value");
+			}
+			return true;
+		};
+		if (option("--backend"))
+		{
+			if (std::strcmp(value, "software") != 0 && std::strcmp(value, "null") != 0)
+			{
+				throw HEADLESS_ARGUMENT_EXCEPT(std::string("unknown backend ") + value);
+			}
+			options.backend = std::strcmp(value, "null") == 0 ? Backend::Null : Backend::Software;
+		}
+		else if (option("--frames"))
+		{
+			options.frames = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (option("--seconds"))
+		{
+			options.seconds = std::strtof(value, nullptr);
+		}
+		else if (option("--warmup"))
+		{
+			options.warmupFrames = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (option("--threads"))
+		{
+			options.threads = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (option("--size"))
+		{
+			char* pEnd = nullptr;
+			options.width = unsigned(std::strtoul(value, &pEnd, 10));
+			options.height = *pEnd == 'x' ? unsigned(std::strtoul(pEnd + 1, nullptr, 10)) : options.height;
+		}
+		else if (option("--script"))
+		{
+			options.scriptPath = value;
+		}
+		else if (option("--baseline"))
+		{
+			options.baselinePath = value;
+		}
+		else if (option("--save-baseline"))
+		{
+			options.saveBaselinePath = value;
+		}
+		else if (option("--tolerance"))
+		{
+			options.tolerance = std::strtof(value, nullptr);
+		}
+		else if (option("--capture"))
+		{
+			options.capturePath = value;
+		}
+		else if (option("--capture-frames"))
+		{
+			options.captureFrames = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (option("--replay"))
+		{
+			options.replayPath = value;
+		}
+		else
+		{
+			throw HEADLESS_ARGUMENT_EXCEPT(std::string("unknown argument ") + arg);
+		}
+		i++;
+	}
+	options.stress = StressScene::ParseArguments(argc, argv, options.stressSettings);
+	options.frames = options.frames == 0u ? 1u : options.frames;
+	options.width = options.width == 0u ? 800u : options.width;
+	options.height = options.height == 0u ? 600u : options.height;
+	return options;
+}
+
+void HeadlessBenchmark::WriteUsage(std::ostream& out)
+{
+	out << "frame loop options:" << std::endl
+		<< "  --backend software|null  rasterize on the CPU, or time culling and submission alone" << std::endl
+		<< "  --frames N               measured frames after the warmup (1000)" << std::endl
+		<< "  --seconds S              run for S seconds instead of a frame count" << std::endl
+		<< "  --warmup N               frames before measuring (60)" << std::endl
+		<< "  --threads N              worker threads, 0 = every hardware thread" << std::endl
+		<< "  --size WxH               software framebuffer size (800x600)" << std::endl
+		<< "  --script file            input script, see InputScript::Load" << std::endl
+		<< "  --baseline file          compare against a saved baseline, non-zero exit on regression" << std::endl
+		<< "  --save-baseline file     store this run as a baseline" << std::endl
+		<< "  --tolerance T            allowed slowdown against the baseline (0.1 = 10%)" << std::endl
+		<< "  --capture file           null backend: capture frames after the warmup" << std::endl
+		<< "  --capture-frames N       frames to capture (60)" << std::endl
+		<< "  --replay file            replay a capture on every device-free backend" << std::endl
+		<< "stress scene options:" << std::endl
+		<< "  --stress N               N cubes in place of the test scene" << std::endl
+		<< "  --distribution grid|sphere|clusters" << std::endl
+		<< "  --materials N            distinct tints (8)" << std::endl
+		<< "  --occluders N            every N-th cube is an occluder" << std::endl
+		<< "  --seed N                 placement seed" << std::endl
+		<< "  --static                 no animation" << std::endl;
+}
+
+int HeadlessBenchmark::Run(const Options& options, std::ostream& out)
+{
+	PROFILE_THREAD("main");
+	if (!options.replayPath.empty())
+	{
+		return ReplayCapture(options, out);
+	}
+	const InputScript script = options.scriptPath.empty() ? InputScript::Default() : InputScript::Load(options.scriptPath);
+	std::unique_ptr<SoftwareGraphics> pSoftware;
+	std::unique_ptr<NullGraphics> pNull;
+	if (options.backend == Backend::Null)
+	{
+		pNull = std::make_unique<NullGraphics>(false, options.threads);
+	}
+	else
+	{
+		pSoftware = std::make_unique<SoftwareGraphics>(options.width, options.height, options.threads);
+	}
+	IFrameRenderer& gfx = pNull ? static_cast<IFrameRenderer&>(*pNull) : *pSoftware;
+	JobSystem& jobs = pNull ? pNull->GetJobSystem() : pSoftware->GetJobSystem();
+	// the script types into a window and the frame loop reads that window's keyboard and mouse,
+	// the same input path App takes
+	HeadlessWindow wnd(int(options.width), int(options.height), "HeadlessBench");
+	unsigned long long frame = 0u;
+	FrameLoop frameLoop(gfx, jobs, [&wnd](FrameInput& input)
+	{
+		FrameLoop::ReadControls(wnd, input);
+	});
+	std::unique_ptr<StressScene> pStress;
+	if (options.stress)
+	{
+		pStress = std::make_unique<StressScene>(options.stressSettings);
+		frameLoop.SetStressScene(pStress.get());
+	}
+
+	// whole frame, the frame graph tasks, then the render thread side
+	const FrameGraph& graph = frameLoop.GetFrameGraph();
+	std::vector<std::unique_ptr<Phase>> phases;
+	phases.push_back(std::make_unique<Phase>("frame"));
+	for (const FrameGraph::TaskId task : graph.GetSchedule())
+	{
+		phases.push_back(std::make_unique<Phase>(graph.GetTaskName(task)));
+	}
+	const size_t waitPhase = phases.size();
+	phases.push_back(std::make_unique<Phase>("sim_wait"));
+	phases.push_back(std::make_unique<Phase>("render"));
+	phases.push_back(std::make_unique<Phase>("draw_submit"));
+
+	ChiliTimer frameTimer;
+	ChiliTimer runTimer;
+	const unsigned long long total = options.seconds > 0.0f ? std::numeric_limits<unsigned long long>::max() :
+		options.warmupFrames + options.frames;
+	for (; frame < total; frame++)
+	{
+		if (frame == options.warmupFrames)
+		{
+			runTimer.Mark();
+			if (pNull && !options.capturePath.empty())
+			{
+				pNull->RequestCapture(options.captureFrames, options.capturePath);
+			}
+		}
+		else if (frame > options.warmupFrames && options.seconds > 0.0f && runTimer.Peek() >= options.seconds)
+		{
+			break;
+		}
+		frameTimer.Mark();
+		script.Post(frame, wnd);
+		if (wnd.ProcessMessages())
+		{
+			break;
+		}
+		{
+			PROFILE_ZONE("DoFrame");
+			frameLoop.DoFrame();
+		}
+		const int64_t frameNs = frameTimer.MarkNs();
+		if (frame < options.warmupFrames)
+		{
+			continue;
+		}
+		phases[0]->histogram.Record(frameNs);
+		const std::vector<FrameGraph::TaskId>& schedule = graph.GetSchedule();
+		for (size_t i = 0; i < schedule.size(); i++)
+		{
+			phases[i + 1u]->histogram.Record(ToNs(graph.GetTiming(schedule[i]).durationMs));
+		}
+		// the render thread reports the last frame it finished, usually the one before this
+		const RenderThread::Stats render = frameLoop.GetRenderStats();
+		phases[waitPhase]->histogram.Record(ToNs(render.waitMs));
+		phases[waitPhase + 1u]->histogram.Record(ToNs(render.renderMs));
+		phases[waitPhase + 2u]->histogram.Record(ToNs(render.renderer.submitMs));
+	}
+	frameLoop.Flush();
+	const float elapsed = runTimer.Peek();
+	const unsigned long long measured = frame - options.warmupFrames;
+
+	out << "[Headless] frames=" << measured << " seconds=" << elapsed
+		<< " fps=" << double(measured) / double(elapsed)
+		<< " backend=" << (pNull ? "null" : "software")
+		<< " threads=" << jobs.GetThreadCount()
+		<< " size=" << options.width << 'x' << options.height
+		<< " last_frame_draws=" << gfx.GetFrameStats().draws
+		<< " triangles=" << gfx.GetFrameStats().triangles;
+	if (pNull)
+	{
+		out << " binds_issued=" << pNull->GetStateStats().TotalIssued()
+			<< " binds_elided=" << pNull->GetStateStats().TotalElided() << std::endl;
+	}
+	else
+	{
+		out << " binned=" << pSoftware->GetRasterStats().trianglesBinned << std::endl;
+	}
+	if (!options.capturePath.empty())
+	{
+		if (!pNull)
+		{
+			out << "[Headless] --capture needs --backend null" << std::endl;
+		}
+		else if (pNull->GetCapturer().GetSavedPath().empty())
+		{
+			out << "[Headless] capture not written, run at least " << options.captureFrames << " frames" << std::endl;
+		}
+		else
+		{
+			out << "[Headless] capture of " << options.captureFrames << " frames saved to "
+				<< pNull->GetCapturer().GetSavedPath() << std::endl;
+		}
+	}
+	if (pStress)
+	{
+		const StressScene::Settings& stress = pStress->GetSettings();
+		out << "[Headless] stress count=" << pStress->GetCount()
+			<< " distribution=" << StressScene::GetDistributionName(stress.distribution)
+			<< " materials=" << stress.materials
+			<< " occluder_stride=" << stress.occluderStride
+			<< " animate=" << (stress.animate ? 1 : 0) << std::endl;
+	}
+	std::map<std::string, double> current;
+	for (const auto& pPhase : phases)
+	{
+		out << "[Headless] phase=" << pPhase->name;
+		for (const auto& m : Metrics(pPhase->histogram))
+		{
+			out << ' ' << m.first << '=' << m.second;
+			current[pPhase->name + ' ' + m.first] = m.second;
+		}
+		out << std::endl;
+	}
+
+	return CompareBaseline(options, current, out);
+}
+
+
+// argument exception stuff
+HeadlessBenchmark::ArgumentException::ArgumentException(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* HeadlessBenchmark::ArgumentException::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* HeadlessBenchmark::ArgumentException::GetType() const noexcept
+{
+	return "Headless Argument Exception";
+}
+
+const std::string& HeadlessBenchmark::ArgumentException::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
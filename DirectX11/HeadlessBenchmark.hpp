@@ -0,0 +1,67 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "StressScene.hpp"
+#include <ostream>
+#include <string>
+
+// App's frame loop without a display or a GPU: SoftwareGraphics (or NullGraphics, to time submission
+// alone) renders on the render thread and an InputScript drives the camera through a HeadlessWindow. reports min / mean / percentiles of the whole frame and of every
+// phase, and can store them as a baseline or compare against one to gate regressions. with a replay
+// file it replays a FrameCapture on each device-free backend instead and reports those times
+namespace HeadlessBenchmark
+{
+	enum class Backend
+	{
+		// rasterizes every frame on the CPU
+		Software,
+		// Graphics' culling and submission into a NullRenderContext, no pixels
+		Null
+	};
+	struct Options
+	{
+		Backend backend = Backend::Software;
+		// measured frames, after the warmup
+		unsigned int frames = 1000u;
+		// > 0 runs for this long instead of a frame count
+		float seconds = 0.0f;
+		unsigned int warmupFrames = 60u;
+		unsigned int width = 800u;
+		unsigned int height = 600u;
+		// worker threads, 0 = every hardware thread
+		unsigned int threads = 0u;
+		// empty uses InputScript::Default
+		std::string scriptPath;
+		std::string baselinePath;
+		std::string saveBaselinePath;
+		// allowed slowdown against the baseline, 0.1 = 10%
+		float tolerance = 0.1f;
+		// StressScene in place of the test scene
+		bool stress = false;
+		StressScene::Settings stressSettings;
+		// null backend only: captures captureFrames frames after the warmup into capturePath
+		std::string capturePath;
+		unsigned int captureFrames = 60u;
+		// replays this FrameCapture instead of running the frame loop
+		std::string replayPath;
+	};
+	// a command line ParseArguments cannot make sense of, the note names the argument
+	class ArgumentException : public ChiliException
+	{
+	public:
+		ArgumentException(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	// --backend software|null --frames N --seconds S --warmup N --threads N --size WxH --script file
+	// --baseline file --save-baseline file --tolerance T --capture file --capture-frames N
+	// --replay file, plus the StressScene options; --headless (WinMain's switch into this mode) is
+	// skipped, anything else or an option without its value throws ArgumentException
+	Options ParseArguments(int argc, const char* const* argv);
+	// the options above, one per line
+	void WriteUsage(std::ostream& out);
+	// 0 when nothing regressed beyond the tolerance (or there was no baseline), 1 otherwise
+	int Run(const Options& options, std::ostream& out);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "HeadlessBenchmark.hpp"
+#include "Benchmarks.hpp"
+#include "ChiliException.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	void WriteUsage(std::ostream& out)
+	{
+		out << "usage: HeadlessBench [options]   headless frame loop benchmark" << std::endl
+			<< "       HeadlessBench --bench     CPU micro benchmarks" << std::endl;
+		HeadlessBenchmark::WriteUsage(out);
+	}
+}
+
+// entry point of the windowless build (CMakeLists.txt): the headless frame loop benchmark,
+// or the micro benchmarks with --bench. the Windows build reaches both through WinMain
+int main(int argc, char* argv[])
+{
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			if (std::strcmp(argv[i], "--bench") == 0)
+			{
+				Benchmarks::RunAll(std::cout);
+				return 0;
+			}
+			if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0)
+			{
+				WriteUsage(std::cout);
+				return 0;
+			}
+		}
+		return HeadlessBenchmark::Run(HeadlessBenchmark::ParseArguments(argc - 1, argv + 1), std::cout);
+	}
+	catch (const HeadlessBenchmark::ArgumentException& e)
+	{
+		// a typo should not silently run a full benchmark
+		std::cerr << e.GetNote() << std::endl;
+		WriteUsage(std::cerr);
+	}
+	catch (const ChiliException& e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Standard Exception" << std::endl << e.what() << std::endl;
+	}
+	catch (...)
+	{
+		std::cerr << "Unknown Exception" << std::endl;
+	}
+	return 2;
+}
\ No newline at end of file
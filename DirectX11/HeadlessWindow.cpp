@@ -0,0 +1,154 @@
+#include "HeadlessWindow.hpp"
+#include "Profiler.hpp"
+
+HeadlessWindow::HeadlessWindow(int width, int height, const char* name)
+	:
+	PlatformWindow(width, height),
+	title(name)
+{}
+
+void HeadlessWindow::SetTitle(const std::string& title_in)
+{
+	title = title_in;
+}
+
+std::optional<int> HeadlessWindow::ProcessMessages()
+{
+	PROFILE_ZONE("ProcessMessages");
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		processing.swap(pending);
+	}
+	for (size_t i = 0; i < processing.size(); i++)
+	{
+		const Event& e = processing[i];
+		switch (e.type)
+		{
+		case Event::Type::KeyDown:
+			OnKeyDown(static_cast<unsigned char>(e.x), e.value != 0);
+			break;
+		case Event::Type::KeyUp:
+			OnKeyUp(static_cast<unsigned char>(e.x));
+			break;
+		case Event::Type::Char:
+			OnChar(static_cast<char>(e.value));
+			break;
+		case Event::Type::FocusLost:
+			OnFocusLost();
+			break;
+		case Event::Type::MouseMove:
+			OnMouseMove(e.x, e.y);
+			break;
+		case Event::Type::LeftDown:
+			OnLeftDown(e.x, e.y);
+			break;
+		case Event::Type::LeftUp:
+			OnLeftUp(e.x, e.y);
+			break;
+		case Event::Type::RightDown:
+			OnRightDown(e.x, e.y);
+			break;
+		case Event::Type::RightUp:
+			OnRightUp(e.x, e.y);
+			break;
+		case Event::Type::Wheel:
+			OnWheel(e.x, e.y, e.value);
+			break;
+		case Event::Type::Quit:
+		{
+			// like WM_QUIT: the pump returns at once, whatever follows stays queued for the next call
+			const int exitCode = e.value;
+			std::lock_guard<std::mutex> lock(mutex);
+			pending.insert(pending.begin(), processing.begin() + i + 1, processing.end());
+			processing.clear();
+			return exitCode;
+		}
+		}
+	}
+	processing.clear();
+	return {};
+}
+
+void* HeadlessWindow::GetNativeHandle() const noexcept
+{
+	return nullptr;
+}
+
+const std::string& HeadlessWindow::GetTitle() const noexcept
+{
+	return title;
+}
+
+void HeadlessWindow::PostKeyDown(unsigned char keycode, bool repeat)
+{
+	Post({ Event::Type::KeyDown,repeat ? 1 : 0,keycode,0 });
+}
+
+void HeadlessWindow::PostKeyUp(unsigned char keycode)
+{
+	Post({ Event::Type::KeyUp,0,keycode,0 });
+}
+
+void HeadlessWindow::PostChar(char character)
+{
+	Post({ Event::Type::Char,character,0,0 });
+}
+
+void HeadlessWindow::PostFocusLost()
+{
+	Post({ Event::Type::FocusLost,0,0,0 });
+}
+
+void HeadlessWindow::PostMouseMove(int x, int y)
+{
+	Post({ Event::Type::MouseMove,0,x,y });
+}
+
+void HeadlessWindow::PostLeftDown(int x, int y)
+{
+	Post({ Event::Type::LeftDown,0,x,y });
+}
+
+void HeadlessWindow::PostLeftUp(int x, int y)
+{
+	Post({ Event::Type::LeftUp,0,x,y });
+}
+
+void HeadlessWindow::PostRightDown(int x, int y)
+{
+	Post({ Event::Type::RightDown,0,x,y });
+}
+
+void HeadlessWindow::PostRightUp(int x, int y)
+{
+	Post({ Event::Type::RightUp,0,x,y });
+}
+
+void HeadlessWindow::PostWheel(int x, int y, int delta)
+{
+	Post({ Event::Type::Wheel,delta,x,y });
+}
+
+void HeadlessWindow::PostQuit(int exitCode)
+{
+	Post({ Event::Type::Quit,exitCode,0,0 });
+}
+
+size_t HeadlessWindow::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.size();
+}
+
+void HeadlessWindow::Post(Event e)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pending.push_back(e);
+}
+
+#ifndef _WIN32
+std::unique_ptr<PlatformWindow> PlatformWindow::Create(int width, int height, const char* name)
+{
+	return std::make_unique<HeadlessWindow>(width, height, name);
+}
+#endif
\ No newline at end of file
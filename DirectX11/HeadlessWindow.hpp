@@ -0,0 +1,63 @@
+#pragma once
+#include "PlatformWindow.hpp"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// PlatformWindow without a display, for Linux builds, tests and benchmarks: events are posted from
+// code (any thread) and ProcessMessages delivers them to kbd / mouse in order, the way the Win32
+// pump delivers window messages. a posted quit ends the pump with its exit code
+class HeadlessWindow : public PlatformWindow
+{
+public:
+	HeadlessWindow(int width, int height, const char* name);
+	void SetTitle(const std::string& title_in) override;
+	std::optional<int> ProcessMessages() override;
+	void* GetNativeHandle() const noexcept override;
+	const std::string& GetTitle() const noexcept;
+	// repeat marks an autorepeat press of a key that is already down
+	void PostKeyDown(unsigned char keycode, bool repeat = false);
+	void PostKeyUp(unsigned char keycode);
+	void PostChar(char character);
+	void PostFocusLost();
+	void PostMouseMove(int x, int y);
+	void PostLeftDown(int x, int y);
+	void PostLeftUp(int x, int y);
+	void PostRightDown(int x, int y);
+	void PostRightUp(int x, int y);
+	void PostWheel(int x, int y, int delta);
+	void PostQuit(int exitCode);
+	// events posted and not yet processed
+	size_t GetPendingCount() const;
+private:
+	struct Event
+	{
+		enum class Type : uint8_t
+		{
+			KeyDown,
+			KeyUp,
+			Char,
+			FocusLost,
+			MouseMove,
+			LeftDown,
+			LeftUp,
+			RightDown,
+			RightUp,
+			Wheel,
+			Quit
+		};
+		Type type;
+		// character, repeat flag, wheel delta or exit code
+		int value;
+		// pointer position; keys keep their code in x
+		int x;
+		int y;
+	};
+	void Post(Event e);
+private:
+	std::string title;
+	mutable std::mutex mutex;
+	std::vector<Event> pending;
+	// swapped with pending so events are delivered without holding the lock
+	std::vector<Event> processing;
+};
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "InputScript.hpp"
+#include "HeadlessWindow.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#define INPUT_SCRIPT_EXCEPT(note) InputScript::Exception( __LINE__,__FILE__,(note) )
+
+InputScript InputScript::Default()
+{
+	const auto key = [](unsigned int frame, float moveX, float moveZ, float pointerX, float pointerY)
+	{
+		Keyframe k;
+		k.frame = frame;
+		k.input.moveX = moveX;
+		k.input.moveZ = moveZ;
+		k.input.pointerX = pointerX;
+		k.input.pointerY = pointerY;
+		return k;
+	};
+	return InputScript({
+		key(0u, 0.0f, 0.0f, -0.8f, 0.0f),
+		key(100u, 1.0f, 0.0f, 0.8f, 0.5f),
+		key(200u, -1.0f, 0.0f, 0.0f, -0.5f),
+		key(300u, 0.0f, 1.0f, -0.5f, 0.8f),
+		key(400u, 0.0f, -1.0f, 0.5f, -0.8f),
+		key(500u, 1.0f, 1.0f, -0.8f, 0.0f),
+		// a loop ends where it began, so the camera does not drift off over long runs
+		key(600u, 0.0f, 0.0f, -0.8f, 0.0f)
+	});
+}
+
+InputScript InputScript::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		throw INPUT_SCRIPT_EXCEPT("cannot open " + path);
+	}
+	std::vector<Keyframe> keyframes;
+	std::string line;
+	for (unsigned int lineNumber = 1u; std::getline(file, line); lineNumber++)
+	{
+		line = line.substr(0, line.find('#'));
+		std::istringstream fields(line);
+		Keyframe k;
+		if (!(fields >> k.frame))
+		{
+			// blank or comment only
+			continue;
+		}
+		if (!(fields >> k.input.moveX >> k.input.moveZ >> k.input.pointerX >> k.input.pointerY))
+		{
+			throw INPUT_SCRIPT_EXCEPT(path + ":" + std::to_string(lineNumber) + " needs frame moveX moveZ pointerX pointerY");
+		}
+		if (!keyframes.empty() && k.frame <= keyframes.back().frame)
+		{
+			throw INPUT_SCRIPT_EXCEPT(path + ":" + std::to_string(lineNumber) + " frames must be ascending");
+		}
+		keyframes.push_back(k);
+	}
+	if (keyframes.empty() || keyframes.front().frame != 0u)
+	{
+		throw INPUT_SCRIPT_EXCEPT(path + " must start with a keyframe at frame 0");
+	}
+	return InputScript(std::move(keyframes));
+}
+
+InputScript::InputScript(std::vector<Keyframe> keyframes)
+	:
+	keyframes(std::move(keyframes))
+{}
+
+void InputScript::Sample(unsigned long long frame, FrameInput& input) const noexcept
+{
+	if (keyframes.empty())
+	{
+		input = {};
+		return;
+	}
+	const unsigned int length = GetLength();
+	const unsigned int f = length != 0u ? unsigned(frame % length) : 0u;
+	size_t i = 0u;
+	while (i + 1u < keyframes.size() && keyframes[i + 1u].frame <= f)
+	{
+		i++;
+	}
+	const Keyframe& a = keyframes[i];
+	input = a.input;
+	if (i + 1u < keyframes.size())
+	{
+		const Keyframe& b = keyframes[i + 1u];
+		const float t = float(f - a.frame) / float(b.frame - a.frame);
+		input.pointerX = a.input.pointerX + (b.input.pointerX - a.input.pointerX) * t;
+		input.pointerY = a.input.pointerY + (b.input.pointerY - a.input.pointerY) * t;
+	}
+}
+
+void InputScript::Post(unsigned long long frame, HeadlessWindow& wnd) const
+{
+	FrameInput input;
+	Sample(frame, input);
+	// the keys FrameLoop::ReadControls reads, moveX = A - D and moveZ = W - S
+	const auto hold = [&wnd](unsigned char keycode, bool down)
+	{
+		if (down == wnd.kbd.KeyIsPressed(keycode))
+		{
+			return;
+		}
+		if (down)
+		{
+			wnd.PostKeyDown(keycode);
+		}
+		else
+		{
+			wnd.PostKeyUp(keycode);
+		}
+	};
+	hold('A', input.moveX > 0.5f);
+	hold('D', input.moveX < -0.5f);
+	hold('W', input.moveZ > 0.5f);
+	hold('S', input.moveZ < -0.5f);
+	// inverse of the pointer mapping, kept inside the client area so the move is not a leave
+	const int halfWidth = wnd.GetWidth() / 2;
+	const int halfHeight = wnd.GetHeight() / 2;
+	const int x = std::clamp(int(std::lround((input.pointerX + 1.0f) * float(halfWidth))), 0, wnd.GetWidth() - 1);
+	const int y = std::clamp(int(std::lround((1.0f - input.pointerY) * float(halfHeight))), 0, wnd.GetHeight() - 1);
+	if (!wnd.mouse.IsInWindow() || x != wnd.mouse.GetPosX() || y != wnd.mouse.GetPosY())
+	{
+		wnd.PostMouseMove(x, y);
+	}
+}
+
+unsigned int InputScript::GetLength() const noexcept
+{
+	return keyframes.empty() ? 0u : keyframes.back().frame;
+}
+
+
+// input script exception stuff
+InputScript::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* InputScript::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* InputScript::Exception::GetType() const noexcept
+{
+	return "Input Script Exception";
+}
+
+const std::string& InputScript::Exception::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
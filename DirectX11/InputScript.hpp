@@ -0,0 +1,47 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "FrameLoop.hpp"
+#include <string>
+#include <vector>
+
+class HeadlessWindow;
+
+// camera input for runs without a keyboard or mouse: keyframes by frame number, controls are held
+// and the pointer is interpolated between them, and the script loops after its last keyframe.
+// frame numbers rather than times, so every run of a script feeds the same input to the same frame.
+// Post plays it into a HeadlessWindow as key and mouse events, so the frame loop reads it the way it
+// reads a real window (FrameLoop::ReadControls)
+class InputScript
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	struct Keyframe
+	{
+		unsigned int frame = 0u;
+		FrameInput input;
+	};
+public:
+	// strafes, flies in and out and sweeps the pointer across the screen, 600 frames a loop
+	static InputScript Default();
+	// one keyframe per line: frame moveX moveZ pointerX pointerY, '#' starts a comment,
+	// frames ascending and the first one 0
+	static InputScript Load(const std::string& path);
+	explicit InputScript(std::vector<Keyframe> keyframes);
+	void Sample(unsigned long long frame, FrameInput& input) const noexcept;
+	// posts the events that take wnd from its current keyboard / mouse state to the sample of frame:
+	// a move axis beyond half holds its key, the pointer moves to the nearest pixel
+	void Post(unsigned long long frame, HeadlessWindow& wnd) const;
+	// frames until the script repeats
+	unsigned int GetLength() const noexcept;
+private:
+	std::vector<Keyframe> keyframes;
+};
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#ifdef _WIN32
+#include "ChiliWin.hpp"
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+	struct ThreadContext
+	{
+		const JobSystem* pSystem = nullptr;
+		unsigned int index = 0u;
+	};
+	thread_local ThreadContext currentThread;
+
+	// tries before an idle worker goes to sleep
+	constexpr int spinRounds = 64;
+
+	void PinCurrentThread(unsigned int processor) noexcept
+	{
+		const unsigned int nProcessors = std::max(1u, std::thread::hardware_concurrency());
+#ifdef _WIN32
+		SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (processor % nProcessors % 64u));
+#else
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(processor % nProcessors, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+	}
+}
+
+JobSystem::Worker::Worker(unsigned int index)
+	:
+	deque(jobsPerThread),
+	pJobs(std::make_unique<Job[]>(jobsPerThread)),
+	index(index),
+	rng(index * 2654435761u + 1u)
+{}
+
+JobSystem::JobSystem(unsigned int nThreads, bool pinThreads, unsigned int attachSlots)
+	:
+	ownerId(std::this_thread::get_id())
+{
+	if (nThreads == 0u)
+	{
+		nThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = nThreads;
+	for (unsigned int i = 0; i < nThreads + attachSlots; i++)
+	{
+		workers.push_back(std::make_unique<Worker>(i));
+	}
+	for (unsigned int i = 1; i < nThreads; i++)
+	{
+		threads.emplace_back(&JobSystem::WorkerLoop, this, i, pinThreads);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	quitting.store(true);
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wake.notify_all();
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+}
+
+void JobSystem::Wait(const JobCounter& counter) noexcept
+{
+	Worker* const pSelf = GetCurrentWorker();
+	while (!counter.IsDone())
+	{
+		if (!pSelf || !TryRunOne(*pSelf))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::RunPendingJob() noexcept
+{
+	Worker* const pSelf = GetCurrentWorker();
+	return pSelf && TryRunOne(*pSelf);
+}
+
+bool JobSystem::AttachCurrentThread() noexcept
+{
+	if (GetCurrentWorker())
+	{
+		return true;
+	}
+	for (size_t i = threadCount; i < workers.size(); i++)
+	{
+		bool expected = false;
+		if (workers[i]->attached.compare_exchange_strong(expected, true))
+		{
+			currentThread.pSystem = this;
+			currentThread.index = unsigned(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::DetachCurrentThread() noexcept
+{
+	if (currentThread.pSystem != this || currentThread.index < threadCount)
+	{
+		return;
+	}
+	workers[currentThread.index]->attached.store(false);
+	currentThread = {};
+}
+
+unsigned int JobSystem::GetThreadCount() const noexcept
+{
+	return threadCount;
+}
+
+int JobSystem::GetThreadIndex() const noexcept
+{
+	const Worker* const pSelf = GetCurrentWorker();
+	return pSelf ? int(pSelf->index) : -1;
+}
+
+JobSystem::Worker* JobSystem::GetCurrentWorker() const noexcept
+{
+	if (currentThread.pSystem == this)
+	{
+		return workers[currentThread.index].get();
+	}
+	if (std::this_thread::get_id() == ownerId)
+	{
+		return workers[0].get();
+	}
+	return nullptr;
+}
+
+JobSystem::Job* JobSystem::AllocateJob(Worker& self) noexcept
+{
+	Job& job = self.pJobs[self.nextJob & (jobsPerThread - 1u)];
+	if (job.busy.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	self.nextJob++;
+	job.busy.store(true, std::memory_order_relaxed);
+	return &job;
+}
+
+void JobSystem::Submit(Worker& self, Job* pJob) noexcept
+{
+	// counted before the push: once pushed a thief may take the job and decrement straight away, which
+	// must not wrap the count around. pairs with the sleeping / queued check of an idle worker, one of
+	// the two sides sees the other
+	queued.fetch_add(1u);
+	if (!self.deque.Push(pJob))
+	{
+		queued.fetch_sub(1u);
+		Execute(pJob);
+		return;
+	}
+	if (sleeping.load() != 0u)
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wake.notify_one();
+	}
+}
+
+bool JobSystem::TryRunOne(Worker& self) noexcept
+{
+	Job* pJob = nullptr;
+	bool found = self.deque.Pop(pJob);
+	if (!found)
+	{
+		// random first victim so thieves spread over the deques, then everyone in turn
+		self.rng ^= self.rng << 13;
+		self.rng ^= self.rng >> 17;
+		self.rng ^= self.rng << 5;
+		const size_t n = workers.size();
+		const size_t first = self.rng % n;
+		for (size_t i = 0; i < n && !found; i++)
+		{
+			const size_t victim = (first + i) % n;
+			if (victim != self.index)
+			{
+				found = workers[victim]->deque.Steal(pJob);
+			}
+		}
+	}
+	if (!found)
+	{
+		return false;
+	}
+	queued.fetch_sub(1u);
+	Execute(pJob);
+	return true;
+}
+
+void JobSystem::Execute(Job* pJob) noexcept
+{
+	{
+		PROFILE_ZONE("job");
+		pJob->pEntry(*pJob);
+	}
+	JobCounter* const pCounter = pJob->pCounter;
+	pJob->busy.store(false, std::memory_order_release);
+	// last touch of the counter, a waiter may release it as soon as this reaches zero
+	pCounter->pending.fetch_sub(1u, std::memory_order_acq_rel);
+}
+
+void JobSystem::WorkerLoop(unsigned int index, bool pin) noexcept
+{
+	currentThread.pSystem = this;
+	currentThread.index = index;
+	PROFILE_THREAD("worker " + std::to_string(index));
+	if (pin)
+	{
+		PinCurrentThread(index);
+	}
+	Worker& self = *workers[index];
+	while (!quitting.load(std::memory_order_acquire))
+	{
+		bool ran = false;
+		for (int i = 0; i < spinRounds && !ran; i++)
+		{
+			ran = TryRunOne(self);
+			if (!ran)
+			{
+				std::this_thread::yield();
+			}
+		}
+		if (ran)
+		{
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleeping.fetch_add(1u);
+		wake.wait(lock, [this] { return quitting.load() || queued.load() != 0u; });
+		sleeping.fetch_sub(1u);
+	}
+	currentThread = {};
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+#include "WorkStealingDeque.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// number of unfinished jobs run against it; waiting for zero is the fence between dependent batches
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+	bool IsDone() const noexcept
+	{
+		return pending.load(std::memory_order_acquire) == 0u;
+	}
+private:
+	friend class JobSystem;
+	std::atomic<unsigned int> pending{ 0u };
+};
+
+// work stealing thread pool: every thread owns a Chase-Lev deque and a ring of preallocated jobs,
+// idle threads steal the oldest job of a random victim. the constructing thread is thread 0 and
+// works too whenever it waits; threads outside the system run their jobs inline unless they attach
+class JobSystem
+{
+public:
+	// nThreads counts the constructing thread, 0 uses every hardware thread;
+	// pinThreads binds worker i to logical processor i; attachSlots reserves deques for long lived
+	// threads of their own (a render thread) that join later through AttachCurrentThread
+	JobSystem(unsigned int nThreads = 0u, bool pinThreads = false, unsigned int attachSlots = 0u);
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	// queues job() and counts it on counter; jobs must not throw and their captures must fit in payloadSize.
+	// when the calling thread's job ring is exhausted the job runs inline instead
+	template<typename F>
+	void Run(JobCounter& counter, F&& job)
+	{
+		using Fn = std::decay_t<F>;
+		static_assert(sizeof(Fn) <= payloadSize, "job captures too large, capture by reference instead");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "over aligned job captures");
+		counter.pending.fetch_add(1u, std::memory_order_relaxed);
+		Worker* const pSelf = GetCurrentWorker();
+		Job* const pJob = pSelf ? AllocateJob(*pSelf) : nullptr;
+		if (!pJob)
+		{
+			job();
+			counter.pending.fetch_sub(1u, std::memory_order_acq_rel);
+			return;
+		}
+		new(pJob->payload) Fn(std::forward<F>(job));
+		pJob->pEntry = [](Job& j) noexcept
+		{
+			Fn& fn = *std::launder(reinterpret_cast<Fn*>(j.payload));
+			fn();
+			fn.~Fn();
+		};
+		pJob->pCounter = &counter;
+		Submit(*pSelf, pJob);
+	}
+	// runs other jobs until the counter reaches zero, valid from inside a job too
+	void Wait(const JobCounter& counter) noexcept;
+	// runs one queued job on the calling thread, false when none was found (or the thread is not in the system)
+	bool RunPendingJob() noexcept;
+	// body(first, last) on disjoint sub ranges of [begin, end) no longer than grain, returns when all are done;
+	// ranges are halved recursively so a thief always takes the biggest piece left
+	template<typename F>
+	void ParallelFor(size_t begin, size_t end, size_t grain, F&& body)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+		JobCounter counter;
+		SplitRange(begin, end, std::max<size_t>(grain, 1u), body, counter);
+		Wait(counter);
+	}
+	// takes a free attach slot for the calling thread: its jobs are queued for the others to steal
+	// and its Wait helps out. false when every slot is taken
+	bool AttachCurrentThread() noexcept;
+	// gives the slot back, every counter the thread ran jobs against must be done by then
+	void DetachCurrentThread() noexcept;
+	// threads the system was built with, attached threads come on top
+	unsigned int GetThreadCount() const noexcept;
+	// 0 for the constructing thread, 1..n-1 for the workers, n.. for attached threads, -1 for threads outside the system
+	int GetThreadIndex() const noexcept;
+public:
+	static constexpr size_t payloadSize = 64u;
+	static constexpr size_t jobsPerThread = 4096u;
+private:
+	struct Job
+	{
+		void (*pEntry)(Job&) noexcept = nullptr;
+		JobCounter* pCounter = nullptr;
+		std::atomic<bool> busy{ false };
+		alignas(std::max_align_t) unsigned char payload[payloadSize];
+	};
+	struct Worker
+	{
+		explicit Worker(unsigned int index);
+		WorkStealingDeque<Job*> deque;
+		std::unique_ptr<Job[]> pJobs;
+		size_t nextJob = 0u;
+		unsigned int index;
+		uint32_t rng;
+		// only used by attach slots
+		std::atomic<bool> attached{ false };
+	};
+private:
+	template<typename F>
+	void SplitRange(size_t begin, size_t end, size_t grain, const F& body, JobCounter& counter)
+	{
+		// the upper half goes on the deque for thieves, this thread keeps going with the lower half
+		while (end - begin > grain)
+		{
+			const size_t mid = begin + (end - begin) / 2u;
+			Run(counter, [this, mid, end, grain, &body, &counter]()
+			{
+				SplitRange(mid, end, grain, body, counter);
+			});
+			end = mid;
+		}
+		body(begin, end);
+	}
+	Worker* GetCurrentWorker() const noexcept;
+	// nullptr when the next ring slot is still queued or running
+	static Job* AllocateJob(Worker& self) noexcept;
+	void Submit(Worker& self, Job* pJob) noexcept;
+	bool TryRunOne(Worker& self) noexcept;
+	static void Execute(Job* pJob) noexcept;
+	void WorkerLoop(unsigned int index, bool pin) noexcept;
+private:
+	std::thread::id ownerId;
+	unsigned int threadCount = 0u;
+	// index 0 belongs to the constructing thread, attach slots follow the workers
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+	// queued, not yet taken jobs; idle workers sleep while it is zero
+	std::atomic<unsigned int> queued{ 0u };
+	std::atomic<unsigned int> sleeping{ 0u };
+	std::atomic<bool> quitting{ false };
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+};
\ No newline at end of file
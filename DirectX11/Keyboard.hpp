@@ -23,7 +23,7 @@
 
 class Keyboard
 {
-	friend class Window;
+	friend class PlatformWindow;
 public:
 	class Event
 	{
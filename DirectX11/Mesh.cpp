@@ -0,0 +1,115 @@
+#include "Mesh.hpp"
+#include <algorithm>
+#include <cstring>
+
+Mesh::Mesh(const void* pVertices, size_t vertexCount, size_t vertexStride, const uint32_t* pIndices, size_t indexCount, size_t positionOffset)
+	:
+	vertices(static_cast<const uint8_t*>(pVertices), static_cast<const uint8_t*>(pVertices) + vertexCount * vertexStride),
+	vertexStride(vertexStride),
+	positionOffset(positionOffset),
+	// trailing indices that do not make a whole triangle are dropped
+	indices(pIndices, pIndices + indexCount / 3u * 3u)
+{
+	ChooseIndexFormat();
+}
+
+Mesh::Report Mesh::Optimize(float overdrawThreshold)
+{
+	Report report;
+	report.verticesBefore = GetVertexCount();
+	report.before = AnalyzeVertexCache();
+
+	std::vector<uint32_t> remap;
+	const size_t welded = MeshOptimizer::WeldVertices(vertices.data(), GetVertexCount(), vertexStride, remap);
+	MeshOptimizer::RemapIndices(indices.data(), indices.size(), remap);
+	vertices.resize(welded * vertexStride);
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), GetVertexCount());
+	MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), vertices.data() + positionOffset, vertexStride,
+		GetVertexCount(), overdrawThreshold);
+	const size_t used = MeshOptimizer::OptimizeVertexFetch(vertices.data(), GetVertexCount(), vertexStride, indices.data(), indices.size());
+	vertices.resize(used * vertexStride);
+
+	ChooseIndexFormat();
+	report.verticesAfter = GetVertexCount();
+	report.after = AnalyzeVertexCache();
+	report.indexFormat = indexFormat;
+	return report;
+}
+
+MeshOptimizer::VertexCacheStats Mesh::AnalyzeVertexCache() const
+{
+	return MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), GetVertexCount());
+}
+
+const void* Mesh::GetVertexData() const noexcept
+{
+	return vertices.data();
+}
+
+size_t Mesh::GetVertexCount() const noexcept
+{
+	return vertexStride ? vertices.size() / vertexStride : 0u;
+}
+
+size_t Mesh::GetVertexStride() const noexcept
+{
+	return vertexStride;
+}
+
+size_t Mesh::GetVertexDataSize() const noexcept
+{
+	return vertices.size();
+}
+
+size_t Mesh::GetPositionOffset() const noexcept
+{
+	return positionOffset;
+}
+
+IndexFormat Mesh::GetIndexFormat() const noexcept
+{
+	return indexFormat;
+}
+
+const void* Mesh::GetIndexData() const noexcept
+{
+	return indexFormat == IndexFormat::Uint16 ? static_cast<const void*>(indices16.data()) : static_cast<const void*>(indices.data());
+}
+
+size_t Mesh::GetIndexCount() const noexcept
+{
+	return indices.size();
+}
+
+size_t Mesh::GetIndexDataSize() const noexcept
+{
+	return indices.size() * (indexFormat == IndexFormat::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t));
+}
+
+const uint16_t* Mesh::GetIndices16() const noexcept
+{
+	return indexFormat == IndexFormat::Uint16 ? indices16.data() : nullptr;
+}
+
+const uint32_t* Mesh::GetIndices32() const noexcept
+{
+	return indices.data();
+}
+
+void Mesh::ChooseIndexFormat()
+{
+	// 0xFFFF stays free so strip cut values can never collide with a real vertex
+	if (GetVertexCount() <= 0xFFFFu)
+	{
+		indexFormat = IndexFormat::Uint16;
+		indices16.resize(indices.size());
+		std::transform(indices.begin(), indices.end(), indices16.begin(), [](uint32_t i) { return uint16_t(i); });
+	}
+	else
+	{
+		indexFormat = IndexFormat::Uint32;
+		indices16.clear();
+		indices16.shrink_to_fit();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include "MeshOptimizer.hpp"
+#include "RenderContext.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// owns an interleaved vertex buffer and a triangle list, the position is a Float3 at positionOffset;
+// Optimize is the import pipeline: weld, vertex cache order, overdraw order, fetch order, index width
+class Mesh
+{
+public:
+	struct Report
+	{
+		MeshOptimizer::VertexCacheStats before;
+		MeshOptimizer::VertexCacheStats after;
+		size_t verticesBefore = 0u;
+		size_t verticesAfter = 0u;
+		IndexFormat indexFormat = IndexFormat::Uint32;
+	};
+public:
+	Mesh() = default;
+	Mesh(const void* pVertices, size_t vertexCount, size_t vertexStride, const uint32_t* pIndices, size_t indexCount, size_t positionOffset = 0u);
+	template<typename V, typename I>
+	static Mesh FromArrays(const V* pVertices, size_t vertexCount, const I* pIndices, size_t indexCount)
+	{
+		const std::vector<uint32_t> indices(pIndices, pIndices + indexCount);
+		return Mesh(pVertices, vertexCount, sizeof(V), indices.data(), indexCount);
+	}
+	Report Optimize(float overdrawThreshold = 1.05f);
+	MeshOptimizer::VertexCacheStats AnalyzeVertexCache() const;
+	const void* GetVertexData() const noexcept;
+	size_t GetVertexCount() const noexcept;
+	size_t GetVertexStride() const noexcept;
+	size_t GetVertexDataSize() const noexcept;
+	size_t GetPositionOffset() const noexcept;
+	// 16 bit when every index fits, chosen by Optimize (or at construction)
+	IndexFormat GetIndexFormat() const noexcept;
+	const void* GetIndexData() const noexcept;
+	size_t GetIndexCount() const noexcept;
+	size_t GetIndexDataSize() const noexcept;
+	const uint16_t* GetIndices16() const noexcept;
+	const uint32_t* GetIndices32() const noexcept;
+private:
+	void ChooseIndexFormat();
+private:
+	std::vector<uint8_t> vertices;
+	size_t vertexStride = 0u;
+	size_t positionOffset = 0u;
+	std::vector<uint32_t> indices;
+	std::vector<uint16_t> indices16;
+	IndexFormat indexFormat = IndexFormat::Uint32;
+};
\ No newline at end of file
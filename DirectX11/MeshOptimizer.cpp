@@ -0,0 +1,442 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+	// FIFO cache that only remembers when a vertex entered, a vertex is resident while
+	// fewer than cacheSize misses happened since
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t vertexCount, unsigned int cacheSize)
+			:
+			stamps(vertexCount, 0u),
+			cacheSize(cacheSize)
+		{}
+		bool Touch(uint32_t v) noexcept
+		{
+			if (time - stamps[v] < cacheSize)
+			{
+				return true;
+			}
+			stamps[v] = ++time;
+			return false;
+		}
+		void Reset() noexcept
+		{
+			// jump far enough ahead that every stamp is stale
+			time += cacheSize + 1u;
+		}
+	private:
+		std::vector<uint64_t> stamps;
+		uint64_t time = 1ull << 32;
+		unsigned int cacheSize;
+	};
+
+	uint64_t HashVertex(const uint8_t* p, size_t size) noexcept
+	{
+		uint64_t h = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			h ^= p[i];
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	Float3 LoadPosition(const void* pPositions, size_t stride, uint32_t v) noexcept
+	{
+		Float3 p;
+		std::memcpy(&p, static_cast<const uint8_t*>(pPositions) + size_t(v) * stride, sizeof(p));
+		return p;
+	}
+
+	Float3 Sub(const Float3& a, const Float3& b) noexcept
+	{
+		return { a.x - b.x,a.y - b.y,a.z - b.z };
+	}
+
+	// Forsyth's scoring constants
+	constexpr int forsythCacheSize = 32;
+	constexpr float cacheDecayPower = 1.5f;
+	constexpr float lastTriScore = 0.75f;
+	constexpr float valenceBoostScale = 2.0f;
+	constexpr float valenceBoostPower = 0.5f;
+
+	float VertexScore(int cachePosition, unsigned int remainingValence) noexcept
+	{
+		if (remainingValence == 0u)
+		{
+			return -1.0f;
+		}
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				// the triangle just emitted, deliberately not the best so strips don't get stuck
+				score = lastTriScore;
+			}
+			else
+			{
+				const float scaler = 1.0f / float(forsythCacheSize - 3);
+				score = std::pow(1.0f - float(cachePosition - 3) * scaler, cacheDecayPower);
+			}
+		}
+		// favour vertices with few triangles left so they leave the mesh early
+		score += valenceBoostScale * std::pow(float(remainingValence), -valenceBoostPower);
+		return score;
+	}
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStats stats;
+	if (indexCount < 3u)
+	{
+		return stats;
+	}
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> referenced(vertexCount, false);
+	size_t referencedCount = 0u;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		const uint32_t v = pIndices[i];
+		if (!cache.Touch(v))
+		{
+			stats.misses++;
+		}
+		if (!referenced[v])
+		{
+			referenced[v] = true;
+			referencedCount++;
+		}
+	}
+	stats.acmr = float(stats.misses) / float(indexCount / 3u);
+	stats.atvr = float(stats.misses) / float(referencedCount);
+	return stats;
+}
+
+size_t MeshOptimizer::WeldVertices(void* pVertices, size_t vertexCount, size_t stride, std::vector<uint32_t>& remap)
+{
+	uint8_t* const pBytes = static_cast<uint8_t*>(pVertices);
+	remap.assign(vertexCount, 0u);
+	// hash -> first kept vertex with that hash; collisions chain through the vector
+	std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+	buckets.reserve(vertexCount);
+	size_t unique = 0u;
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const uint8_t* const pVertex = pBytes + i * stride;
+		auto& bucket = buckets[HashVertex(pVertex, stride)];
+		const auto match = std::find_if(bucket.begin(), bucket.end(), [&](uint32_t kept)
+		{
+			return std::memcmp(pBytes + size_t(kept) * stride, pVertex, stride) == 0;
+		});
+		if (match != bucket.end())
+		{
+			remap[i] = *match;
+			continue;
+		}
+		// kept vertices are compacted toward the front, never overtaking the read position
+		if (unique != i)
+		{
+			std::memcpy(pBytes + unique * stride, pVertex, stride);
+		}
+		bucket.push_back(uint32_t(unique));
+		remap[i] = uint32_t(unique);
+		unique++;
+	}
+	return unique;
+}
+
+void MeshOptimizer::RemapIndices(uint32_t* pIndices, size_t indexCount, const std::vector<uint32_t>& remap) noexcept
+{
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		pIndices[i] = remap[pIndices[i]];
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+{
+	const size_t triCount = indexCount / 3u;
+	if (triCount == 0u)
+	{
+		return;
+	}
+
+	// vertex -> triangle adjacency in one flat array
+	std::vector<uint32_t> valence(vertexCount, 0u);
+	for (size_t i = 0; i < triCount * 3u; i++)
+	{
+		valence[pIndices[i]]++;
+	}
+	std::vector<uint32_t> adjacencyOffset(vertexCount + 1u, 0u);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		adjacencyOffset[v + 1u] = adjacencyOffset[v] + valence[v];
+	}
+	std::vector<uint32_t> adjacency(triCount * 3u);
+	{
+		std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+		for (size_t t = 0; t < triCount; t++)
+		{
+			for (size_t k = 0; k < 3u; k++)
+			{
+				const uint32_t v = pIndices[t * 3u + k];
+				adjacency[fill[v]++] = uint32_t(t);
+			}
+		}
+	}
+
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = VertexScore(-1, valence[v]);
+	}
+	std::vector<float> triScore(triCount);
+	std::vector<bool> emitted(triCount, false);
+	for (size_t t = 0; t < triCount; t++)
+	{
+		triScore[t] = vertexScore[pIndices[t * 3u]] + vertexScore[pIndices[t * 3u + 1u]] + vertexScore[pIndices[t * 3u + 2u]];
+	}
+
+	const auto removeTriangle = [&](uint32_t v, uint32_t t)
+	{
+		uint32_t* const begin = adjacency.data() + adjacencyOffset[v];
+		uint32_t* const end = begin + valence[v];
+		std::iter_swap(std::find(begin, end, t), end - 1);
+		valence[v]--;
+	};
+
+	std::vector<uint32_t> output;
+	output.reserve(triCount * 3u);
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> nextCache;
+	cache.reserve(forsythCacheSize + 3);
+	nextCache.reserve(forsythCacheSize + 3);
+	size_t scanCursor = 0u;
+	int32_t best = 0;
+	// start with the best scoring triangle overall
+	for (size_t t = 1; t < triCount; t++)
+	{
+		if (triScore[t] > triScore[best])
+		{
+			best = int32_t(t);
+		}
+	}
+
+	while (best >= 0)
+	{
+		const uint32_t* const tri = pIndices + size_t(best) * 3u;
+		emitted[best] = true;
+		nextCache.clear();
+		for (size_t k = 0; k < 3u; k++)
+		{
+			output.push_back(tri[k]);
+			removeTriangle(tri[k], uint32_t(best));
+			nextCache.push_back(tri[k]);
+		}
+		for (const uint32_t v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				nextCache.push_back(v);
+			}
+		}
+		// vertices that fell out of the cache lose their position bonus
+		for (size_t i = forsythCacheSize; i < nextCache.size(); i++)
+		{
+			vertexScore[nextCache[i]] = VertexScore(-1, valence[nextCache[i]]);
+		}
+		nextCache.resize(std::min(nextCache.size(), size_t(forsythCacheSize)));
+		std::swap(cache, nextCache);
+
+		for (size_t i = 0; i < cache.size(); i++)
+		{
+			vertexScore[cache[i]] = VertexScore(int(i), valence[cache[i]]);
+		}
+
+		// only triangles touching the cache changed score, the next pick is among them
+		best = -1;
+		float bestScore = -1.0f;
+		for (const uint32_t v : cache)
+		{
+			const uint32_t* const adj = adjacency.data() + adjacencyOffset[v];
+			for (uint32_t a = 0; a < valence[v]; a++)
+			{
+				const uint32_t t = adj[a];
+				const float score = vertexScore[pIndices[t * 3u]] + vertexScore[pIndices[t * 3u + 1u]] + vertexScore[pIndices[t * 3u + 2u]];
+				triScore[t] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					best = int32_t(t);
+				}
+			}
+		}
+		// nothing connected to the cache: continue with the next untouched triangle
+		if (best < 0)
+		{
+			while (scanCursor < triCount && emitted[scanCursor])
+			{
+				scanCursor++;
+			}
+			if (scanCursor < triCount)
+			{
+				best = int32_t(scanCursor);
+			}
+		}
+	}
+	std::copy(output.begin(), output.end(), pIndices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* pIndices, size_t indexCount, const void* pPositions, size_t positionStride,
+	size_t vertexCount, float threshold)
+{
+	const size_t triCount = indexCount / 3u;
+	if (triCount < 2u)
+	{
+		return;
+	}
+	constexpr unsigned int cacheSize = 16u;
+	const float meshAcmr = AnalyzeVertexCache(pIndices, triCount * 3u, vertexCount, cacheSize).acmr;
+
+	// hard boundaries: triangles where the cache-optimized order starts over (all three vertices miss)
+	std::vector<size_t> clusters;
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t t = 0; t < triCount; t++)
+		{
+			unsigned int misses = 0u;
+			for (size_t k = 0; k < 3u; k++)
+			{
+				misses += cache.Touch(pIndices[t * 3u + k]) ? 0u : 1u;
+			}
+			if (t == 0u || misses == 3u)
+			{
+				clusters.push_back(t);
+			}
+		}
+	}
+
+	// soft boundaries: cut a hard cluster wherever its running ACMR is already within threshold,
+	// restarting the cache there costs little and gives the sort finer pieces to work with
+	std::vector<size_t> splits;
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		const size_t begin = clusters[c];
+		const size_t end = c + 1u < clusters.size() ? clusters[c + 1u] : triCount;
+		FifoCache cache(vertexCount, cacheSize);
+		size_t misses = 0u;
+		size_t start = begin;
+		splits.push_back(begin);
+		for (size_t t = begin; t < end; t++)
+		{
+			for (size_t k = 0; k < 3u; k++)
+			{
+				misses += cache.Touch(pIndices[t * 3u + k]) ? 0u : 1u;
+			}
+			const float acmr = float(misses) / float(t + 1u - start);
+			if (t + 1u < end && acmr <= meshAcmr * threshold)
+			{
+				splits.push_back(t + 1u);
+				start = t + 1u;
+				misses = 0u;
+				cache.Reset();
+			}
+		}
+	}
+
+	// mesh centroid from area weighted triangle centroids
+	Float3 meshCentroid = { 0.0f,0.0f,0.0f };
+	float meshArea = 0.0f;
+	std::vector<Float3> triCentroid(triCount);
+	std::vector<Float3> triNormal(triCount);
+	for (size_t t = 0; t < triCount; t++)
+	{
+		const Float3 a = LoadPosition(pPositions, positionStride, pIndices[t * 3u]);
+		const Float3 b = LoadPosition(pPositions, positionStride, pIndices[t * 3u + 1u]);
+		const Float3 c = LoadPosition(pPositions, positionStride, pIndices[t * 3u + 2u]);
+		// unnormalized normal, its length is twice the area
+		triNormal[t] = Cross(Sub(b, a), Sub(c, a));
+		const float area = std::sqrt(Dot(triNormal[t], triNormal[t]));
+		triCentroid[t] = { (a.x + b.x + c.x) / 3.0f,(a.y + b.y + c.y) / 3.0f,(a.z + b.z + c.z) / 3.0f };
+		meshCentroid = { meshCentroid.x + triCentroid[t].x * area,meshCentroid.y + triCentroid[t].y * area,meshCentroid.z + triCentroid[t].z * area };
+		meshArea += area;
+	}
+	if (meshArea > 0.0f)
+	{
+		meshCentroid = { meshCentroid.x / meshArea,meshCentroid.y / meshArea,meshCentroid.z / meshArea };
+	}
+
+	// clusters that face away from the centre are the likely occluders, they go first
+	std::vector<float> sortKey(splits.size());
+	for (size_t s = 0; s < splits.size(); s++)
+	{
+		const size_t end = s + 1u < splits.size() ? splits[s + 1u] : triCount;
+		Float3 centroid = { 0.0f,0.0f,0.0f };
+		Float3 normal = { 0.0f,0.0f,0.0f };
+		float area = 0.0f;
+		for (size_t t = splits[s]; t < end; t++)
+		{
+			const float a = std::sqrt(Dot(triNormal[t], triNormal[t]));
+			centroid = { centroid.x + triCentroid[t].x * a,centroid.y + triCentroid[t].y * a,centroid.z + triCentroid[t].z * a };
+			normal = { normal.x + triNormal[t].x,normal.y + triNormal[t].y,normal.z + triNormal[t].z };
+			area += a;
+		}
+		if (area > 0.0f)
+		{
+			centroid = { centroid.x / area,centroid.y / area,centroid.z / area };
+		}
+		const float length = std::sqrt(Dot(normal, normal));
+		sortKey[s] = length > 0.0f ? Dot(Sub(centroid, meshCentroid), normal) / length : 0.0f;
+	}
+	std::vector<uint32_t> order(splits.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+	{
+		return sortKey[a] > sortKey[b];
+	});
+
+	std::vector<uint32_t> output;
+	output.reserve(triCount * 3u);
+	for (const uint32_t s : order)
+	{
+		const size_t end = s + 1u < splits.size() ? splits[s + 1u] : triCount;
+		output.insert(output.end(), pIndices + splits[s] * 3u, pIndices + end * 3u);
+	}
+	std::copy(output.begin(), output.end(), pIndices);
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(void* pVertices, size_t vertexCount, size_t stride, uint32_t* pIndices, size_t indexCount)
+{
+	constexpr uint32_t unused = ~0u;
+	std::vector<uint32_t> remap(vertexCount, unused);
+	uint32_t next = 0u;
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		uint32_t& slot = remap[pIndices[i]];
+		if (slot == unused)
+		{
+			slot = next++;
+		}
+		pIndices[i] = slot;
+	}
+	// scatter through a copy, the permutation can have arbitrary cycles
+	uint8_t* const pBytes = static_cast<uint8_t*>(pVertices);
+	const std::vector<uint8_t> source(pBytes, pBytes + vertexCount * stride);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] != unused)
+		{
+			std::memcpy(pBytes + size_t(remap[v]) * stride, source.data() + v * stride, stride);
+		}
+	}
+	return next;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// index / vertex buffer optimizations for triangle lists, all in place on CPU data
+namespace MeshOptimizer
+{
+	struct VertexCacheStats
+	{
+		// transformed vertices per triangle (0.5 is the limit for big regular meshes, 3 is no reuse at all)
+		float acmr = 0.0f;
+		// transformed vertices per referenced vertex (1 is ideal)
+		float atvr = 0.0f;
+		size_t misses = 0u;
+	};
+
+	// FIFO post-transform cache simulation, 16 entries is a conservative stand-in for current hardware
+	VertexCacheStats AnalyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16u);
+
+	// merges bitwise identical vertices; fills remap (old -> new) and compacts pVertices, returns the new vertex count
+	size_t WeldVertices(void* pVertices, size_t vertexCount, size_t stride, std::vector<uint32_t>& remap);
+	// rewrites indices through a remap table produced by WeldVertices
+	void RemapIndices(uint32_t* pIndices, size_t indexCount, const std::vector<uint32_t>& remap) noexcept;
+
+	// Forsyth's linear-speed vertex cache optimization: greedily emits the triangle with the best
+	// LRU position / remaining valence score
+	void OptimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount);
+
+	// splits a cache-optimized list into clusters (hard splits at cache restarts, soft splits while the
+	// cluster ACMR stays within threshold of the mesh ACMR) and draws outward facing clusters first;
+	// pPositions is read with positionStride so it can point into an interleaved vertex buffer
+	void OptimizeOverdraw(uint32_t* pIndices, size_t indexCount, const void* pPositions, size_t positionStride,
+		size_t vertexCount, float threshold = 1.05f);
+
+	// orders vertices by first use in the index buffer and drops unreferenced ones, returns the new vertex count
+	size_t OptimizeVertexFetch(void* pVertices, size_t vertexCount, size_t stride, uint32_t* pIndices, size_t indexCount);
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "MetricsServer.hpp"
+#include "Clock.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#ifdef _WIN32
+#include "ChiliWin.hpp"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <psapi.h>
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define METRICS_EXCEPT(note) MetricsServer::Exception( __LINE__,__FILE__,(note) )
+
+namespace
+{
+#ifdef _WIN32
+	using Socket = SOCKET;
+	const uintptr_t invalidSocket = uintptr_t(INVALID_SOCKET);
+	// a send that would block is as good as failed, the client is too slow
+	constexpr int sendFlags = 0;
+
+	int LastSocketError() noexcept
+	{
+		return WSAGetLastError();
+	}
+
+	void CloseSocket(uintptr_t s) noexcept
+	{
+		closesocket(Socket(s));
+	}
+
+	bool SetNonBlocking(uintptr_t s) noexcept
+	{
+		u_long on = 1u;
+		return ioctlsocket(Socket(s), FIONBIO, &on) == 0;
+	}
+#else
+	using Socket = int;
+	const uintptr_t invalidSocket = uintptr_t(-1);
+	// no SIGPIPE when a client has gone away
+	constexpr int sendFlags = MSG_NOSIGNAL;
+
+	int LastSocketError() noexcept
+	{
+		return errno;
+	}
+
+	void CloseSocket(uintptr_t s) noexcept
+	{
+		close(Socket(s));
+	}
+
+	bool SetNonBlocking(uintptr_t s) noexcept
+	{
+		const int flags = fcntl(Socket(s), F_GETFL, 0);
+		return flags >= 0 && fcntl(Socket(s), F_SETFL, flags | O_NONBLOCK) == 0;
+	}
+#endif
+
+	// whole buffer or nothing useful: a partial line would corrupt the stream
+	bool SendAll(uintptr_t s, const char* pData, size_t size) noexcept
+	{
+		return send(Socket(s), pData, int(size), sendFlags) == int(size);
+	}
+}
+
+MetricsServer::MetricsServer(unsigned short port, const FrameTelemetry* pTelemetry, unsigned int intervalMs)
+	:
+	pTelemetry(pTelemetry),
+	intervalMs(intervalMs == 0u ? 1u : intervalMs),
+	listenSocket(invalidSocket)
+{
+#ifdef _WIN32
+	WSADATA wsa;
+	if (const int error = WSAStartup(MAKEWORD(2, 2), &wsa))
+	{
+		throw METRICS_EXCEPT("WSAStartup failed with error " + std::to_string(error));
+	}
+#endif
+	const auto fail = [this](const char* what)
+	{
+		std::string note = std::string(what) + " failed with error " + std::to_string(LastSocketError());
+		if (listenSocket != invalidSocket)
+		{
+			CloseSocket(listenSocket);
+		}
+#ifdef _WIN32
+		WSACleanup();
+#endif
+		return METRICS_EXCEPT(std::move(note));
+	};
+	listenSocket = uintptr_t(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (listenSocket == invalidSocket)
+	{
+		throw fail("socket");
+	}
+	// loopback only, soak test boxes should not expose this to the network
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	if (bind(Socket(listenSocket), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		throw fail("bind");
+	}
+	if (listen(Socket(listenSocket), 8) != 0)
+	{
+		throw fail("listen");
+	}
+	if (!SetNonBlocking(listenSocket))
+	{
+		throw fail("non blocking mode");
+	}
+	socklen_t length = sizeof(address);
+	getsockname(Socket(listenSocket), reinterpret_cast<sockaddr*>(&address), &length);
+	this->port = ntohs(address.sin_port);
+	thread = std::thread(&MetricsServer::Loop, this);
+}
+
+MetricsServer::~MetricsServer()
+{
+	quitting.store(true, std::memory_order_release);
+	thread.join();
+	for (const uintptr_t c : clients)
+	{
+		CloseSocket(c);
+	}
+	CloseSocket(listenSocket);
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+void MetricsServer::Publish(const MetricsSnapshot& snapshot) noexcept
+{
+	latest.Write(snapshot);
+}
+
+unsigned short MetricsServer::GetPort() const noexcept
+{
+	return port;
+}
+
+size_t MetricsServer::GetClientCount() const noexcept
+{
+	return clientCount.load(std::memory_order_relaxed);
+}
+
+uint64_t MetricsServer::GetWorkingSetBytes() noexcept
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return uint64_t(counters.WorkingSetSize);
+	}
+	return 0u;
+#else
+	// second field of statm is the resident set in pages
+	unsigned long long pages = 0u, resident = 0u;
+	FILE* pFile = std::fopen("/proc/self/statm", "r");
+	if (!pFile)
+	{
+		return 0u;
+	}
+	const int read = std::fscanf(pFile, "%llu %llu", &pages, &resident);
+	std::fclose(pFile);
+	return read == 2 ? uint64_t(resident) * uint64_t(sysconf(_SC_PAGESIZE)) : 0u;
+#endif
+}
+
+void MetricsServer::Loop() noexcept
+{
+	const int64_t interval = int64_t(intervalMs) * 1000000;
+	int64_t next = HighPrecisionClock::Now();
+	MetricsSnapshot snapshot;
+	char line[512];
+	while (!quitting.load(std::memory_order_acquire))
+	{
+		// sleep in accept until the next line is due, at most 50ms so shutdown stays quick
+		const int64_t wait = std::clamp<int64_t>(next - HighPrecisionClock::Now(), 0, 50000000);
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(Socket(listenSocket), &readable);
+		timeval timeout = { long(wait / 1000000000), long(wait / 1000 % 1000000) };
+		if (select(int(listenSocket) + 1, &readable, nullptr, nullptr, &timeout) > 0)
+		{
+			const char header[] = "# chili metrics v1\n";
+			uintptr_t client;
+			while ((client = uintptr_t(accept(Socket(listenSocket), nullptr, nullptr))) != invalidSocket)
+			{
+				if (SetNonBlocking(client) && SendAll(client, header, sizeof(header) - 1u))
+				{
+					clients.push_back(client);
+				}
+				else
+				{
+					CloseSocket(client);
+				}
+			}
+		}
+
+		const int64_t now = HighPrecisionClock::Now();
+		if (now < next)
+		{
+			continue;
+		}
+		// a stalled server thread skips the lines it missed rather than bursting them
+		next = std::max(next + interval, now);
+		latest.Read(snapshot);
+		if (clients.empty())
+		{
+			continue;
+		}
+		const size_t length = FormatLine(snapshot, line, sizeof(line));
+		for (size_t i = 0; i < clients.size();)
+		{
+			if (SendAll(clients[i], line, length))
+			{
+				i++;
+			}
+			else
+			{
+				// gone, or so far behind that its socket buffer is full
+				CloseSocket(clients[i]);
+				clients[i] = clients.back();
+				clients.pop_back();
+			}
+		}
+		clientCount.store(clients.size(), std::memory_order_relaxed);
+	}
+}
+
+size_t MetricsServer::FormatLine(const MetricsSnapshot& s, char* pBuffer, size_t size) const noexcept
+{
+	FrameTelemetry::Summary frames;
+	double frameMs = 0.0, presentMs = 0.0, pumpMs = 0.0;
+	if (pTelemetry)
+	{
+		frames = pTelemetry->GetSummary(FrameTelemetry::Channel::Frame);
+		frameMs = double(pTelemetry->GetLast(FrameTelemetry::Channel::Frame)) * 1e-6;
+		presentMs = double(pTelemetry->GetLast(FrameTelemetry::Channel::Present)) * 1e-6;
+		pumpMs = double(pTelemetry->GetLast(FrameTelemetry::Channel::MessagePump)) * 1e-6;
+	}
+	const int length = std::snprintf(pBuffer, size,
+		"frame=%llu frame_ms=%.3f frame_p50_ms=%.3f frame_p99_ms=%.3f frame_p99_9_ms=%.3f frame_max_ms=%.3f"
+		" present_ms=%.3f pump_ms=%.3f draws=%u triangles=%llu state_calls=%u state_elided=%u maps=%u"
+		" occludees_tested=%u occludees_culled=%u working_set_mb=%.1f\n",
+		(unsigned long long)s.frame, frameMs, frames.p50Ms, frames.p99Ms, frames.p999Ms, frames.maxMs,
+		presentMs, pumpMs, s.draws, s.triangles, s.stateCalls, s.stateCallsElided, s.maps,
+		s.occludeesTested, s.occludeesCulled, double(GetWorkingSetBytes()) / (1024.0 * 1024.0));
+	return length < 0 ? 0u : std::min(size_t(length), size - 1u);
+}
+
+
+// metrics server exception stuff
+MetricsServer::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* MetricsServer::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* MetricsServer::Exception::GetType() const noexcept
+{
+	return "Metrics Server Exception";
+}
+
+const std::string& MetricsServer::Exception::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "FrameTelemetry.hpp"
+#include "TripleBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// per frame counters of the renderer, published once a frame
+struct MetricsSnapshot
+{
+	uint64_t frame = 0u;
+	unsigned int draws = 0u;
+	unsigned long long triangles = 0u;
+	unsigned int stateCalls = 0u;
+	unsigned int stateCallsElided = 0u;
+	unsigned int maps = 0u;
+	unsigned int occludeesTested = 0u;
+	unsigned int occludeesCulled = 0u;
+};
+
+// streams the latest MetricsSnapshot (plus frame time percentiles and the process working set)
+// to every client connected to 127.0.0.1:port, one "key=value ..." text line per interval.
+// the socket work runs on a thread of its own; Publish is a wait-free triple buffer write, so the
+// publishing thread never waits on the network. clients that cannot keep up are disconnected
+class MetricsServer
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+public:
+	static constexpr unsigned short defaultPort = 7780u;
+	// binds right away and throws if that fails; port 0 picks a free one (see GetPort)
+	MetricsServer(unsigned short port = defaultPort, const FrameTelemetry* pTelemetry = nullptr, unsigned int intervalMs = 100u);
+	MetricsServer(const MetricsServer&) = delete;
+	MetricsServer& operator=(const MetricsServer&) = delete;
+	~MetricsServer();
+	// a single publishing thread at a time
+	void Publish(const MetricsSnapshot& snapshot) noexcept;
+	unsigned short GetPort() const noexcept;
+	size_t GetClientCount() const noexcept;
+	// resident memory of this process, 0 when the platform will not say
+	static uint64_t GetWorkingSetBytes() noexcept;
+private:
+	void Loop() noexcept;
+	// formats one line into buffer, returns its length
+	size_t FormatLine(const MetricsSnapshot& s, char* pBuffer, size_t size) const noexcept;
+private:
+	const FrameTelemetry* pTelemetry;
+	unsigned int intervalMs;
+	// platform socket handles widened to a common type
+	uintptr_t listenSocket;
+	unsigned short port = 0u;
+	// server thread only
+	std::vector<uintptr_t> clients;
+	std::atomic<size_t> clientCount{ 0u };
+	TripleBuffer<MetricsSnapshot> latest;
+	std::atomic<bool> quitting{ false };
+	std::thread thread;
+};
\ No newline at end of file
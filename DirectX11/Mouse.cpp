@@ -19,7 +19,6 @@
  *	along with The Chili DirectX Framework.  If not, see <http://www.gnu.org/licenses/>.  *
  ******************************************************************************************/
 #include "Mouse.hpp"
-#include <Windows.h>
 
 std::pair<int, int> Mouse::GetPos() const noexcept
 {
@@ -149,14 +148,14 @@ void Mouse::OnWheelDelta(int x, int y, int delta) noexcept
 {
 	wheelDeltaCarry += delta;
 	// generate events for every 120 
-	while (wheelDeltaCarry >= WHEEL_DELTA)
+	while (wheelDeltaCarry >= wheelDelta)
 	{
-		wheelDeltaCarry -= WHEEL_DELTA;
+		wheelDeltaCarry -= wheelDelta;
 		OnWheelUp(x, y);
 	}
-	while (wheelDeltaCarry <= -WHEEL_DELTA)
+	while (wheelDeltaCarry <= -wheelDelta)
 	{
-		wheelDeltaCarry += WHEEL_DELTA;
+		wheelDeltaCarry += wheelDelta;
 		OnWheelDown(x, y);
 	}
 }
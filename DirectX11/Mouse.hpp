@@ -23,7 +23,7 @@
 
 class Mouse
 {
-	friend class Window;
+	friend class PlatformWindow;
 public:
 	class Event
 	{
@@ -123,6 +123,8 @@ private:
 	void OnWheelDelta(int x, int y, int delta) noexcept;
 private:
 	static constexpr unsigned int bufferSize = 16u;
+	// one wheel notch, WHEEL_DELTA on Win32
+	static constexpr int wheelDelta = 120;
 	int x;
 	int y;
 	bool leftIsPressed = false;
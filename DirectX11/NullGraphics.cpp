@@ -0,0 +1,117 @@
+#include "NullGraphics.hpp"
+#include "Geometry.hpp"
+
+namespace
+{
+	// cube buffers and stand-in pipeline objects made on the null context, the way Graphics makes them on the device
+	SceneSubmitter::Resources MakeResources(NullRenderContext& context)
+	{
+		const Mesh& cube = Geometry::ColoredCube();
+		const Matrix4 identity = Matrix4::Identity();
+		SceneSubmitter::Resources resources;
+		resources.inputLayout = context.CreateHandle<InputLayoutHandle>();
+		resources.vertexShader = context.CreateHandle<VertexShaderHandle>();
+		resources.pixelShader = context.CreateHandle<PixelShaderHandle>();
+		resources.depthStencilState = context.CreateHandle<DepthStencilStateHandle>();
+		resources.target = context.CreateHandle<RenderTargetHandle>();
+		resources.depth = context.CreateHandle<DepthStencilViewHandle>();
+		resources.vertexBuffer = context.CreateBuffer(cube.GetVertexDataSize(), cube.GetVertexData());
+		resources.vertexStride = unsigned(cube.GetVertexStride());
+		resources.indexBuffer = context.CreateBuffer(cube.GetIndexDataSize(), cube.GetIndexData());
+		resources.indexFormat = cube.GetIndexFormat();
+		resources.indexCount = unsigned(cube.GetIndexCount());
+		resources.identityInstances = context.CreateBuffer(sizeof(identity), &identity);
+		resources.instanceRing = context.CreateBuffer(SceneSubmitter::instanceRingSize);
+		resources.constantRing = context.CreateBuffer(SceneSubmitter::constantRingSize);
+		return resources;
+	}
+}
+
+NullGraphics::NullGraphics(bool record, unsigned int nThreads)
+	:
+	jobs(nThreads),
+	recording(context, record),
+	capturer(recording),
+	stateFilter(recording),
+	submitter(stateFilter, MakeResources(context), &jobs),
+	target(submitter.GetResources().target),
+	depth(submitter.GetResources().depth)
+{
+	submitter.AddResources(capturer.GetCapture());
+}
+
+void NullGraphics::EndFrame()
+{
+	// nothing to present: closing the frame recycles the ring and the counters
+	submitter.Flush(GetViewProjection());
+	submitter.EndFrame();
+	stateFilter.EndFrame();
+	if (capturer.EndFrame())
+	{
+		stateFilter.Invalidate();
+	}
+}
+
+RendererStats NullGraphics::GetFrameStats() const
+{
+	RendererStats stats = submitter.GetFrameStats();
+	stats.draws = stateFilter.GetLastFrameStats().draws;
+	stats.triangles = stateFilter.GetLastFrameStats().triangles;
+	return stats;
+}
+
+void NullGraphics::ClearBuffer(float red, float green, float blue) noexcept
+{
+	const float color[] = { red,green,blue,1.0f };
+	stateFilter.ClearDepth(depth, 1.0f);
+	stateFilter.ClearRenderTarget(target, color);
+}
+
+void NullGraphics::SetCamera(float x, float y, float z) noexcept
+{
+	xPos = x;
+	yPos = y;
+	zPos = z;
+}
+
+void NullGraphics::DrawScene(const FrameSnapshot& scene)
+{
+	submitter.QueueScene(scene);
+	submitter.Flush(GetViewProjection());
+}
+
+Matrix4 NullGraphics::GetViewProjection() const noexcept
+{
+	return Matrix4::LookAtLH({ xPos, yPos, zPos }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }) *
+		Matrix4::PerspectiveLH(1.f, 3.f / 4.f, 0.5f, SceneSubmitter::farZ);
+}
+
+const StateFilter::Stats& NullGraphics::GetStateStats() const noexcept
+{
+	return stateFilter.GetLastFrameStats();
+}
+
+RecordingRenderContext& NullGraphics::GetRecording() noexcept
+{
+	return recording;
+}
+
+void NullGraphics::RequestCapture(unsigned int frames, std::string path)
+{
+	capturer.Request(frames, std::move(path));
+}
+
+FrameCapturer& NullGraphics::GetCapturer() noexcept
+{
+	return capturer;
+}
+
+NullRenderContext& NullGraphics::GetContext() noexcept
+{
+	return context;
+}
+
+JobSystem& NullGraphics::GetJobSystem() noexcept
+{
+	return jobs;
+}
\ No newline at end of file
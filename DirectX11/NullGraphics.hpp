@@ -0,0 +1,52 @@
+#pragma once
+#include "NullRenderContext.hpp"
+#include "RecordingRenderContext.hpp"
+#include "FrameCapture.hpp"
+#include "StateFilter.hpp"
+#include "SceneSubmitter.hpp"
+#include "JobSystem.hpp"
+#include "RenderThread.hpp"
+#include <string>
+
+// Graphics without a device: the same culling, sorting, state filtering and constant uploads run
+// against a NullRenderContext, so a frame costs exactly the engine's CPU side of submission.
+// a RecordingRenderContext sits between the state filter and the null context; with record set it
+// keeps every call that would have reached the device, otherwise it only records for RequestCapture
+class NullGraphics : public IFrameRenderer
+{
+public:
+	// nThreads sizes the job system culling runs on, 0 uses every hardware thread
+	NullGraphics(bool record = false, unsigned int nThreads = 0u);
+	NullGraphics(const NullGraphics&) = delete;
+	NullGraphics& operator=(const NullGraphics&) = delete;
+	~NullGraphics() override = default;
+	void EndFrame() override;
+	RendererStats GetFrameStats() const override;
+	void ClearBuffer(float red, float green, float blue) noexcept override;
+	void SetCamera(float x, float y, float z) noexcept override;
+	// queues every cube of the snapshot and flushes the queue
+	void DrawScene(const FrameSnapshot& scene) override;
+	Matrix4 GetViewProjection() const noexcept;
+	// issued vs. elided binds of the last ended frame
+	const StateFilter::Stats& GetStateStats() const noexcept;
+	// every frame since the last Clear() when constructed with record; a capture takes it over
+	RecordingRenderContext& GetRecording() noexcept;
+	// writes the next frames frames to path as a FrameCapture, from any thread
+	void RequestCapture(unsigned int frames, std::string path);
+	FrameCapturer& GetCapturer() noexcept;
+	NullRenderContext& GetContext() noexcept;
+	JobSystem& GetJobSystem() noexcept;
+
+	float xPos = 0.0f;
+	float yPos = 0.0f;
+	float zPos = -5.0f;
+private:
+	JobSystem jobs;
+	NullRenderContext context;
+	RecordingRenderContext recording;
+	FrameCapturer capturer;
+	StateFilter stateFilter;
+	SceneSubmitter submitter;
+	RenderTargetHandle target;
+	DepthStencilViewHandle depth;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "NullRenderContext.hpp"
+
+BufferHandle NullRenderContext::CreateBuffer(size_t size, const void* pInitialData)
+{
+	// never zero sized, so every buffer has a distinct non null address
+	buffers.push_back(std::make_unique<unsigned char[]>(size != 0u ? size : 1u));
+	unsigned char* const pData = buffers.back().get();
+	if (pInitialData)
+	{
+		std::memcpy(pData, pInitialData, size);
+	}
+	return BufferHandle(reinterpret_cast<uintptr_t>(pData));
+}
+
+const void* NullRenderContext::GetBufferData(BufferHandle buffer) const noexcept
+{
+	return reinterpret_cast<const void*>(uintptr_t(buffer));
+}
+
+void NullRenderContext::IASetPrimitiveTopology(Topology)
+{}
+
+void NullRenderContext::IASetInputLayout(InputLayoutHandle)
+{}
+
+void NullRenderContext::IASetVertexBuffer(unsigned int, BufferHandle, unsigned int, unsigned int)
+{}
+
+void NullRenderContext::IASetIndexBuffer(BufferHandle, IndexFormat, unsigned int)
+{}
+
+void NullRenderContext::VSSetShader(VertexShaderHandle)
+{}
+
+void NullRenderContext::PSSetShader(PixelShaderHandle)
+{}
+
+void NullRenderContext::VSSetConstantBuffer(unsigned int, BufferHandle, unsigned int, unsigned int)
+{}
+
+void NullRenderContext::OMSetRenderTarget(RenderTargetHandle, DepthStencilViewHandle)
+{}
+
+void NullRenderContext::OMSetDepthStencilState(DepthStencilStateHandle, unsigned int)
+{}
+
+void* NullRenderContext::Map(BufferHandle buffer, MapMode)
+{
+	// discard and no-overwrite are the same thing when nothing reads the buffer behind our back
+	return reinterpret_cast<void*>(uintptr_t(buffer));
+}
+
+void NullRenderContext::Unmap(BufferHandle)
+{}
+
+void NullRenderContext::ClearRenderTarget(RenderTargetHandle, const float[4])
+{}
+
+void NullRenderContext::ClearDepth(DepthStencilViewHandle, float)
+{}
+
+void NullRenderContext::DrawIndexed(unsigned int, unsigned int, int)
+{}
+
+void NullRenderContext::DrawIndexedInstanced(unsigned int, unsigned int, unsigned int, int, unsigned int)
+{}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "RenderContext.hpp"
+#include <memory>
+#include <vector>
+
+// IRenderContext that draws nothing: binds and draws return at once, buffers are plain system memory
+// so Map hands out real bytes. with it the submission path runs without a GPU and what is left of a
+// frame is the engine's own CPU cost
+class NullRenderContext : public IRenderContext
+{
+public:
+	NullRenderContext() = default;
+	NullRenderContext(const NullRenderContext&) = delete;
+	NullRenderContext& operator=(const NullRenderContext&) = delete;
+	// size bytes, zeroed or copied from pInitialData; the handle is the address of the storage
+	BufferHandle CreateBuffer(size_t size, const void* pInitialData = nullptr);
+	// ids standing in for the objects nothing ever looks inside (shaders, layouts, views, states)
+	template<typename Handle>
+	Handle CreateHandle() noexcept
+	{
+		return Handle(++lastId);
+	}
+	// bytes of a buffer made by CreateBuffer, for checking what was uploaded
+	const void* GetBufferData(BufferHandle buffer) const noexcept;
+	void IASetPrimitiveTopology(Topology topology) override;
+	void IASetInputLayout(InputLayoutHandle layout) override;
+	void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) override;
+	void IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset) override;
+	void VSSetShader(VertexShaderHandle shader) override;
+	void PSSetShader(PixelShaderHandle shader) override;
+	void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant = 0u, unsigned int numConstants = 0u) override;
+	void OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth) override;
+	void OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef) override;
+	void* Map(BufferHandle buffer, MapMode mode) override;
+	void Unmap(BufferHandle buffer) override;
+	void ClearRenderTarget(RenderTargetHandle target, const float color[4]) override;
+	void ClearDepth(DepthStencilViewHandle depth, float value) override;
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) override;
+	void DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+		unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+private:
+	std::vector<std::unique_ptr<unsigned char[]>> buffers;
+	// counts from 1 so no id is Null, small enough never to collide with a buffer address
+	uintptr_t lastId = 0u;
+};
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "OcclusionCuller.hpp"
+#include "JobSystem.hpp"
+#include "Mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(_M_X64) || defined(__SSE2__)
+#define CHILI_OCCLUSION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr uint32_t fullMask = 0xFFFFFFFFu;
+
+	// E(x, y) = a * x + b * y + c, positive inside; pixels exactly on an edge belong to the
+	// triangle only for top and left edges so quads split along a diagonal leave no holes
+	struct Edge
+	{
+		float a;
+		float b;
+		float c;
+		bool topLeft;
+	};
+
+	Edge MakeEdge(float ax, float ay, float bx, float by) noexcept
+	{
+		Edge e;
+		e.a = ay - by;
+		e.b = bx - ax;
+		e.c = -(e.a * ax + e.b * ay);
+		e.topLeft = e.a > 0.0f || (e.a == 0.0f && e.b > 0.0f);
+		return e;
+	}
+
+	// bit (row * 8 + column) set for every covered pixel center of the 8x4 tile whose first center is (x0, y0)
+	uint32_t CoverageMask(const Edge* pEdges, float x0, float y0) noexcept
+	{
+		uint32_t mask = 0u;
+#ifdef CHILI_OCCLUSION_SSE2
+		const __m128 lanesLo = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const __m128 lanesHi = _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f);
+		const __m128 zero = _mm_setzero_ps();
+		for (unsigned int row = 0; row < OcclusionCuller::tileHeight; row++)
+		{
+			__m128 insideLo = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			__m128 insideHi = insideLo;
+			for (int i = 0; i < 3; i++)
+			{
+				const Edge& e = pEdges[i];
+				const __m128 base = _mm_set1_ps(e.a * x0 + e.b * (y0 + float(row)) + e.c);
+				const __m128 a = _mm_set1_ps(e.a);
+				const __m128 lo = _mm_add_ps(base, _mm_mul_ps(a, lanesLo));
+				const __m128 hi = _mm_add_ps(base, _mm_mul_ps(a, lanesHi));
+				insideLo = _mm_and_ps(insideLo, e.topLeft ? _mm_cmpge_ps(lo, zero) : _mm_cmpgt_ps(lo, zero));
+				insideHi = _mm_and_ps(insideHi, e.topLeft ? _mm_cmpge_ps(hi, zero) : _mm_cmpgt_ps(hi, zero));
+			}
+			const uint32_t bits = uint32_t(_mm_movemask_ps(insideLo)) | (uint32_t(_mm_movemask_ps(insideHi)) << 4u);
+			mask |= bits << (row * OcclusionCuller::tileWidth);
+		}
+#else
+		for (unsigned int row = 0; row < OcclusionCuller::tileHeight; row++)
+		{
+			for (unsigned int column = 0; column < OcclusionCuller::tileWidth; column++)
+			{
+				bool inside = true;
+				for (int i = 0; i < 3; i++)
+				{
+					const Edge& e = pEdges[i];
+					const float value = (e.a * x0 + e.b * (y0 + float(row)) + e.c) + e.a * float(column);
+					inside = inside && (e.topLeft ? value >= 0.0f : value > 0.0f);
+				}
+				mask |= uint32_t(inside) << (row * OcclusionCuller::tileWidth + column);
+			}
+		}
+#endif
+		return mask;
+	}
+}
+
+float OcclusionCuller::Stats::CulledPercent() const noexcept
+{
+	return tested != 0u ? 100.0f * float(culled) / float(tested) : 0.0f;
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height, JobSystem* pJobs)
+	:
+	tilesX(std::max(1u, (width + tileWidth - 1u) / tileWidth)),
+	tilesY(std::max(1u, (height + tileHeight - 1u) / tileHeight)),
+	pJobs(pJobs),
+	zMax0(size_t(tilesX) * tilesY, 1.0f),
+	zMax1(size_t(tilesX) * tilesY, 0.0f),
+	mask(size_t(tilesX) * tilesY, 0u)
+{}
+
+void OcclusionCuller::BeginFrame(const Matrix4& viewProj_in)
+{
+	viewProj = viewProj_in;
+	triangles.clear();
+	std::fill(zMax0.begin(), zMax0.end(), 1.0f);
+	std::fill(zMax1.begin(), zMax1.end(), 0.0f);
+	std::fill(mask.begin(), mask.end(), 0u);
+	stats = {};
+}
+
+void OcclusionCuller::AddOccluder(const Float3* pPositions, size_t positionStride, const uint32_t* pIndices, size_t indexCount, const Matrix4& world)
+{
+	const Matrix4 worldViewProj = world * viewProj;
+	const float width = float(GetWidth());
+	const float height = float(GetHeight());
+	const uint8_t* const pBase = reinterpret_cast<const uint8_t*>(pPositions);
+	for (size_t i = 0; i + 2u < indexCount; i += 3u)
+	{
+		ScreenTriangle tri;
+		bool clipped = false;
+		for (int v = 0; v < 3; v++)
+		{
+			Float3 p;
+			std::memcpy(&p, pBase + pIndices[i + v] * positionStride, sizeof(p));
+			const Float4 clip = worldViewProj.TransformPoint(p);
+			if (clip.z < 0.0f || clip.w <= 0.0f)
+			{
+				clipped = true;
+				break;
+			}
+			const float invW = 1.0f / clip.w;
+			tri.x[v] = (clip.x * invW * 0.5f + 0.5f) * width;
+			tri.y[v] = (0.5f - clip.y * invW * 0.5f) * height;
+			tri.z[v] = clip.z * invW;
+		}
+		if (clipped)
+		{
+			continue;
+		}
+		// one winding for the edge setup, occluders are rendered double sided
+		const float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+		if (area == 0.0f)
+		{
+			continue;
+		}
+		if (area < 0.0f)
+		{
+			std::swap(tri.x[1], tri.x[2]);
+			std::swap(tri.y[1], tri.y[2]);
+			std::swap(tri.z[1], tri.z[2]);
+		}
+		triangles.push_back(tri);
+	}
+	stats.occluderTriangles = triangles.size();
+}
+
+void OcclusionCuller::AddOccluder(const Mesh& mesh, const Matrix4& world)
+{
+	const auto pPositions = reinterpret_cast<const Float3*>(static_cast<const uint8_t*>(mesh.GetVertexData()) + mesh.GetPositionOffset());
+	AddOccluder(pPositions, mesh.GetVertexStride(), mesh.GetIndices32(), mesh.GetIndexCount(), world);
+}
+
+void OcclusionCuller::RenderOccluders()
+{
+	// bands own disjoint tile rows, so no tile is ever written by two threads
+	const unsigned int nBands = unsigned(std::max<size_t>(1u, std::min<size_t>({ GetThreadCount(),tilesY,triangles.size() / minTrianglesPerBand })));
+	if (nBands == 1u)
+	{
+		RasterizeBand(0u, tilesY);
+		return;
+	}
+	pJobs->ParallelFor(0u, nBands, 1u, [this, nBands](size_t first, size_t last)
+	{
+		for (size_t b = first; b < last; b++)
+		{
+			RasterizeBand(unsigned(tilesY * b / nBands), unsigned(tilesY * (b + 1u) / nBands));
+		}
+	});
+}
+
+void OcclusionCuller::RasterizeBand(unsigned int firstTileRow, unsigned int endTileRow) noexcept
+{
+	for (const ScreenTriangle& tri : triangles)
+	{
+		RasterizeTriangle(tri, firstTileRow, endTileRow);
+	}
+}
+
+void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& tri, unsigned int firstTileRow, unsigned int endTileRow) noexcept
+{
+	const float minX = std::max(std::min({ tri.x[0],tri.x[1],tri.x[2] }), 0.0f);
+	const float maxX = std::min(std::max({ tri.x[0],tri.x[1],tri.x[2] }), float(GetWidth() - 1u));
+	const float minY = std::max(std::min({ tri.y[0],tri.y[1],tri.y[2] }), float(firstTileRow * tileHeight));
+	const float maxY = std::min(std::max({ tri.y[0],tri.y[1],tri.y[2] }), float(endTileRow * tileHeight) - 1.0f);
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+	const unsigned int tx0 = unsigned(minX) / tileWidth;
+	const unsigned int tx1 = unsigned(maxX) / tileWidth;
+	const unsigned int ty0 = unsigned(minY) / tileHeight;
+	const unsigned int ty1 = unsigned(maxY) / tileHeight;
+
+	const Edge edges[3] = {
+		MakeEdge(tri.x[0], tri.y[0], tri.x[1], tri.y[1]),
+		MakeEdge(tri.x[1], tri.y[1], tri.x[2], tri.y[2]),
+		MakeEdge(tri.x[2], tri.y[2], tri.x[0], tri.y[0])
+	};
+	// depth is linear in screen space: z = zA * x + zB * y + zC
+	const float dx1 = tri.x[1] - tri.x[0];
+	const float dy1 = tri.y[1] - tri.y[0];
+	const float dz1 = tri.z[1] - tri.z[0];
+	const float dx2 = tri.x[2] - tri.x[0];
+	const float dy2 = tri.y[2] - tri.y[0];
+	const float dz2 = tri.z[2] - tri.z[0];
+	const float invArea = 1.0f / (dx1 * dy2 - dx2 * dy1);
+	const float zA = (dz1 * dy2 - dz2 * dy1) * invArea;
+	const float zB = (dx1 * dz2 - dx2 * dz1) * invArea;
+	const float zC = tri.z[0] - zA * tri.x[0] - zB * tri.y[0];
+	const float triZMin = std::min({ tri.z[0],tri.z[1],tri.z[2] });
+	const float triZMax = std::max({ tri.z[0],tri.z[1],tri.z[2] });
+
+	for (unsigned int ty = ty0; ty <= ty1; ty++)
+	{
+		const float py = float(ty * tileHeight);
+		for (unsigned int tx = tx0; tx <= tx1; tx++)
+		{
+			const float px = float(tx * tileWidth);
+			const uint32_t coverage = CoverageMask(edges, px + 0.5f, py + 0.5f);
+			if (coverage == 0u)
+			{
+				continue;
+			}
+			// the plane's extremes over the tile are at its corners, the triangle's own range bounds it too
+			const float z00 = zA * px + zB * py + zC;
+			const float z10 = z00 + zA * float(tileWidth);
+			const float z01 = z00 + zB * float(tileHeight);
+			const float z11 = z10 + zB * float(tileHeight);
+			const float zMin = std::max(std::min({ z00,z10,z01,z11 }), triZMin);
+			const float zMax = std::min(std::max({ z00,z10,z01,z11 }), triZMax);
+			UpdateTile(size_t(ty) * tilesX + tx, coverage, zMin, zMax);
+		}
+	}
+}
+
+void OcclusionCuller::UpdateTile(size_t tile, uint32_t coverage, float zMin, float zMax) noexcept
+{
+	float& z0 = zMax0[tile];
+	float& z1 = zMax1[tile];
+	uint32_t& m = mask[tile];
+	if (zMin >= z0)
+	{
+		return;
+	}
+	// a triangle much nearer than the working layer starts a new layer rather than dragging it back
+	if (m != 0u && z1 - zMax > z0 - z1)
+	{
+		z1 = 0.0f;
+		m = 0u;
+	}
+	z1 = std::max(z1, zMax);
+	m |= coverage;
+	// a fully covered working layer becomes the reference layer
+	if (m == fullMask)
+	{
+		z0 = std::min(z0, z1);
+		z1 = 0.0f;
+		m = 0u;
+	}
+}
+
+bool OcclusionCuller::IsVisible(const Float3& center, const Float3& extents) const noexcept
+{
+	const float width = float(GetWidth());
+	const float height = float(GetHeight());
+	float minX = width;
+	float maxX = 0.0f;
+	float minY = height;
+	float maxY = 0.0f;
+	float zMin = 1.0f;
+	for (int i = 0; i < 8; i++)
+	{
+		const Float3 corner = {
+			center.x + (i & 1 ? extents.x : -extents.x),
+			center.y + (i & 2 ? extents.y : -extents.y),
+			center.z + (i & 4 ? extents.z : -extents.z)
+		};
+		const Float4 clip = viewProj.TransformPoint(corner);
+		// reaches in front of the near plane, no conservative screen rectangle
+		if (clip.z < 0.0f || clip.w <= 0.0f)
+		{
+			return true;
+		}
+		const float invW = 1.0f / clip.w;
+		const float x = (clip.x * invW * 0.5f + 0.5f) * width;
+		const float y = (0.5f - clip.y * invW * 0.5f) * height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		zMin = std::min(zMin, clip.z * invW);
+	}
+	if (maxX < 0.0f || minX >= width || maxY < 0.0f || minY >= height)
+	{
+		return false;
+	}
+	const unsigned int tx0 = unsigned(std::max(minX, 0.0f)) / tileWidth;
+	const unsigned int tx1 = unsigned(std::min(maxX, width - 1.0f)) / tileWidth;
+	const unsigned int ty0 = unsigned(std::max(minY, 0.0f)) / tileHeight;
+	const unsigned int ty1 = unsigned(std::min(maxY, height - 1.0f)) / tileHeight;
+	for (unsigned int ty = ty0; ty <= ty1; ty++)
+	{
+		const float* const pRow = zMax0.data() + size_t(ty) * tilesX;
+		for (unsigned int tx = tx0; tx <= tx1; tx++)
+		{
+			if (zMin < pRow[tx])
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void OcclusionCuller::TestBoxes(const BoxBounds& bounds, std::vector<uint32_t>& visible)
+{
+	const size_t count = bounds.Size();
+	visible.resize(count);
+	const size_t nRanges = pJobs ? std::max<size_t>(1u, std::min<size_t>(GetThreadCount() * rangesPerThread, count / minBoxesPerRange)) : 1u;
+	if (nRanges == 1u)
+	{
+		visible.resize(TestRange(bounds, 0u, count, visible.data()));
+	}
+	else
+	{
+		// same scheme as FrustumCuller: write at the range start, then slide the partial lists together
+		const auto rangeBegin = [&](size_t r)
+		{
+			return count * r / nRanges;
+		};
+		found.resize(nRanges);
+		pJobs->ParallelFor(0u, nRanges, 1u, [&](size_t first, size_t last)
+		{
+			for (size_t r = first; r < last; r++)
+			{
+				found[r] = TestRange(bounds, rangeBegin(r), rangeBegin(r + 1u), visible.data() + rangeBegin(r));
+			}
+		});
+		size_t n = found[0];
+		for (size_t r = 1; r < nRanges; r++)
+		{
+			std::memmove(visible.data() + n, visible.data() + rangeBegin(r), found[r] * sizeof(uint32_t));
+			n += found[r];
+		}
+		visible.resize(n);
+	}
+	stats.tested += count;
+	stats.culled += count - visible.size();
+}
+
+size_t OcclusionCuller::TestRange(const BoxBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) const noexcept
+{
+	size_t n = 0u;
+	for (size_t i = begin; i < end; i++)
+	{
+		const Float3 center = { bounds.centerX[i],bounds.centerY[i],bounds.centerZ[i] };
+		const Float3 extents = { bounds.extentX[i],bounds.extentY[i],bounds.extentZ[i] };
+		if (IsVisible(center, extents))
+		{
+			pVisible[n++] = uint32_t(i);
+		}
+	}
+	return n;
+}
+
+unsigned int OcclusionCuller::GetWidth() const noexcept
+{
+	return tilesX * tileWidth;
+}
+
+unsigned int OcclusionCuller::GetHeight() const noexcept
+{
+	return tilesY * tileHeight;
+}
+
+unsigned int OcclusionCuller::GetThreadCount() const noexcept
+{
+	return pJobs ? pJobs->GetThreadCount() : 1u;
+}
+
+float OcclusionCuller::GetTileDepth(unsigned int x, unsigned int y) const noexcept
+{
+	return zMax0[size_t(y / tileHeight) * tilesX + x / tileWidth];
+}
+
+const OcclusionCuller::Stats& OcclusionCuller::GetStats() const noexcept
+{
+	return stats;
+}
\ No newline at end of file
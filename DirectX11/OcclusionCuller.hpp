@@ -0,0 +1,76 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include "FrustumCuller.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+class Mesh;
+
+// masked software occlusion culling: occluder triangles are rasterized into a low resolution depth
+// buffer of 8x4 pixel tiles, each tile keeps a coverage mask and two max depth layers instead of
+// per pixel depth; occludee boxes are then tested against the conservative per tile depth.
+// depth follows D3D (0 = near), a box is occluded when every tile under it holds only nearer depth
+class OcclusionCuller
+{
+public:
+	struct Stats
+	{
+		size_t occluderTriangles = 0u;
+		size_t tested = 0u;
+		size_t culled = 0u;
+		float CulledPercent() const noexcept;
+	};
+public:
+	static constexpr unsigned int tileWidth = 8u;
+	static constexpr unsigned int tileHeight = 4u;
+public:
+	// width / height are rounded up to whole tiles; without a job system everything runs on the calling thread
+	OcclusionCuller(unsigned int width = 320u, unsigned int height = 192u, JobSystem* pJobs = nullptr);
+	// clears the depth buffer, occluders and stats for a new view
+	void BeginFrame(const Matrix4& viewProj);
+	// transforms the triangles into screen space; triangles crossing the near plane are dropped
+	// (fewer occluders only means less culling)
+	void AddOccluder(const Float3* pPositions, size_t positionStride, const uint32_t* pIndices, size_t indexCount, const Matrix4& world);
+	void AddOccluder(const Mesh& mesh, const Matrix4& world);
+	// rasterizes every added occluder, the screen is split into bands of tile rows that run as jobs
+	void RenderOccluders();
+	// false when the box is hidden behind rendered occluders or entirely outside the screen
+	bool IsVisible(const Float3& center, const Float3& extents) const noexcept;
+	// compact, ascending list of the visible boxes
+	void TestBoxes(const BoxBounds& bounds, std::vector<uint32_t>& visible);
+	unsigned int GetWidth() const noexcept;
+	unsigned int GetHeight() const noexcept;
+	unsigned int GetThreadCount() const noexcept;
+	// farthest depth that is certain for the tile holding pixel (x, y), for debug views
+	float GetTileDepth(unsigned int x, unsigned int y) const noexcept;
+	const Stats& GetStats() const noexcept;
+private:
+	struct ScreenTriangle
+	{
+		float x[3];
+		float y[3];
+		float z[3];
+	};
+private:
+	void RasterizeBand(unsigned int firstTileRow, unsigned int endTileRow) noexcept;
+	void RasterizeTriangle(const ScreenTriangle& tri, unsigned int firstTileRow, unsigned int endTileRow) noexcept;
+	void UpdateTile(size_t tile, uint32_t coverage, float zMin, float zMax) noexcept;
+	size_t TestRange(const BoxBounds& bounds, size_t begin, size_t end, uint32_t* pVisible) const noexcept;
+private:
+	static constexpr size_t minTrianglesPerBand = 256u;
+	static constexpr size_t minBoxesPerRange = 4096u;
+	static constexpr size_t rangesPerThread = 4u;
+	unsigned int tilesX;
+	unsigned int tilesY;
+	JobSystem* pJobs;
+	Matrix4 viewProj = Matrix4::Identity();
+	std::vector<ScreenTriangle> triangles;
+	// per tile, structure-of-arrays: zMax0 bounds every pixel of the tile, zMax1 bounds the pixels in mask
+	std::vector<float> zMax0;
+	std::vector<float> zMax1;
+	std::vector<uint32_t> mask;
+	std::vector<size_t> found;
+	Stats stats;
+};
\ No newline at end of file
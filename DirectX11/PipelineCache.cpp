@@ -0,0 +1,106 @@
+#include "PipelineCache.hpp"
+
+DescriptorKey& DescriptorKey::AddString(const char* pString)
+{
+	const size_t length = pString ? std::strlen(pString) : 0u;
+	Add(uint32_t(length));
+	bytes.insert(bytes.end(), pString, pString + length);
+	return *this;
+}
+
+DescriptorKey& DescriptorKey::AddBytecode(const ShaderBytecode& code)
+{
+	Add(uint64_t(code.size));
+	Add(HashBytes(code.pData, code.size));
+	// second, differently seeded hash makes an accidental match of two shaders practically impossible
+	Add(HashBytes(code.pData, code.size, 0x9E3779B97F4A7C15ull));
+	return *this;
+}
+
+uint64_t DescriptorKey::Hash() const noexcept
+{
+	return HashBytes(bytes.data(), bytes.size());
+}
+
+bool DescriptorKey::operator==(const DescriptorKey& rhs) const noexcept
+{
+	return bytes == rhs.bytes;
+}
+
+uint64_t DescriptorKey::HashBytes(const void* pData, size_t size, uint64_t seed) noexcept
+{
+	const uint8_t* p = static_cast<const uint8_t*>(pData);
+	uint64_t h = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		h ^= p[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+namespace
+{
+	// fields one by one so struct padding never leaks into the key
+	DescriptorKey& AddStencilOp(DescriptorKey& key, const StencilOpDesc& op)
+	{
+		return key.Add(op.stencilFailOp)
+			.Add(op.stencilDepthFailOp)
+			.Add(op.stencilPassOp)
+			.Add(op.stencilFunc);
+	}
+
+	DescriptorKey& AddDepthStencil(DescriptorKey& key, const DepthStencilDesc& desc)
+	{
+		key.Add(uint8_t(desc.depthEnable))
+			.Add(desc.depthWriteMask)
+			.Add(desc.depthFunc)
+			.Add(uint8_t(desc.stencilEnable))
+			.Add(desc.stencilReadMask)
+			.Add(desc.stencilWriteMask);
+		AddStencilOp(key, desc.frontFace);
+		return AddStencilOp(key, desc.backFace);
+	}
+}
+
+DescriptorKey MakeKey(const DepthStencilDesc& desc)
+{
+	DescriptorKey key;
+	key.Add(uint8_t('D'));
+	AddDepthStencil(key, desc);
+	return key;
+}
+
+DescriptorKey MakeKey(const ShaderBytecode& code)
+{
+	DescriptorKey key;
+	key.Add(uint8_t('S')).AddBytecode(code);
+	return key;
+}
+
+DescriptorKey MakeKey(const InputElementDesc* pElements, size_t count, const ShaderBytecode& vertexShader)
+{
+	DescriptorKey key;
+	key.Add(uint8_t('L')).Add(uint32_t(count));
+	for (size_t i = 0; i < count; i++)
+	{
+		const InputElementDesc& e = pElements[i];
+		key.AddString(e.semanticName)
+			.Add(e.semanticIndex)
+			.Add(e.format)
+			.Add(e.inputSlot)
+			.Add(e.alignedByteOffset)
+			.Add(uint8_t(e.perInstance))
+			.Add(e.instanceDataStepRate);
+	}
+	key.AddBytecode(vertexShader);
+	return key;
+}
+
+DescriptorKey MakeKey(const PipelineDesc& desc)
+{
+	DescriptorKey key = MakeKey(desc.pInputElements, desc.inputElementCount, desc.vertexShader);
+	key.Add(uint8_t('P')).AddBytecode(desc.pixelShader);
+	AddDepthStencil(key, desc.depthStencil);
+	return key;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// platform free mirrors of the D3D11 descriptors that make up a pipeline,
+// enum fields carry the raw D3D11 / DXGI values
+struct ShaderBytecode
+{
+	const void* pData = nullptr;
+	size_t size = 0u;
+};
+
+struct StencilOpDesc
+{
+	// D3D11_STENCIL_OP_KEEP
+	uint32_t stencilFailOp = 1u;
+	uint32_t stencilDepthFailOp = 1u;
+	uint32_t stencilPassOp = 1u;
+	// D3D11_COMPARISON_ALWAYS
+	uint32_t stencilFunc = 8u;
+};
+
+struct DepthStencilDesc
+{
+	bool depthEnable = true;
+	// D3D11_DEPTH_WRITE_MASK_ALL
+	uint32_t depthWriteMask = 1u;
+	// D3D11_COMPARISON_LESS
+	uint32_t depthFunc = 2u;
+	bool stencilEnable = false;
+	uint8_t stencilReadMask = 0xFFu;
+	uint8_t stencilWriteMask = 0xFFu;
+	StencilOpDesc frontFace;
+	StencilOpDesc backFace;
+};
+
+struct InputElementDesc
+{
+	const char* semanticName = nullptr;
+	uint32_t semanticIndex = 0u;
+	// DXGI_FORMAT
+	uint32_t format = 0u;
+	uint32_t inputSlot = 0u;
+	uint32_t alignedByteOffset = 0u;
+	bool perInstance = false;
+	uint32_t instanceDataStepRate = 0u;
+};
+
+struct PipelineDesc
+{
+	ShaderBytecode vertexShader;
+	ShaderBytecode pixelShader;
+	const InputElementDesc* pInputElements = nullptr;
+	size_t inputElementCount = 0u;
+	DepthStencilDesc depthStencil;
+};
+
+// serialized descriptor plus its 64 bit FNV-1a hash; equality compares the bytes, so hash collisions are harmless
+class DescriptorKey
+{
+public:
+	template<typename T>
+	DescriptorKey& Add(const T& value)
+	{
+		const size_t at = bytes.size();
+		bytes.resize(at + sizeof(T));
+		std::memcpy(bytes.data() + at, &value, sizeof(T));
+		return *this;
+	}
+	DescriptorKey& AddString(const char* pString);
+	// shaders go in by content hash and size rather than by value to keep keys small
+	DescriptorKey& AddBytecode(const ShaderBytecode& code);
+	uint64_t Hash() const noexcept;
+	bool operator==(const DescriptorKey& rhs) const noexcept;
+	static uint64_t HashBytes(const void* pData, size_t size, uint64_t seed = 14695981039346656037ull) noexcept;
+private:
+	std::vector<uint8_t> bytes;
+};
+
+DescriptorKey MakeKey(const DepthStencilDesc& desc);
+DescriptorKey MakeKey(const ShaderBytecode& code);
+// an input layout is validated against the vertex shader signature, so the shader is part of its key
+DescriptorKey MakeKey(const InputElementDesc* pElements, size_t count, const ShaderBytecode& vertexShader);
+DescriptorKey MakeKey(const PipelineDesc& desc);
+
+// hash -> shared object map; Object is a ref counted handle (ComPtr, shared_ptr) so callers share instances
+template<typename Object>
+class StateCache
+{
+public:
+	struct Stats
+	{
+		unsigned long long hits = 0u;
+		unsigned long long misses = 0u;
+	};
+public:
+	template<typename Factory>
+	Object GetOrCreate(const DescriptorKey& key, Factory&& create)
+	{
+		auto& bucket = entries[key.Hash()];
+		for (const auto& e : bucket)
+		{
+			if (e.key == key)
+			{
+				stats.hits++;
+				return e.object;
+			}
+		}
+		stats.misses++;
+		Object object = create();
+		bucket.push_back({ key,object });
+		return object;
+	}
+	size_t Size() const noexcept
+	{
+		size_t n = 0u;
+		for (const auto& b : entries)
+		{
+			n += b.second.size();
+		}
+		return n;
+	}
+	void Clear() noexcept
+	{
+		entries.clear();
+	}
+	const Stats& GetStats() const noexcept
+	{
+		return stats;
+	}
+private:
+	struct Entry
+	{
+		DescriptorKey key;
+		Object object;
+	};
+	std::unordered_map<uint64_t, std::vector<Entry>> entries;
+	Stats stats;
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "PlatformWindow.hpp"
+
+PlatformWindow::PlatformWindow(int width, int height) noexcept
+	:
+	width(width),
+	height(height)
+{}
+
+int PlatformWindow::GetWidth() const noexcept
+{
+	return width;
+}
+
+int PlatformWindow::GetHeight() const noexcept
+{
+	return height;
+}
+
+void PlatformWindow::OnKeyDown(unsigned char keycode, bool repeat) noexcept
+{
+	if (!repeat || kbd.AutorepeatIsEnabled())
+	{
+		kbd.OnKeyPressed(keycode);
+	}
+}
+
+void PlatformWindow::OnKeyUp(unsigned char keycode) noexcept
+{
+	kbd.OnKeyReleased(keycode);
+}
+
+void PlatformWindow::OnChar(char character) noexcept
+{
+	kbd.OnChar(character);
+}
+
+void PlatformWindow::OnFocusLost() noexcept
+{
+	kbd.ClearState();
+}
+
+bool PlatformWindow::OnMouseMove(int x, int y) noexcept
+{
+	// in client region -> log move, and log enter (if not previously in window)
+	if (IsInClientArea(x, y))
+	{
+		mouse.OnMouseMove(x, y);
+		if (!mouse.IsInWindow())
+		{
+			mouse.OnMouseEnter();
+		}
+		return false;
+	}
+	// not in client -> log move while a button is down (drag), otherwise log leaving
+	if (mouse.LeftIsPressed() || mouse.RightIsPressed())
+	{
+		mouse.OnMouseMove(x, y);
+		return false;
+	}
+	mouse.OnMouseLeave();
+	return true;
+}
+
+void PlatformWindow::OnLeftDown(int x, int y) noexcept
+{
+	mouse.OnLeftPressed(x, y);
+}
+
+void PlatformWindow::OnRightDown(int x, int y) noexcept
+{
+	mouse.OnRightPressed(x, y);
+}
+
+bool PlatformWindow::OnLeftUp(int x, int y) noexcept
+{
+	mouse.OnLeftReleased(x, y);
+	if (IsInClientArea(x, y))
+	{
+		return false;
+	}
+	mouse.OnMouseLeave();
+	return true;
+}
+
+bool PlatformWindow::OnRightUp(int x, int y) noexcept
+{
+	mouse.OnRightReleased(x, y);
+	if (IsInClientArea(x, y))
+	{
+		return false;
+	}
+	mouse.OnMouseLeave();
+	return true;
+}
+
+void PlatformWindow::OnWheel(int x, int y, int delta) noexcept
+{
+	mouse.OnWheelDelta(x, y, delta);
+}
+
+bool PlatformWindow::IsInClientArea(int x, int y) const noexcept
+{
+	return x >= 0 && x < width && y >= 0 && y < height;
+}
\ No newline at end of file
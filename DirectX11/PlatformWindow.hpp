@@ -0,0 +1,52 @@
+#pragma once
+#include "Keyboard.hpp"
+#include "Mouse.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+
+// what the engine needs from a window on any platform: a title, a non blocking event pump and the
+// keyboard / mouse state that pump feeds. implementations turn their native events into the
+// protected On* calls, the only way input reaches kbd and mouse
+class PlatformWindow
+{
+public:
+	PlatformWindow(int width, int height) noexcept;
+	virtual ~PlatformWindow() = default;
+	PlatformWindow(const PlatformWindow&) = delete;
+	PlatformWindow& operator=(const PlatformWindow&) = delete;
+	virtual void SetTitle(const std::string& title) = 0;
+	// handles every pending event without blocking; a value is the exit code once the window is closed
+	virtual std::optional<int> ProcessMessages() = 0;
+	// HWND on Win32, nullptr when there is no native window
+	virtual void* GetNativeHandle() const noexcept = 0;
+	// client area in pixels
+	int GetWidth() const noexcept;
+	int GetHeight() const noexcept;
+	// Window on Win32, HeadlessWindow everywhere else
+	static std::unique_ptr<PlatformWindow> Create(int width, int height, const char* name);
+public:
+	Keyboard kbd;
+	Mouse mouse;
+protected:
+	// keycodes are Win32 virtual key codes; repeats of a held key are dropped unless autorepeat is on
+	void OnKeyDown(unsigned char keycode, bool repeat) noexcept;
+	void OnKeyUp(unsigned char keycode) noexcept;
+	void OnChar(char character) noexcept;
+	// releases every key so nothing stays stuck while the window is not looking
+	void OnFocusLost() noexcept;
+	// client coordinates; returns whether the move left the client area with no button held,
+	// which is when a native implementation releases its pointer capture
+	bool OnMouseMove(int x, int y) noexcept;
+	void OnLeftDown(int x, int y) noexcept;
+	void OnRightDown(int x, int y) noexcept;
+	// same return as OnMouseMove, for a button let go outside the client area
+	bool OnLeftUp(int x, int y) noexcept;
+	bool OnRightUp(int x, int y) noexcept;
+	// raw wheel delta, 120 per notch
+	void OnWheel(int x, int y, int delta) noexcept;
+	bool IsInClientArea(int x, int y) const noexcept;
+protected:
+	int width;
+	int height;
+};
\ No newline at end of file
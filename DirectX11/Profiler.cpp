@@ -0,0 +1,238 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	// end of a zone that has not closed yet
+	constexpr int64_t openZone = std::numeric_limits<int64_t>::min();
+
+	// fields are relaxed atomics (plain moves on x86) so an export racing the owner is still defined.
+	// end is the closing tick of an outermost zone, and for a nested zone the ring index of the
+	// next zone the thread opened after it closed
+	struct Event
+	{
+		std::atomic<const char*> pName{ nullptr };
+		std::atomic<int64_t> begin{ 0 };
+		std::atomic<int64_t> end{ openZone };
+		std::atomic<uint32_t> depth{ 0u };
+	};
+
+	struct ThreadBuffer
+	{
+		explicit ThreadBuffer(unsigned int id)
+			:
+			id(id),
+			name("thread " + std::to_string(id)),
+			pEvents(std::make_unique<Event[]>(Profiler::eventsPerThread))
+		{}
+		unsigned int id;
+		// guarded by the registry mutex
+		std::string name;
+		std::unique_ptr<Event[]> pEvents;
+		// zones written so far, only the owning thread stores it
+		std::atomic<uint64_t> head{ 0u };
+		// zones open right now, only the owning thread touches it
+		uint32_t depth = 0u;
+	};
+
+	// buffers outlive their threads so an export still sees zones of threads that have exited
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		// nodes never move, so their c_str() stays put
+		std::unordered_set<std::string> names;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	thread_local ThreadBuffer* pCurrentBuffer = nullptr;
+
+	ThreadBuffer& GetCurrentBuffer()
+	{
+		if (!pCurrentBuffer)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.buffers.push_back(std::make_unique<ThreadBuffer>(unsigned(registry.buffers.size()) + 1u));
+			pCurrentBuffer = registry.buffers.back().get();
+		}
+		return *pCurrentBuffer;
+	}
+
+	void WriteJsonString(std::ostream& out, const char* p)
+	{
+		out << '"';
+		for (; p && *p; p++)
+		{
+			if (*p == '"' || *p == '\\')
+			{
+				out << '\\';
+			}
+			out << (static_cast<unsigned char>(*p) < 0x20u ? ' ' : *p);
+		}
+		out << '"';
+	}
+
+	// chrome wants microseconds, keep the nanosecond digits
+	void WriteMicroseconds(std::ostream& out, int64_t ns)
+	{
+		const int64_t fraction = ns % 1000;
+		out << ns / 1000 << '.' << char('0' + fraction / 100) << char('0' + fraction / 10 % 10) << char('0' + fraction % 10);
+	}
+}
+
+uint64_t Profiler::Begin(const char* pName) noexcept
+{
+	constexpr uint64_t mask = eventsPerThread - 1u;
+	ThreadBuffer* pBuffer = pCurrentBuffer;
+	if (!pBuffer)
+	{
+		pBuffer = &GetCurrentBuffer();
+	}
+	const int64_t begin = HighPrecisionClock::Ticks();
+	const uint64_t h = pBuffer->head.load(std::memory_order_relaxed);
+	Event& e = pBuffer->pEvents[h & mask];
+	e.pName.store(pName, std::memory_order_relaxed);
+	e.begin.store(begin, std::memory_order_relaxed);
+	e.end.store(openZone, std::memory_order_relaxed);
+	e.depth.store(pBuffer->depth++, std::memory_order_relaxed);
+	// publishes the event to an exporter that acquires head
+	pBuffer->head.store(h + 1u, std::memory_order_release);
+	return h;
+}
+
+void Profiler::End(uint64_t index) noexcept
+{
+	constexpr uint64_t mask = eventsPerThread - 1u;
+	ThreadBuffer& buffer = *pCurrentBuffer;
+	const uint64_t h = buffer.head.load(std::memory_order_relaxed);
+	// only the outermost zone pays for a second clock read, a nested one ends where the next zone opens
+	const int64_t end = --buffer.depth == 0u ? HighPrecisionClock::Ticks() : int64_t(h);
+	// a zone that stayed open for a whole ring of nested zones has lost its slot
+	if (h - index < eventsPerThread)
+	{
+		buffer.pEvents[index & mask].end.store(end, std::memory_order_relaxed);
+	}
+}
+
+const char* Profiler::Intern(const std::string& name)
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	return registry.names.insert(name).first->c_str();
+}
+
+void Profiler::SetThreadName(std::string name)
+{
+	ThreadBuffer& buffer = GetCurrentBuffer();
+	std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+	buffer.name = std::move(name);
+}
+
+void Profiler::WriteChromeTrace(std::ostream& out)
+{
+	constexpr uint64_t mask = eventsPerThread - 1u;
+	struct Copy
+	{
+		const char* pName;
+		int64_t begin;
+		int64_t end;
+		uint32_t depth;
+	};
+	std::vector<Copy> events;
+	// end tick of the zone open at each depth, openZone where it is not known
+	std::vector<int64_t> enclosingEnds;
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	const auto separate = [&]()
+	{
+		out << (first ? "\n" : ",\n");
+		first = false;
+	};
+	for (const auto& pBuffer : registry.buffers)
+	{
+		separate();
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pBuffer->id << ",\"args\":{\"name\":";
+		WriteJsonString(out, pBuffer->name.c_str());
+		out << "}}";
+
+		// copy what is there, then drop whatever the owner may have overwritten meanwhile
+		// (including the slot it may be writing right now)
+		const uint64_t before = pBuffer->head.load(std::memory_order_acquire);
+		const uint64_t oldest = before > eventsPerThread ? before - eventsPerThread : 0u;
+		events.clear();
+		for (uint64_t i = oldest; i < before; i++)
+		{
+			const Event& e = pBuffer->pEvents[i & mask];
+			events.push_back({
+				e.pName.load(std::memory_order_relaxed),
+				e.begin.load(std::memory_order_relaxed),
+				e.end.load(std::memory_order_relaxed),
+				e.depth.load(std::memory_order_relaxed) });
+		}
+		const uint64_t after = pBuffer->head.load(std::memory_order_acquire);
+		const uint64_t firstSafe = std::max(oldest, after + 1u > eventsPerThread ? after + 1u - eventsPerThread : 0u);
+		enclosingEnds.clear();
+		for (uint64_t i = firstSafe; i < before; i++)
+		{
+			const Copy& e = events[size_t(i - oldest)];
+			// zones come in the order they opened, so the enclosing zone's end is already resolved
+			enclosingEnds.resize(size_t(e.depth) + 1u, openZone);
+			const int64_t parentEnd = e.depth > 0u ? enclosingEnds[e.depth - 1u] : openZone;
+			int64_t end = openZone;
+			if (e.end != openZone && e.depth == 0u)
+			{
+				end = e.end;
+			}
+			else if (e.end != openZone && uint64_t(e.end) > i && uint64_t(e.end) < before)
+			{
+				end = events[size_t(uint64_t(e.end) - oldest)].begin;
+			}
+			if (parentEnd != openZone && (end == openZone || parentEnd < end))
+			{
+				end = parentEnd;
+			}
+			enclosingEnds[e.depth] = end;
+			// still open, or closed with nothing after it yet to say when
+			if (end == openZone)
+			{
+				continue;
+			}
+			const int64_t beginNs = HighPrecisionClock::TicksToNanoseconds(e.begin);
+			separate();
+			out << "{\"name\":";
+			WriteJsonString(out, e.pName);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << pBuffer->id << ",\"ts\":";
+			WriteMicroseconds(out, beginNs);
+			out << ",\"dur\":";
+			WriteMicroseconds(out, HighPrecisionClock::TicksToNanoseconds(end) - beginNs);
+			out << '}';
+		}
+	}
+	out << "\n]}\n";
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		return false;
+	}
+	WriteChromeTrace(file);
+	return bool(file);
+}
\ No newline at end of file
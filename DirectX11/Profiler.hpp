@@ -0,0 +1,64 @@
+#pragma once
+#include "Clock.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// compile with CHILI_PROFILING=0 and every PROFILE_ macro expands to nothing
+#ifndef CHILI_PROFILING
+#define CHILI_PROFILING 1
+#endif
+
+// scoped timing zones: each thread writes finished zones into a ring of its own (no locks, the
+// oldest zones are overwritten), any thread can export all rings as Chrome trace event JSON.
+// zones keep raw clock ticks, scaling to nanoseconds is left to the export.
+// a nested zone reads the clock once, when it opens: it ends where the next zone on its thread
+// opens, or with its parent, whichever comes first. only outermost zones read the clock again
+// when they close, so time outside of any zone is never charged to one
+// zone names are not copied, they have to outlive the export; string literals always do, run time
+// names go through Intern
+class Profiler
+{
+public:
+	class Zone
+	{
+	public:
+		explicit Zone(const char* pName) noexcept
+			:
+			index(Profiler::Begin(pName))
+		{}
+		~Zone()
+		{
+			Profiler::End(index);
+		}
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+	private:
+		uint64_t index;
+	};
+public:
+	// opens a zone on the calling thread and returns its place in the thread's ring
+	static uint64_t Begin(const char* pName) noexcept;
+	// closes the zone Begin returned, on the same thread and innermost first
+	static void End(uint64_t index) noexcept;
+	// a copy of name that lives as long as the process, the same pointer for equal names
+	static const char* Intern(const std::string& name);
+	// shown as the track name of the calling thread
+	static void SetThreadName(std::string name);
+	// chrome://tracing or ui.perfetto.dev
+	static void WriteChromeTrace(std::ostream& out);
+	static bool WriteChromeTrace(const std::string& path);
+	// zones each thread keeps before overwriting its oldest
+	static constexpr size_t eventsPerThread = size_t(1) << 16;
+};
+
+#if CHILI_PROFILING
+#define CHILI_PROFILE_CONCAT_(a, b) a##b
+#define CHILI_PROFILE_CONCAT(a, b) CHILI_PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone CHILI_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,447 @@
+#include "RecordingRenderContext.hpp"
+#include <cstring>
+
+namespace
+{
+	using Op = RecordingRenderContext::Op;
+
+	// arguments every op is recorded with, UpdateBuffer adds its payload after them
+	constexpr unsigned int argCounts[size_t(Op::Count)] = {
+		1u,	// Topology
+		1u,	// InputLayout
+		4u,	// VertexBuffer
+		3u,	// IndexBuffer
+		1u,	// VertexShader
+		1u,	// PixelShader
+		4u,	// ConstantBuffer
+		2u,	// RenderTarget
+		2u,	// DepthStencilState
+		2u,	// Map
+		1u,	// Unmap
+		3u,	// UpdateBuffer
+		5u,	// ClearRenderTarget
+		2u,	// ClearDepth
+		3u,	// DrawIndexed
+		5u	// DrawIndexedInstanced
+	};
+
+	// bit i set when argument i is a handle
+	constexpr uint8_t handleArgs[size_t(Op::Count)] = {
+		0x00u,	// Topology
+		0x01u,	// InputLayout
+		0x02u,	// VertexBuffer
+		0x01u,	// IndexBuffer
+		0x01u,	// VertexShader
+		0x01u,	// PixelShader
+		0x02u,	// ConstantBuffer
+		0x03u,	// RenderTarget
+		0x01u,	// DepthStencilState
+		0x01u,	// Map
+		0x01u,	// Unmap
+		0x01u,	// UpdateBuffer
+		0x01u,	// ClearRenderTarget
+		0x01u,	// ClearDepth
+		0x00u,	// DrawIndexed
+		0x00u	// DrawIndexedInstanced
+	};
+
+	template<typename Handle>
+	Handle ToHandle(uint64_t value) noexcept
+	{
+		return Handle(uintptr_t(value));
+	}
+}
+
+float RecordingRenderContext::Call::GetFloat(size_t i) const noexcept
+{
+	const uint32_t bits = uint32_t(args[i]);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+RecordingRenderContext::RecordingRenderContext(IRenderContext& inner, bool enabled) noexcept
+	:
+	inner(inner),
+	enabled(enabled)
+{}
+
+void RecordingRenderContext::SetEnabled(bool enabled_in) noexcept
+{
+	enabled = enabled_in;
+}
+
+bool RecordingRenderContext::IsEnabled() const noexcept
+{
+	return enabled;
+}
+
+const std::vector<uint8_t>& RecordingRenderContext::GetBytes() const noexcept
+{
+	return bytes;
+}
+
+size_t RecordingRenderContext::GetCallCount() const noexcept
+{
+	size_t n = 0u;
+	for (const size_t c : counts)
+	{
+		n += c;
+	}
+	return n;
+}
+
+size_t RecordingRenderContext::GetCallCount(Op op) const noexcept
+{
+	return counts[size_t(op)];
+}
+
+void RecordingRenderContext::Clear() noexcept
+{
+	bytes.clear();
+	counts = {};
+}
+
+bool RecordingRenderContext::Decode(const uint8_t* pBytes, size_t size, std::vector<Call>& calls)
+{
+	const uint8_t* p = pBytes;
+	const uint8_t* const pEnd = pBytes + size;
+	while (p != pEnd)
+	{
+		Call call;
+		if (*p >= uint8_t(Op::Count))
+		{
+			return false;
+		}
+		call.op = Op(*p++);
+		for (unsigned int i = 0; i < argCounts[size_t(call.op)]; i++)
+		{
+			if (!GetVarint(p, pEnd, call.args[i]))
+			{
+				return false;
+			}
+		}
+		if (call.op == Op::UpdateBuffer)
+		{
+			uint64_t payload = 0u;
+			if (!GetVarint(p, pEnd, payload) || payload > uint64_t(pEnd - p))
+			{
+				return false;
+			}
+			call.pData = p;
+			call.size = size_t(payload);
+			p += payload;
+		}
+		calls.push_back(call);
+	}
+	return true;
+}
+
+std::vector<RecordingRenderContext::Call> RecordingRenderContext::Decode() const
+{
+	std::vector<Call> calls;
+	calls.reserve(GetCallCount());
+	Decode(bytes.data(), bytes.size(), calls);
+	return calls;
+}
+
+void RecordingRenderContext::Replay(const Call& c, IRenderContext& target)
+{
+	const auto& a = c.args;
+	switch (c.op)
+	{
+	case Op::Topology:
+		target.IASetPrimitiveTopology(Topology(a[0]));
+		break;
+	case Op::InputLayout:
+		target.IASetInputLayout(ToHandle<InputLayoutHandle>(a[0]));
+		break;
+	case Op::VertexBuffer:
+		target.IASetVertexBuffer(unsigned(a[0]), ToHandle<BufferHandle>(a[1]), unsigned(a[2]), unsigned(a[3]));
+		break;
+	case Op::IndexBuffer:
+		target.IASetIndexBuffer(ToHandle<BufferHandle>(a[0]), IndexFormat(a[1]), unsigned(a[2]));
+		break;
+	case Op::VertexShader:
+		target.VSSetShader(ToHandle<VertexShaderHandle>(a[0]));
+		break;
+	case Op::PixelShader:
+		target.PSSetShader(ToHandle<PixelShaderHandle>(a[0]));
+		break;
+	case Op::ConstantBuffer:
+		target.VSSetConstantBuffer(unsigned(a[0]), ToHandle<BufferHandle>(a[1]), unsigned(a[2]), unsigned(a[3]));
+		break;
+	case Op::RenderTarget:
+		target.OMSetRenderTarget(ToHandle<RenderTargetHandle>(a[0]), ToHandle<DepthStencilViewHandle>(a[1]));
+		break;
+	case Op::DepthStencilState:
+		target.OMSetDepthStencilState(ToHandle<DepthStencilStateHandle>(a[0]), unsigned(a[1]));
+		break;
+	case Op::Map:
+		target.Map(ToHandle<BufferHandle>(a[0]), MapMode(a[1]));
+		break;
+	case Op::Unmap:
+		target.Unmap(ToHandle<BufferHandle>(a[0]));
+		break;
+	case Op::UpdateBuffer:
+		target.UpdateBuffer(ToHandle<BufferHandle>(a[0]), MapMode(a[1]), size_t(a[2]), c.pData, c.size);
+		break;
+	case Op::ClearRenderTarget:
+	{
+		const float color[4] = { c.GetFloat(1),c.GetFloat(2),c.GetFloat(3),c.GetFloat(4) };
+		target.ClearRenderTarget(ToHandle<RenderTargetHandle>(a[0]), color);
+		break;
+	}
+	case Op::ClearDepth:
+		target.ClearDepth(ToHandle<DepthStencilViewHandle>(a[0]), c.GetFloat(1));
+		break;
+	case Op::DrawIndexed:
+		target.DrawIndexed(unsigned(a[0]), unsigned(a[1]), int(uint32_t(a[2])));
+		break;
+	case Op::DrawIndexedInstanced:
+		target.DrawIndexedInstanced(unsigned(a[0]), unsigned(a[1]), unsigned(a[2]), int(uint32_t(a[3])), unsigned(a[4]));
+		break;
+	case Op::Count:
+		break;
+	}
+}
+
+void RecordingRenderContext::Replay(IRenderContext& target) const
+{
+	for (const Call& c : Decode())
+	{
+		Replay(c, target);
+	}
+}
+
+void RecordingRenderContext::Dump(std::ostream& out) const
+{
+	for (const Call& c : Decode())
+	{
+		out << GetOpName(c.op);
+		for (unsigned int i = 0; i < argCounts[size_t(c.op)]; i++)
+		{
+			const bool isFloat = c.op == Op::ClearRenderTarget ? i > 0u : c.op == Op::ClearDepth && i == 1u;
+			out << ' ';
+			if (isFloat)
+			{
+				out << c.GetFloat(i);
+			}
+			else
+			{
+				out << c.args[i];
+			}
+		}
+		if (c.op == Op::UpdateBuffer)
+		{
+			out << " bytes=" << c.size;
+		}
+		out << '\n';
+	}
+}
+
+const char* RecordingRenderContext::GetOpName(Op op) noexcept
+{
+	switch (op)
+	{
+	case Op::Topology:
+		return "IASetPrimitiveTopology";
+	case Op::InputLayout:
+		return "IASetInputLayout";
+	case Op::VertexBuffer:
+		return "IASetVertexBuffer";
+	case Op::IndexBuffer:
+		return "IASetIndexBuffer";
+	case Op::VertexShader:
+		return "VSSetShader";
+	case Op::PixelShader:
+		return "PSSetShader";
+	case Op::ConstantBuffer:
+		return "VSSetConstantBuffer";
+	case Op::RenderTarget:
+		return "OMSetRenderTarget";
+	case Op::DepthStencilState:
+		return "OMSetDepthStencilState";
+	case Op::Map:
+		return "Map";
+	case Op::Unmap:
+		return "Unmap";
+	case Op::UpdateBuffer:
+		return "UpdateBuffer";
+	case Op::ClearRenderTarget:
+		return "ClearRenderTarget";
+	case Op::ClearDepth:
+		return "ClearDepth";
+	case Op::DrawIndexed:
+		return "DrawIndexed";
+	case Op::DrawIndexedInstanced:
+		return "DrawIndexedInstanced";
+	case Op::Count:
+		break;
+	}
+	return "Unknown";
+}
+
+unsigned int RecordingRenderContext::GetArgCount(Op op) noexcept
+{
+	return op < Op::Count ? argCounts[size_t(op)] : 0u;
+}
+
+bool RecordingRenderContext::IsHandleArg(Op op, unsigned int i) noexcept
+{
+	return op < Op::Count && i < maxArgs && ((handleArgs[size_t(op)] >> i) & 1u) != 0u;
+}
+
+void RecordingRenderContext::PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+	// 7 bits per byte, high bit set while more follow: small counts and slots take a single byte
+	while (value >= 0x80u)
+	{
+		out.push_back(uint8_t(value) | 0x80u);
+		value >>= 7u;
+	}
+	out.push_back(uint8_t(value));
+}
+
+bool RecordingRenderContext::GetVarint(const uint8_t*& p, const uint8_t* pEnd, uint64_t& value) noexcept
+{
+	value = 0u;
+	for (unsigned int shift = 0u; shift < 64u; shift += 7u)
+	{
+		if (p == pEnd)
+		{
+			return false;
+		}
+		const uint8_t b = *p++;
+		value |= uint64_t(b & 0x7Fu) << shift;
+		if ((b & 0x80u) == 0u)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void RecordingRenderContext::IASetPrimitiveTopology(Topology topology)
+{
+	Record(Op::Topology, { uint64_t(topology) });
+	inner.IASetPrimitiveTopology(topology);
+}
+
+void RecordingRenderContext::IASetInputLayout(InputLayoutHandle layout)
+{
+	Record(Op::InputLayout, { uint64_t(layout) });
+	inner.IASetInputLayout(layout);
+}
+
+void RecordingRenderContext::IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset)
+{
+	Record(Op::VertexBuffer, { slot,uint64_t(buffer),stride,offset });
+	inner.IASetVertexBuffer(slot, buffer, stride, offset);
+}
+
+void RecordingRenderContext::IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset)
+{
+	Record(Op::IndexBuffer, { uint64_t(buffer),uint64_t(format),offset });
+	inner.IASetIndexBuffer(buffer, format, offset);
+}
+
+void RecordingRenderContext::VSSetShader(VertexShaderHandle shader)
+{
+	Record(Op::VertexShader, { uint64_t(shader) });
+	inner.VSSetShader(shader);
+}
+
+void RecordingRenderContext::PSSetShader(PixelShaderHandle shader)
+{
+	Record(Op::PixelShader, { uint64_t(shader) });
+	inner.PSSetShader(shader);
+}
+
+void RecordingRenderContext::VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant, unsigned int numConstants)
+{
+	Record(Op::ConstantBuffer, { slot,uint64_t(buffer),firstConstant,numConstants });
+	inner.VSSetConstantBuffer(slot, buffer, firstConstant, numConstants);
+}
+
+void RecordingRenderContext::OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth)
+{
+	Record(Op::RenderTarget, { uint64_t(target),uint64_t(depth) });
+	inner.OMSetRenderTarget(target, depth);
+}
+
+void RecordingRenderContext::OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef)
+{
+	Record(Op::DepthStencilState, { uint64_t(state),stencilRef });
+	inner.OMSetDepthStencilState(state, stencilRef);
+}
+
+void* RecordingRenderContext::Map(BufferHandle buffer, MapMode mode)
+{
+	Record(Op::Map, { uint64_t(buffer),uint64_t(mode) });
+	return inner.Map(buffer, mode);
+}
+
+void RecordingRenderContext::Unmap(BufferHandle buffer)
+{
+	Record(Op::Unmap, { uint64_t(buffer) });
+	inner.Unmap(buffer);
+}
+
+void RecordingRenderContext::UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size)
+{
+	if (enabled)
+	{
+		Record(Op::UpdateBuffer, { uint64_t(buffer),uint64_t(mode),offset });
+		PutVarint(bytes, size);
+		const uint8_t* const p = static_cast<const uint8_t*>(pData);
+		bytes.insert(bytes.end(), p, p + size);
+	}
+	inner.UpdateBuffer(buffer, mode, offset, pData, size);
+}
+
+void RecordingRenderContext::ClearRenderTarget(RenderTargetHandle target, const float color[4])
+{
+	Record(Op::ClearRenderTarget, { uint64_t(target),FromFloat(color[0]),FromFloat(color[1]),FromFloat(color[2]),FromFloat(color[3]) });
+	inner.ClearRenderTarget(target, color);
+}
+
+void RecordingRenderContext::ClearDepth(DepthStencilViewHandle depth, float value)
+{
+	Record(Op::ClearDepth, { uint64_t(depth),FromFloat(value) });
+	inner.ClearDepth(depth, value);
+}
+
+void RecordingRenderContext::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	Record(Op::DrawIndexed, { indexCount,startIndex,uint32_t(baseVertex) });
+	inner.DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void RecordingRenderContext::DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+	unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	Record(Op::DrawIndexedInstanced, { indexCountPerInstance,instanceCount,startIndex,uint32_t(baseVertex),startInstance });
+	inner.DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+void RecordingRenderContext::Record(Op op, std::initializer_list<uint64_t> args)
+{
+	if (!enabled)
+	{
+		return;
+	}
+	counts[size_t(op)]++;
+	bytes.push_back(uint8_t(op));
+	for (const uint64_t a : args)
+	{
+		PutVarint(bytes, a);
+	}
+}
+
+uint64_t RecordingRenderContext::FromFloat(float value) noexcept
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
\ No newline at end of file
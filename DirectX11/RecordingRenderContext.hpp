@@ -0,0 +1,100 @@
+#pragma once
+#include "RenderContext.hpp"
+#include <array>
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+
+// IRenderContext decorator that appends every call and its arguments to a compact byte stream
+// (an op byte, then LEB128 varints) before forwarding it to the wrapped context. UpdateBuffer
+// keeps the bytes it uploads; a raw Map / Unmap pair is recorded as the calls alone, the recorder
+// cannot see what goes through the pointer. wrap a NullRenderContext to record without a device;
+// disabled, it only forwards, so it can stay in a chain for captures on demand (see FrameCapture)
+class RecordingRenderContext : public IRenderContext
+{
+public:
+	enum class Op : uint8_t
+	{
+		Topology,
+		InputLayout,
+		VertexBuffer,
+		IndexBuffer,
+		VertexShader,
+		PixelShader,
+		ConstantBuffer,
+		RenderTarget,
+		DepthStencilState,
+		Map,
+		Unmap,
+		UpdateBuffer,
+		ClearRenderTarget,
+		ClearDepth,
+		DrawIndexed,
+		DrawIndexedInstanced,
+		Count
+	};
+	static constexpr unsigned int maxArgs = 5u;
+	// one decoded call: arguments in the order of the IRenderContext method, enums and handles as
+	// their integer values, floats by bit pattern (see GetFloat)
+	struct Call
+	{
+		Op op = Op::Count;
+		std::array<uint64_t, maxArgs> args{};
+		// UpdateBuffer payload, points into the recording
+		const void* pData = nullptr;
+		size_t size = 0u;
+		float GetFloat(size_t i) const noexcept;
+	};
+public:
+	RecordingRenderContext(IRenderContext& inner, bool enabled = true) noexcept;
+	RecordingRenderContext(const RecordingRenderContext&) = delete;
+	RecordingRenderContext& operator=(const RecordingRenderContext&) = delete;
+	// set between frames from the thread that makes the calls
+	void SetEnabled(bool enabled_in) noexcept;
+	bool IsEnabled() const noexcept;
+	const std::vector<uint8_t>& GetBytes() const noexcept;
+	size_t GetCallCount() const noexcept;
+	size_t GetCallCount(Op op) const noexcept;
+	// forgets everything recorded, keeps the capacity
+	void Clear() noexcept;
+	// every call of a stream made by GetBytes, in order; false and a partial list when it is cut short
+	static bool Decode(const uint8_t* pBytes, size_t size, std::vector<Call>& calls);
+	std::vector<Call> Decode() const;
+	// issues call on target; handles go through unchanged, so target has to know them
+	static void Replay(const Call& call, IRenderContext& target);
+	void Replay(IRenderContext& target) const;
+	// one line per call, for diffs and test expectations
+	void Dump(std::ostream& out) const;
+	static const char* GetOpName(Op op) noexcept;
+	static unsigned int GetArgCount(Op op) noexcept;
+	// whether argument i of op is a resource handle, for remapping the handles of a recording
+	static bool IsHandleArg(Op op, unsigned int i) noexcept;
+	// the LEB128 encoding of the stream, GetVarint advances p and fails at pEnd
+	static void PutVarint(std::vector<uint8_t>& out, uint64_t value);
+	static bool GetVarint(const uint8_t*& p, const uint8_t* pEnd, uint64_t& value) noexcept;
+	void IASetPrimitiveTopology(Topology topology) override;
+	void IASetInputLayout(InputLayoutHandle layout) override;
+	void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) override;
+	void IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset) override;
+	void VSSetShader(VertexShaderHandle shader) override;
+	void PSSetShader(PixelShaderHandle shader) override;
+	void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant = 0u, unsigned int numConstants = 0u) override;
+	void OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth) override;
+	void OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef) override;
+	void* Map(BufferHandle buffer, MapMode mode) override;
+	void Unmap(BufferHandle buffer) override;
+	void UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size) override;
+	void ClearRenderTarget(RenderTargetHandle target, const float color[4]) override;
+	void ClearDepth(DepthStencilViewHandle depth, float value) override;
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) override;
+	void DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+		unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+private:
+	void Record(Op op, std::initializer_list<uint64_t> args);
+	static uint64_t FromFloat(float value) noexcept;
+private:
+	IRenderContext& inner;
+	bool enabled;
+	std::vector<uint8_t> bytes;
+	std::array<size_t, size_t(Op::Count)> counts{};
+};
\ No newline at end of file
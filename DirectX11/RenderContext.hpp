@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// opaque resource handles; the D3D11 backend stores the interface pointer, other backends their own ids
+enum class BufferHandle : uintptr_t { Null = 0 };
+enum class InputLayoutHandle : uintptr_t { Null = 0 };
+enum class VertexShaderHandle : uintptr_t { Null = 0 };
+enum class PixelShaderHandle : uintptr_t { Null = 0 };
+enum class RenderTargetHandle : uintptr_t { Null = 0 };
+enum class DepthStencilViewHandle : uintptr_t { Null = 0 };
+enum class DepthStencilStateHandle : uintptr_t { Null = 0 };
+
+// values match D3D11_PRIMITIVE_TOPOLOGY / DXGI_FORMAT / D3D11_MAP so the D3D11 backend can cast them
+enum class Topology : uint32_t
+{
+	TriangleList = 4u,
+	TriangleStrip = 5u
+};
+enum class IndexFormat : uint32_t
+{
+	Uint32 = 42u,
+	Uint16 = 57u
+};
+enum class MapMode : uint32_t
+{
+	WriteDiscard = 4u,
+	WriteNoOverwrite = 5u
+};
+
+// the subset of ID3D11DeviceContext that Graphics submits through, without any platform types
+class IRenderContext
+{
+public:
+	virtual ~IRenderContext() = default;
+	virtual void IASetPrimitiveTopology(Topology topology) = 0;
+	virtual void IASetInputLayout(InputLayoutHandle layout) = 0;
+	virtual void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) = 0;
+	virtual void IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset) = 0;
+	virtual void VSSetShader(VertexShaderHandle shader) = 0;
+	virtual void PSSetShader(PixelShaderHandle shader) = 0;
+	// range is in 16 byte constants, numConstants == 0 binds the whole buffer
+	virtual void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant = 0u, unsigned int numConstants = 0u) = 0;
+	virtual void OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth) = 0;
+	virtual void OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef) = 0;
+	virtual void* Map(BufferHandle buffer, MapMode mode) = 0;
+	virtual void Unmap(BufferHandle buffer) = 0;
+	// Map, copy size bytes to offset, Unmap; wrappers that care about the bytes (recording) override it
+	virtual void UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size)
+	{
+		std::memcpy(static_cast<char*>(Map(buffer, mode)) + offset, pData, size);
+		Unmap(buffer);
+	}
+	virtual void ClearRenderTarget(RenderTargetHandle target, const float color[4]) = 0;
+	virtual void ClearDepth(DepthStencilViewHandle depth, float value) = 0;
+	virtual void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) = 0;
+	virtual void DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+		unsigned int startIndex, int baseVertex, unsigned int startInstance) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "RenderQueue.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	uint64_t Field(uint64_t value, unsigned int bits) noexcept
+	{
+		return value & ((uint64_t(1) << bits) - 1u);
+	}
+
+	uint64_t QuantizeDepth(float depth01, unsigned int bits) noexcept
+	{
+		const float d = std::clamp(depth01, 0.0f, 1.0f);
+		const uint64_t maxValue = (uint64_t(1) << bits) - 1u;
+		return uint64_t(d * float(maxValue));
+	}
+
+	constexpr unsigned int translucentShift = 63u - SortKey::passBits;
+	constexpr unsigned int passShift = 64u - SortKey::passBits;
+}
+
+uint64_t SortKey::Opaque(unsigned int pass, float depth01, unsigned int shader, unsigned int layout, unsigned int buffers) noexcept
+{
+	constexpr unsigned int layoutShift = opaqueBufferBits;
+	constexpr unsigned int shaderShift = layoutShift + layoutBits;
+	constexpr unsigned int depthShift = shaderShift + shaderBits;
+	return
+		(Field(pass, passBits) << passShift) |
+		(QuantizeDepth(depth01, opaqueDepthBits) << depthShift) |
+		(Field(shader, shaderBits) << shaderShift) |
+		(Field(layout, layoutBits) << layoutShift) |
+		Field(buffers, opaqueBufferBits);
+}
+
+uint64_t SortKey::Translucent(unsigned int pass, float depth01, unsigned int shader, unsigned int layout, unsigned int buffers) noexcept
+{
+	constexpr unsigned int layoutShift = translucentBufferBits;
+	constexpr unsigned int shaderShift = layoutShift + layoutBits;
+	constexpr unsigned int depthShift = shaderShift + shaderBits;
+	// far things first: invert the depth so ascending keys run back to front
+	const uint64_t depth = ((uint64_t(1) << translucentDepthBits) - 1u) - QuantizeDepth(depth01, translucentDepthBits);
+	return
+		(Field(pass, passBits) << passShift) |
+		(uint64_t(1) << translucentShift) |
+		(depth << depthShift) |
+		(Field(shader, shaderBits) << shaderShift) |
+		(Field(layout, layoutBits) << layoutShift) |
+		Field(buffers, translucentBufferBits);
+}
+
+unsigned int SortKey::GetPass(uint64_t key) noexcept
+{
+	return unsigned(key >> passShift);
+}
+
+bool SortKey::IsTranslucent(uint64_t key) noexcept
+{
+	return ((key >> translucentShift) & 1u) != 0u;
+}
+
+unsigned int SortKey::GetShader(uint64_t key) noexcept
+{
+	const unsigned int shift = (IsTranslucent(key) ? translucentBufferBits : opaqueBufferBits) + layoutBits;
+	return unsigned(Field(key >> shift, shaderBits));
+}
+
+unsigned int SortKey::GetLayout(uint64_t key) noexcept
+{
+	const unsigned int shift = IsTranslucent(key) ? translucentBufferBits : opaqueBufferBits;
+	return unsigned(Field(key >> shift, layoutBits));
+}
+
+void RadixSort(SortEntry* pEntries, SortEntry* pScratch, size_t count) noexcept
+{
+	if (count < 2u)
+	{
+		return;
+	}
+	constexpr unsigned int digits = 8u;
+	constexpr unsigned int buckets = 256u;
+	// all eight histograms in a single read of the keys (8 KiB, stays in L1)
+	uint32_t histograms[digits][buckets];
+	std::memset(histograms, 0, sizeof(histograms));
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint64_t key = pEntries[i].key;
+		for (unsigned int d = 0; d < digits; d++)
+		{
+			histograms[d][(key >> (d * 8u)) & 0xFFu]++;
+		}
+	}
+
+	SortEntry* pSrc = pEntries;
+	SortEntry* pDst = pScratch;
+	for (unsigned int d = 0; d < digits; d++)
+	{
+		uint32_t* const hist = histograms[d];
+		// a digit shared by every key would be an identity scatter
+		if (hist[(pSrc[0].key >> (d * 8u)) & 0xFFu] == count)
+		{
+			continue;
+		}
+		uint32_t sum = 0u;
+		for (unsigned int b = 0; b < buckets; b++)
+		{
+			const uint32_t n = hist[b];
+			hist[b] = sum;
+			sum += n;
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			const SortEntry& e = pSrc[i];
+			pDst[hist[(e.key >> (d * 8u)) & 0xFFu]++] = e;
+		}
+		std::swap(pSrc, pDst);
+	}
+	if (pSrc != pEntries)
+	{
+		std::memcpy(pEntries, pSrc, count * sizeof(SortEntry));
+	}
+}
+
+void RenderQueue::Clear() noexcept
+{
+	entries.clear();
+}
+
+void RenderQueue::Reserve(size_t count)
+{
+	entries.reserve(count);
+	scratch.reserve(count);
+}
+
+void RenderQueue::Push(uint64_t key, uint32_t item)
+{
+	entries.push_back({ key,item });
+}
+
+void RenderQueue::Sort()
+{
+	if (entries.size() < 2u)
+	{
+		return;
+	}
+	scratch.resize(entries.size());
+	RadixSort(entries.data(), scratch.data(), entries.size());
+}
+
+size_t RenderQueue::Size() const noexcept
+{
+	return entries.size();
+}
+
+bool RenderQueue::Empty() const noexcept
+{
+	return entries.empty();
+}
+
+const SortEntry& RenderQueue::operator[](size_t i) const noexcept
+{
+	return entries[i];
+}
+
+const SortEntry* RenderQueue::begin() const noexcept
+{
+	return entries.data();
+}
+
+const SortEntry* RenderQueue::end() const noexcept
+{
+	return entries.data() + entries.size();
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64 bit draw sort keys, most significant field first:
+// opaque:      [pass:4][translucent=0:1][depth:14 front-to-back][shader:12][layout:8][buffers:25]
+// translucent: [pass:4][translucent=1:1][depth:24 back-to-front][shader:12][layout:8][buffers:15]
+// opaques use coarse depth buckets so state still groups inside a bucket,
+// translucents need exact back-to-front order and get the finer depth
+namespace SortKey
+{
+	constexpr unsigned int passBits = 4u;
+	constexpr unsigned int opaqueDepthBits = 14u;
+	constexpr unsigned int translucentDepthBits = 24u;
+	constexpr unsigned int shaderBits = 12u;
+	constexpr unsigned int layoutBits = 8u;
+	constexpr unsigned int opaqueBufferBits = 25u;
+	constexpr unsigned int translucentBufferBits = 15u;
+
+	// depth01 is view depth normalized to [0,1] (0 = near), ids are truncated to their field width
+	uint64_t Opaque(unsigned int pass, float depth01, unsigned int shader, unsigned int layout, unsigned int buffers) noexcept;
+	uint64_t Translucent(unsigned int pass, float depth01, unsigned int shader, unsigned int layout, unsigned int buffers) noexcept;
+	unsigned int GetPass(uint64_t key) noexcept;
+	bool IsTranslucent(uint64_t key) noexcept;
+	unsigned int GetShader(uint64_t key) noexcept;
+	unsigned int GetLayout(uint64_t key) noexcept;
+}
+
+// LSD radix sort on 8 bit digits, stable; digits that are equal for every key are skipped
+struct SortEntry
+{
+	uint64_t key;
+	uint32_t item;
+};
+void RadixSort(SortEntry* pEntries, SortEntry* pScratch, size_t count) noexcept;
+
+// collects (key, item) pairs for a frame and hands them back in key order,
+// items are indices into whatever draw records the caller keeps
+class RenderQueue
+{
+public:
+	void Clear() noexcept;
+	void Reserve(size_t count);
+	void Push(uint64_t key, uint32_t item);
+	void Sort();
+	size_t Size() const noexcept;
+	bool Empty() const noexcept;
+	const SortEntry& operator[](size_t i) const noexcept;
+	const SortEntry* begin() const noexcept;
+	const SortEntry* end() const noexcept;
+private:
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> scratch;
+};
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "RenderThread.hpp"
+#include "ChiliTimer.hpp"
+#include "Profiler.hpp"
+#include <sstream>
+
+#define RENDER_THREAD_EXCEPT(note) RenderThread::Exception( __LINE__,__FILE__,(note) )
+
+void FrameSnapshot::Clear() noexcept
+{
+	cubes.clear();
+	occluders.clear();
+	materials.clear();
+}
+
+void FrameSnapshot::QueueCube(const Matrix4& world, bool occluder, uint16_t material)
+{
+	cubes.push_back(world);
+	occluders.push_back(occluder ? 1u : 0u);
+	materials.push_back(material);
+}
+
+RenderThread::RenderThread(IFrameRenderer& renderer, JobSystem* pJobs)
+	:
+	renderer(renderer),
+	pJobs(pJobs),
+	commands(commandCapacity)
+{
+	thread = std::thread(&RenderThread::Loop, this);
+}
+
+RenderThread::~RenderThread()
+{
+	stopping.store(true);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		commandReady.notify_all();
+	}
+	thread.join();
+}
+
+FrameSnapshot& RenderThread::BeginFrame()
+{
+	if (frameOpen)
+	{
+		throw RENDER_THREAD_EXCEPT("BeginFrame called twice without EndFrame");
+	}
+	RethrowError();
+	// the snapshot written now was last read by the frame ended snapshotCount frames ago
+	ChiliTimer waitTimer;
+	if (framesEnded - framesPresented.load(std::memory_order_acquire) >= snapshotCount)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		framePresented.wait(lock, [this]
+		{
+			return framesEnded - framesPresented.load() < snapshotCount || failed.load();
+		});
+	}
+	const float waited = waitTimer.Mark();
+	RethrowError();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.waitMs = waited * 1000.0f;
+	}
+	frameOpen = true;
+	FrameSnapshot& snapshot = snapshots[framesEnded % snapshotCount];
+	snapshot.Clear();
+	return snapshot;
+}
+
+void RenderThread::SetCamera(float x, float y, float z)
+{
+	Push({ CommandType::SetCamera,0u,{ x,y,z } });
+}
+
+void RenderThread::ClearBuffer(float red, float green, float blue)
+{
+	Push({ CommandType::Clear,0u,{ red,green,blue } });
+}
+
+void RenderThread::EndFrame()
+{
+	if (!frameOpen)
+	{
+		throw RENDER_THREAD_EXCEPT("EndFrame called without BeginFrame");
+	}
+	const uint32_t snapshot = uint32_t(framesEnded % snapshotCount);
+	Push({ CommandType::DrawScene,snapshot,{} });
+	Push({ CommandType::EndFrame,snapshot,{} });
+	framesEnded++;
+	frameOpen = false;
+}
+
+void RenderThread::Flush()
+{
+	RethrowError();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		framePresented.wait(lock, [this]
+		{
+			return framesPresented.load() == framesEnded || failed.load();
+		});
+	}
+	RethrowError();
+}
+
+RenderThread::Stats RenderThread::GetStats() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void RenderThread::Push(const Command& command)
+{
+	// a full ring means the render thread is far behind, wait for it to drain
+	while (!commands.TryPush(command))
+	{
+		RethrowError();
+		std::this_thread::yield();
+	}
+	// pairs with the sleeping flag / ring check in WaitForCommand, one of the two sides sees the other
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (renderSleeping.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		commandReady.notify_one();
+	}
+}
+
+bool RenderThread::WaitForCommand(Command& command, float& idleSeconds)
+{
+	while (!stopping.load())
+	{
+		if (commands.TryPop(command))
+		{
+			return true;
+		}
+		ChiliTimer idleTimer;
+		std::unique_lock<std::mutex> lock(mutex);
+		renderSleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		commandReady.wait(lock, [this] { return stopping.load() || !commands.Empty(); });
+		renderSleeping.store(false, std::memory_order_relaxed);
+		idleSeconds += idleTimer.Mark();
+	}
+	return false;
+}
+
+void RenderThread::Loop() noexcept
+{
+	PROFILE_THREAD("render");
+	if (pJobs)
+	{
+		// without a free slot the culling jobs of this thread simply run inline
+		pJobs->AttachCurrentThread();
+	}
+	try
+	{
+		ChiliTimer frameTimer;
+		float idle = 0.0f;
+		Command c;
+		while (WaitForCommand(c, idle))
+		{
+			switch (c.type)
+			{
+			case CommandType::SetCamera:
+				renderer.SetCamera(c.args[0], c.args[1], c.args[2]);
+				break;
+			case CommandType::Clear:
+				renderer.ClearBuffer(c.args[0], c.args[1], c.args[2]);
+				break;
+			case CommandType::DrawScene:
+				renderer.DrawScene(snapshots[c.snapshot]);
+				break;
+			case CommandType::EndFrame:
+			{
+				renderer.EndFrame();
+				const float frame = frameTimer.Mark();
+				const RendererStats rendererStats = renderer.GetFrameStats();
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					stats.renderer = rendererStats;
+					stats.renderMs = (frame - idle) * 1000.0f;
+					stats.idleMs = idle * 1000.0f;
+					framesPresented.fetch_add(1u, std::memory_order_release);
+				}
+				framePresented.notify_all();
+				idle = 0.0f;
+				break;
+			}
+			}
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pError = std::current_exception();
+		failed.store(true);
+	}
+	framePresented.notify_all();
+	if (pJobs)
+	{
+		pJobs->DetachCurrentThread();
+	}
+}
+
+void RenderThread::RethrowError()
+{
+	if (failed.load())
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::rethrow_exception(pError);
+	}
+}
+
+
+// render thread exception stuff
+RenderThread::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* RenderThread::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* RenderThread::Exception::GetType() const noexcept
+{
+	return "Render Thread Exception";
+}
+
+const std::string& RenderThread::Exception::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "ChiliMath.hpp"
+#include "JobSystem.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// bulk scene data of one frame, written by the simulation thread and read by the render thread
+struct FrameSnapshot
+{
+	void Clear() noexcept;
+	void QueueCube(const Matrix4& world, bool occluder = false, uint16_t material = 0u);
+	// row-major world transforms, same layout as DirectX::XMFLOAT4X4
+	std::vector<Matrix4> cubes;
+	std::vector<uint8_t> occluders;
+	// tint id per cube, see Geometry::MaterialTint
+	std::vector<uint16_t> materials;
+};
+
+// what the renderer did with the last presented frame
+struct RendererStats
+{
+	// cubes in the snapshot and cubes left after culling
+	unsigned int objects = 0u;
+	unsigned int visible = 0u;
+	unsigned int draws = 0u;
+	unsigned long long triangles = 0u;
+	// CPU time of the frustum + occlusion cull, sort key building and draw submission
+	float cullMs = 0.0f;
+	float buildMs = 0.0f;
+	float submitMs = 0.0f;
+};
+
+// the frame level operations a render thread replays, implemented by whoever owns the device
+class IFrameRenderer
+{
+public:
+	virtual ~IFrameRenderer() = default;
+	virtual void SetCamera(float x, float y, float z) = 0;
+	virtual void ClearBuffer(float red, float green, float blue) = 0;
+	virtual void DrawScene(const FrameSnapshot& scene) = 0;
+	virtual void EndFrame() = 0;
+	// read on the render thread right after EndFrame
+	virtual RendererStats GetFrameStats() const
+	{
+		return {};
+	}
+};
+
+// runs an IFrameRenderer on a thread of its own: the simulation thread records small commands into
+// a lock free ring and fills one of two scene snapshots, so it builds frame N+1 while frame N is
+// being submitted. an exception on the render thread is rethrown by the next call from the simulation side
+class RenderThread
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	struct Stats
+	{
+		// simulation thread blocked in BeginFrame waiting for a free snapshot (render bound)
+		float waitMs = 0.0f;
+		// render thread time from the first command of a frame to the end of its EndFrame
+		float renderMs = 0.0f;
+		// render thread idle, waiting for the next frame (simulation bound)
+		float idleMs = 0.0f;
+		// of the last frame presented
+		RendererStats renderer;
+	};
+public:
+	// pJobs gets the render thread attached so culling on it still fans out over the workers
+	RenderThread(IFrameRenderer& renderer, JobSystem* pJobs = nullptr);
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+	// drops whatever was not replayed yet
+	~RenderThread();
+	// snapshot of the next frame, cleared; blocks while the render thread still reads it
+	FrameSnapshot& BeginFrame();
+	void SetCamera(float x, float y, float z);
+	void ClearBuffer(float red, float green, float blue);
+	// draws the snapshot of BeginFrame and presents, the snapshot belongs to the render thread from here
+	void EndFrame();
+	// blocks until every frame ended so far is presented
+	void Flush();
+	Stats GetStats() const noexcept;
+public:
+	static constexpr unsigned int snapshotCount = 2u;
+	static constexpr size_t commandCapacity = 256u;
+private:
+	enum class CommandType : uint32_t
+	{
+		SetCamera,
+		Clear,
+		DrawScene,
+		EndFrame
+	};
+	struct Command
+	{
+		CommandType type;
+		uint32_t snapshot;
+		float args[3];
+	};
+private:
+	void Push(const Command& command);
+	// next command, sleeping while there is none; false once stopping. adds the time slept to idleSeconds
+	bool WaitForCommand(Command& command, float& idleSeconds);
+	void Loop() noexcept;
+	void RethrowError();
+private:
+	IFrameRenderer& renderer;
+	JobSystem* pJobs;
+	SpscRing<Command> commands;
+	FrameSnapshot snapshots[snapshotCount];
+	// simulation side only
+	uint64_t framesEnded = 0u;
+	bool frameOpen = false;
+	// render side counts presented frames, the simulation side waits on it for free snapshots
+	std::atomic<uint64_t> framesPresented{ 0u };
+	std::atomic<bool> renderSleeping{ false };
+	std::atomic<bool> stopping{ false };
+	std::atomic<bool> failed{ false };
+	std::exception_ptr pError;
+	mutable std::mutex mutex;
+	std::condition_variable commandReady;
+	std::condition_variable framePresented;
+	Stats stats;
+	std::thread thread;
+};
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "SceneSubmitter.hpp"
+#include "Geometry.hpp"
+#include "FrameCapture.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+	// shaders take column-major matrices
+	Matrix4 Transpose(const Matrix4& m) noexcept
+	{
+		Matrix4 t;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				t.m[i][j] = m.m[j][i];
+			}
+		}
+		return t;
+	}
+}
+
+SceneSubmitter::SceneSubmitter(IRenderContext& context, const Resources& resources, JobSystem* pJobs)
+	:
+	context(context),
+	resources(resources),
+	constantRing(constantRingSize, framesInFlight),
+	instanceRing(instanceRingSize, framesInFlight),
+	frustumCuller(pJobs),
+	occlusionCuller(320u, 192u, pJobs)
+{}
+
+void SceneSubmitter::QueueCube(const Matrix4& world, bool occluder, uint16_t material)
+{
+	queuedCubes.push_back(world);
+	queuedOccluders.push_back(occluder ? 1u : 0u);
+	queuedMaterials.push_back(material);
+}
+
+void SceneSubmitter::QueueScene(const FrameSnapshot& scene)
+{
+	queuedCubes.insert(queuedCubes.end(), scene.cubes.begin(), scene.cubes.end());
+	queuedOccluders.insert(queuedOccluders.end(), scene.occluders.begin(), scene.occluders.end());
+	queuedMaterials.insert(queuedMaterials.end(), scene.materials.begin(), scene.materials.end());
+}
+
+void SceneSubmitter::Flush(const Matrix4& viewProj)
+{
+	frameStats.objects += unsigned(queuedCubes.size());
+	stageTimer.Mark();
+	CullQueue(viewProj);
+	frameStats.cullMs += stageTimer.Mark() * 1000.0f;
+	frameStats.visible += unsigned(drawnCubes.size());
+	BuildDraws(viewProj);
+	frameStats.buildMs += stageTimer.Mark() * 1000.0f;
+	SubmitDraws(viewProj);
+	frameStats.submitMs += stageTimer.Mark() * 1000.0f;
+}
+
+void SceneSubmitter::CullQueue(const Matrix4& viewProj)
+{
+	PROFILE_ZONE("CullQueue");
+	drawnCubes.clear();
+	if (queuedCubes.empty())
+	{
+		return;
+	}
+
+	// world space bounding sphere of each cube: the mesh spans [-0.5,0.5]x[-0.5,0.5]x[0,1],
+	// the radius scales with the longest basis row of the world matrix
+	cubeBounds.Clear();
+	for (const Matrix4& w : queuedCubes)
+	{
+		const Float4 center = w.TransformPoint({ 0.0f,0.0f,0.5f });
+		const float scale = std::sqrt(std::max({
+			w.m[0][0] * w.m[0][0] + w.m[0][1] * w.m[0][1] + w.m[0][2] * w.m[0][2],
+			w.m[1][0] * w.m[1][0] + w.m[1][1] * w.m[1][1] + w.m[1][2] * w.m[1][2],
+			w.m[2][0] * w.m[2][0] + w.m[2][1] * w.m[2][1] + w.m[2][2] * w.m[2][2] }));
+		cubeBounds.Add({ center.x,center.y,center.z }, 0.8660254f * scale);
+	}
+	frustumCuller.Cull(Frustum::FromViewProjection(viewProj), cubeBounds, visibleCubes);
+
+	// occluders in view go into the software depth buffer and are always drawn,
+	// the other cubes are tested with their world space box against it
+	occlusionCuller.BeginFrame(viewProj);
+	occludees.clear();
+	occludeeBounds.Clear();
+	for (const uint32_t i : visibleCubes)
+	{
+		const Matrix4& w = queuedCubes[i];
+		if (queuedOccluders[i])
+		{
+			occlusionCuller.AddOccluder(Geometry::ColoredCube(), w);
+			drawnCubes.push_back(i);
+			continue;
+		}
+		const Float4 center = w.TransformPoint({ 0.0f,0.0f,0.5f });
+		occludees.push_back(i);
+		occludeeBounds.Add(
+			{ center.x,center.y,center.z },
+			{
+				0.5f * (std::abs(w.m[0][0]) + std::abs(w.m[1][0]) + std::abs(w.m[2][0])),
+				0.5f * (std::abs(w.m[0][1]) + std::abs(w.m[1][1]) + std::abs(w.m[2][1])),
+				0.5f * (std::abs(w.m[0][2]) + std::abs(w.m[1][2]) + std::abs(w.m[2][2]))
+			});
+	}
+	occlusionCuller.RenderOccluders();
+	occlusionCuller.TestBoxes(occludeeBounds, visibleCubes);
+	for (const uint32_t i : visibleCubes)
+	{
+		drawnCubes.push_back(occludees[i]);
+	}
+}
+
+void SceneSubmitter::BuildDraws(const Matrix4& viewProj)
+{
+	PROFILE_ZONE("BuildDraws");
+	// clip w of the object origin is its view depth; shader/layout ids are 0 while the cube pipeline
+	// is the only one, the material goes into the buffer field so tints group inside a depth bucket
+	renderQueue.Clear();
+	for (const uint32_t i : drawnCubes)
+	{
+		const Matrix4& w = queuedCubes[i];
+		const Float4 origin = viewProj.TransformPoint({ w.m[3][0],w.m[3][1],w.m[3][2] });
+		renderQueue.Push(SortKey::Opaque(0u, origin.w / farZ, 0u, 0u, queuedMaterials[i]), i);
+	}
+	renderQueue.Sort();
+}
+
+void SceneSubmitter::SubmitDraws(const Matrix4& viewProj)
+{
+	PROFILE_ZONE("SubmitDraws");
+	if (renderQueue.Empty())
+	{
+		queuedCubes.clear();
+		queuedOccluders.clear();
+		queuedMaterials.clear();
+		return;
+	}
+	BindPipeline();
+	BindFrameConstants(viewProj);
+	if (resources.instanceRing != BufferHandle::Null)
+	{
+		SubmitBatches();
+	}
+	else
+	{
+		SubmitObjects();
+	}
+	renderQueue.Clear();
+	queuedCubes.clear();
+	queuedOccluders.clear();
+	queuedMaterials.clear();
+}
+
+void SceneSubmitter::SubmitBatches()
+{
+	// the sort puts cubes of one material next to each other inside a depth bucket; each run goes up as
+	// one slice of world matrices (row-major, as the instance rows expect) and is drawn with one call
+	const Matrix4 identity = Matrix4::Identity();
+	BindConstants(objectConstantSlot, &identity, sizeof(identity));
+	const size_t count = renderQueue.Size();
+	unsigned int boundMaterial = ~0u;
+	size_t first = 0u;
+	while (first < count)
+	{
+		const unsigned int material = queuedMaterials[renderQueue[first].item];
+		size_t last = first + 1u;
+		while (last < count && last - first < maxBatchInstances && queuedMaterials[renderQueue[last].item] == material)
+		{
+			last++;
+		}
+		batchInstances.clear();
+		for (size_t i = first; i < last; i++)
+		{
+			batchInstances.push_back(queuedCubes[renderQueue[i].item]);
+		}
+
+		const size_t size = batchInstances.size() * sizeof(Matrix4);
+		auto alloc = instanceRing.Allocate(size);
+		if (!alloc)
+		{
+			// draws already issued keep the old copy once the discard renames the buffer
+			instanceRing.Reset();
+			alloc = instanceRing.Allocate(size);
+		}
+		context.UpdateBuffer(resources.instanceRing, alloc->discard ? MapMode::WriteDiscard : MapMode::WriteNoOverwrite,
+			alloc->offset, batchInstances.data(), size);
+		context.IASetVertexBuffer(1u, resources.instanceRing, sizeof(Matrix4), unsigned(alloc->offset));
+
+		// a run split at the batch limit carries on with the same tint
+		if (material != boundMaterial)
+		{
+			boundMaterial = material;
+			const Float4 tint = Geometry::MaterialTint(material);
+			BindConstants(materialConstantSlot, &tint, sizeof(tint));
+		}
+		context.DrawIndexedInstanced(resources.indexCount, unsigned(last - first), 0u, 0, 0u);
+		first = last;
+	}
+}
+
+void SceneSubmitter::SubmitObjects()
+{
+	// each cube is a separate object: only its world matrix is uploaded, view-projection is per frame
+	context.IASetVertexBuffer(1u, resources.identityInstances, sizeof(Matrix4), 0u);
+	unsigned int material = ~0u;
+	for (const SortEntry& e : renderQueue)
+	{
+		// the tint only goes up when the material changes from the previous draw
+		if (queuedMaterials[e.item] != material)
+		{
+			material = queuedMaterials[e.item];
+			const Float4 tint = Geometry::MaterialTint(material);
+			BindConstants(materialConstantSlot, &tint, sizeof(tint));
+		}
+		const Matrix4 world = Transpose(queuedCubes[e.item]);
+		BindConstants(objectConstantSlot, &world, sizeof(world));
+		context.DrawIndexedInstanced(resources.indexCount, 1u, 0u, 0, 0u);
+	}
+}
+
+void SceneSubmitter::BindPipeline()
+{
+	context.IASetPrimitiveTopology(Topology::TriangleList);
+	context.IASetInputLayout(resources.inputLayout);
+	context.IASetVertexBuffer(0u, resources.vertexBuffer, resources.vertexStride, 0u);
+	context.IASetIndexBuffer(resources.indexBuffer, resources.indexFormat, 0u);
+	context.VSSetShader(resources.vertexShader);
+	context.PSSetShader(resources.pixelShader);
+	context.OMSetDepthStencilState(resources.depthStencilState, 0u);
+	context.OMSetRenderTarget(resources.target, resources.depth);
+}
+
+void SceneSubmitter::BindFrameConstants(const Matrix4& viewProj)
+{
+	if (frameConstantsValid)
+	{
+		return;
+	}
+	const Matrix4 constants = Transpose(viewProj);
+	BindConstants(frameConstantSlot, &constants, sizeof(constants));
+	frameConstantsValid = true;
+}
+
+void SceneSubmitter::BindConstants(unsigned int slot, const void* pData, size_t size)
+{
+	if (resources.constantRing == BufferHandle::Null)
+	{
+		const BufferHandle buffer = resources.constantSlots[slot];
+		context.UpdateBuffer(buffer, MapMode::WriteDiscard, 0u, pData, size);
+		context.VSSetConstantBuffer(slot, buffer);
+		return;
+	}
+
+	std::memcpy(boundConstants[slot], pData, size);
+	boundSizes[slot] = size;
+	if (const auto alloc = constantRing.Allocate(size))
+	{
+		UploadConstants(slot, *alloc, pData, size);
+		return;
+	}
+
+	// ring is full of in flight data; a discard renames the buffer so starting over is safe, but the
+	// slices bound to the other slots earlier this frame go with the old copy and are uploaded again
+	constantRing.Reset();
+	UploadConstants(slot, *constantRing.Allocate(size), pData, size);
+	for (unsigned int s = 0u; s < constantSlotCount; s++)
+	{
+		if (s != slot && boundSizes[s] != 0u)
+		{
+			UploadConstants(s, *constantRing.Allocate(boundSizes[s]), boundConstants[s], boundSizes[s]);
+		}
+	}
+}
+
+void SceneSubmitter::UploadConstants(unsigned int slot, const UploadRing::Allocation& alloc, const void* pData, size_t size)
+{
+	context.UpdateBuffer(resources.constantRing, alloc.discard ? MapMode::WriteDiscard : MapMode::WriteNoOverwrite,
+		alloc.offset, pData, size);
+	// offsets and sizes are in 16 byte constants
+	context.VSSetConstantBuffer(slot, resources.constantRing, unsigned(alloc.offset / 16u), unsigned(alloc.size / 16u));
+}
+
+void SceneSubmitter::EndFrame() noexcept
+{
+	constantRing.EndFrame();
+	instanceRing.EndFrame();
+	frameConstantsValid = false;
+	std::fill(std::begin(boundSizes), std::end(boundSizes), size_t(0u));
+	lastFrameStats = frameStats;
+	frameStats = {};
+}
+
+const RendererStats& SceneSubmitter::GetFrameStats() const noexcept
+{
+	return lastFrameStats;
+}
+
+const OcclusionCuller::Stats& SceneSubmitter::GetOcclusionStats() const noexcept
+{
+	return occlusionCuller.GetStats();
+}
+
+const SceneSubmitter::Resources& SceneSubmitter::GetResources() const noexcept
+{
+	return resources;
+}
+
+void SceneSubmitter::AddResources(FrameCapture& capture) const
+{
+	const Mesh& cube = Geometry::ColoredCube();
+	const Matrix4 identity = Matrix4::Identity();
+	capture.AddResource(resources.inputLayout);
+	capture.AddResource(resources.vertexShader);
+	capture.AddResource(resources.pixelShader);
+	capture.AddResource(resources.depthStencilState);
+	capture.AddResource(resources.target);
+	capture.AddResource(resources.depth);
+	capture.AddResource(resources.vertexBuffer, cube.GetVertexDataSize(), cube.GetVertexData());
+	capture.AddResource(resources.indexBuffer, cube.GetIndexDataSize(), cube.GetIndexData());
+	capture.AddResource(resources.identityInstances, sizeof(identity), &identity);
+	if (resources.instanceRing != BufferHandle::Null)
+	{
+		capture.AddResource(resources.instanceRing, instanceRingSize);
+	}
+	if (resources.constantRing != BufferHandle::Null)
+	{
+		capture.AddResource(resources.constantRing, constantRingSize);
+		return;
+	}
+	for (const BufferHandle buffer : resources.constantSlots)
+	{
+		capture.AddResource(buffer, sizeof(Matrix4));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include "RenderContext.hpp"
+#include "RenderQueue.hpp"
+#include "FrustumCuller.hpp"
+#include "OcclusionCuller.hpp"
+#include "UploadRing.hpp"
+#include "RenderThread.hpp"
+#include "ChiliTimer.hpp"
+#include "ChiliMath.hpp"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+class FrameCapture;
+
+// the device independent half of Graphics: queued cubes are frustum and occlusion culled, sorted by
+// draw key and submitted through an IRenderContext (normally a StateFilter). the owner creates the
+// cube pipeline and buffers on whatever device it has and hands them over by handle, so the same
+// submission runs on D3D11, on a NullRenderContext or under a RecordingRenderContext
+class SceneSubmitter
+{
+public:
+	static constexpr unsigned int frameConstantSlot = 0u;
+	static constexpr unsigned int objectConstantSlot = 1u;
+	static constexpr unsigned int materialConstantSlot = 2u;
+	static constexpr unsigned int constantSlotCount = 3u;
+	static constexpr unsigned int framesInFlight = 3u;
+	static constexpr size_t constantRingSize = 4u * 1024u * 1024u;
+	static constexpr size_t maxConstantSize = 64u;
+	// dynamic vertex buffer for the world matrices of batched draws, one draw takes at most maxBatchInstances
+	static constexpr size_t instanceRingSize = 4u * 1024u * 1024u;
+	static constexpr unsigned int maxBatchInstances = 4096u;
+	static constexpr float farZ = 100.0f;
+	struct Resources
+	{
+		InputLayoutHandle inputLayout = InputLayoutHandle::Null;
+		VertexShaderHandle vertexShader = VertexShaderHandle::Null;
+		PixelShaderHandle pixelShader = PixelShaderHandle::Null;
+		DepthStencilStateHandle depthStencilState = DepthStencilStateHandle::Null;
+		RenderTargetHandle target = RenderTargetHandle::Null;
+		DepthStencilViewHandle depth = DepthStencilViewHandle::Null;
+		BufferHandle vertexBuffer = BufferHandle::Null;
+		unsigned int vertexStride = 0u;
+		BufferHandle indexBuffer = BufferHandle::Null;
+		IndexFormat indexFormat = IndexFormat::Uint16;
+		unsigned int indexCount = 0u;
+		// one identity world matrix on input slot 1, lets plain draws use the instanced input layout
+		BufferHandle identityInstances = BufferHandle::Null;
+		// dynamic vertex buffer of instanceRingSize bytes: runs of cubes with the same material are drawn
+		// as one instanced draw out of it; Null draws every cube on its own with a per-object constant
+		BufferHandle instanceRing = BufferHandle::Null;
+		// dynamic constant buffer of constantRingSize bytes, bound by range (needs the 11.1 runtime);
+		// Null falls back to one 64 byte buffer per slot that is renamed on every update
+		BufferHandle constantRing = BufferHandle::Null;
+		BufferHandle constantSlots[constantSlotCount] = {};
+	};
+public:
+	// without a job system culling runs on the calling thread
+	SceneSubmitter(IRenderContext& context, const Resources& resources, JobSystem* pJobs = nullptr);
+	SceneSubmitter(const SceneSubmitter&) = delete;
+	SceneSubmitter& operator=(const SceneSubmitter&) = delete;
+	// material is a Geometry::MaterialTint id
+	void QueueCube(const Matrix4& world, bool occluder = false, uint16_t material = 0u);
+	void QueueScene(const FrameSnapshot& scene);
+	// CullQueue, BuildDraws and SubmitDraws against viewProj, each one timed into the frame stats
+	void Flush(const Matrix4& viewProj);
+	// culling and draw building only touch CPU side state and may run on any thread,
+	// submitting talks to the context
+	void CullQueue(const Matrix4& viewProj);
+	void BuildDraws(const Matrix4& viewProj);
+	void SubmitDraws(const Matrix4& viewProj);
+	// bound for every draw, the state filter drops whatever is already in place
+	void BindPipeline();
+	// camera is read at the first draw of a frame and stays fixed until EndFrame
+	void BindFrameConstants(const Matrix4& viewProj);
+	// uploads constants into a fresh ring slice (or the slot's own buffer) and binds it to b<slot>,
+	// at most maxConstantSize bytes
+	void BindConstants(unsigned int slot, const void* pData, size_t size);
+	// after present: recycles the constants of the oldest frame in flight and closes the frame stats
+	void EndFrame() noexcept;
+	// objects, visible and stage times of the last ended frame; draws and triangles are the
+	// state filter's to count
+	const RendererStats& GetFrameStats() const noexcept;
+	// occludees tested / culled by the last flush
+	const OcclusionCuller::Stats& GetOcclusionStats() const noexcept;
+	const Resources& GetResources() const noexcept;
+	// enters every resource into the capture's table, buffers with their size and initial contents
+	void AddResources(FrameCapture& capture) const;
+private:
+	void SubmitBatches();
+	void SubmitObjects();
+	void UploadConstants(unsigned int slot, const UploadRing::Allocation& alloc, const void* pData, size_t size);
+private:
+	IRenderContext& context;
+	Resources resources;
+	UploadRing constantRing;
+	UploadRing instanceRing;
+	std::vector<Matrix4> batchInstances;
+	RenderQueue renderQueue;
+	std::vector<Matrix4> queuedCubes;
+	std::vector<uint8_t> queuedOccluders;
+	std::vector<uint16_t> queuedMaterials;
+	FrustumCuller frustumCuller;
+	OcclusionCuller occlusionCuller;
+	SphereBounds cubeBounds;
+	BoxBounds occludeeBounds;
+	std::vector<uint32_t> visibleCubes;
+	std::vector<uint32_t> occludees;
+	std::vector<uint32_t> drawnCubes;
+	bool frameConstantsValid = false;
+	// what each slot was last bound to this frame, goes up again when the ring is discarded mid-frame
+	uint8_t boundConstants[constantSlotCount][maxConstantSize] = {};
+	size_t boundSizes[constantSlotCount] = {};
+	ChiliTimer stageTimer;
+	RendererStats frameStats;
+	RendererStats lastFrameStats;
+};
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "ShaderArchive.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#ifdef _WIN32
+#include "ChiliWin.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SHADER_ARCHIVE_EXCEPT(note) ShaderArchive::Exception( __LINE__,__FILE__,(note) )
+
+#ifdef CHILI_EMBEDDED_SHADERS
+// headers written by fxc (HeaderFileOutput) into the intermediate directory
+#include "VertexShader.h"
+#include "PixelShader.h"
+
+namespace
+{
+	const ShaderArchive::Source embeddedShaders[] =
+	{
+		{ "VertexShader",g_VertexShader,sizeof(g_VertexShader) },
+		{ "PixelShader",g_PixelShader,sizeof(g_PixelShader) }
+	};
+}
+#endif
+
+// read only view of a whole file, unmapped when the last archive referencing it goes away
+class ShaderArchive::MappedFile
+{
+public:
+	MappedFile(const std::string& path)
+	{
+#ifdef _WIN32
+		hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("cannot open " + path);
+		}
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(hFile, &fileSize);
+		size = size_t(fileSize.QuadPart);
+		if (size == 0u ||
+			(hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr)) == nullptr ||
+			(pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0u, 0u, 0u)) == nullptr)
+		{
+			Release();
+			throw SHADER_ARCHIVE_EXCEPT("cannot map " + path);
+		}
+#else
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("cannot open " + path);
+		}
+		struct stat st {};
+		void* p = MAP_FAILED;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			size = size_t(st.st_size);
+			p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		// the mapping keeps the file referenced on its own
+		close(fd);
+		if (p == MAP_FAILED)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("cannot map " + path);
+		}
+		pData = p;
+#endif
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile()
+	{
+		Release();
+	}
+	const void* GetData() const noexcept
+	{
+		return pData;
+	}
+	size_t GetSize() const noexcept
+	{
+		return size;
+	}
+private:
+	void Release() noexcept
+	{
+#ifdef _WIN32
+		if (pData)
+		{
+			UnmapViewOfFile(pData);
+		}
+		if (hMapping)
+		{
+			CloseHandle(hMapping);
+		}
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(hFile);
+		}
+#else
+		if (pData)
+		{
+			munmap(const_cast<void*>(pData), size);
+		}
+#endif
+		pData = nullptr;
+	}
+private:
+#ifdef _WIN32
+	HANDLE hFile = INVALID_HANDLE_VALUE;
+	HANDLE hMapping = nullptr;
+#endif
+	const void* pData = nullptr;
+	size_t size = 0u;
+};
+
+namespace
+{
+	std::string GetExecutableDirectory()
+	{
+		char path[1024] = {};
+#ifdef _WIN32
+		const DWORD length = GetModuleFileNameA(nullptr, path, DWORD(sizeof(path)));
+		if (length == 0u || length == DWORD(sizeof(path)))
+		{
+			return {};
+		}
+#else
+		if (readlink("/proc/self/exe", path, sizeof(path) - 1u) <= 0)
+		{
+			return {};
+		}
+#endif
+		std::string dir = path;
+		const size_t slash = dir.find_last_of("\\/");
+		return slash == std::string::npos ? std::string{} : dir.substr(0u, slash + 1u);
+	}
+
+	bool FileExists(const std::string& path)
+	{
+		return std::ifstream(path, std::ios::binary).good();
+	}
+
+	std::string GetStem(const std::string& path)
+	{
+		const size_t slash = path.find_last_of("\\/");
+		std::string name = slash == std::string::npos ? path : path.substr(slash + 1u);
+		const size_t dot = name.find_last_of('.');
+		return dot == std::string::npos ? name : name.substr(0u, dot);
+	}
+}
+
+ShaderArchive ShaderArchive::FromMemory(const void* pData, size_t size)
+{
+	const uint8_t* const pBytes = static_cast<const uint8_t*>(pData);
+	Header header;
+	if (size < sizeof(Header))
+	{
+		throw SHADER_ARCHIVE_EXCEPT("archive is truncated");
+	}
+	std::memcpy(&header, pBytes, sizeof(header));
+	if (header.magic != magic || header.version != version)
+	{
+		throw SHADER_ARCHIVE_EXCEPT("not a shader archive or wrong version");
+	}
+	if ((size - sizeof(Header)) / sizeof(Entry) < header.entryCount)
+	{
+		throw SHADER_ARCHIVE_EXCEPT("entry table is truncated");
+	}
+
+	ShaderArchive archive;
+	archive.records.reserve(header.entryCount);
+	for (uint32_t i = 0; i < header.entryCount; i++)
+	{
+		Entry e;
+		std::memcpy(&e, pBytes + sizeof(Header) + i * sizeof(Entry), sizeof(e));
+		if (size_t(e.offset) + e.size > size)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("blob lies outside the archive");
+		}
+		if (!archive.records.empty() && archive.records.back().nameHash >= e.nameHash)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("entry table is not sorted");
+		}
+		archive.records.push_back({ e.nameHash,e.contentHash,{ pBytes + e.offset,size_t(e.size) } });
+	}
+	return archive;
+}
+
+ShaderArchive ShaderArchive::FromFile(const std::string& path)
+{
+	auto pMapping = std::make_shared<const MappedFile>(path);
+	ShaderArchive archive = FromMemory(pMapping->GetData(), pMapping->GetSize());
+	archive.pMapping = std::move(pMapping);
+	return archive;
+}
+
+ShaderArchive ShaderArchive::FromSources(const Source* pSources, size_t count)
+{
+	ShaderArchive archive;
+	archive.records.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Source& s = pSources[i];
+		archive.records.push_back({ HashName(s.name),DescriptorKey::HashBytes(s.pData,s.size),{ s.pData,s.size } });
+	}
+	std::sort(archive.records.begin(), archive.records.end(), [](const Record& a, const Record& b)
+	{
+		return a.nameHash < b.nameHash;
+	});
+	return archive;
+}
+
+ShaderArchive ShaderArchive::LoadDefault()
+{
+#ifdef CHILI_EMBEDDED_SHADERS
+	return FromSources(embeddedShaders, std::size(embeddedShaders));
+#else
+	const std::string path = GetExecutableDirectory() + "Shaders.pak";
+	if (!FileExists(path))
+	{
+		return {};
+	}
+	return FromFile(path);
+#endif
+}
+
+std::vector<uint8_t> ShaderArchive::Pack(const Source* pSources, size_t count)
+{
+	std::vector<Entry> entries(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		entries[i].nameHash = HashName(pSources[i].name);
+		entries[i].contentHash = DescriptorKey::HashBytes(pSources[i].pData, pSources[i].size);
+		entries[i].size = uint32_t(pSources[i].size);
+	}
+
+	std::vector<uint8_t> image(sizeof(Header) + count * sizeof(Entry));
+	for (size_t i = 0; i < count; i++)
+	{
+		// shaders compiled from the same source share one blob
+		const auto dup = std::find_if(entries.begin(), entries.begin() + i, [&](const Entry& e)
+		{
+			return e.contentHash == entries[i].contentHash && e.size == entries[i].size &&
+				std::memcmp(image.data() + e.offset, pSources[i].pData, e.size) == 0;
+		});
+		if (dup != entries.begin() + i)
+		{
+			entries[i].offset = dup->offset;
+			continue;
+		}
+		const size_t offset = (image.size() + blobAlignment - 1u) & ~(blobAlignment - 1u);
+		image.resize(offset + pSources[i].size);
+		std::memcpy(image.data() + offset, pSources[i].pData, pSources[i].size);
+		entries[i].offset = uint32_t(offset);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+	{
+		return a.nameHash < b.nameHash;
+	});
+	for (size_t i = 1; i < count; i++)
+	{
+		if (entries[i].nameHash == entries[i - 1u].nameHash)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("duplicate shader name (or name hash collision)");
+		}
+	}
+
+	const Header header = { magic,version,uint32_t(count),0u };
+	std::memcpy(image.data(), &header, sizeof(header));
+	std::memcpy(image.data() + sizeof(Header), entries.data(), count * sizeof(Entry));
+	return image;
+}
+
+void ShaderArchive::PackFiles(const std::string& outPath, const std::vector<std::string>& inputPaths)
+{
+	std::vector<std::vector<char>> blobs;
+	std::vector<std::string> names;
+	for (const auto& path : inputPaths)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			throw SHADER_ARCHIVE_EXCEPT("cannot read " + path);
+		}
+		blobs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		names.push_back(GetStem(path));
+	}
+	std::vector<Source> sources;
+	for (size_t i = 0; i < blobs.size(); i++)
+	{
+		sources.push_back({ names[i].c_str(),blobs[i].data(),blobs[i].size() });
+	}
+
+	const std::vector<uint8_t> image = Pack(sources.data(), sources.size());
+	std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(image.data()), std::streamsize(image.size()));
+	if (!out)
+	{
+		throw SHADER_ARCHIVE_EXCEPT("cannot write " + outPath);
+	}
+}
+
+uint64_t ShaderArchive::HashName(const char* name) noexcept
+{
+	return DescriptorKey::HashBytes(name, std::strlen(name));
+}
+
+std::optional<ShaderBytecode> ShaderArchive::Find(const char* name) const noexcept
+{
+	if (const Record* pRecord = FindRecord(name))
+	{
+		return pRecord->code;
+	}
+	return std::nullopt;
+}
+
+uint64_t ShaderArchive::GetContentHash(const char* name) const noexcept
+{
+	const Record* pRecord = FindRecord(name);
+	return pRecord ? pRecord->contentHash : 0u;
+}
+
+size_t ShaderArchive::GetCount() const noexcept
+{
+	return records.size();
+}
+
+bool ShaderArchive::Empty() const noexcept
+{
+	return records.empty();
+}
+
+const ShaderArchive::Record* ShaderArchive::FindRecord(const char* name) const noexcept
+{
+	const uint64_t hash = HashName(name);
+	const auto it = std::lower_bound(records.begin(), records.end(), hash, [](const Record& r, uint64_t h)
+	{
+		return r.nameHash < h;
+	});
+	return (it != records.end() && it->nameHash == hash) ? &*it : nullptr;
+}
+
+
+// ShaderArchive exception stuff
+ShaderArchive::Exception::Exception(int line, const char* file, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	note(std::move(note))
+{}
+
+const char* ShaderArchive::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Note] " << GetNote() << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* ShaderArchive::Exception::GetType() const noexcept
+{
+	return "Shader Archive Exception";
+}
+
+const std::string& ShaderArchive::Exception::GetNote() const noexcept
+{
+	return note;
+}
\ No newline at end of file
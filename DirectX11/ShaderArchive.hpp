@@ -0,0 +1,80 @@
+#pragma once
+#include "ChiliException.hpp"
+#include "PipelineCache.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// compiled shader bytecode packed into one content hashed file:
+// [header][entry table sorted by name hash][16 byte aligned blobs, identical blobs stored once]
+// lookups hand out views into the mapped file (or the executable image when embedded), nothing is copied
+class ShaderArchive
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::string note;
+	};
+	struct Source
+	{
+		const char* name;
+		const void* pData;
+		size_t size;
+	};
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+	};
+	struct Entry
+	{
+		uint64_t nameHash;
+		uint64_t contentHash;
+		uint32_t offset;
+		uint32_t size;
+	};
+	static constexpr uint32_t magic = 0x41485343u; // "CSHA"
+	static constexpr uint32_t version = 1u;
+	static constexpr size_t blobAlignment = 16u;
+public:
+	ShaderArchive() = default;
+	// views an archive image that outlives the ShaderArchive, throws on a malformed image
+	static ShaderArchive FromMemory(const void* pData, size_t size);
+	// memory maps the file, the mapping lives as long as any copy of the archive
+	static ShaderArchive FromFile(const std::string& path);
+	// index over blobs that are already in memory (shaders embedded with CHILI_EMBEDDED_SHADERS)
+	static ShaderArchive FromSources(const Source* pSources, size_t count);
+	// embedded shaders when compiled in, else Shaders.pak next to the executable, else an empty archive
+	static ShaderArchive LoadDefault();
+	static std::vector<uint8_t> Pack(const Source* pSources, size_t count);
+	// build step: packs .cso files into outPath, each named after its file stem ("VertexShader")
+	static void PackFiles(const std::string& outPath, const std::vector<std::string>& inputPaths);
+	static uint64_t HashName(const char* name) noexcept;
+	std::optional<ShaderBytecode> Find(const char* name) const noexcept;
+	// content hash recorded at pack time, 0 when the shader is not in the archive
+	uint64_t GetContentHash(const char* name) const noexcept;
+	size_t GetCount() const noexcept;
+	bool Empty() const noexcept;
+private:
+	struct Record
+	{
+		uint64_t nameHash;
+		uint64_t contentHash;
+		ShaderBytecode code;
+	};
+	class MappedFile;
+	const Record* FindRecord(const char* name) const noexcept;
+private:
+	std::vector<Record> records;
+	std::shared_ptr<const MappedFile> pMapping;
+};
\ No newline at end of file
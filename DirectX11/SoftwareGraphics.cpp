@@ -0,0 +1,149 @@
+#include "SoftwareGraphics.hpp"
+#include "Geometry.hpp"
+
+SoftwareGraphics::SoftwareGraphics(unsigned int width, unsigned int height, unsigned int nThreads)
+	:
+	jobs(nThreads),
+	rasterizer(width, height, &jobs)
+{}
+
+void SoftwareGraphics::EndFrame()
+{
+	// no swap chain, presenting means resolving all binned tiles into the frame buffer
+	rasterizer.Flush();
+	frameCount++;
+	lastFrameStats = frameStats;
+	frameStats = {};
+}
+
+RendererStats SoftwareGraphics::GetFrameStats() const
+{
+	return lastFrameStats;
+}
+
+void SoftwareGraphics::ClearBuffer(float red, float green, float blue) noexcept
+{
+	const auto toByte = [](float c)
+	{
+		return static_cast<uint32_t>((c < 0.0f ? 0.0f : c > 1.0f ? 1.0f : c) * 255.0f + 0.5f);
+	};
+	rasterizer.Clear(toByte(blue) | (toByte(green) << 8) | (toByte(red) << 16) | (0xFFu << 24), 1.0f);
+}
+
+void SoftwareGraphics::SetCamera(float x, float y, float z) noexcept
+{
+	xPos = x;
+	yPos = y;
+	zPos = z;
+}
+
+void SoftwareGraphics::DrawScene(const FrameSnapshot& scene)
+{
+	stageTimer.Mark();
+	const Matrix4 viewProj = GetViewProjection();
+	for (size_t i = 0; i < scene.cubes.size(); i++)
+	{
+		DrawCube(scene.cubes[i] * viewProj, scene.materials[i]);
+	}
+	frameStats.objects += unsigned(scene.cubes.size());
+	frameStats.visible += unsigned(scene.cubes.size());
+	frameStats.submitMs += stageTimer.Mark() * 1000.0f;
+}
+
+void SoftwareGraphics::DrawTestTriangle(float x, float y)
+{
+	theta += 1.0f / 3000.f;
+	theta2 += 1.3f / 3000.f;
+
+	// same split as Graphics: one view-projection per frame, a world matrix per cube
+	const Matrix4 viewProj = GetViewProjection();
+
+	// 1
+	DrawCube(
+		Matrix4::RotationZ(theta) *
+		Matrix4::Translation(x, y, 0.0f) *
+		viewProj
+	);
+
+	// 2
+	DrawCube(
+		Matrix4::RotationZ(theta2) *
+		Matrix4::RotationX(theta2) *
+		Matrix4::Scaling(0.1f, 0.1f, 0.1f) *
+		Matrix4::Translation(0.0f, 0.0f, 6.0f) *
+		viewProj
+	);
+}
+
+void SoftwareGraphics::DrawInstanced(const Matrix4* pTransforms, size_t count)
+{
+	const Matrix4 viewProj = GetViewProjection();
+	for (size_t i = 0; i < count; i++)
+	{
+		DrawCube(pTransforms[i] * viewProj);
+	}
+}
+
+Matrix4 SoftwareGraphics::GetViewProjection() const noexcept
+{
+	return Matrix4::LookAtLH({ xPos, yPos, zPos }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }) *
+		Matrix4::PerspectiveLH(1.f, 3.f / 4.f, 0.5f, 100.f);
+}
+
+void SoftwareGraphics::DrawCube(const Matrix4& mvp, unsigned int material)
+{
+	const Mesh& cube = Geometry::ColoredCube();
+	const auto* pSource = static_cast<const Geometry::ColoredVertex*>(cube.GetVertexData());
+	// vertex colors are B8G8R8A8, the tint is rgba
+	const Float4 tint = Geometry::MaterialTint(material);
+	const float scale[4] = { tint.z,tint.y,tint.x,tint.w };
+	transformed.resize(cube.GetVertexCount());
+	for (size_t i = 0; i < transformed.size(); i++)
+	{
+		transformed[i].pos = mvp.TransformPoint(pSource[i].pos);
+		for (int c = 0; c < 4; c++)
+		{
+			transformed[i].col[c] = material == 0u ? pSource[i].color[c] : uint8_t(float(pSource[i].color[c]) * scale[c] + 0.5f);
+		}
+	}
+	frameStats.draws++;
+	frameStats.triangles += cube.GetIndexCount() / 3u;
+	if (cube.GetIndexFormat() == IndexFormat::Uint16)
+	{
+		rasterizer.DrawIndexed(transformed.data(), cube.GetIndices16(), cube.GetIndexCount());
+	}
+	else
+	{
+		rasterizer.DrawIndexed(transformed.data(), cube.GetIndices32(), cube.GetIndexCount());
+	}
+}
+
+const uint32_t* SoftwareGraphics::GetFrameBuffer() const noexcept
+{
+	return rasterizer.GetColorBuffer();
+}
+
+unsigned int SoftwareGraphics::GetWidth() const noexcept
+{
+	return rasterizer.GetWidth();
+}
+
+unsigned int SoftwareGraphics::GetHeight() const noexcept
+{
+	return rasterizer.GetHeight();
+}
+
+unsigned long long SoftwareGraphics::GetFrameCount() const noexcept
+{
+	return frameCount;
+}
+
+const SoftwareRasterizer::Stats& SoftwareGraphics::GetRasterStats() const noexcept
+{
+	return rasterizer.GetStats();
+}
+
+JobSystem& SoftwareGraphics::GetJobSystem() noexcept
+{
+	return jobs;
+}
\ No newline at end of file
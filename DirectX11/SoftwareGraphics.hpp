@@ -0,0 +1,53 @@
+#pragma once
+#include "SoftwareRasterizer.hpp"
+#include "JobSystem.hpp"
+#include "RenderThread.hpp"
+#include "ChiliTimer.hpp"
+#include <cstdint>
+#include <vector>
+
+// headless CPU counterpart of Graphics: same frame surface, renders into system memory
+class SoftwareGraphics : public IFrameRenderer
+{
+public:
+	// nThreads sizes the job system the tiles are rasterized on, 0 uses every hardware thread
+	SoftwareGraphics(unsigned int width = 800u, unsigned int height = 600u, unsigned int nThreads = 0u);
+	SoftwareGraphics(const SoftwareGraphics&) = delete;
+	SoftwareGraphics& operator=(const SoftwareGraphics&) = delete;
+	~SoftwareGraphics() override = default;
+	void EndFrame() override;
+	RendererStats GetFrameStats() const override;
+	void ClearBuffer(float red, float green, float blue) noexcept override;
+	void SetCamera(float x, float y, float z) noexcept override;
+	// every cube of the snapshot with its material tint, no culling
+	void DrawScene(const FrameSnapshot& scene) override;
+	void DrawTestTriangle(float x, float y);
+	// cube per world transform, CPU counterpart of a batched SceneSubmitter draw
+	void DrawInstanced(const Matrix4* pTransforms, size_t count);
+	Matrix4 GetViewProjection() const noexcept;
+	// B8G8R8A8 pixels of the last completed frame, width * height entries
+	const uint32_t* GetFrameBuffer() const noexcept;
+	unsigned int GetWidth() const noexcept;
+	unsigned int GetHeight() const noexcept;
+	unsigned long long GetFrameCount() const noexcept;
+	const SoftwareRasterizer::Stats& GetRasterStats() const noexcept;
+	JobSystem& GetJobSystem() noexcept;
+
+	float xPos = 0.0f;
+	float yPos = 0.0f;
+	float zPos = -5.0f;
+private:
+	void DrawCube(const Matrix4& mvp, unsigned int material = 0u);
+private:
+	JobSystem jobs;
+	SoftwareRasterizer rasterizer;
+	// post-transform vertices of the mesh being drawn, kept to avoid reallocating per draw
+	std::vector<SoftwareRasterizer::Vertex> transformed;
+	unsigned long long frameCount = 0u;
+	// transform and binning time of DrawScene goes into submitMs, the tile work of EndFrame is not counted
+	ChiliTimer stageTimer;
+	RendererStats frameStats;
+	RendererStats lastFrameStats;
+	float theta = 0.0f;
+	float theta2 = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "SoftwareRasterizer.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr int subPixelBits = 4;
+	constexpr int subPixelScale = 1 << subPixelBits;
+
+	uint32_t PackColor(float b, float g, float r, float a) noexcept
+	{
+		const auto toByte = [](float c)
+		{
+			return static_cast<uint32_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+		};
+		return toByte(b) | (toByte(g) << 8) | (toByte(r) << 16) | (toByte(a) << 24);
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned int width, unsigned int height, JobSystem* pJobs)
+	:
+	width(width),
+	height(height),
+	tilesX((width + tileSize - 1u) / tileSize),
+	tilesY((height + tileSize - 1u) / tileSize),
+	colorBuffer(size_t(width) * height, 0u),
+	depthBuffer(size_t(width) * height, 1.0f),
+	tileBins(size_t(tilesX) * tilesY),
+	pJobs(pJobs)
+{}
+
+void SoftwareRasterizer::Clear(uint32_t color, float depth) noexcept
+{
+	// a clear invalidates everything binned so far this frame
+	triangles.clear();
+	for (auto& bin : tileBins)
+	{
+		bin.clear();
+	}
+	clearPending = true;
+	clearColor = color;
+	clearDepth = depth;
+}
+
+void SoftwareRasterizer::DrawIndexed(const Vertex* pVertices, const uint16_t* pIndices, size_t indexCount)
+{
+	DrawTriangles(pVertices, pIndices, indexCount);
+}
+
+void SoftwareRasterizer::DrawIndexed(const Vertex* pVertices, const uint32_t* pIndices, size_t indexCount)
+{
+	DrawTriangles(pVertices, pIndices, indexCount);
+}
+
+template<typename Index>
+void SoftwareRasterizer::DrawTriangles(const Vertex* pVertices, const Index* pIndices, size_t indexCount)
+{
+	// clip planes as signed distances: -w <= x <= w, -w <= y <= w, 0 <= z <= w
+	const auto planeDistance = [](const Float4& p, int plane)
+	{
+		switch (plane)
+		{
+		case 0: return p.x + p.w;
+		case 1: return p.w - p.x;
+		case 2: return p.y + p.w;
+		case 3: return p.w - p.y;
+		case 4: return p.z;
+		default: return p.w - p.z;
+		}
+	};
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		frameStats.trianglesSubmitted++;
+		ClipVertex poly[2][9];
+		int count = 3;
+		for (int v = 0; v < 3; v++)
+		{
+			const Vertex& src = pVertices[pIndices[i + v]];
+			poly[0][v].pos = src.pos;
+			for (int c = 0; c < 4; c++)
+			{
+				poly[0][v].col[c] = src.col[c] / 255.0f;
+			}
+		}
+
+		// sutherland-hodgman against the view volume, skipped for triangles fully inside
+		int cur = 0;
+		for (int plane = 0; plane < 6 && count > 0; plane++)
+		{
+			bool allInside = true;
+			for (int v = 0; v < count; v++)
+			{
+				allInside = allInside && planeDistance(poly[cur][v].pos, plane) >= 0.0f;
+			}
+			if (allInside)
+			{
+				continue;
+			}
+			const ClipVertex* in = poly[cur];
+			ClipVertex* out = poly[cur ^ 1];
+			int outCount = 0;
+			for (int v = 0; v < count; v++)
+			{
+				const ClipVertex& a = in[v];
+				const ClipVertex& b = in[(v + 1) % count];
+				const float da = planeDistance(a.pos, plane);
+				const float db = planeDistance(b.pos, plane);
+				if (da >= 0.0f)
+				{
+					out[outCount++] = a;
+				}
+				if ((da >= 0.0f) != (db >= 0.0f))
+				{
+					const float t = da / (da - db);
+					ClipVertex& o = out[outCount++];
+					o.pos = {
+						a.pos.x + (b.pos.x - a.pos.x) * t,
+						a.pos.y + (b.pos.y - a.pos.y) * t,
+						a.pos.z + (b.pos.z - a.pos.z) * t,
+						a.pos.w + (b.pos.w - a.pos.w) * t
+					};
+					for (int c = 0; c < 4; c++)
+					{
+						o.col[c] = a.col[c] + (b.col[c] - a.col[c]) * t;
+					}
+				}
+			}
+			count = outCount;
+			cur ^= 1;
+		}
+
+		// clipped polygon is convex, emit as a fan
+		for (int v = 1; v + 1 < count; v++)
+		{
+			SetupTriangle(poly[cur][0], poly[cur][v], poly[cur][v + 1]);
+		}
+	}
+}
+
+void SoftwareRasterizer::SetupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2)
+{
+	Triangle tri;
+	const ClipVertex* verts[3] = { &v0,&v1,&v2 };
+	for (int i = 0; i < 3; i++)
+	{
+		const Float4& p = verts[i]->pos;
+		if (p.w <= 0.0f)
+		{
+			return;
+		}
+		const float invW = 1.0f / p.w;
+		const float sx = (p.x * invW * 0.5f + 0.5f) * float(width);
+		const float sy = (-p.y * invW * 0.5f + 0.5f) * float(height);
+		tri.x[i] = static_cast<int32_t>(std::lround(sx * subPixelScale));
+		tri.y[i] = static_cast<int32_t>(std::lround(sy * subPixelScale));
+		tri.z[i] = p.z * invW;
+		tri.invW[i] = invW;
+		for (int c = 0; c < 4; c++)
+		{
+			tri.col[i][c] = verts[i]->col[c] * invW;
+		}
+	}
+
+	// clockwise (in y-down screen space) is front facing, cull back faces and degenerates
+	const int64_t area =
+		int64_t(tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+		int64_t(tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+	if (area <= 0)
+	{
+		return;
+	}
+
+	// pixel bounds (inclusive) whose centers could be covered
+	const int32_t minX = std::min({ tri.x[0],tri.x[1],tri.x[2] });
+	const int32_t maxX = std::max({ tri.x[0],tri.x[1],tri.x[2] });
+	const int32_t minY = std::min({ tri.y[0],tri.y[1],tri.y[2] });
+	const int32_t maxY = std::max({ tri.y[0],tri.y[1],tri.y[2] });
+	tri.minX = std::max(0, (minX - subPixelScale / 2) >> subPixelBits);
+	tri.minY = std::max(0, (minY - subPixelScale / 2) >> subPixelBits);
+	tri.maxX = std::min(int32_t(width) - 1, (maxX - subPixelScale / 2) >> subPixelBits);
+	tri.maxY = std::min(int32_t(height) - 1, (maxY - subPixelScale / 2) >> subPixelBits);
+	if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+	{
+		return;
+	}
+
+	triangles.push_back(tri);
+	BinTriangle(uint32_t(triangles.size() - 1u));
+}
+
+void SoftwareRasterizer::BinTriangle(uint32_t triIndex)
+{
+	const Triangle& tri = triangles[triIndex];
+	const unsigned int tx0 = unsigned(tri.minX) / tileSize;
+	const unsigned int tx1 = unsigned(tri.maxX) / tileSize;
+	const unsigned int ty0 = unsigned(tri.minY) / tileSize;
+	const unsigned int ty1 = unsigned(tri.maxY) / tileSize;
+	for (unsigned int ty = ty0; ty <= ty1; ty++)
+	{
+		for (unsigned int tx = tx0; tx <= tx1; tx++)
+		{
+			tileBins[size_t(ty) * tilesX + tx].push_back(triIndex);
+			frameStats.tileTriangleRefs++;
+		}
+	}
+	frameStats.trianglesBinned++;
+}
+
+void SoftwareRasterizer::Flush()
+{
+	// one tile per job, tiles own disjoint pixels so no synchronization is needed inside
+	const unsigned int nTiles = tilesX * tilesY;
+	if (pJobs)
+	{
+		pJobs->ParallelFor(0u, nTiles, 1u, [this](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				RasterizeTile(unsigned(i));
+			}
+		});
+	}
+	else
+	{
+		for (unsigned int i = 0; i < nTiles; i++)
+		{
+			RasterizeTile(i);
+		}
+	}
+
+	// frame is resolved, reset bins for the next one
+	triangles.clear();
+	for (auto& bin : tileBins)
+	{
+		bin.clear();
+	}
+	clearPending = false;
+	stats = frameStats;
+	frameStats = {};
+}
+
+void SoftwareRasterizer::RasterizeTile(unsigned int tileIndex) noexcept
+{
+	const int tileMinX = int(tileIndex % tilesX * tileSize);
+	const int tileMinY = int(tileIndex / tilesX * tileSize);
+	const int tileMaxX = std::min(tileMinX + int(tileSize), int(width)) - 1;
+	const int tileMaxY = std::min(tileMinY + int(tileSize), int(height)) - 1;
+
+	if (clearPending)
+	{
+		for (int y = tileMinY; y <= tileMaxY; y++)
+		{
+			const size_t row = size_t(y) * width;
+			std::fill(colorBuffer.begin() + row + tileMinX, colorBuffer.begin() + row + tileMaxX + 1, clearColor);
+			std::fill(depthBuffer.begin() + row + tileMinX, depthBuffer.begin() + row + tileMaxX + 1, clearDepth);
+		}
+	}
+
+	// bins hold triangles in submission order, so results do not depend on thread scheduling
+	for (const uint32_t triIndex : tileBins[tileIndex])
+	{
+		RasterizeTriangle(triangles[triIndex], tileMinX, tileMinY, tileMaxX, tileMaxY);
+	}
+}
+
+void SoftwareRasterizer::RasterizeTriangle(const Triangle& tri, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY) noexcept
+{
+	const int x0 = std::max(tri.minX, tileMinX);
+	const int x1 = std::min(tri.maxX, tileMaxX);
+	const int y0 = std::max(tri.minY, tileMinY);
+	const int y1 = std::min(tri.maxY, tileMaxY);
+	if (x0 > x1 || y0 > y1)
+	{
+		return;
+	}
+
+	// edge i runs from vertex i to vertex i+1, its function weights the opposite vertex (i+2)
+	int64_t stepX[3];
+	int64_t stepY[3];
+	int64_t rowStart[3];
+	const int64_t px = int64_t(x0) * subPixelScale + subPixelScale / 2;
+	const int64_t py = int64_t(y0) * subPixelScale + subPixelScale / 2;
+	for (int e = 0; e < 3; e++)
+	{
+		const int a = e;
+		const int b = (e + 1) % 3;
+		const int64_t dx = tri.x[b] - tri.x[a];
+		const int64_t dy = tri.y[b] - tri.y[a];
+		// top-left fill rule: pixels exactly on a top or left edge are inside, on other edges outside
+		const bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+		stepX[e] = -dy * subPixelScale;
+		stepY[e] = dx * subPixelScale;
+		rowStart[e] = dx * (py - tri.y[a]) - dy * (px - tri.x[a]) - (topLeft ? 0 : 1);
+	}
+	const int64_t area =
+		int64_t(tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+		int64_t(tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+	const float invArea = 1.0f / float(area);
+
+	for (int y = y0; y <= y1; y++)
+	{
+		int64_t e0 = rowStart[0];
+		int64_t e1 = rowStart[1];
+		int64_t e2 = rowStart[2];
+		uint32_t* pColor = colorBuffer.data() + size_t(y) * width;
+		float* pDepth = depthBuffer.data() + size_t(y) * width;
+		for (int x = x0; x <= x1; x++)
+		{
+			if ((e0 | e1 | e2) >= 0)
+			{
+				// fill rule bias is a single edge unit (28.4 coordinates, so 1/256 pixel area), negligible for interpolation
+				const float b2 = float(e0) * invArea;
+				const float b0 = float(e1) * invArea;
+				const float b1 = 1.0f - b0 - b2;
+				const float z = b0 * tri.z[0] + b1 * tri.z[1] + b2 * tri.z[2];
+				// D3D11_COMPARISON_LESS with depth writes enabled
+				if (z < pDepth[x])
+				{
+					pDepth[x] = z;
+					const float w = 1.0f / (b0 * tri.invW[0] + b1 * tri.invW[1] + b2 * tri.invW[2]);
+					float c[4];
+					for (int i = 0; i < 4; i++)
+					{
+						c[i] = (b0 * tri.col[0][i] + b1 * tri.col[1][i] + b2 * tri.col[2][i]) * w;
+					}
+					pColor[x] = PackColor(c[0], c[1], c[2], c[3]);
+				}
+			}
+			e0 += stepX[0];
+			e1 += stepX[1];
+			e2 += stepX[2];
+		}
+		rowStart[0] += stepY[0];
+		rowStart[1] += stepY[1];
+		rowStart[2] += stepY[2];
+	}
+}
+
+const uint32_t* SoftwareRasterizer::GetColorBuffer() const noexcept
+{
+	return colorBuffer.data();
+}
+
+const float* SoftwareRasterizer::GetDepthBuffer() const noexcept
+{
+	return depthBuffer.data();
+}
+
+unsigned int SoftwareRasterizer::GetWidth() const noexcept
+{
+	return width;
+}
+
+unsigned int SoftwareRasterizer::GetHeight() const noexcept
+{
+	return height;
+}
+
+unsigned int SoftwareRasterizer::GetThreadCount() const noexcept
+{
+	return pJobs ? pJobs->GetThreadCount() : 1u;
+}
+
+const SoftwareRasterizer::Stats& SoftwareRasterizer::GetStats() const noexcept
+{
+	return stats;
+}
\ No newline at end of file
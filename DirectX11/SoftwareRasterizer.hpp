@@ -0,0 +1,81 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// tile based triangle rasterizer writing B8G8R8A8 color + D32 depth into system memory
+// triangles are binned into screen tiles on submission and the tiles are rasterized in parallel on Flush(),
+// as jobs on pJobs (or on the calling thread without one)
+class SoftwareRasterizer
+{
+public:
+	// clip space position + color (bytes in B,G,R,A order, same as DXGI_FORMAT_B8G8R8A8_UNORM)
+	struct Vertex
+	{
+		Float4 pos;
+		uint8_t col[4];
+	};
+	struct Stats
+	{
+		unsigned int trianglesSubmitted = 0u;
+		unsigned int trianglesBinned = 0u;
+		unsigned int tileTriangleRefs = 0u;
+	};
+	static constexpr unsigned int tileSize = 64u;
+public:
+	SoftwareRasterizer(unsigned int width, unsigned int height, JobSystem* pJobs = nullptr);
+	SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+	// clear is deferred and executed per tile on the worker that owns the tile
+	void Clear(uint32_t color, float depth) noexcept;
+	// culls (back faces, clockwise front like the default D3D11 rasterizer state), clips and bins the triangles
+	void DrawIndexed(const Vertex* pVertices, const uint16_t* pIndices, size_t indexCount);
+	void DrawIndexed(const Vertex* pVertices, const uint32_t* pIndices, size_t indexCount);
+	// rasterizes every binned tile; the color and depth buffers are valid after this returns
+	void Flush();
+	const uint32_t* GetColorBuffer() const noexcept;
+	const float* GetDepthBuffer() const noexcept;
+	unsigned int GetWidth() const noexcept;
+	unsigned int GetHeight() const noexcept;
+	unsigned int GetThreadCount() const noexcept;
+	const Stats& GetStats() const noexcept;
+private:
+	// screen space triangle, vertices in 28.4 fixed point, attributes pre-divided by w
+	struct Triangle
+	{
+		int32_t x[3];
+		int32_t y[3];
+		float z[3];
+		float invW[3];
+		float col[3][4];
+		int32_t minX, minY, maxX, maxY;
+	};
+	struct ClipVertex
+	{
+		Float4 pos;
+		float col[4];
+	};
+	template<typename Index>
+	void DrawTriangles(const Vertex* pVertices, const Index* pIndices, size_t indexCount);
+	void SetupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+	void BinTriangle(uint32_t triIndex);
+	void RasterizeTile(unsigned int tileIndex) noexcept;
+	void RasterizeTriangle(const Triangle& tri, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY) noexcept;
+private:
+	unsigned int width;
+	unsigned int height;
+	unsigned int tilesX;
+	unsigned int tilesY;
+	std::vector<uint32_t> colorBuffer;
+	std::vector<float> depthBuffer;
+	std::vector<Triangle> triangles;
+	std::vector<std::vector<uint32_t>> tileBins;
+	bool clearPending = false;
+	uint32_t clearColor = 0u;
+	float clearDepth = 1.0f;
+	Stats stats;
+	Stats frameStats;
+	JobSystem* pJobs;
+};
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// lock free single producer / single consumer ring (Lamport queue with cached indices):
+// one thread pushes, one other thread pops. fixed power of two capacity, TryPush reports a full ring
+template<typename T>
+class SpscRing
+{
+	static_assert(std::is_trivially_copyable<T>::value, "ring items are copied by value between threads");
+public:
+	explicit SpscRing(size_t capacity = 1024u)
+	{
+		size_t size = 1u;
+		while (size < capacity)
+		{
+			size *= 2u;
+		}
+		mask = size - 1u;
+		pItems = std::make_unique<T[]>(size);
+	}
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+	// producer only
+	bool TryPush(const T& item) noexcept
+	{
+		const size_t t = tail.load(std::memory_order_relaxed);
+		if (t - headCache > mask)
+		{
+			// looks full, refresh the consumer position before giving up
+			headCache = head.load(std::memory_order_acquire);
+			if (t - headCache > mask)
+			{
+				return false;
+			}
+		}
+		pItems[t & mask] = item;
+		// publishes the item to the consumer that acquires tail
+		tail.store(t + 1u, std::memory_order_release);
+		return true;
+	}
+	// consumer only
+	bool TryPop(T& item) noexcept
+	{
+		const size_t h = head.load(std::memory_order_relaxed);
+		if (h == tailCache)
+		{
+			tailCache = tail.load(std::memory_order_acquire);
+			if (h == tailCache)
+			{
+				return false;
+			}
+		}
+		item = pItems[h & mask];
+		// hands the slot back to the producer
+		head.store(h + 1u, std::memory_order_release);
+		return true;
+	}
+	// approximate when called concurrently
+	bool Empty() const noexcept
+	{
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+	size_t GetCapacity() const noexcept
+	{
+		return mask + 1u;
+	}
+private:
+	// one cache line per side: the consumer's head with its copy of tail, the producer's tail with its copy of head
+	alignas(64) std::atomic<size_t> head{ 0u };
+	size_t tailCache = 0u;
+	alignas(64) std::atomic<size_t> tail{ 0u };
+	size_t headCache = 0u;
+	alignas(64) size_t mask = 0u;
+	std::unique_ptr<T[]> pItems;
+};
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "StateFilter.hpp"
+
+unsigned int StateFilter::Stats::TotalIssued() const noexcept
+{
+	unsigned int total = 0u;
+	for (const auto n : issued)
+	{
+		total += n;
+	}
+	return total;
+}
+
+unsigned int StateFilter::Stats::TotalElided() const noexcept
+{
+	unsigned int total = 0u;
+	for (const auto n : elided)
+	{
+		total += n;
+	}
+	return total;
+}
+
+StateFilter::StateFilter(IRenderContext& inner) noexcept
+	:
+	inner(inner)
+{}
+
+void StateFilter::EndFrame() noexcept
+{
+	lastFrameStats = frameStats;
+	frameStats = {};
+}
+
+void StateFilter::Invalidate() noexcept
+{
+	known.fill(false);
+	knownVertexBuffers.fill(false);
+	knownConstantBuffers.fill(false);
+}
+
+const StateFilter::Stats& StateFilter::GetFrameStats() const noexcept
+{
+	return frameStats;
+}
+
+const StateFilter::Stats& StateFilter::GetLastFrameStats() const noexcept
+{
+	return lastFrameStats;
+}
+
+bool StateFilter::Filter(Call call, bool changed) noexcept
+{
+	if (changed)
+	{
+		frameStats.issued[size_t(call)]++;
+	}
+	else
+	{
+		frameStats.elided[size_t(call)]++;
+	}
+	return changed;
+}
+
+void StateFilter::IASetPrimitiveTopology(Topology topology)
+{
+	auto& k = known[size_t(Call::Topology)];
+	if (Filter(Call::Topology, !k || shadow.topology != topology))
+	{
+		shadow.topology = topology;
+		k = true;
+		inner.IASetPrimitiveTopology(topology);
+	}
+}
+
+void StateFilter::IASetInputLayout(InputLayoutHandle layout)
+{
+	auto& k = known[size_t(Call::InputLayout)];
+	if (Filter(Call::InputLayout, !k || shadow.layout != layout))
+	{
+		shadow.layout = layout;
+		k = true;
+		inner.IASetInputLayout(layout);
+	}
+}
+
+void StateFilter::IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset)
+{
+	if (slot >= maxVertexBuffers)
+	{
+		Filter(Call::VertexBuffer, true);
+		inner.IASetVertexBuffer(slot, buffer, stride, offset);
+		return;
+	}
+	auto& b = shadow.vertexBuffers[slot];
+	const bool changed = !knownVertexBuffers[slot] || b.buffer != buffer || b.stride != stride || b.offset != offset;
+	if (Filter(Call::VertexBuffer, changed))
+	{
+		b = { buffer,stride,offset };
+		knownVertexBuffers[slot] = true;
+		inner.IASetVertexBuffer(slot, buffer, stride, offset);
+	}
+}
+
+void StateFilter::IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset)
+{
+	auto& k = known[size_t(Call::IndexBuffer)];
+	const bool changed = !k || shadow.indexBuffer != buffer || shadow.indexFormat != format || shadow.indexOffset != offset;
+	if (Filter(Call::IndexBuffer, changed))
+	{
+		shadow.indexBuffer = buffer;
+		shadow.indexFormat = format;
+		shadow.indexOffset = offset;
+		k = true;
+		inner.IASetIndexBuffer(buffer, format, offset);
+	}
+}
+
+void StateFilter::VSSetShader(VertexShaderHandle shader)
+{
+	auto& k = known[size_t(Call::VertexShader)];
+	if (Filter(Call::VertexShader, !k || shadow.vertexShader != shader))
+	{
+		shadow.vertexShader = shader;
+		k = true;
+		inner.VSSetShader(shader);
+	}
+}
+
+void StateFilter::PSSetShader(PixelShaderHandle shader)
+{
+	auto& k = known[size_t(Call::PixelShader)];
+	if (Filter(Call::PixelShader, !k || shadow.pixelShader != shader))
+	{
+		shadow.pixelShader = shader;
+		k = true;
+		inner.PSSetShader(shader);
+	}
+}
+
+void StateFilter::VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant, unsigned int numConstants)
+{
+	if (slot >= maxConstantBuffers)
+	{
+		Filter(Call::ConstantBuffer, true);
+		inner.VSSetConstantBuffer(slot, buffer, firstConstant, numConstants);
+		return;
+	}
+	// ring suballocations share one buffer, so the offset range is part of the binding
+	auto& b = shadow.constantBuffers[slot];
+	const bool changed = !knownConstantBuffers[slot] || b.buffer != buffer ||
+		b.firstConstant != firstConstant || b.numConstants != numConstants;
+	if (Filter(Call::ConstantBuffer, changed))
+	{
+		b = { buffer,firstConstant,numConstants };
+		knownConstantBuffers[slot] = true;
+		inner.VSSetConstantBuffer(slot, buffer, firstConstant, numConstants);
+	}
+}
+
+void StateFilter::OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth)
+{
+	auto& k = known[size_t(Call::RenderTarget)];
+	if (Filter(Call::RenderTarget, !k || shadow.target != target || shadow.depth != depth))
+	{
+		shadow.target = target;
+		shadow.depth = depth;
+		k = true;
+		inner.OMSetRenderTarget(target, depth);
+	}
+}
+
+void StateFilter::OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef)
+{
+	auto& k = known[size_t(Call::DepthStencilState)];
+	if (Filter(Call::DepthStencilState, !k || shadow.depthState != state || shadow.stencilRef != stencilRef))
+	{
+		shadow.depthState = state;
+		shadow.stencilRef = stencilRef;
+		k = true;
+		inner.OMSetDepthStencilState(state, stencilRef);
+	}
+}
+
+void* StateFilter::Map(BufferHandle buffer, MapMode mode)
+{
+	frameStats.maps++;
+	return inner.Map(buffer, mode);
+}
+
+void StateFilter::Unmap(BufferHandle buffer)
+{
+	inner.Unmap(buffer);
+}
+
+void StateFilter::UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size)
+{
+	frameStats.maps++;
+	inner.UpdateBuffer(buffer, mode, offset, pData, size);
+}
+
+void StateFilter::ClearRenderTarget(RenderTargetHandle target, const float color[4])
+{
+	inner.ClearRenderTarget(target, color);
+}
+
+void StateFilter::ClearDepth(DepthStencilViewHandle depth, float value)
+{
+	inner.ClearDepth(depth, value);
+}
+
+void StateFilter::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	frameStats.draws++;
+	frameStats.triangles += indexCount / 3u;
+	inner.DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void StateFilter::DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+	unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	frameStats.draws++;
+	frameStats.triangles += static_cast<unsigned long long>(indexCountPerInstance / 3u) * instanceCount;
+	inner.DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include "RenderContext.hpp"
+#include <array>
+
+// shadows pipeline bindings and forwards only the ones that change the state of the wrapped context
+class StateFilter : public IRenderContext
+{
+public:
+	enum class Call
+	{
+		Topology,
+		InputLayout,
+		VertexBuffer,
+		IndexBuffer,
+		VertexShader,
+		PixelShader,
+		ConstantBuffer,
+		RenderTarget,
+		DepthStencilState,
+		Count
+	};
+	struct Stats
+	{
+		std::array<unsigned int, size_t(Call::Count)> issued{};
+		std::array<unsigned int, size_t(Call::Count)> elided{};
+		unsigned int draws = 0u;
+		unsigned long long triangles = 0u;
+		unsigned int maps = 0u;
+		unsigned int TotalIssued() const noexcept;
+		unsigned int TotalElided() const noexcept;
+	};
+	static constexpr unsigned int maxVertexBuffers = 16u;
+	static constexpr unsigned int maxConstantBuffers = 14u;
+public:
+	StateFilter(IRenderContext& inner) noexcept;
+	StateFilter(const StateFilter&) = delete;
+	StateFilter& operator=(const StateFilter&) = delete;
+	// closes the counters of the current frame, readable through GetLastFrameStats()
+	void EndFrame() noexcept;
+	// forget the shadow copy, use after something bound state on the inner context behind our back
+	void Invalidate() noexcept;
+	const Stats& GetFrameStats() const noexcept;
+	const Stats& GetLastFrameStats() const noexcept;
+	void IASetPrimitiveTopology(Topology topology) override;
+	void IASetInputLayout(InputLayoutHandle layout) override;
+	void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) override;
+	void IASetIndexBuffer(BufferHandle buffer, IndexFormat format, unsigned int offset) override;
+	void VSSetShader(VertexShaderHandle shader) override;
+	void PSSetShader(PixelShaderHandle shader) override;
+	void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant = 0u, unsigned int numConstants = 0u) override;
+	void OMSetRenderTarget(RenderTargetHandle target, DepthStencilViewHandle depth) override;
+	void OMSetDepthStencilState(DepthStencilStateHandle state, unsigned int stencilRef) override;
+	void* Map(BufferHandle buffer, MapMode mode) override;
+	void Unmap(BufferHandle buffer) override;
+	void UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size) override;
+	void ClearRenderTarget(RenderTargetHandle target, const float color[4]) override;
+	void ClearDepth(DepthStencilViewHandle depth, float value) override;
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) override;
+	void DrawIndexedInstanced(unsigned int indexCountPerInstance, unsigned int instanceCount,
+		unsigned int startIndex, int baseVertex, unsigned int startInstance) override;
+private:
+	// returns true when the call has to be forwarded, and counts it either way
+	bool Filter(Call call, bool changed) noexcept;
+private:
+	struct VertexBufferBinding
+	{
+		BufferHandle buffer;
+		unsigned int stride;
+		unsigned int offset;
+	};
+	struct ConstantBufferBinding
+	{
+		BufferHandle buffer;
+		unsigned int firstConstant;
+		unsigned int numConstants;
+	};
+	struct Shadow
+	{
+		Topology topology = Topology::TriangleList;
+		InputLayoutHandle layout = InputLayoutHandle::Null;
+		std::array<VertexBufferBinding, maxVertexBuffers> vertexBuffers{};
+		BufferHandle indexBuffer = BufferHandle::Null;
+		IndexFormat indexFormat = IndexFormat::Uint16;
+		unsigned int indexOffset = 0u;
+		VertexShaderHandle vertexShader = VertexShaderHandle::Null;
+		PixelShaderHandle pixelShader = PixelShaderHandle::Null;
+		std::array<ConstantBufferBinding, maxConstantBuffers> constantBuffers{};
+		RenderTargetHandle target = RenderTargetHandle::Null;
+		DepthStencilViewHandle depth = DepthStencilViewHandle::Null;
+		DepthStencilStateHandle depthState = DepthStencilStateHandle::Null;
+		unsigned int stencilRef = 0u;
+	};
+	IRenderContext& inner;
+	// a binding is only compared against the shadow once we know what the inner context holds
+	std::array<bool, size_t(Call::Count)> known{};
+	std::array<bool, maxVertexBuffers> knownVertexBuffers{};
+	std::array<bool, maxConstantBuffers> knownConstantBuffers{};
+	Shadow shadow;
+	Stats frameStats;
+	Stats lastFrameStats;
+};
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "StressScene.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace
+{
+	// spin * time reduced to one turn in double, in float the angle would stop moving after a few hours
+	float SpinAngle(float rate, double time) noexcept
+	{
+		constexpr double twoPi = 6.283185307179586;
+		const double turns = double(rate) * time * (1.0 / twoPi);
+		// truncating keeps the sign; (-2pi,2pi) serves sin and cos as well and skips a floor call
+		return float((turns - double(int64_t(turns))) * twoPi);
+	}
+}
+
+StressScene::StressScene(const Settings& settings)
+	:
+	settings(settings)
+{
+	const size_t count = settings.count;
+	std::mt19937 rng(settings.seed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	const auto inBall = [&]()
+	{
+		Float3 p;
+		do
+		{
+			p = { unit(rng),unit(rng),unit(rng) };
+		} while (Dot(p, p) > 1.0f);
+		return Float3{ p.x * radius,p.y * radius,p.z * radius };
+	};
+
+	// edge length that gives every cube about an even share of the ball, half of it filled
+	const float share = std::cbrt(4.18879f * radius * radius * radius / float(std::max<size_t>(count, 1u)));
+	const unsigned int side = unsigned(std::ceil(std::cbrt(double(count))));
+	const float spacing = 2.0f * radius / float(std::max(side, 1u));
+	std::vector<Float3> clusterCenters;
+	if (settings.distribution == Distribution::Clusters)
+	{
+		clusterCenters.resize(std::clamp<size_t>(count / 256u, 1u, 64u));
+		for (Float3& c : clusterCenters)
+		{
+			c = inBall();
+		}
+	}
+	std::normal_distribution<float> spread(0.0f, radius * 0.1f);
+	std::uniform_real_distribution<float> spin(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> phase(0.0f, 2.0f * PI);
+
+	instances.resize(count);
+	occluders.resize(count);
+	materials.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Instance& inst = instances[i];
+		switch (settings.distribution)
+		{
+		case Distribution::Grid:
+		{
+			const size_t x = i % side;
+			const size_t y = (i / side) % side;
+			const size_t z = i / (size_t(side) * side);
+			inst.position = {
+				-radius + (float(x) + 0.5f) * spacing,
+				-radius + (float(y) + 0.5f) * spacing,
+				-radius + (float(z) + 0.5f) * spacing
+			};
+			inst.scale = 0.5f * spacing;
+			break;
+		}
+		case Distribution::Sphere:
+			inst.position = inBall();
+			inst.scale = 0.5f * share;
+			break;
+		case Distribution::Clusters:
+		{
+			const Float3& c = clusterCenters[i % clusterCenters.size()];
+			inst.position = { c.x + spread(rng),c.y + spread(rng),c.z + spread(rng) };
+			inst.scale = 0.25f * share;
+			break;
+		}
+		}
+		inst.spinX = spin(rng);
+		inst.spinY = spin(rng);
+		inst.phaseX = phase(rng);
+		inst.phaseY = phase(rng);
+		occluders[i] = settings.occluderStride != 0u && i % settings.occluderStride == 0u ? 1u : 0u;
+		materials[i] = settings.materials == 0u ? 0u : uint16_t(1u + rng() % settings.materials);
+	}
+
+	if (!settings.animate)
+	{
+		restTransforms.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			restTransforms[i] = Transform(i, 0.0f);
+		}
+	}
+}
+
+void StressScene::Build(FrameSnapshot& scene, double time, JobSystem& jobs) const
+{
+	PROFILE_ZONE("StressScene");
+	const size_t first = scene.cubes.size();
+	const size_t count = instances.size();
+	// resize keeps the capacity of the earlier frames, steady state does not allocate
+	scene.cubes.resize(first + count);
+	scene.occluders.resize(first + count);
+	scene.materials.resize(first + count);
+	Matrix4* const pCubes = scene.cubes.data() + first;
+	std::memcpy(scene.occluders.data() + first, occluders.data(), count * sizeof(uint8_t));
+	std::memcpy(scene.materials.data() + first, materials.data(), count * sizeof(uint16_t));
+	if (!settings.animate)
+	{
+		std::memcpy(pCubes, restTransforms.data(), count * sizeof(Matrix4));
+		return;
+	}
+	jobs.ParallelFor(0u, count, 4096u, [this, pCubes, time](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			pCubes[i] = Transform(i, time);
+		}
+	});
+}
+
+const StressScene::Settings& StressScene::GetSettings() const noexcept
+{
+	return settings;
+}
+
+size_t StressScene::GetCount() const noexcept
+{
+	return instances.size();
+}
+
+const char* StressScene::GetDistributionName(Distribution distribution) noexcept
+{
+	switch (distribution)
+	{
+	case Distribution::Grid:
+		return "grid";
+	case Distribution::Sphere:
+		return "sphere";
+	case Distribution::Clusters:
+		return "clusters";
+	}
+	return "unknown";
+}
+
+bool StressScene::ParseArguments(int argc, const char* const* argv, Settings& settings)
+{
+	bool found = false;
+	for (int i = 0; i < argc; i++)
+	{
+		const char* const arg = argv[i];
+		if (std::strcmp(arg, "--static") == 0)
+		{
+			settings.animate = false;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			break;
+		}
+		const char* const value = argv[i + 1];
+		if (std::strcmp(arg, "--stress") == 0)
+		{
+			settings.count = size_t(std::strtoull(value, nullptr, 10));
+			found = true;
+		}
+		else if (std::strcmp(arg, "--distribution") == 0)
+		{
+			for (const Distribution d : { Distribution::Grid,Distribution::Sphere,Distribution::Clusters })
+			{
+				if (std::strcmp(value, GetDistributionName(d)) == 0)
+				{
+					settings.distribution = d;
+				}
+			}
+		}
+		else if (std::strcmp(arg, "--materials") == 0)
+		{
+			settings.materials = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (std::strcmp(arg, "--occluders") == 0)
+		{
+			settings.occluderStride = unsigned(std::strtoul(value, nullptr, 10));
+		}
+		else if (std::strcmp(arg, "--seed") == 0)
+		{
+			settings.seed = uint32_t(std::strtoul(value, nullptr, 10));
+		}
+		else
+		{
+			continue;
+		}
+		i++;
+	}
+	// the material id has to fit the 16 bit snapshot field
+	settings.materials = std::min(settings.materials, 65535u);
+	return found;
+}
+
+int StressScene::GetArgumentValueCount(const char* arg) noexcept
+{
+	if (std::strcmp(arg, "--static") == 0)
+	{
+		return 0;
+	}
+	for (const char* const option : { "--stress","--distribution","--materials","--occluders","--seed" })
+	{
+		if (std::strcmp(arg, option) == 0)
+		{
+			return 1;
+		}
+	}
+	return -1;
+}
+
+Matrix4 StressScene::Transform(size_t i, double time) const noexcept
+{
+	// Scaling * RotationX * RotationY * Translation written out, it runs a million times a frame
+	const Instance& inst = instances[i];
+	const float ax = inst.phaseX + SpinAngle(inst.spinX, time);
+	const float ay = inst.phaseY + SpinAngle(inst.spinY, time);
+	const float sx = std::sin(ax), cx = std::cos(ax);
+	const float sy = std::sin(ay), cy = std::cos(ay);
+	const float s = inst.scale;
+	return { {
+		{ s * cy, 0.0f, -s * sy, 0.0f },
+		{ s * sx * sy, s * cx, s * sx * cy, 0.0f },
+		{ s * cx * sy, -s * sx, s * cx * cy, 0.0f },
+		{ inst.position.x, inst.position.y, inst.position.z, 1.0f }
+	} };
+}
\ No newline at end of file
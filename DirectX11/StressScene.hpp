@@ -0,0 +1,68 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include "JobSystem.hpp"
+#include "RenderThread.hpp"
+#include <cstdint>
+#include <vector>
+
+// synthetic load for finding where submission and culling stop scaling: count cubes spread through
+// a ball around the origin, so the camera sits inside the scene and most of it gets frustum culled.
+// placement, spin and material are seeded at construction, a frame only evaluates the spin at a time
+class StressScene
+{
+public:
+	enum class Distribution
+	{
+		// regular lattice filling the bounding cube
+		Grid,
+		// uniform inside the ball
+		Sphere,
+		// gaussian blobs with empty space between them, uneven work per cull range
+		Clusters
+	};
+	struct Settings
+	{
+		size_t count = 10000u;
+		Distribution distribution = Distribution::Grid;
+		// distinct tints handed out at random, 0 leaves every cube untinted
+		unsigned int materials = 8u;
+		// every n-th cube is an occluder, 0 = none
+		unsigned int occluderStride = 0u;
+		// false keeps every cube at its rest pose, Build then only copies transforms
+		bool animate = true;
+		uint32_t seed = 1u;
+	};
+	static constexpr float radius = 20.0f;
+public:
+	explicit StressScene(const Settings& settings);
+	// appends every cube at time seconds to the snapshot, transforms are filled in parallel on jobs
+	void Build(FrameSnapshot& scene, double time, JobSystem& jobs) const;
+	const Settings& GetSettings() const noexcept;
+	size_t GetCount() const noexcept;
+	static const char* GetDistributionName(Distribution distribution) noexcept;
+	// --stress N --distribution grid|sphere|clusters --materials N --occluders N --static --seed N;
+	// false when --stress is missing, unknown arguments and values are ignored
+	static bool ParseArguments(int argc, const char* const* argv, Settings& settings);
+	// values the option takes (0 for --static), -1 when arg is not one of the options above;
+	// lets a caller that shares its command line with ParseArguments reject what neither knows
+	static int GetArgumentValueCount(const char* arg) noexcept;
+private:
+	Matrix4 Transform(size_t i, double time) const noexcept;
+private:
+	struct Instance
+	{
+		Float3 position;
+		float scale;
+		// radians per second and at time 0, about x then y
+		float spinX;
+		float spinY;
+		float phaseX;
+		float phaseY;
+	};
+	Settings settings;
+	std::vector<Instance> instances;
+	std::vector<uint8_t> occluders;
+	std::vector<uint16_t> materials;
+	// only when not animated
+	std::vector<Matrix4> restTransforms;
+};
\ No newline at end of file
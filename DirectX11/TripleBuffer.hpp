@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// lock free latest-value mailbox between one writer and one reader: the writer never waits and
+// never overwrites what the reader is looking at, the reader always gets the newest complete value.
+// values in between are dropped, which is the point for stats that are sampled slower than produced
+template<typename T>
+class TripleBuffer
+{
+	static_assert(std::is_trivially_copyable<T>::value, "values are copied by value between threads");
+public:
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+	// writer only
+	void Write(const T& value) noexcept
+	{
+		buffers[writeIndex] = value;
+		// hand the filled buffer over and take whichever one was waiting in the middle
+		writeIndex = middle.exchange(uint8_t(writeIndex | freshBit), std::memory_order_acq_rel) & indexMask;
+	}
+	// reader only, false when nothing was written since the previous Read
+	bool Read(T& value) noexcept
+	{
+		const bool fresh = (middle.load(std::memory_order_relaxed) & freshBit) != 0u;
+		if (fresh)
+		{
+			readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+		}
+		value = buffers[readIndex];
+		return fresh;
+	}
+private:
+	static constexpr uint8_t indexMask = 3u;
+	static constexpr uint8_t freshBit = 4u;
+	T buffers[3] = {};
+	// index of the buffer between writer and reader, plus whether it holds an unread value
+	alignas(64) std::atomic<uint8_t> middle{ 1u };
+	alignas(64) uint8_t writeIndex = 0u;
+	alignas(64) uint8_t readIndex = 2u;
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "UploadRing.hpp"
+#include <algorithm>
+
+UploadRing::UploadRing(size_t capacity, unsigned int framesInFlight)
+	:
+	capacity(capacity - capacity % alignment),
+	framesInFlight(std::max(1u, framesInFlight)),
+	frameEnds(std::max(1u, framesInFlight))
+{}
+
+std::optional<UploadRing::Allocation> UploadRing::Allocate(size_t size) noexcept
+{
+	const size_t alignedSize = Align(std::max<size_t>(size, 1u));
+	if (alignedSize > capacity)
+	{
+		return {};
+	}
+	uint64_t pos = head;
+	// slices never straddle the end of the buffer, pad to the start instead
+	const size_t physical = size_t(pos % capacity);
+	if (physical + alignedSize > capacity)
+	{
+		pos += capacity - physical;
+	}
+	if (pos + alignedSize - tail > capacity)
+	{
+		return {};
+	}
+	head = pos + alignedSize;
+	peakFrameBytes = std::max(peakFrameBytes, size_t(head - frameStart));
+
+	Allocation a;
+	a.offset = size_t(pos % capacity);
+	a.size = alignedSize;
+	a.discard = needsDiscard;
+	needsDiscard = false;
+	return a;
+}
+
+void UploadRing::EndFrame() noexcept
+{
+	if (pendingFrames == framesInFlight)
+	{
+		// the oldest frame can no longer be in use by the GPU, its space becomes free
+		tail = frameEnds[oldestFrame];
+		oldestFrame = (oldestFrame + 1u) % framesInFlight;
+		pendingFrames--;
+	}
+	frameEnds[(oldestFrame + pendingFrames) % framesInFlight] = head;
+	pendingFrames++;
+	frameStart = head;
+}
+
+void UploadRing::Reset() noexcept
+{
+	head = 0u;
+	tail = 0u;
+	frameStart = 0u;
+	oldestFrame = 0u;
+	pendingFrames = 0u;
+	needsDiscard = true;
+}
+
+size_t UploadRing::GetCapacity() const noexcept
+{
+	return capacity;
+}
+
+size_t UploadRing::GetBytesInFlight() const noexcept
+{
+	return size_t(head - tail);
+}
+
+size_t UploadRing::GetFrameBytes() const noexcept
+{
+	return size_t(head - frameStart);
+}
+
+size_t UploadRing::GetPeakFrameBytes() const noexcept
+{
+	return peakFrameBytes;
+}
\ No newline at end of file
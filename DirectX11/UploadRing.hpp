@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// linear suballocator over one large upload buffer (dynamic constant buffer)
+// slices are carved out in submission order and the space of a frame is only recycled
+// after framesInFlight later frames have ended, so writes never touch memory the GPU may still read
+class UploadRing
+{
+public:
+	// constant buffer offsets must be multiples of 16 constants (256 bytes)
+	static constexpr size_t alignment = 256u;
+	struct Allocation
+	{
+		size_t offset = 0u;
+		size_t size = 0u;
+		// first slice since the ring was started: map with WRITE_DISCARD, otherwise WRITE_NO_OVERWRITE
+		bool discard = false;
+	};
+public:
+	UploadRing(size_t capacity, unsigned int framesInFlight);
+	// empty optional when the ring has no room left without overwriting in flight frames
+	std::optional<Allocation> Allocate(size_t size) noexcept;
+	// closes the current frame and retires the oldest one once more than framesInFlight are pending
+	void EndFrame() noexcept;
+	// drops all tracking, valid after the backing buffer was discarded (renamed) by the driver
+	void Reset() noexcept;
+	size_t GetCapacity() const noexcept;
+	// bytes between the oldest in flight slice and the write head, including wrap padding
+	size_t GetBytesInFlight() const noexcept;
+	size_t GetFrameBytes() const noexcept;
+	size_t GetPeakFrameBytes() const noexcept;
+	static constexpr size_t Align(size_t size) noexcept
+	{
+		return (size + alignment - 1u) & ~(alignment - 1u);
+	}
+private:
+	size_t capacity;
+	unsigned int framesInFlight;
+	// monotonic positions, physical offset is position % capacity
+	uint64_t head = 0u;
+	uint64_t tail = 0u;
+	uint64_t frameStart = 0u;
+	size_t peakFrameBytes = 0u;
+	bool needsDiscard = true;
+	// ring of head positions recorded at the end of each pending frame
+	std::vector<uint64_t> frameEnds;
+	unsigned int oldestFrame = 0u;
+	unsigned int pendingFrames = 0u;
+};
\ No newline at end of file
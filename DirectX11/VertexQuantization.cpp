@@ -0,0 +1,642 @@
+#include "VertexQuantization.hpp"
+#include "CpuFeatures.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef CHILI_X86
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(Float2) == 8u && sizeof(Float3) == 12u, "kernels read packed float vectors");
+
+namespace
+{
+	using namespace VertexQuantization;
+
+	constexpr float unorm16Max = 65535.0f;
+	constexpr float snorm16Max = 32767.0f;
+
+	Kernel DetectKernel() noexcept
+	{
+		if (CpuFeatures::HasAvx2())
+		{
+			return Kernel::Avx2;
+		}
+		return CpuFeatures::HasSse2() ? Kernel::Sse2 : Kernel::Scalar;
+	}
+
+	const Kernel supportedKernel = DetectKernel();
+	Kernel activeKernel = supportedKernel;
+
+	void Store32(uint8_t* p, uint32_t value) noexcept
+	{
+		std::memcpy(p, &value, sizeof(value));
+	}
+
+	uint32_t Load32(const uint8_t* p) noexcept
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	// scalar reference versions, also handle the tails of the simd loops;
+	// the simd kernels use the same operation order so all paths produce identical bits
+
+	float PositionScale(float min, float max) noexcept
+	{
+		return max > min ? unorm16Max / (max - min) : 0.0f;
+	}
+
+	uint32_t QuantizeUnorm16(float v, float min, float scale) noexcept
+	{
+		const float q = std::min(std::max((v - min) * scale, 0.0f), unorm16Max);
+		return uint32_t(std::nearbyint(q));
+	}
+
+	uint32_t QuantizeSnorm16(float v) noexcept
+	{
+		const float q = std::min(std::max(v, -1.0f), 1.0f) * snorm16Max;
+		return uint32_t(int32_t(std::nearbyint(q))) & 0xFFFFu;
+	}
+
+	void EncodePositionScalar(const Float3& p, const Float3& min, const Float3& scale, uint8_t* pOut) noexcept
+	{
+		Store32(pOut, QuantizeUnorm16(p.x, min.x, scale.x) | (QuantizeUnorm16(p.y, min.y, scale.y) << 16));
+		// w = 1.0 so the shader can treat the position as a full float4
+		Store32(pOut + 4, QuantizeUnorm16(p.z, min.z, scale.z) | 0xFFFF0000u);
+	}
+
+	void EncodeNormalScalar(const Float3& n, uint8_t* pOut) noexcept
+	{
+		// project onto the octahedron |x|+|y|+|z| = 1, then fold the lower half over the diagonals
+		const float inv = 1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+		float x = n.x * inv;
+		float y = n.y * inv;
+		if (n.z * inv < 0.0f)
+		{
+			const float fx = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+			const float fy = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+			x = fx;
+			y = fy;
+		}
+		Store32(pOut, QuantizeSnorm16(x) | (QuantizeSnorm16(y) << 16));
+	}
+
+	float DecodeSnorm16(uint32_t bits) noexcept
+	{
+		return std::max(float(int16_t(uint16_t(bits))) / snorm16Max, -1.0f);
+	}
+
+	Float3 DecodeNormalScalar(const uint8_t* pIn) noexcept
+	{
+		const uint32_t bits = Load32(pIn);
+		float x = DecodeSnorm16(bits);
+		float y = DecodeSnorm16(bits >> 16);
+		const float z = 1.0f - std::abs(x) - std::abs(y);
+		// unfold the lower hemisphere
+		const float t = std::max(-z, 0.0f);
+		x -= std::copysign(t, x);
+		y -= std::copysign(t, y);
+		return Normalize({ x,y,z });
+	}
+
+#ifdef CHILI_X86
+	__m128 Clamp(__m128 v, __m128 lo, __m128 hi) noexcept
+	{
+		return _mm_min_ps(_mm_max_ps(v, lo), hi);
+	}
+
+	size_t EncodePositionsSse2(const Float3* pIn, size_t count, const Float3& min, const Float3& scale, uint8_t* pOut, size_t outStride) noexcept
+	{
+		const __m128 minX = _mm_set1_ps(min.x), minY = _mm_set1_ps(min.y), minZ = _mm_set1_ps(min.z);
+		const __m128 scaleX = _mm_set1_ps(scale.x), scaleY = _mm_set1_ps(scale.y), scaleZ = _mm_set1_ps(scale.z);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 maxQ = _mm_set1_ps(unorm16Max);
+		const __m128i w = _mm_set1_epi32(int(0xFFFF0000u));
+		alignas(16) uint32_t xy[4];
+		alignas(16) uint32_t zw[4];
+		size_t i = 0;
+		for (; i + 4u <= count; i += 4u)
+		{
+			const Float3* p = pIn + i;
+			const __m128 x = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+			const __m128 y = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+			const __m128 z = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+			const __m128i qx = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_sub_ps(x, minX), scaleX), zero, maxQ));
+			const __m128i qy = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_sub_ps(y, minY), scaleY), zero, maxQ));
+			const __m128i qz = _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_sub_ps(z, minZ), scaleZ), zero, maxQ));
+			_mm_store_si128(reinterpret_cast<__m128i*>(xy), _mm_or_si128(qx, _mm_slli_epi32(qy, 16)));
+			_mm_store_si128(reinterpret_cast<__m128i*>(zw), _mm_or_si128(qz, w));
+			for (size_t k = 0; k < 4u; k++)
+			{
+				Store32(pOut + (i + k) * outStride, xy[k]);
+				Store32(pOut + (i + k) * outStride + 4, zw[k]);
+			}
+		}
+		return i;
+	}
+
+	size_t EncodeNormalsSse2(const Float3* pIn, size_t count, uint8_t* pOut, size_t outStride) noexcept
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+		const __m128 maxQ = _mm_set1_ps(snorm16Max);
+		alignas(16) uint32_t words[4];
+		size_t i = 0;
+		for (; i + 4u <= count; i += 4u)
+		{
+			const Float3* n = pIn + i;
+			const __m128 x = _mm_setr_ps(n[0].x, n[1].x, n[2].x, n[3].x);
+			const __m128 y = _mm_setr_ps(n[0].y, n[1].y, n[2].y, n[3].y);
+			const __m128 z = _mm_setr_ps(n[0].z, n[1].z, n[2].z, n[3].z);
+			const __m128 ax = _mm_andnot_ps(signMask, x);
+			const __m128 ay = _mm_andnot_ps(signMask, y);
+			const __m128 az = _mm_andnot_ps(signMask, z);
+			const __m128 inv = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(ax, ay), az));
+			const __m128 px = _mm_mul_ps(x, inv);
+			const __m128 py = _mm_mul_ps(y, inv);
+			const __m128 apx = _mm_andnot_ps(signMask, px);
+			const __m128 apy = _mm_andnot_ps(signMask, py);
+			// (1 - |other|) with the sign of the component itself
+			const __m128 fx = _mm_mul_ps(_mm_sub_ps(one, apy), _mm_or_ps(one, _mm_and_ps(px, signMask)));
+			const __m128 fy = _mm_mul_ps(_mm_sub_ps(one, apx), _mm_or_ps(one, _mm_and_ps(py, signMask)));
+			const __m128 lower = _mm_cmplt_ps(_mm_mul_ps(z, inv), _mm_setzero_ps());
+			const __m128 ox = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, px));
+			const __m128 oy = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, py));
+			const __m128i qx = _mm_cvtps_epi32(_mm_mul_ps(Clamp(ox, minusOne, one), maxQ));
+			const __m128i qy = _mm_cvtps_epi32(_mm_mul_ps(Clamp(oy, minusOne, one), maxQ));
+			const __m128i low = _mm_and_si128(qx, _mm_set1_epi32(0xFFFF));
+			_mm_store_si128(reinterpret_cast<__m128i*>(words), _mm_or_si128(low, _mm_slli_epi32(qy, 16)));
+			for (size_t k = 0; k < 4u; k++)
+			{
+				Store32(pOut + (i + k) * outStride, words[k]);
+			}
+		}
+		return i;
+	}
+
+	size_t DecodePositionsSse2(const uint8_t* pIn, size_t inStride, size_t count, const Float3& min, const Float3& step, Float3* pOut) noexcept
+	{
+		const __m128 minX = _mm_set1_ps(min.x), minY = _mm_set1_ps(min.y), minZ = _mm_set1_ps(min.z);
+		const __m128 stepX = _mm_set1_ps(step.x), stepY = _mm_set1_ps(step.y), stepZ = _mm_set1_ps(step.z);
+		const __m128i low = _mm_set1_epi32(0xFFFF);
+		alignas(16) float x[4];
+		alignas(16) float y[4];
+		alignas(16) float z[4];
+		size_t i = 0;
+		for (; i + 4u <= count; i += 4u)
+		{
+			const uint8_t* p = pIn + i * inStride;
+			const __m128i xy = _mm_setr_epi32(int(Load32(p)), int(Load32(p + inStride)), int(Load32(p + 2u * inStride)), int(Load32(p + 3u * inStride)));
+			const __m128i zw = _mm_setr_epi32(int(Load32(p + 4)), int(Load32(p + inStride + 4)), int(Load32(p + 2u * inStride + 4)), int(Load32(p + 3u * inStride + 4)));
+			const __m128 qx = _mm_cvtepi32_ps(_mm_and_si128(xy, low));
+			const __m128 qy = _mm_cvtepi32_ps(_mm_srli_epi32(xy, 16));
+			const __m128 qz = _mm_cvtepi32_ps(_mm_and_si128(zw, low));
+			_mm_store_ps(x, _mm_add_ps(_mm_mul_ps(qx, stepX), minX));
+			_mm_store_ps(y, _mm_add_ps(_mm_mul_ps(qy, stepY), minY));
+			_mm_store_ps(z, _mm_add_ps(_mm_mul_ps(qz, stepZ), minZ));
+			for (size_t k = 0; k < 4u; k++)
+			{
+				pOut[i + k] = { x[k],y[k],z[k] };
+			}
+		}
+		return i;
+	}
+
+	CHILI_TARGET_AVX2 size_t EncodePositionsAvx2(const Float3* pIn, size_t count, const Float3& min, const Float3& scale, uint8_t* pOut, size_t outStride) noexcept
+	{
+		// one gather per component pulls x / y / z of eight vertices out of the packed float3 array
+		const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+		const __m256 minX = _mm256_set1_ps(min.x), minY = _mm256_set1_ps(min.y), minZ = _mm256_set1_ps(min.z);
+		const __m256 scaleX = _mm256_set1_ps(scale.x), scaleY = _mm256_set1_ps(scale.y), scaleZ = _mm256_set1_ps(scale.z);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 maxQ = _mm256_set1_ps(unorm16Max);
+		const __m256i w = _mm256_set1_epi32(int(0xFFFF0000u));
+		alignas(32) uint32_t xy[8];
+		alignas(32) uint32_t zw[8];
+		size_t i = 0;
+		for (; i + 8u <= count; i += 8u)
+		{
+			const float* p = &pIn[i].x;
+			const __m256 x = _mm256_i32gather_ps(p, index, 4);
+			const __m256 y = _mm256_i32gather_ps(p + 1, index, 4);
+			const __m256 z = _mm256_i32gather_ps(p + 2, index, 4);
+			const __m256i qx = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(x, minX), scaleX), zero), maxQ));
+			const __m256i qy = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(y, minY), scaleY), zero), maxQ));
+			const __m256i qz = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(z, minZ), scaleZ), zero), maxQ));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(xy), _mm256_or_si256(qx, _mm256_slli_epi32(qy, 16)));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(zw), _mm256_or_si256(qz, w));
+			for (size_t k = 0; k < 8u; k++)
+			{
+				Store32(pOut + (i + k) * outStride, xy[k]);
+				Store32(pOut + (i + k) * outStride + 4, zw[k]);
+			}
+		}
+		return i;
+	}
+
+	CHILI_TARGET_AVX2 size_t EncodeNormalsAvx2(const Float3* pIn, size_t count, uint8_t* pOut, size_t outStride) noexcept
+	{
+		const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 minusOne = _mm256_set1_ps(-1.0f);
+		const __m256 maxQ = _mm256_set1_ps(snorm16Max);
+		alignas(32) uint32_t words[8];
+		size_t i = 0;
+		for (; i + 8u <= count; i += 8u)
+		{
+			const float* n = &pIn[i].x;
+			const __m256 x = _mm256_i32gather_ps(n, index, 4);
+			const __m256 y = _mm256_i32gather_ps(n + 1, index, 4);
+			const __m256 z = _mm256_i32gather_ps(n + 2, index, 4);
+			const __m256 ax = _mm256_andnot_ps(signMask, x);
+			const __m256 ay = _mm256_andnot_ps(signMask, y);
+			const __m256 az = _mm256_andnot_ps(signMask, z);
+			const __m256 inv = _mm256_div_ps(one, _mm256_add_ps(_mm256_add_ps(ax, ay), az));
+			const __m256 px = _mm256_mul_ps(x, inv);
+			const __m256 py = _mm256_mul_ps(y, inv);
+			const __m256 apx = _mm256_andnot_ps(signMask, px);
+			const __m256 apy = _mm256_andnot_ps(signMask, py);
+			const __m256 fx = _mm256_mul_ps(_mm256_sub_ps(one, apy), _mm256_or_ps(one, _mm256_and_ps(px, signMask)));
+			const __m256 fy = _mm256_mul_ps(_mm256_sub_ps(one, apx), _mm256_or_ps(one, _mm256_and_ps(py, signMask)));
+			const __m256 lower = _mm256_cmp_ps(_mm256_mul_ps(z, inv), _mm256_setzero_ps(), _CMP_LT_OQ);
+			const __m256 ox = _mm256_blendv_ps(px, fx, lower);
+			const __m256 oy = _mm256_blendv_ps(py, fy, lower);
+			const __m256i qx = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(ox, minusOne), one), maxQ));
+			const __m256i qy = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(oy, minusOne), one), maxQ));
+			const __m256i low = _mm256_and_si256(qx, _mm256_set1_epi32(0xFFFF));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(words), _mm256_or_si256(low, _mm256_slli_epi32(qy, 16)));
+			for (size_t k = 0; k < 8u; k++)
+			{
+				Store32(pOut + (i + k) * outStride, words[k]);
+			}
+		}
+		return i;
+	}
+
+	CHILI_TARGET_AVX2 size_t EncodeUVsAvx2(const Float2* pIn, size_t count, uint8_t* pOut, size_t outStride) noexcept
+	{
+		// uvs are already pairs of floats, F16C converts four of them per instruction
+		alignas(16) uint32_t words[4];
+		size_t i = 0;
+		for (; i + 4u <= count; i += 4u)
+		{
+			const __m256 uv = _mm256_loadu_ps(&pIn[i].x);
+			_mm_store_si128(reinterpret_cast<__m128i*>(words), _mm256_cvtps_ph(uv, _MM_FROUND_TO_NEAREST_INT));
+			for (size_t k = 0; k < 4u; k++)
+			{
+				Store32(pOut + (i + k) * outStride, words[k]);
+			}
+		}
+		return i;
+	}
+
+	CHILI_TARGET_AVX2 size_t DecodeUVsAvx2(const uint8_t* pIn, size_t inStride, size_t count, Float2* pOut) noexcept
+	{
+		size_t i = 0;
+		for (; i + 4u <= count; i += 4u)
+		{
+			const uint8_t* p = pIn + i * inStride;
+			const __m128i halves = _mm_setr_epi32(int(Load32(p)), int(Load32(p + inStride)), int(Load32(p + 2u * inStride)), int(Load32(p + 3u * inStride)));
+			_mm256_storeu_ps(&pOut[i].x, _mm256_cvtph_ps(halves));
+		}
+		return i;
+	}
+#endif
+}
+
+VertexQuantization::Layout VertexQuantization::GetLayout(const VertexFormat& format) noexcept
+{
+	Layout layout;
+	layout.positionOffset = layout.stride;
+	layout.stride += format.position == PositionEncoding::Unorm16 ? 8u : 12u;
+	if (format.normal != NormalEncoding::None)
+	{
+		layout.normalOffset = layout.stride;
+		layout.stride += format.normal == NormalEncoding::Octahedral16 ? 4u : 12u;
+	}
+	if (format.uv != UVEncoding::None)
+	{
+		layout.uvOffset = layout.stride;
+		layout.stride += format.uv == UVEncoding::Half16 ? 4u : 8u;
+	}
+	if (format.color)
+	{
+		layout.colorOffset = layout.stride;
+		layout.stride += 4u;
+	}
+	return layout;
+}
+
+std::vector<InputElementDesc> VertexQuantization::MakeInputElements(const VertexFormat& format, uint32_t inputSlot)
+{
+	// DXGI_FORMAT values
+	constexpr uint32_t r32g32b32Float = 6u;
+	constexpr uint32_t r16g16b16a16Unorm = 11u;
+	constexpr uint32_t r32g32Float = 16u;
+	constexpr uint32_t r16g16Float = 34u;
+	constexpr uint32_t r16g16Snorm = 37u;
+	constexpr uint32_t b8g8r8a8Unorm = 87u;
+
+	const Layout layout = GetLayout(format);
+	std::vector<InputElementDesc> elements;
+	elements.push_back({ "Position",0u,format.position == PositionEncoding::Unorm16 ? r16g16b16a16Unorm : r32g32b32Float,
+		inputSlot,uint32_t(layout.positionOffset),false,0u });
+	if (format.normal != NormalEncoding::None)
+	{
+		elements.push_back({ "Normal",0u,format.normal == NormalEncoding::Octahedral16 ? r16g16Snorm : r32g32b32Float,
+			inputSlot,uint32_t(layout.normalOffset),false,0u });
+	}
+	if (format.uv != UVEncoding::None)
+	{
+		elements.push_back({ "TexCoord",0u,format.uv == UVEncoding::Half16 ? r16g16Float : r32g32Float,
+			inputSlot,uint32_t(layout.uvOffset),false,0u });
+	}
+	if (format.color)
+	{
+		elements.push_back({ "Color",0u,b8g8r8a8Unorm,inputSlot,uint32_t(layout.colorOffset),false,0u });
+	}
+	return elements;
+}
+
+VertexQuantization::Bounds VertexQuantization::ComputeBounds(const Float3* pPositions, size_t count) noexcept
+{
+	if (count == 0u)
+	{
+		return { { 0.0f,0.0f,0.0f },{ 0.0f,0.0f,0.0f } };
+	}
+	Bounds b = { pPositions[0],pPositions[0] };
+	for (size_t i = 1; i < count; i++)
+	{
+		const Float3& p = pPositions[i];
+		b.min = { std::min(b.min.x, p.x),std::min(b.min.y, p.y),std::min(b.min.z, p.z) };
+		b.max = { std::max(b.max.x, p.x),std::max(b.max.y, p.y),std::max(b.max.z, p.z) };
+	}
+	return b;
+}
+
+Matrix4 VertexQuantization::DecodeMatrix(const Bounds& bounds) noexcept
+{
+	return Matrix4::Scaling(bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z) *
+		Matrix4::Translation(bounds.min.x, bounds.min.y, bounds.min.z);
+}
+
+std::vector<uint8_t> VertexQuantization::Encode(const VertexStreams& streams, const VertexFormat& format, const Bounds& bounds)
+{
+	const Layout layout = GetLayout(format);
+	std::vector<uint8_t> vertices(layout.stride * streams.count);
+	uint8_t* const pBase = vertices.data();
+	const size_t n = streams.count;
+
+	if (format.position == PositionEncoding::Unorm16)
+	{
+		EncodePositionsUnorm16(streams.pPositions, n, bounds, pBase + layout.positionOffset, layout.stride);
+	}
+	else
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			std::memcpy(pBase + i * layout.stride + layout.positionOffset, &streams.pPositions[i], sizeof(Float3));
+		}
+	}
+	if (format.normal == NormalEncoding::Octahedral16)
+	{
+		EncodeNormalsOctahedral16(streams.pNormals, n, pBase + layout.normalOffset, layout.stride);
+	}
+	else if (format.normal == NormalEncoding::Float32)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			std::memcpy(pBase + i * layout.stride + layout.normalOffset, &streams.pNormals[i], sizeof(Float3));
+		}
+	}
+	if (format.uv == UVEncoding::Half16)
+	{
+		EncodeUVsHalf(streams.pUVs, n, pBase + layout.uvOffset, layout.stride);
+	}
+	else if (format.uv == UVEncoding::Float32)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			std::memcpy(pBase + i * layout.stride + layout.uvOffset, &streams.pUVs[i], sizeof(Float2));
+		}
+	}
+	if (format.color)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			std::memcpy(pBase + i * layout.stride + layout.colorOffset, streams.pColors[i], 4u);
+		}
+	}
+	return vertices;
+}
+
+VertexQuantization::Kernel VertexQuantization::GetKernel() noexcept
+{
+	return activeKernel;
+}
+
+void VertexQuantization::SetKernel(Kernel kernel) noexcept
+{
+	activeKernel = std::min(kernel, supportedKernel);
+}
+
+void VertexQuantization::EncodePositionsUnorm16(const Float3* pIn, size_t count, const Bounds& bounds, void* pOut, size_t outStride) noexcept
+{
+	uint8_t* const pBytes = static_cast<uint8_t*>(pOut);
+	const Float3 scale = {
+		PositionScale(bounds.min.x, bounds.max.x),
+		PositionScale(bounds.min.y, bounds.max.y),
+		PositionScale(bounds.min.z, bounds.max.z)
+	};
+	size_t done = 0u;
+#ifdef CHILI_X86
+	if (activeKernel == Kernel::Avx2)
+	{
+		done = EncodePositionsAvx2(pIn, count, bounds.min, scale, pBytes, outStride);
+	}
+	else if (activeKernel == Kernel::Sse2)
+	{
+		done = EncodePositionsSse2(pIn, count, bounds.min, scale, pBytes, outStride);
+	}
+#endif
+	for (size_t i = done; i < count; i++)
+	{
+		EncodePositionScalar(pIn[i], bounds.min, scale, pBytes + i * outStride);
+	}
+}
+
+void VertexQuantization::EncodeNormalsOctahedral16(const Float3* pIn, size_t count, void* pOut, size_t outStride) noexcept
+{
+	uint8_t* const pBytes = static_cast<uint8_t*>(pOut);
+	size_t done = 0u;
+#ifdef CHILI_X86
+	if (activeKernel == Kernel::Avx2)
+	{
+		done = EncodeNormalsAvx2(pIn, count, pBytes, outStride);
+	}
+	else if (activeKernel == Kernel::Sse2)
+	{
+		done = EncodeNormalsSse2(pIn, count, pBytes, outStride);
+	}
+#endif
+	for (size_t i = done; i < count; i++)
+	{
+		EncodeNormalScalar(pIn[i], pBytes + i * outStride);
+	}
+}
+
+void VertexQuantization::EncodeUVsHalf(const Float2* pIn, size_t count, void* pOut, size_t outStride) noexcept
+{
+	uint8_t* const pBytes = static_cast<uint8_t*>(pOut);
+	size_t done = 0u;
+#ifdef CHILI_X86
+	// sse2 has no half conversion, that path stays scalar
+	if (activeKernel == Kernel::Avx2)
+	{
+		done = EncodeUVsAvx2(pIn, count, pBytes, outStride);
+	}
+#endif
+	for (size_t i = done; i < count; i++)
+	{
+		Store32(pBytes + i * outStride, uint32_t(FloatToHalf(pIn[i].x)) | (uint32_t(FloatToHalf(pIn[i].y)) << 16));
+	}
+}
+
+void VertexQuantization::DecodePositionsUnorm16(const void* pIn, size_t inStride, size_t count, const Bounds& bounds, Float3* pOut) noexcept
+{
+	const uint8_t* const pBytes = static_cast<const uint8_t*>(pIn);
+	const Float3 step = {
+		(bounds.max.x - bounds.min.x) / unorm16Max,
+		(bounds.max.y - bounds.min.y) / unorm16Max,
+		(bounds.max.z - bounds.min.z) / unorm16Max
+	};
+	size_t done = 0u;
+#ifdef CHILI_X86
+	if (activeKernel != Kernel::Scalar)
+	{
+		done = DecodePositionsSse2(pBytes, inStride, count, bounds.min, step, pOut);
+	}
+#endif
+	for (size_t i = done; i < count; i++)
+	{
+		const uint32_t xy = Load32(pBytes + i * inStride);
+		const uint32_t zw = Load32(pBytes + i * inStride + 4);
+		pOut[i] = {
+			float(xy & 0xFFFFu) * step.x + bounds.min.x,
+			float(xy >> 16) * step.y + bounds.min.y,
+			float(zw & 0xFFFFu) * step.z + bounds.min.z
+		};
+	}
+}
+
+void VertexQuantization::DecodeNormalsOctahedral16(const void* pIn, size_t inStride, size_t count, Float3* pOut) noexcept
+{
+	const uint8_t* const pBytes = static_cast<const uint8_t*>(pIn);
+	for (size_t i = 0; i < count; i++)
+	{
+		pOut[i] = DecodeNormalScalar(pBytes + i * inStride);
+	}
+}
+
+void VertexQuantization::DecodeUVsHalf(const void* pIn, size_t inStride, size_t count, Float2* pOut) noexcept
+{
+	const uint8_t* const pBytes = static_cast<const uint8_t*>(pIn);
+	size_t done = 0u;
+#ifdef CHILI_X86
+	if (activeKernel == Kernel::Avx2)
+	{
+		done = DecodeUVsAvx2(pBytes, inStride, count, pOut);
+	}
+#endif
+	for (size_t i = done; i < count; i++)
+	{
+		const uint32_t bits = Load32(pBytes + i * inStride);
+		pOut[i] = { HalfToFloat(uint16_t(bits)),HalfToFloat(uint16_t(bits >> 16)) };
+	}
+}
+
+uint16_t VertexQuantization::FloatToHalf(float value) noexcept
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000u;
+	const uint32_t abs = bits & 0x7FFFFFFFu;
+	if (abs > 0x7F800000u)
+	{
+		// nan, keep it quiet
+		return uint16_t(sign | 0x7E00u);
+	}
+	if (abs >= 0x47800000u)
+	{
+		// 65536 and up (or inf) overflow to inf
+		return uint16_t(sign | 0x7C00u);
+	}
+	if (abs >= 0x38800000u)
+	{
+		// normal half: rebias the exponent (127 - 15) and round the 13 dropped mantissa bits;
+		// a carry out of the mantissa correctly bumps the exponent, up to inf
+		uint32_t h = (abs - 0x38000000u) >> 13;
+		const uint32_t rest = abs & 0x1FFFu;
+		if (rest > 0x1000u || (rest == 0x1000u && (h & 1u)))
+		{
+			h++;
+		}
+		return uint16_t(sign | h);
+	}
+	if (abs < 0x33000000u)
+	{
+		// below half of the smallest subnormal
+		return uint16_t(sign);
+	}
+	// subnormal half, counted in units of 2^-24
+	const uint32_t exponent = abs >> 23;
+	const uint32_t mantissa = (abs & 0x7FFFFFu) | 0x800000u;
+	const uint32_t shift = 126u - exponent;
+	uint32_t h = mantissa >> shift;
+	const uint32_t rest = mantissa & ((1u << shift) - 1u);
+	const uint32_t halfway = 1u << (shift - 1u);
+	if (rest > halfway || (rest == halfway && (h & 1u)))
+	{
+		h++;
+	}
+	return uint16_t(sign | h);
+}
+
+float VertexQuantization::HalfToFloat(uint16_t value) noexcept
+{
+	const uint32_t sign = uint32_t(value & 0x8000u) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x3FFu;
+	uint32_t bits;
+	if (exponent == 0x1Fu)
+	{
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	}
+	else if (exponent != 0u)
+	{
+		bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+	}
+	else if (mantissa != 0u)
+	{
+		// subnormal: normalize the mantissa
+		uint32_t e = 113u;
+		while ((mantissa & 0x400u) == 0u)
+		{
+			mantissa <<= 1;
+			e--;
+		}
+		bits = sign | (e << 23) | ((mantissa & 0x3FFu) << 13);
+	}
+	else
+	{
+		bits = sign;
+	}
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include "ChiliMath.hpp"
+#include "PipelineCache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// compact vertex encodings and the kernels that produce them:
+// positions as R16G16B16A16_UNORM inside the mesh bounding box (decode folds into the world matrix),
+// normals octahedral mapped to R16G16_SNORM, uvs as R16G16_FLOAT
+namespace VertexQuantization
+{
+	enum class PositionEncoding
+	{
+		Float32,
+		Unorm16
+	};
+	enum class NormalEncoding
+	{
+		None,
+		Float32,
+		Octahedral16
+	};
+	enum class UVEncoding
+	{
+		None,
+		Float32,
+		Half16
+	};
+	struct VertexFormat
+	{
+		PositionEncoding position = PositionEncoding::Float32;
+		NormalEncoding normal = NormalEncoding::None;
+		UVEncoding uv = UVEncoding::None;
+		// B8G8R8A8_UNORM, stored as is
+		bool color = false;
+	};
+	// byte offsets of each attribute inside one interleaved vertex, absent attributes stay at 0
+	struct Layout
+	{
+		size_t stride = 0u;
+		size_t positionOffset = 0u;
+		size_t normalOffset = 0u;
+		size_t uvOffset = 0u;
+		size_t colorOffset = 0u;
+	};
+	struct Bounds
+	{
+		Float3 min;
+		Float3 max;
+	};
+	// source attributes as separate arrays, optional streams may be null
+	struct VertexStreams
+	{
+		const Float3* pPositions = nullptr;
+		const Float3* pNormals = nullptr;
+		const Float2* pUVs = nullptr;
+		const uint8_t(*pColors)[4] = nullptr;
+		size_t count = 0u;
+	};
+	enum class Kernel
+	{
+		Scalar,
+		Sse2,
+		Avx2
+	};
+
+	Layout GetLayout(const VertexFormat& format) noexcept;
+	// semantics Position / Normal / TexCoord / Color in that order, all in one input slot
+	std::vector<InputElementDesc> MakeInputElements(const VertexFormat& format, uint32_t inputSlot = 0u);
+	Bounds ComputeBounds(const Float3* pPositions, size_t count) noexcept;
+	// maps the unorm [0,1] cube back onto the bounds, apply it in front of the world matrix
+	Matrix4 DecodeMatrix(const Bounds& bounds) noexcept;
+	// interleaves and encodes all streams the format asks for
+	std::vector<uint8_t> Encode(const VertexStreams& streams, const VertexFormat& format, const Bounds& bounds);
+
+	// kernels run with the best instruction set the cpu supports unless a lower one is forced
+	Kernel GetKernel() noexcept;
+	// requests above what the cpu supports fall back to the best supported kernel
+	void SetKernel(Kernel kernel) noexcept;
+
+	// batch kernels; outputs / inputs are strided so they can write straight into an interleaved buffer
+	void EncodePositionsUnorm16(const Float3* pIn, size_t count, const Bounds& bounds, void* pOut, size_t outStride) noexcept;
+	void EncodeNormalsOctahedral16(const Float3* pIn, size_t count, void* pOut, size_t outStride) noexcept;
+	void EncodeUVsHalf(const Float2* pIn, size_t count, void* pOut, size_t outStride) noexcept;
+	void DecodePositionsUnorm16(const void* pIn, size_t inStride, size_t count, const Bounds& bounds, Float3* pOut) noexcept;
+	void DecodeNormalsOctahedral16(const void* pIn, size_t inStride, size_t count, Float3* pOut) noexcept;
+	void DecodeUVsHalf(const void* pIn, size_t inStride, size_t count, Float2* pOut) noexcept;
+
+	// IEEE half conversion, round to nearest even with subnormals (same results as F16C)
+	uint16_t FloatToHalf(float value) noexcept;
+	float HalfToFloat(uint16_t value) noexcept;
+}
\ No newline at end of file
@@ -4,15 +4,29 @@ struct VSOut
     float4 Pos : SV_Position;
 };
 
-cbuffer MVP
+// split by update frequency: b0 is written once per frame, b1 once per object, b2 when the material changes
+cbuffer Frame : register(b0)
 {
-    matrix mvp;
+    matrix viewProj;
 };
 
-VSOut main(float3 pos : Position, float4 color : Color)
+cbuffer Object : register(b1)
+{
+    matrix world;
+};
+
+cbuffer Material : register(b2)
+{
+    float4 tint;
+};
+
+// instance matrix arrives per instance as four rows (input slot 1)
+VSOut main(float3 pos : Position, float4 color : Color,
+    float4 world0 : World0, float4 world1 : World1, float4 world2 : World2, float4 world3 : World3)
 {
     VSOut outp;
-    outp.Pos = mul(float4(pos, 1.0f), mvp);
-    outp.Color = color;
+    const float4x4 instance = float4x4(world0, world1, world2, world3);
+    outp.Pos = mul(mul(mul(float4(pos, 1.0f), instance), world), viewProj);
+    outp.Color = color * tint;
     return outp;
 }
\ No newline at end of file
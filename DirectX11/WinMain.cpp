@@ -18,7 +18,29 @@
 *	along with The Chili Direct3D Engine.  If not, see <http://www.gnu.org/licenses/>.    *
 ******************************************************************************************/
 #include "App.hpp"
+#include "Benchmarks.hpp"
+#include "HeadlessBenchmark.hpp"
+#include "ShaderArchive.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
+namespace
+{
+	// compares whole arguments of the split command line, a substring of lpCmdLine would also match
+	// paths and values that merely contain the switch
+	bool HasArgument(const char* arg) noexcept
+	{
+		for (int i = 1; i < __argc; i++)
+		{
+			if (std::strcmp(__argv[i], arg) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
 
 int CALLBACK WinMain(
 	HINSTANCE hInstance,
@@ -28,7 +50,39 @@ int CALLBACK WinMain(
 {
 	try
 	{
-		return App{}.Go();
+		// micro benchmarks run without creating a window and report to a text file
+		if (HasArgument("--bench"))
+		{
+			std::ofstream report("benchmarks.txt");
+			Benchmarks::RunAll(report);
+			return 0;
+		}
+		// App's frame loop on the CPU backend with scripted input, see HeadlessBenchmark::ParseArguments
+		if (HasArgument("--headless"))
+		{
+			std::ofstream report("headless.txt");
+			return HeadlessBenchmark::Run(HeadlessBenchmark::ParseArguments(__argc - 1, __argv + 1), report);
+		}
+		// build step: --pack-shaders <archive> <shader.cso>...
+		if (__argc >= 3 && std::strcmp(__argv[1], "--pack-shaders") == 0)
+		{
+			ShaderArchive::PackFiles(__argv[2], std::vector<std::string>(__argv + 3, __argv + __argc));
+			return 0;
+		}
+		// live counters for soak tests: --metrics [port]
+		unsigned short metricsPort = 0u;
+		for (int i = 1; i < __argc; i++)
+		{
+			if (std::strcmp(__argv[i], "--metrics") == 0)
+			{
+				metricsPort = i + 1 < __argc ? (unsigned short)std::atoi(__argv[i + 1]) : 0u;
+				metricsPort = metricsPort != 0u ? metricsPort : MetricsServer::defaultPort;
+			}
+		}
+		// scaling tests: --stress N [--distribution grid|sphere|clusters] [--materials N] [--occluders N] [--static]
+		StressScene::Settings stress;
+		const bool stressScene = StressScene::ParseArguments(__argc - 1, __argv + 1, stress);
+		return App{ metricsPort,stressScene ? &stress : nullptr }.Go();
 	}
 	catch (const ChiliException& e)
 	{
@@ -18,6 +18,7 @@
 *	along with The Chili Direct3D Engine.  If not, see <http://www.gnu.org/licenses/>.    *
 ******************************************************************************************/
 #include "Window.hpp"
+#include "Profiler.hpp"
 #include <sstream>
 #include "resource.h"
 
@@ -70,8 +71,7 @@ HINSTANCE Window::WindowClass::GetInstance() noexcept
 // Window Stuff
 Window::Window(int width, int height, const char* name)
 	:
-	width(width),
-	height(height)
+	PlatformWindow(width, height)
 {
 	// calculate window size based on desired client region size
 	RECT wr;
@@ -97,8 +97,6 @@ Window::Window(int width, int height, const char* name)
 	}
 	// newly created windows start off as hidden
 	ShowWindow(hWnd, SW_SHOWDEFAULT);
-	// create graphics object
-	pGfx = std::make_unique<Graphics>(hWnd);
 }
 
 Window::~Window()
@@ -116,6 +114,7 @@ void Window::SetTitle(const std::string& title)
 
 std::optional<int> Window::ProcessMessages() noexcept
 {
+	PROFILE_ZONE("ProcessMessages");
 	MSG msg;
 	// while queue has messages, remove and dispatch them (but do not block on empty queue)
 	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
@@ -136,13 +135,14 @@ std::optional<int> Window::ProcessMessages() noexcept
 	return {};
 }
 
-Graphics& Window::Gfx()
+void* Window::GetNativeHandle() const noexcept
 {
-	if (!pGfx)
-	{
-		throw CHWND_NOGFX_EXCEPT();
-	}
-	return *pGfx;
+	return hWnd;
+}
+
+std::unique_ptr<PlatformWindow> PlatformWindow::Create(int width, int height, const char* name)
+{
+	return std::make_unique<Window>(width, height, name);
 }
 
 LRESULT CALLBACK Window::HandleMsgSetup(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
@@ -183,24 +183,22 @@ LRESULT Window::HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noe
 		return 0;
 		// clear keystate when window loses focus to prevent input getting "stuck"
 	case WM_KILLFOCUS:
-		kbd.ClearState();
+		OnFocusLost();
 		break;
 
 		/*********** KEYBOARD MESSAGES ***********/
 	case WM_KEYDOWN:
 		// syskey commands need to be handled to track ALT key (VK_MENU) and F10
 	case WM_SYSKEYDOWN:
-		if (!(lParam & 0x40000000) || kbd.AutorepeatIsEnabled()) // filter autorepeat
-		{
-			kbd.OnKeyPressed(static_cast<unsigned char>(wParam));
-		}
+		// bit 30 is set on autorepeat
+		OnKeyDown(static_cast<unsigned char>(wParam), (lParam & 0x40000000) != 0);
 		break;
 	case WM_KEYUP:
 	case WM_SYSKEYUP:
-		kbd.OnKeyReleased(static_cast<unsigned char>(wParam));
+		OnKeyUp(static_cast<unsigned char>(wParam));
 		break;
 	case WM_CHAR:
-		kbd.OnChar(static_cast<unsigned char>(wParam));
+		OnChar(static_cast<unsigned char>(wParam));
 		break;
 		/*********** END KEYBOARD MESSAGES ***********/
 
@@ -208,73 +206,54 @@ LRESULT Window::HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noe
 	case WM_MOUSEMOVE:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		// in client region -> log move, and log enter + capture mouse (if not previously in window)
-		if (pt.x >= 0 && pt.x < width && pt.y >= 0 && pt.y < height)
+		// capture the mouse on entering the client region, so drags keep reporting outside of it
+		if (IsInClientArea(pt.x, pt.y) && !mouse.IsInWindow())
 		{
-			mouse.OnMouseMove(pt.x, pt.y);
-			if (!mouse.IsInWindow())
-			{
-				SetCapture(hWnd);
-				mouse.OnMouseEnter();
-			}
+			SetCapture(hWnd);
 		}
-		// not in client -> log move / maintain capture if button down
-		else
+		// left with no button down -> release capture
+		if (OnMouseMove(pt.x, pt.y))
 		{
-			if (wParam & (MK_LBUTTON | MK_RBUTTON))
-			{
-				mouse.OnMouseMove(pt.x, pt.y);
-			}
-			// button up -> release capture / log event for leaving
-			else
-			{
-				ReleaseCapture();
-				mouse.OnMouseLeave();
-			}
+			ReleaseCapture();
 		}
 		break;
 	}
 	case WM_LBUTTONDOWN:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		mouse.OnLeftPressed(pt.x, pt.y);
+		OnLeftDown(pt.x, pt.y);
 		break;
 	}
 	case WM_RBUTTONDOWN:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		mouse.OnRightPressed(pt.x, pt.y);
+		OnRightDown(pt.x, pt.y);
 		break;
 	}
 	case WM_LBUTTONUP:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		mouse.OnLeftReleased(pt.x, pt.y);
 		// release mouse if outside of window
-		if (pt.x < 0 || pt.x >= width || pt.y < 0 || pt.y >= height)
+		if (OnLeftUp(pt.x, pt.y))
 		{
 			ReleaseCapture();
-			mouse.OnMouseLeave();
 		}
 		break;
 	}
 	case WM_RBUTTONUP:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		mouse.OnRightReleased(pt.x, pt.y);
 		// release mouse if outside of window
-		if (pt.x < 0 || pt.x >= width || pt.y < 0 || pt.y >= height)
+		if (OnRightUp(pt.x, pt.y))
 		{
 			ReleaseCapture();
-			mouse.OnMouseLeave();
 		}
 		break;
 	}
 	case WM_MOUSEWHEEL:
 	{
 		const POINTS pt = MAKEPOINTS(lParam);
-		const int delta = GET_WHEEL_DELTA_WPARAM(wParam);
-		mouse.OnWheelDelta(pt.x, pt.y, delta);
+		OnWheel(pt.x, pt.y, GET_WHEEL_DELTA_WPARAM(wParam));
 		break;
 	}
 	/************** END MOUSE MESSAGES **************/
@@ -340,9 +319,3 @@ std::string Window::HrException::GetErrorDescription() const noexcept
 {
 	return Exception::TranslateErrorCode(hr);
 }
-
-
-const char* Window::NoGfxException::GetType() const noexcept
-{
-	return "Chili Window Exception [No Graphics]";
-}
\ No newline at end of file
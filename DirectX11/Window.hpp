@@ -20,14 +20,12 @@
 #pragma once
 #include "ChiliWin.hpp"
 #include "ChiliException.hpp"
-#include "Keyboard.hpp"
-#include "Mouse.hpp"
-#include "Graphics.hpp"
+#include "PlatformWindow.hpp"
 #include <optional>
-#include <memory>
 
 
-class Window
+// the Win32 PlatformWindow: registers the window class and translates window messages into input
+class Window : public PlatformWindow
 {
 public:
 	class Exception : public ChiliException
@@ -47,12 +45,6 @@ public:
 	private:
 		HRESULT hr;
 	};
-	class NoGfxException : public Exception
-	{
-	public:
-		using Exception::Exception;
-		const char* GetType() const noexcept override;
-	};
 private:
 	// singleton manages registration/cleanup of window class
 	class WindowClass
@@ -71,28 +63,22 @@ private:
 	};
 public:
 	Window(int width, int height, const char* name);
-	~Window();
+	~Window() override;
 	Window(const Window&) = delete;
 	Window& operator=(const Window&) = delete;
-	void SetTitle(const std::string& title);
-	static std::optional<int> ProcessMessages() noexcept;
-	Graphics& Gfx();
+	void SetTitle(const std::string& title) override;
+	// pumps the thread's message queue, so it serves every window of the thread
+	std::optional<int> ProcessMessages() noexcept override;
+	void* GetNativeHandle() const noexcept override;
 private:
 	static LRESULT CALLBACK HandleMsgSetup(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
 	static LRESULT CALLBACK HandleMsgThunk(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
 	LRESULT HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
-public:
-	Keyboard kbd;
-	Mouse mouse;
 private:
-	int width;
-	int height;
 	HWND hWnd;
-	std::unique_ptr<Graphics> pGfx;
 };
 
 
 // error exception helper macro
 #define CHWND_EXCEPT( hr ) Window::HrException( __LINE__,__FILE__,(hr) )
-#define CHWND_LAST_EXCEPT() Window::HrException( __LINE__,__FILE__,GetLastError() )
-#define CHWND_NOGFX_EXCEPT() Window::NoGfxException( __LINE__,__FILE__ )
\ No newline at end of file
+#define CHWND_LAST_EXCEPT() Window::HrException( __LINE__,__FILE__,GetLastError() )
\ No newline at end of file
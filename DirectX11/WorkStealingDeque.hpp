@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models"):
+// the owning thread pushes and pops at the bottom, any other thread steals from the top.
+// fixed power of two capacity, Push reports a full deque instead of growing
+template<typename T>
+class WorkStealingDeque
+{
+	static_assert(std::is_trivially_copyable<T>::value, "deque items are copied through atomics");
+public:
+	explicit WorkStealingDeque(size_t capacity = 4096u)
+	{
+		size_t size = 1u;
+		while (size < capacity)
+		{
+			size *= 2u;
+		}
+		mask = int64_t(size) - 1;
+		pItems = std::make_unique<std::atomic<T>[]>(size);
+	}
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+	// owner only
+	bool Push(T item) noexcept
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		if (b - t > mask)
+		{
+			return false;
+		}
+		pItems[b & mask].store(item, std::memory_order_relaxed);
+		// publishes the item (and whatever it points to) to thieves that acquire bottom
+		bottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+	// owner only, newest item first
+	bool Pop(T& item) noexcept
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+		if (t > b)
+		{
+			// empty
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		item = pItems[b & mask].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// last item, race the thieves for it
+			const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+	// any thread, oldest item first; false when empty or when another thread won the item
+	bool Steal(T& item) noexcept
+	{
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b)
+		{
+			return false;
+		}
+		item = pItems[t & mask].load(std::memory_order_relaxed);
+		return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+	// approximate when called concurrently
+	bool Empty() const noexcept
+	{
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+private:
+	// top and bottom on separate cache lines, thieves hammer top while the owner works the bottom
+	alignas(64) std::atomic<int64_t> top{ 0 };
+	alignas(64) std::atomic<int64_t> bottom{ 0 };
+	alignas(64) int64_t mask = 0;
+	std::unique_ptr<std::atomic<T>[]> pItems;
+};
\ No newline at end of file
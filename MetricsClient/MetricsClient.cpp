@@ -0,0 +1,112 @@
+// reference client for the engine's live metrics stream (DirectX11 --metrics [port])
+// build: cl /EHsc /std:c++17 MetricsClient.cpp   or   g++ -std=c++17 -o MetricsClient MetricsClient.cpp
+// usage: MetricsClient [port] [--csv]
+// prints the key=value lines as they arrive; --csv turns them into a header row plus one row per line
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// "a=1 b=2" -> header "a,b" and row "1,2"
+	void ToCsv(const std::string& line, std::string& header, std::string& row)
+	{
+		std::istringstream fields(line);
+		std::string field;
+		header.clear();
+		row.clear();
+		while (fields >> field)
+		{
+			const size_t equals = field.find('=');
+			if (equals == std::string::npos)
+			{
+				continue;
+			}
+			header += (header.empty() ? "" : ",") + field.substr(0, equals);
+			row += (row.empty() ? "" : ",") + field.substr(equals + 1u);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned short port = 7780u;
+	bool csv = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--csv") == 0)
+		{
+			csv = true;
+		}
+		else
+		{
+			port = (unsigned short)std::atoi(argv[i]);
+		}
+	}
+#ifdef _WIN32
+	WSADATA wsa;
+	WSAStartup(MAKEWORD(2, 2), &wsa);
+	const SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#else
+	const int s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#endif
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	if (connect(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		std::cerr << "cannot connect to 127.0.0.1:" << port << std::endl;
+		return 1;
+	}
+
+	std::string pending;
+	std::string header;
+	std::string lastHeader;
+	std::string row;
+	char buffer[4096];
+	int received;
+	while ((received = int(recv(s, buffer, sizeof(buffer), 0))) > 0)
+	{
+		pending.append(buffer, size_t(received));
+		size_t end;
+		while ((end = pending.find('\n')) != std::string::npos)
+		{
+			const std::string line = pending.substr(0, end);
+			pending.erase(0, end + 1u);
+			// comment lines carry the protocol version
+			if (!csv || line.empty() || line[0] == '#')
+			{
+				(csv ? std::cerr : std::cout) << line << std::endl;
+				continue;
+			}
+			ToCsv(line, header, row);
+			if (header != lastHeader)
+			{
+				std::cout << header << '\n';
+				lastHeader = header;
+			}
+			std::cout << row << std::endl;
+		}
+	}
+	std::cerr << "connection closed" << std::endl;
+#ifdef _WIN32
+	closesocket(s);
+	WSACleanup();
+#else
+	close(s);
+#endif
+	return 0;
+}
\ No newline at end of file
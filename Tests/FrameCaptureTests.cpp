@@ -0,0 +1,134 @@
+#include "Test.hpp"
+#include "FrameCapture.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	const char* const capturePath = "FrameCaptureTests.cfcp";
+
+	template<typename F>
+	bool Throws(F&& f)
+	{
+		try
+		{
+			f();
+		}
+		catch (const FrameCapture::Exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	// a capture of one buffer registered with registeredSize bytes (the device buffer has 2 KiB) and
+	// one frame that records calls
+	template<typename F>
+	FrameCapture MakeCapture(size_t registeredSize, F&& calls)
+	{
+		NullRenderContext context;
+		RecordingRenderContext recording(context);
+		const BufferHandle buffer = context.CreateBuffer(2048u);
+		const VertexShaderHandle shader = context.CreateHandle<VertexShaderHandle>();
+		FrameCapture capture;
+		capture.AddResource(buffer, registeredSize);
+		capture.AddResource(shader);
+		calls(recording, buffer, shader);
+		capture.AddFrame(recording);
+		return capture;
+	}
+}
+
+TEST_CASE(CaptureReplaysUploadsAndRemapsHandles)
+{
+	const uint8_t bytes[16] = { 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 };
+	const FrameCapture capture = MakeCapture(64u, [&bytes](IRenderContext& c, BufferHandle buffer, VertexShaderHandle shader)
+	{
+		c.VSSetShader(shader);
+		c.VSSetConstantBuffer(0u, BufferHandle::Null);
+		c.UpdateBuffer(buffer, MapMode::WriteDiscard, 48u, bytes, sizeof(bytes));
+		c.DrawIndexed(36u, 0u, 0);
+	});
+	CHECK(capture.Save(capturePath));
+	const FrameCapture loaded = FrameCapture::Load(capturePath);
+	std::remove(capturePath);
+
+	NullRenderContext target;
+	BufferHandle replayed = BufferHandle::Null;
+	const FrameCapture::ResourceFactory factory = FrameCapture::NullFactory(target);
+	const FrameCapture::ReplayStats stats = loaded.Replay(target, [&](const FrameCapture::Resource& r)
+	{
+		const uint64_t handle = factory(r);
+		if (r.kind == FrameCapture::ResourceKind::Buffer)
+		{
+			replayed = BufferHandle(handle);
+		}
+		return handle;
+	});
+	CHECK(stats.frameNs.size() == 1u);
+	CHECK(stats.calls[size_t(RecordingRenderContext::Op::UpdateBuffer)] == 1u);
+	CHECK(replayed != BufferHandle::Null);
+	if (replayed != BufferHandle::Null)
+	{
+		CHECK(std::memcmp(static_cast<const uint8_t*>(target.GetBufferData(replayed)) + 48u, bytes, sizeof(bytes)) == 0);
+	}
+}
+
+TEST_CASE(CaptureRejectsUnknownHandles)
+{
+	const FrameCapture capture = MakeCapture(64u, [](IRenderContext& c, BufferHandle, VertexShaderHandle)
+	{
+		c.PSSetShader(PixelShaderHandle(0x5151u));
+	});
+	NullRenderContext target;
+	CHECK(Throws([&]() { capture.Replay(target, FrameCapture::NullFactory(target)); }));
+	CHECK(capture.Save(capturePath));
+	CHECK(Throws([]() { FrameCapture::Load(capturePath); }));
+	std::remove(capturePath);
+}
+
+TEST_CASE(CaptureRejectsUploadsPastBufferEnd)
+{
+	const uint8_t bytes[16] = {};
+	for (const size_t offset : { size_t(56u),size_t(64u),size_t(1000u) })
+	{
+		const FrameCapture capture = MakeCapture(64u, [&](IRenderContext& c, BufferHandle buffer, VertexShaderHandle)
+		{
+			// the device buffer takes it, the captured one is smaller
+			c.UpdateBuffer(buffer, MapMode::WriteNoOverwrite, offset, bytes, sizeof(bytes));
+		});
+		NullRenderContext target;
+		CHECK(Throws([&]() { capture.Replay(target, FrameCapture::NullFactory(target)); }));
+	}
+	// exactly up to the end is fine
+	const FrameCapture fits = MakeCapture(64u, [&](IRenderContext& c, BufferHandle buffer, VertexShaderHandle)
+	{
+		c.UpdateBuffer(buffer, MapMode::WriteNoOverwrite, 48u, bytes, 16u);
+	});
+	NullRenderContext target;
+	CHECK(!Throws([&]() { fits.Replay(target, FrameCapture::NullFactory(target)); }));
+}
+
+TEST_CASE(CaptureLoadRejectsTruncatedFiles)
+{
+	const uint8_t bytes[16] = {};
+	const FrameCapture capture = MakeCapture(64u, [&](IRenderContext& c, BufferHandle buffer, VertexShaderHandle)
+	{
+		c.UpdateBuffer(buffer, MapMode::WriteDiscard, 0u, bytes, 16u);
+	});
+	CHECK(capture.Save(capturePath));
+	std::string file;
+	{
+		std::ifstream in(capturePath, std::ios::binary);
+		file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	{
+		std::ofstream out(capturePath, std::ios::binary);
+		out.write(file.data(), std::streamsize(file.size() - 5u));
+	}
+	CHECK(Throws([]() { FrameCapture::Load(capturePath); }));
+	std::remove(capturePath);
+	CHECK(Throws([]() { FrameCapture::Load(capturePath); }));
+}
\ No newline at end of file
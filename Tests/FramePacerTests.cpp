@@ -0,0 +1,181 @@
+#include "Test.hpp"
+#include "FramePacer.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	constexpr int64_t ms = 1000000;
+
+	// every sleep overshoots by exactly overshoot and is recorded, reads cost 10ns
+	class OvershootClock : public IClock
+	{
+	public:
+		int64_t Now() noexcept override
+		{
+			return now += 10;
+		}
+		void Sleep(int64_t ns) noexcept override
+		{
+			lastRequest = ns;
+			now += ns + overshoot;
+		}
+	public:
+		int64_t now = 1000 * ms;
+		int64_t overshoot = 0;
+		int64_t lastRequest = 0;
+	};
+
+	bool Near(float a, float b)
+	{
+		return std::abs(a - b) < 0.01f;
+	}
+}
+
+TEST_CASE(FramePacerDeadlinesStayOnePeriodApart)
+{
+	SimulatedClock clock;
+	FramePacer pacer(clock, FramePacer::Mode::TargetFps, 100.0f);
+	int64_t last = 0;
+	for (int frame = 0; frame < 100; frame++)
+	{
+		// uneven work below the period must not move the cadence
+		clock.Advance((frame % 5) * 1500000);
+		pacer.WaitForDeadline();
+		const int64_t now = clock.Now();
+		if (frame > 0)
+		{
+			CHECK(std::abs(now - last - 10 * ms) < 1000);
+		}
+		last = now;
+	}
+}
+
+TEST_CASE(FramePacerRestartsCadenceAfterLateFrame)
+{
+	SimulatedClock clock;
+	FramePacer pacer(clock, FramePacer::Mode::TargetFps, 100.0f);
+	for (int frame = 0; frame < 10; frame++)
+	{
+		pacer.WaitForDeadline();
+	}
+	// more than a period late: no wait, and no rush of short frames to catch the old cadence up
+	clock.Advance(25 * ms);
+	const int64_t before = clock.Now();
+	pacer.WaitForDeadline();
+	const int64_t late = clock.Now();
+	CHECK(late - before < 1000);
+	pacer.WaitForDeadline();
+	CHECK(std::abs(clock.Now() - late - 10 * ms) < 1000);
+}
+
+TEST_CASE(FramePacerSleepMarginFollowsOvershoot)
+{
+	OvershootClock clock;
+	clock.overshoot = 3 * ms;
+	FramePacer pacer(clock, FramePacer::Mode::TargetFps, 100.0f);
+	pacer.WaitForDeadline();
+	int64_t deadline = clock.Now();
+
+	// the first sleep overshoots the 2ms starting margin and misses, after that the margin covers it
+	deadline += 10 * ms;
+	pacer.WaitForDeadline();
+	CHECK(clock.Now() - deadline > ms / 2);
+	deadline += 10 * ms;
+	for (int frame = 0; frame < 10; frame++)
+	{
+		pacer.WaitForDeadline();
+		CHECK(std::abs(clock.Now() - deadline) < 1000);
+		deadline += 10 * ms;
+	}
+	const int64_t wideRequest = clock.lastRequest;
+
+	// once sleeps get precise the margin decays and the pacer sleeps closer to the deadline
+	clock.overshoot = 100000;
+	for (int frame = 0; frame < 5000; frame++)
+	{
+		pacer.WaitForDeadline();
+	}
+	CHECK(clock.lastRequest > wideRequest + 2 * ms);
+}
+
+TEST_CASE(FramePacerModeSwitchResetsDeadline)
+{
+	SimulatedClock clock;
+	FramePacer pacer(clock, FramePacer::Mode::TargetFps, 100.0f);
+	for (int frame = 0; frame < 10; frame++)
+	{
+		pacer.WaitForDeadline();
+	}
+	// a few ms in vsync, then back: the first capped frame goes at once instead of on the old cadence
+	pacer.SetMode(FramePacer::Mode::VSync);
+	const int64_t vsyncStart = clock.Now();
+	pacer.WaitForDeadline();
+	CHECK(clock.Now() - vsyncStart < 1000);
+	clock.Advance(3 * ms);
+	pacer.SetMode(FramePacer::Mode::TargetFps);
+	const int64_t before = clock.Now();
+	pacer.WaitForDeadline();
+	const int64_t restarted = clock.Now();
+	CHECK(restarted - before < 1000);
+	pacer.WaitForDeadline();
+	CHECK(std::abs(clock.Now() - restarted - 10 * ms) < 1000);
+}
+
+TEST_CASE(FramePacerSyncIntervalPerMode)
+{
+	SimulatedClock clock;
+	FramePacer pacer(clock);
+	CHECK(pacer.GetSyncInterval() == 0u);
+	pacer.SetMode(FramePacer::Mode::TargetFps);
+	CHECK(pacer.GetSyncInterval() == 0u);
+	pacer.SetMode(FramePacer::Mode::VSync);
+	CHECK(pacer.GetSyncInterval() == 1u);
+	pacer.SetMode(FramePacer::Mode::LowLatency);
+	CHECK(pacer.GetSyncInterval() == 1u);
+}
+
+TEST_CASE(FramePacerStatsTrackErrorAndWorst)
+{
+	// free reads so the intervals are exactly what the test advances
+	SimulatedClock clock(0);
+	clock.Advance(ms);
+	FramePacer pacer(clock, FramePacer::Mode::TargetFps, 100.0f);
+	pacer.MarkPresented();
+	CHECK(pacer.GetStats().frames == 0u);
+	for (const int64_t interval : { 12 * ms,9 * ms,15 * ms,10 * ms })
+	{
+		clock.Advance(interval);
+		pacer.MarkPresented();
+	}
+	FramePacer::Stats stats = pacer.GetStats();
+	CHECK(stats.frames == 4u);
+	CHECK(Near(stats.targetMs, 10.0f));
+	CHECK(Near(stats.intervalMs, 10.0f));
+	CHECK(Near(stats.errorMs, 0.0f));
+	CHECK(Near(stats.meanAbsErrorMs, 2.0f));
+	CHECK(Near(stats.worstErrorMs, 5.0f));
+
+	// the worst error keeps its sign, early frames count as much as late ones
+	clock.Advance(4 * ms);
+	pacer.MarkPresented();
+	stats = pacer.GetStats();
+	CHECK(Near(stats.errorMs, -6.0f));
+	CHECK(Near(stats.worstErrorMs, -6.0f));
+
+	// uncapped has no target and so no error
+	pacer.SetMode(FramePacer::Mode::Uncapped);
+	clock.Advance(7 * ms);
+	pacer.MarkPresented();
+	stats = pacer.GetStats();
+	CHECK(stats.mode == FramePacer::Mode::Uncapped);
+	CHECK(Near(stats.targetMs, 0.0f));
+	CHECK(Near(stats.intervalMs, 7.0f));
+	CHECK(Near(stats.errorMs, 0.0f));
+
+	pacer.ResetStats();
+	stats = pacer.GetStats();
+	CHECK(stats.frames == 0u);
+	CHECK(Near(stats.meanAbsErrorMs, 0.0f));
+	CHECK(Near(stats.worstErrorMs, 0.0f));
+}
\ No newline at end of file
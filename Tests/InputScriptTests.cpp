@@ -0,0 +1,44 @@
+#include "Test.hpp"
+#include "InputScript.hpp"
+#include "HeadlessWindow.hpp"
+#include <algorithm>
+#include <cmath>
+
+TEST_CASE(ScriptedInputReadsBackThroughWindow)
+{
+	// what the frame loop reads from the window has to be what the script sampled, the pointer to a pixel
+	const InputScript script = InputScript::Default();
+	HeadlessWindow wnd(800, 600, "test");
+	unsigned int mismatchedMoves = 0u;
+	float pointerError = 0.0f;
+	for (unsigned long long frame = 0u; frame < 2u * script.GetLength(); frame++)
+	{
+		script.Post(frame, wnd);
+		CHECK(!wnd.ProcessMessages());
+		FrameInput sampled;
+		FrameInput read;
+		script.Sample(frame, sampled);
+		FrameLoop::ReadControls(wnd, read);
+		mismatchedMoves += sampled.moveX != read.moveX || sampled.moveZ != read.moveZ ? 1u : 0u;
+		pointerError = std::max({ pointerError,
+			std::abs(sampled.pointerX - read.pointerX) * 400.0f,
+			std::abs(sampled.pointerY - read.pointerY) * 300.0f });
+	}
+	CHECK(mismatchedMoves == 0u);
+	CHECK(pointerError <= 0.5f + 1e-3f);
+	CHECK(wnd.mouse.IsInWindow());
+}
+
+TEST_CASE(ScriptPostsOnlyChanges)
+{
+	const InputScript script({ { 0u,{ 1.0f,-1.0f,0.0f,0.0f } },{ 10u,{ 1.0f,-1.0f,0.0f,0.0f } } });
+	HeadlessWindow wnd(800, 600, "test");
+	script.Post(0u, wnd);
+	// A and S down, one move into the window
+	CHECK(wnd.GetPendingCount() == 3u);
+	wnd.ProcessMessages();
+	script.Post(1u, wnd);
+	CHECK(wnd.GetPendingCount() == 0u);
+	CHECK(wnd.kbd.KeyIsPressed('A') && wnd.kbd.KeyIsPressed('S'));
+	CHECK(wnd.mouse.GetPosX() == 400 && wnd.mouse.GetPosY() == 300);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Test.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <memory>
+
+TEST_CASE(ParallelForCoversRangeOnce)
+{
+	JobSystem jobs(4u);
+	constexpr size_t count = size_t(1) << 18;
+	const std::unique_ptr<std::atomic<unsigned int>[]> pHits = std::make_unique<std::atomic<unsigned int>[]>(count);
+	for (int pass = 0; pass < 4; pass++)
+	{
+		jobs.ParallelFor(0u, count, 1u, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				pHits[i].fetch_add(1u, std::memory_order_relaxed);
+			}
+		});
+	}
+	size_t wrong = 0u;
+	for (size_t i = 0; i < count; i++)
+	{
+		wrong += pHits[i].load() != 4u ? 1u : 0u;
+	}
+	CHECK(wrong == 0u);
+}
+
+TEST_CASE(RunPastJobRingRunsInline)
+{
+	// more jobs than the ring and deque hold, the overflow runs on the submitting thread
+	JobSystem jobs(4u);
+	std::atomic<unsigned int> done{ 0u };
+	JobCounter counter;
+	const unsigned int total = unsigned(3u * JobSystem::jobsPerThread);
+	for (unsigned int i = 0u; i < total; i++)
+	{
+		jobs.Run(counter, [&done]()
+		{
+			done.fetch_add(1u, std::memory_order_relaxed);
+		});
+	}
+	jobs.Wait(counter);
+	CHECK(counter.IsDone());
+	CHECK(done.load() == total);
+}
\ No newline at end of file
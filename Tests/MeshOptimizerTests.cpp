@@ -0,0 +1,193 @@
+#include "Test.hpp"
+#include "MeshOptimizer.hpp"
+#include "Mesh.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct GridVertex
+	{
+		float x, y, z;
+		uint32_t id;
+	};
+
+	// n x n quads of a unit grid; triangles come in a fixed pseudo random order so there is cache locality to win
+	void MakeGrid(unsigned int n, std::vector<GridVertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		for (unsigned int y = 0; y <= n; y++)
+		{
+			for (unsigned int x = 0; x <= n; x++)
+			{
+				vertices.push_back({ float(x),float(y),0.0f,uint32_t(vertices.size()) });
+			}
+		}
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (unsigned int y = 0; y < n; y++)
+		{
+			for (unsigned int x = 0; x < n; x++)
+			{
+				const uint32_t i = y * (n + 1u) + x;
+				triangles.push_back({ i,i + n + 1u,i + 1u });
+				triangles.push_back({ i + 1u,i + n + 1u,i + n + 2u });
+			}
+		}
+		uint32_t state = 12345u;
+		for (size_t i = triangles.size() - 1u; i > 0u; i--)
+		{
+			state = state * 1664525u + 1013904223u;
+			std::swap(triangles[i], triangles[(state >> 8u) % (i + 1u)]);
+		}
+		indices.clear();
+		for (const auto& t : triangles)
+		{
+			indices.insert(indices.end(), t.begin(), t.end());
+		}
+	}
+
+	// each triangle rotated to start at its smallest index (winding kept), then sorted
+	std::vector<std::array<uint32_t, 3>> TriangleSet(const std::vector<uint32_t>& indices)
+	{
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (size_t i = 0; i < indices.size(); i += 3u)
+		{
+			std::array<uint32_t, 3> t = { indices[i],indices[i + 1u],indices[i + 2u] };
+			std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+			triangles.push_back(t);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+TEST_CASE(OptimizeVertexCacheKeepsTrianglesAndLowersAcmr)
+{
+	std::vector<GridVertex> vertices;
+	std::vector<uint32_t> indices;
+	MakeGrid(32u, vertices, indices);
+	const auto before = TriangleSet(indices);
+	const float acmrBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()).acmr;
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	CHECK(TriangleSet(indices) == before);
+	const float acmrAfter = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()).acmr;
+	CHECK(acmrAfter <= acmrBefore);
+	// shuffled triangles share almost nothing, a good order gets near one vertex per triangle
+	CHECK(acmrAfter < 1.0f);
+}
+
+TEST_CASE(OptimizeOverdrawKeepsTriangles)
+{
+	std::vector<GridVertex> vertices;
+	std::vector<uint32_t> indices;
+	MakeGrid(24u, vertices, indices);
+	// bend the grid into a half pipe so clusters face different ways
+	for (GridVertex& v : vertices)
+	{
+		v.z = (v.x - 12.0f) * (v.x - 12.0f) * 0.1f;
+	}
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	const auto before = TriangleSet(indices);
+	MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), &vertices[0].x, sizeof(GridVertex), vertices.size());
+	CHECK(TriangleSet(indices) == before);
+}
+
+TEST_CASE(OptimizeVertexFetchOrdersByFirstUse)
+{
+	std::vector<GridVertex> vertices;
+	std::vector<uint32_t> indices;
+	MakeGrid(8u, vertices, indices);
+	// one vertex no triangle uses
+	vertices.push_back({ -1.0f,-1.0f,-1.0f,uint32_t(vertices.size()) });
+	const std::vector<GridVertex> original = vertices;
+	const std::vector<uint32_t> originalIndices = indices;
+
+	const size_t used = MeshOptimizer::OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(GridVertex),
+		indices.data(), indices.size());
+	CHECK(used == original.size() - 1u);
+	// new indices appear in order 0, 1, 2, ... and each still names the same vertex
+	uint32_t next = 0u;
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		CHECK(indices[i] <= next);
+		if (indices[i] == next)
+		{
+			next++;
+		}
+		CHECK(vertices[indices[i]].id == original[originalIndices[i]].id);
+	}
+	CHECK(next == used);
+}
+
+TEST_CASE(WeldVerticesMergesExactDuplicatesOnly)
+{
+	const float nudged = std::nextafter(1.0f, 2.0f);
+	std::vector<GridVertex> vertices = {
+		{ 0.0f,0.0f,0.0f,0u },
+		{ 1.0f,0.0f,0.0f,0u },
+		{ 0.0f,0.0f,0.0f,0u },
+		// one ulp away, and -0 against 0: equal as floats but not as bytes, both stay
+		{ nudged,0.0f,0.0f,0u },
+		{ -0.0f,0.0f,0.0f,0u },
+		{ 1.0f,0.0f,0.0f,0u },
+	};
+	std::vector<uint32_t> remap;
+	const size_t unique = MeshOptimizer::WeldVertices(vertices.data(), vertices.size(), sizeof(GridVertex), remap);
+	CHECK(unique == 4u);
+	CHECK((remap == std::vector<uint32_t>{ 0u,1u,0u,2u,3u,1u }));
+	CHECK(vertices[2].x == nudged);
+	CHECK(std::signbit(vertices[3].x));
+
+	std::vector<uint32_t> indices = { 0u,1u,2u,3u,4u,5u };
+	MeshOptimizer::RemapIndices(indices.data(), indices.size(), remap);
+	CHECK((indices == std::vector<uint32_t>{ 0u,1u,0u,2u,3u,1u }));
+}
+
+TEST_CASE(MeshChoosesIndexFormatByVertexCount)
+{
+	// one triangle whose last index is the highest vertex
+	for (const size_t vertexCount : { size_t(3u),size_t(0xFFFFu),size_t(0x10000u) })
+	{
+		std::vector<GridVertex> vertices(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			vertices[i] = { float(i),0.0f,0.0f,uint32_t(i) };
+		}
+		const uint32_t indices[] = { 0u,1u,uint32_t(vertexCount - 1u) };
+		const Mesh mesh(vertices.data(), vertexCount, sizeof(GridVertex), indices, 3u);
+		const bool small = vertexCount <= 0xFFFFu;
+		CHECK(mesh.GetIndexFormat() == (small ? IndexFormat::Uint16 : IndexFormat::Uint32));
+		CHECK(mesh.GetIndexDataSize() == 3u * (small ? 2u : 4u));
+		if (small)
+		{
+			CHECK(mesh.GetIndices16()[2] == uint16_t(vertexCount - 1u));
+		}
+	}
+}
+
+TEST_CASE(MeshOptimizeWeldsAndImprovesGrid)
+{
+	// every triangle with its own three vertices, the way an exporter without indexing writes them
+	std::vector<GridVertex> grid;
+	std::vector<uint32_t> gridIndices;
+	MakeGrid(16u, grid, gridIndices);
+	std::vector<GridVertex> vertices;
+	std::vector<uint32_t> indices;
+	for (const uint32_t i : gridIndices)
+	{
+		indices.push_back(uint32_t(vertices.size()));
+		vertices.push_back(grid[i]);
+	}
+	Mesh mesh(vertices.data(), vertices.size(), sizeof(GridVertex), indices.data(), indices.size());
+	const Mesh::Report report = mesh.Optimize();
+	CHECK(report.verticesBefore == vertices.size());
+	CHECK(report.verticesAfter == grid.size());
+	CHECK(report.after.acmr <= report.before.acmr);
+	CHECK(report.after.acmr < 1.0f);
+	CHECK(report.indexFormat == IndexFormat::Uint16);
+	CHECK(mesh.GetIndexCount() == indices.size());
+}
\ No newline at end of file
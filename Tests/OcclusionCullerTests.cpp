@@ -0,0 +1,128 @@
+#include "Test.hpp"
+#include "OcclusionCuller.hpp"
+#include "JobSystem.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	// camera of NullGraphics: at z = -5 looking down +z, near plane 0.5
+	Matrix4 ViewProjection()
+	{
+		return Matrix4::LookAtLH({ 0.0f,0.0f,-5.0f }, { 0.0f,0.0f,0.0f }, { 0.0f,1.0f,0.0f }) *
+			Matrix4::PerspectiveLH(1.0f, 0.75f, 0.5f, 100.0f);
+	}
+
+	// n x n quads over [x0,x1] x [-50,50] in the plane z, facing the camera
+	void AddWall(OcclusionCuller& culler, float z, float x0, float x1, unsigned int n = 1u)
+	{
+		std::vector<Float3> positions;
+		std::vector<uint32_t> indices;
+		for (unsigned int j = 0; j <= n; j++)
+		{
+			for (unsigned int i = 0; i <= n; i++)
+			{
+				positions.push_back({ x0 + (x1 - x0) * float(i) / float(n),-50.0f + 100.0f * float(j) / float(n),z });
+			}
+		}
+		for (unsigned int j = 0; j < n; j++)
+		{
+			for (unsigned int i = 0; i < n; i++)
+			{
+				const uint32_t v = j * (n + 1u) + i;
+				indices.insert(indices.end(), { v,v + n + 1u,v + 1u,v + 1u,v + n + 1u,v + n + 2u });
+			}
+		}
+		culler.AddOccluder(positions.data(), sizeof(Float3), indices.data(), indices.size(), Matrix4::Identity());
+	}
+}
+
+TEST_CASE(OcclusionCullsBoxBehindWall)
+{
+	OcclusionCuller culler;
+	culler.BeginFrame(ViewProjection());
+	AddWall(culler, 0.0f, -50.0f, 50.0f);
+	culler.RenderOccluders();
+	CHECK(culler.GetStats().occluderTriangles == 2u);
+	// behind, in front of and cutting through the wall
+	CHECK(!culler.IsVisible({ 0.0f,0.0f,5.0f }, { 1.0f,1.0f,1.0f }));
+	CHECK(!culler.IsVisible({ 2.0f,-1.0f,0.5f }, { 0.25f,0.25f,0.25f }));
+	CHECK(culler.IsVisible({ 0.0f,0.0f,-2.0f }, { 0.5f,0.5f,0.5f }));
+	CHECK(culler.IsVisible({ 0.0f,0.0f,0.0f }, { 0.5f,0.5f,0.5f }));
+	// entirely off screen is never visible
+	CHECK(!culler.IsVisible({ 40.0f,0.0f,-2.0f }, { 0.5f,0.5f,0.5f }));
+}
+
+TEST_CASE(OcclusionKeepsBoxesCrossingNearPlane)
+{
+	OcclusionCuller culler;
+	culler.BeginFrame(ViewProjection());
+	// a wall one unit in front of the camera covers the whole screen
+	AddWall(culler, -4.0f, -50.0f, 50.0f);
+	culler.RenderOccluders();
+	CHECK(!culler.IsVisible({ 0.0f,0.0f,0.0f }, { 0.5f,0.5f,0.5f }));
+	// mostly behind the wall, but a corner reaches past the near plane: no safe screen rectangle
+	CHECK(culler.IsVisible({ 0.0f,0.0f,-2.0f }, { 0.3f,0.3f,2.6f }));
+	CHECK(culler.IsVisible({ 0.0f,0.0f,5.0f }, { 1.0f,1.0f,10.0f }));
+}
+
+TEST_CASE(OcclusionThreadedTestMatchesSingleThread)
+{
+	JobSystem jobs(4u);
+	OcclusionCuller single;
+	OcclusionCuller threaded(320u, 192u, &jobs);
+	BoxBounds boxes;
+	uint32_t state = 7u;
+	const auto random = [&state](float scale)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (float(state >> 8u) / float(1u << 24u) - 0.5f) * scale;
+	};
+	for (int i = 0; i < 60000; i++)
+	{
+		boxes.Add({ random(8.0f),random(6.0f),random(8.0f) }, { 0.1f,0.1f,0.1f });
+	}
+
+	// the left half of the screen is walled off, finely tessellated so the occluders split into bands too
+	std::vector<uint32_t> expected;
+	std::vector<uint32_t> visible;
+	for (OcclusionCuller* pCuller : { &single,&threaded })
+	{
+		pCuller->BeginFrame(ViewProjection());
+		AddWall(*pCuller, 1.0f, -50.0f, 0.0f, 40u);
+		pCuller->RenderOccluders();
+		pCuller->TestBoxes(boxes, pCuller == &single ? expected : visible);
+	}
+	CHECK(visible == expected);
+	CHECK(expected.size() > 1000u && expected.size() < boxes.Size() - 1000u);
+	CHECK(threaded.GetStats().culled == single.GetStats().culled);
+	for (size_t i = 1; i < visible.size(); i++)
+	{
+		CHECK(visible[i - 1u] < visible[i]);
+	}
+}
+
+TEST_CASE(OcclusionCulledPercent)
+{
+	OcclusionCuller culler;
+	CHECK(culler.GetStats().CulledPercent() == 0.0f);
+	culler.BeginFrame(ViewProjection());
+	AddWall(culler, 0.0f, -50.0f, 50.0f);
+	culler.RenderOccluders();
+	BoxBounds boxes;
+	boxes.Add({ 0.0f,0.0f,5.0f }, { 1.0f,1.0f,1.0f });
+	boxes.Add({ 0.0f,0.0f,-2.0f }, { 0.5f,0.5f,0.5f });
+	boxes.Add({ 1.0f,1.0f,3.0f }, { 0.5f,0.5f,0.5f });
+	boxes.Add({ -1.0f,0.0f,-1.0f }, { 0.5f,0.5f,0.5f });
+	std::vector<uint32_t> visible;
+	culler.TestBoxes(boxes, visible);
+	CHECK((visible == std::vector<uint32_t>{ 1u,3u }));
+	CHECK(culler.GetStats().tested == 4u);
+	CHECK(culler.GetStats().culled == 2u);
+	CHECK(std::abs(culler.GetStats().CulledPercent() - 50.0f) < 1e-4f);
+	// a new frame starts the counts over
+	culler.BeginFrame(ViewProjection());
+	CHECK(culler.GetStats().tested == 0u);
+	CHECK(culler.GetStats().CulledPercent() == 0.0f);
+}
\ No newline at end of file
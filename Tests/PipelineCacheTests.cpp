@@ -0,0 +1,187 @@
+#include "Test.hpp"
+#include "PipelineCache.hpp"
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace
+{
+	const uint8_t vertexCode[] = { 0x44,0x58,0x42,0x43,0x01,0x02,0x03,0x04 };
+	const uint8_t pixelCode[] = { 0x44,0x58,0x42,0x43,0x05,0x06,0x07,0x08 };
+
+	bool SameKey(const DescriptorKey& a, const DescriptorKey& b) noexcept
+	{
+		return a == b && a.Hash() == b.Hash();
+	}
+
+	// a descriptor built on top of garbage so any padding byte reaching the key would show up
+	template<typename T>
+	T* ConstructOver(void* pStorage, uint8_t fill)
+	{
+		std::memset(pStorage, fill, sizeof(T));
+		return new(pStorage) T;
+	}
+
+	InputElementDesc Element(const char* pName, uint32_t format, uint32_t offset)
+	{
+		InputElementDesc e;
+		e.semanticName = pName;
+		e.format = format;
+		e.alignedByteOffset = offset;
+		return e;
+	}
+}
+
+TEST_CASE(EqualDescriptorsHashEqual)
+{
+	DepthStencilDesc a;
+	DepthStencilDesc b;
+	CHECK(SameKey(MakeKey(a), MakeKey(b)));
+
+	// bytecode and semantic names are compared by content, not by address
+	const std::unique_ptr<uint8_t[]> pCopy = std::make_unique<uint8_t[]>(sizeof(vertexCode));
+	std::memcpy(pCopy.get(), vertexCode, sizeof(vertexCode));
+	CHECK(SameKey(MakeKey(ShaderBytecode{ vertexCode,sizeof(vertexCode) }), MakeKey(ShaderBytecode{ pCopy.get(),sizeof(vertexCode) })));
+
+	const std::string name = "Position";
+	const InputElementDesc literal = Element("Position", 6u, 0u);
+	const InputElementDesc copied = Element(name.c_str(), 6u, 0u);
+	const ShaderBytecode vs = { vertexCode,sizeof(vertexCode) };
+	CHECK(SameKey(MakeKey(&literal, 1u, vs), MakeKey(&copied, 1u, ShaderBytecode{ pCopy.get(),sizeof(vertexCode) })));
+}
+
+TEST_CASE(PaddingNeverReachesKey)
+{
+	alignas(DepthStencilDesc) unsigned char storageA[sizeof(DepthStencilDesc)];
+	alignas(DepthStencilDesc) unsigned char storageB[sizeof(DepthStencilDesc)];
+	DepthStencilDesc* pA = ConstructOver<DepthStencilDesc>(storageA, 0x00u);
+	DepthStencilDesc* pB = ConstructOver<DepthStencilDesc>(storageB, 0xA5u);
+	pA->depthFunc = pB->depthFunc = 4u;
+	CHECK(SameKey(MakeKey(*pA), MakeKey(*pB)));
+
+	alignas(InputElementDesc) unsigned char elementA[sizeof(InputElementDesc)];
+	alignas(InputElementDesc) unsigned char elementB[sizeof(InputElementDesc)];
+	InputElementDesc* pElementA = ConstructOver<InputElementDesc>(elementA, 0x00u);
+	InputElementDesc* pElementB = ConstructOver<InputElementDesc>(elementB, 0xFFu);
+	pElementA->semanticName = pElementB->semanticName = "Normal";
+	pElementA->perInstance = pElementB->perInstance = true;
+	const ShaderBytecode vs = { vertexCode,sizeof(vertexCode) };
+	CHECK(SameKey(MakeKey(pElementA, 1u, vs), MakeKey(pElementB, 1u, vs)));
+
+	PipelineDesc pipelineA;
+	PipelineDesc pipelineB;
+	pipelineA.vertexShader = pipelineB.vertexShader = vs;
+	pipelineA.pixelShader = pipelineB.pixelShader = { pixelCode,sizeof(pixelCode) };
+	pipelineA.pInputElements = pElementA;
+	pipelineB.pInputElements = pElementB;
+	pipelineA.inputElementCount = pipelineB.inputElementCount = 1u;
+	pipelineA.depthStencil = *pA;
+	pipelineB.depthStencil = *pB;
+	CHECK(SameKey(MakeKey(pipelineA), MakeKey(pipelineB)));
+}
+
+TEST_CASE(EachDepthStencilFieldChangesKey)
+{
+	const DescriptorKey base = MakeKey(DepthStencilDesc{});
+	const DescriptorKey basePipeline = MakeKey(PipelineDesc{});
+	const auto differs = [&base, &basePipeline](void(*change)(DepthStencilDesc&))
+	{
+		DepthStencilDesc d;
+		change(d);
+		const DescriptorKey key = MakeKey(d);
+		PipelineDesc pipeline;
+		pipeline.depthStencil = d;
+		const DescriptorKey pipelineKey = MakeKey(pipeline);
+		return !(key == base) && key.Hash() != base.Hash() &&
+			!(pipelineKey == basePipeline) && pipelineKey.Hash() != basePipeline.Hash();
+	};
+	CHECK(differs([](DepthStencilDesc& d) { d.depthEnable = false; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.depthWriteMask = 0u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.depthFunc = 4u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.stencilEnable = true; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.stencilReadMask = 0x0Fu; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.stencilWriteMask = 0xF0u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.frontFace.stencilFailOp = 3u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.frontFace.stencilDepthFailOp = 7u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.frontFace.stencilPassOp = 2u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.frontFace.stencilFunc = 3u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.backFace.stencilFailOp = 3u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.backFace.stencilDepthFailOp = 8u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.backFace.stencilPassOp = 2u; }));
+	CHECK(differs([](DepthStencilDesc& d) { d.backFace.stencilFunc = 6u; }));
+	// the same op on the other face is a different state
+	DepthStencilDesc front;
+	front.frontFace.stencilPassOp = 3u;
+	DepthStencilDesc back;
+	back.backFace.stencilPassOp = 3u;
+	CHECK(!(MakeKey(front) == MakeKey(back)));
+}
+
+TEST_CASE(EachInputElementFieldChangesKey)
+{
+	const ShaderBytecode vs = { vertexCode,sizeof(vertexCode) };
+	const InputElementDesc elements[] = { Element("Position",6u,0u),Element("Color",28u,12u) };
+	const DescriptorKey base = MakeKey(elements, 2u, vs);
+	const auto differs = [&](void(*change)(InputElementDesc&))
+	{
+		InputElementDesc changed[] = { elements[0],elements[1] };
+		change(changed[1]);
+		const DescriptorKey key = MakeKey(changed, 2u, vs);
+		return !(key == base) && key.Hash() != base.Hash();
+	};
+	CHECK(differs([](InputElementDesc& e) { e.semanticName = "Colour"; }));
+	CHECK(differs([](InputElementDesc& e) { e.semanticIndex = 1u; }));
+	CHECK(differs([](InputElementDesc& e) { e.format = 87u; }));
+	CHECK(differs([](InputElementDesc& e) { e.inputSlot = 1u; }));
+	CHECK(differs([](InputElementDesc& e) { e.alignedByteOffset = 16u; }));
+	CHECK(differs([](InputElementDesc& e) { e.perInstance = true; }));
+	CHECK(differs([](InputElementDesc& e) { e.instanceDataStepRate = 1u; }));
+	// fewer elements, and the same elements validated against another shader
+	CHECK(!(MakeKey(elements, 1u, vs) == base));
+	CHECK(!(MakeKey(elements, 2u, ShaderBytecode{ pixelCode,sizeof(pixelCode) }) == base));
+}
+
+TEST_CASE(StringAndBytecodeBoundariesAreEncoded)
+{
+	// the length prefix keeps "ab"+"c" and "a"+"bc" apart
+	DescriptorKey a;
+	DescriptorKey b;
+	a.AddString("ab").AddString("c");
+	b.AddString("a").AddString("bc");
+	CHECK(!(a == b));
+	// one changed byte, and the same bytes cut shorter
+	uint8_t changed[sizeof(vertexCode)];
+	std::memcpy(changed, vertexCode, sizeof(vertexCode));
+	changed[sizeof(changed) - 1u] ^= 1u;
+	const DescriptorKey original = MakeKey(ShaderBytecode{ vertexCode,sizeof(vertexCode) });
+	CHECK(!(MakeKey(ShaderBytecode{ changed,sizeof(changed) }) == original));
+	CHECK(!(MakeKey(ShaderBytecode{ vertexCode,sizeof(vertexCode) - 1u }) == original));
+	// kinds are tagged, a shader and a pipeline never share a key
+	PipelineDesc pipeline;
+	pipeline.vertexShader = { vertexCode,sizeof(vertexCode) };
+	CHECK(!(MakeKey(pipeline) == original));
+}
+
+TEST_CASE(StateCacheSharesObjects)
+{
+	StateCache<std::shared_ptr<int>> cache;
+	int created = 0;
+	const auto create = [&created]()
+	{
+		return std::make_shared<int>(++created);
+	};
+	DepthStencilDesc lessEqual;
+	lessEqual.depthFunc = 4u;
+	const auto first = cache.GetOrCreate(MakeKey(DepthStencilDesc{}), create);
+	const auto second = cache.GetOrCreate(MakeKey(DepthStencilDesc{}), create);
+	const auto other = cache.GetOrCreate(MakeKey(lessEqual), create);
+	CHECK(first == second);
+	CHECK(first != other);
+	CHECK(created == 2);
+	CHECK(cache.Size() == 2u);
+	CHECK(cache.GetStats().hits == 1u && cache.GetStats().misses == 2u);
+	cache.Clear();
+	CHECK(cache.Size() == 0u);
+	CHECK(cache.GetOrCreate(MakeKey(DepthStencilDesc{}), create) != first);
+}
\ No newline at end of file
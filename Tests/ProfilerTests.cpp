@@ -0,0 +1,100 @@
+#include "Test.hpp"
+#include "FrameGraph.hpp"
+#include "Profiler.hpp"
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	struct TraceZone
+	{
+		double ts = -1.0;
+		double dur = -1.0;
+	};
+
+	// ts and dur of the first complete event with this name, ts -1 when there is none
+	TraceZone FindZone(const std::string& trace, const std::string& name)
+	{
+		TraceZone zone;
+		const size_t at = trace.find("{\"name\":\"" + name + "\",\"ph\":\"X\"");
+		if (at != std::string::npos)
+		{
+			const size_t ts = trace.find("\"ts\":", at);
+			const size_t dur = trace.find("\"dur\":", at);
+			zone.ts = std::stod(trace.substr(ts + 5u));
+			zone.dur = std::stod(trace.substr(dur + 6u));
+		}
+		return zone;
+	}
+}
+
+TEST_CASE(InternKeepsOneCopyPerName)
+{
+	std::string name = "interned zone";
+	const char* const p = Profiler::Intern(name);
+	name = "something else";
+	CHECK(std::string(p) == "interned zone");
+	CHECK(Profiler::Intern("interned zone") == p);
+	CHECK(Profiler::Intern("interned zone 2") != p);
+}
+
+TEST_CASE(TraceOutlivesFrameGraphTaskNames)
+{
+	{
+		JobSystem jobs(2u);
+		FrameGraph graph;
+		const FrameGraph::ResourceId r = graph.AddResource("r");
+		graph.AddTask(std::string("graph task ") + "outlived", {}, { r }, []() {});
+		graph.AddTask(std::string("graph task ") + "reader", { r }, {}, []() {});
+		graph.Compile();
+		graph.Execute(jobs);
+		PROFILE_ZONE("after the graph");
+	}
+	std::ostringstream trace;
+	Profiler::WriteChromeTrace(trace);
+	CHECK(trace.str().find("\"graph task outlived\"") != std::string::npos);
+	CHECK(trace.str().find("\"graph task reader\"") != std::string::npos);
+}
+
+TEST_CASE(NestedZonesEndAtNextZoneOrParent)
+{
+	std::thread([]()
+	{
+		{
+			PROFILE_ZONE("nest parent");
+			{
+				PROFILE_ZONE("nest first");
+			}
+			{
+				PROFILE_ZONE("nest second");
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+		{
+			PROFILE_ZONE("nest open");
+			PROFILE_ZONE("nest unresolved");
+		}
+	}).join();
+	std::ostringstream out;
+	Profiler::WriteChromeTrace(out);
+	const std::string trace = out.str();
+	const TraceZone parent = FindZone(trace, "nest parent");
+	const TraceZone first = FindZone(trace, "nest first");
+	const TraceZone second = FindZone(trace, "nest second");
+	CHECK(parent.ts >= 0.0 && first.ts >= 0.0 && second.ts >= 0.0);
+	// a nested zone runs until the next zone opens, the last child is cut off by its parent
+	CHECK(std::abs(first.ts + first.dur - second.ts) < 0.002);
+	CHECK(second.dur >= 2000.0);
+	CHECK(std::abs(second.ts + second.dur - (parent.ts + parent.dur)) < 0.002);
+	CHECK(parent.dur >= 4000.0);
+	CHECK(first.ts >= parent.ts);
+	// closed outermost zones always show, their children end with them
+	const TraceZone open = FindZone(trace, "nest open");
+	const TraceZone unresolved = FindZone(trace, "nest unresolved");
+	CHECK(open.ts >= 0.0 && unresolved.ts >= 0.0);
+	CHECK(unresolved.ts + unresolved.dur <= open.ts + open.dur + 0.002);
+}
\ No newline at end of file
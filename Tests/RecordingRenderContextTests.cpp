@@ -0,0 +1,164 @@
+#include "Test.hpp"
+#include "RecordingRenderContext.hpp"
+#include "NullRenderContext.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	// one call of every kind, with a negative base vertex and an upload; the stream size after each
+	// call goes into pBoundaries
+	void RecordCalls(RecordingRenderContext& recording, NullRenderContext& context, std::vector<size_t>* pBoundaries = nullptr)
+	{
+		const auto mark = [&]()
+		{
+			if (pBoundaries)
+			{
+				pBoundaries->push_back(recording.GetBytes().size());
+			}
+		};
+		const BufferHandle buffer = context.CreateBuffer(256u);
+		const uint8_t payload[40] = { 1,2,3,4,5,6,7,8,9,10 };
+		const float color[4] = { 0.25f,0.5f,0.75f,1.0f };
+		recording.IASetPrimitiveTopology(Topology::TriangleList);
+		mark();
+		recording.IASetInputLayout(context.CreateHandle<InputLayoutHandle>());
+		mark();
+		recording.IASetVertexBuffer(1u, buffer, 64u, 128u);
+		mark();
+		recording.IASetIndexBuffer(buffer, IndexFormat::Uint32, 4u);
+		mark();
+		recording.VSSetShader(context.CreateHandle<VertexShaderHandle>());
+		mark();
+		recording.PSSetShader(context.CreateHandle<PixelShaderHandle>());
+		mark();
+		recording.VSSetConstantBuffer(2u, buffer, 16u, 4u);
+		mark();
+		recording.OMSetRenderTarget(context.CreateHandle<RenderTargetHandle>(), context.CreateHandle<DepthStencilViewHandle>());
+		mark();
+		recording.OMSetDepthStencilState(context.CreateHandle<DepthStencilStateHandle>(), 3u);
+		mark();
+		recording.Map(buffer, MapMode::WriteDiscard);
+		mark();
+		recording.Unmap(buffer);
+		mark();
+		recording.UpdateBuffer(buffer, MapMode::WriteNoOverwrite, 200u, payload, sizeof(payload));
+		mark();
+		recording.ClearRenderTarget(context.CreateHandle<RenderTargetHandle>(), color);
+		mark();
+		recording.ClearDepth(context.CreateHandle<DepthStencilViewHandle>(), 1.0f);
+		mark();
+		recording.DrawIndexed(36u, 6u, -5);
+		mark();
+		recording.DrawIndexedInstanced(36u, 1000u, 0u, -70000, 7u);
+		mark();
+	}
+}
+
+TEST_CASE(VarintRoundTrip)
+{
+	// a negative base vertex is recorded as its 32 bit pattern
+	const uint64_t values[] = { 0u,1u,127u,128u,300u,0xFFFFFFFFu,uint32_t(-5),UINT64_MAX };
+	const size_t lengths[] = { 1u,1u,1u,2u,2u,5u,5u,10u };
+	std::vector<uint8_t> bytes;
+	for (size_t i = 0; i < std::size(values); i++)
+	{
+		const size_t before = bytes.size();
+		RecordingRenderContext::PutVarint(bytes, values[i]);
+		CHECK(bytes.size() - before == lengths[i]);
+	}
+	const uint8_t* p = bytes.data();
+	const uint8_t* const pEnd = bytes.data() + bytes.size();
+	for (const uint64_t expected : values)
+	{
+		uint64_t value = 0u;
+		CHECK(RecordingRenderContext::GetVarint(p, pEnd, value));
+		CHECK(value == expected);
+	}
+	CHECK(p == pEnd);
+	CHECK(int(uint32_t(values[6])) == -5);
+
+	// every byte still has its continuation bit set: reading runs off the end
+	const uint8_t open[] = { 0x80u,0x80u };
+	p = open;
+	uint64_t value = 0u;
+	CHECK(!RecordingRenderContext::GetVarint(p, open + sizeof(open), value));
+}
+
+TEST_CASE(RecordingDecodeRejectsTruncatedStreams)
+{
+	NullRenderContext context;
+	RecordingRenderContext recording(context);
+	std::vector<size_t> boundaries;
+	RecordCalls(recording, context, &boundaries);
+	const std::vector<uint8_t>& bytes = recording.GetBytes();
+	CHECK(boundaries.back() == bytes.size());
+
+	// a cut only decodes when it falls between two calls, and then yields the calls before it
+	size_t call = 0u;
+	for (size_t size = 1u; size < bytes.size(); size++)
+	{
+		const bool boundary = size == boundaries[call];
+		std::vector<RecordingRenderContext::Call> calls;
+		CHECK(RecordingRenderContext::Decode(bytes.data(), size, calls) == boundary);
+		if (boundary)
+		{
+			CHECK(calls.size() == call + 1u);
+			call++;
+		}
+	}
+
+	// an op byte past the last op is not a call
+	std::vector<uint8_t> bad = bytes;
+	bad.push_back(uint8_t(RecordingRenderContext::Op::Count));
+	std::vector<RecordingRenderContext::Call> calls;
+	CHECK(!RecordingRenderContext::Decode(bad.data(), bad.size(), calls));
+}
+
+TEST_CASE(RecordingReplaysToIdenticalBytes)
+{
+	NullRenderContext context;
+	RecordingRenderContext recording(context);
+	RecordCalls(recording, context);
+	const std::vector<RecordingRenderContext::Call> calls = recording.Decode();
+	CHECK(calls.size() == recording.GetCallCount());
+	CHECK(recording.GetCallCount(RecordingRenderContext::Op::UpdateBuffer) == 1u);
+
+	const RecordingRenderContext::Call& draw = calls[calls.size() - 2u];
+	CHECK(draw.op == RecordingRenderContext::Op::DrawIndexed);
+	CHECK(int(uint32_t(draw.args[2])) == -5);
+	const RecordingRenderContext::Call& clear = calls[12];
+	CHECK(clear.op == RecordingRenderContext::Op::ClearRenderTarget);
+	CHECK(clear.GetFloat(1) == 0.25f && clear.GetFloat(4) == 1.0f);
+
+	// handles pass through unchanged, so the second recorder can wrap the same context
+	RecordingRenderContext copy(context);
+	recording.Replay(copy);
+	CHECK(copy.GetBytes() == recording.GetBytes());
+	CHECK(copy.GetCallCount() == recording.GetCallCount());
+}
+
+TEST_CASE(NullContextUpdateBufferWritesAtOffset)
+{
+	NullRenderContext context;
+	const BufferHandle buffer = context.CreateBuffer(64u);
+	const uint8_t payload[8] = { 1,2,3,4,5,6,7,8 };
+	context.UpdateBuffer(buffer, MapMode::WriteNoOverwrite, 20u, payload, sizeof(payload));
+	const uint8_t* pData = static_cast<const uint8_t*>(context.GetBufferData(buffer));
+	bool zeroElsewhere = true;
+	for (size_t i = 0; i < 64u; i++)
+	{
+		zeroElsewhere = zeroElsewhere && ((i >= 20u && i < 28u) || pData[i] == 0u);
+	}
+	CHECK(zeroElsewhere);
+	CHECK(std::memcmp(pData + 20u, payload, sizeof(payload)) == 0);
+
+	// initial contents are copied, a later upload only touches its own range
+	const uint8_t initial[16] = { 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9 };
+	const BufferHandle filled = context.CreateBuffer(sizeof(initial), initial);
+	context.UpdateBuffer(filled, MapMode::WriteNoOverwrite, 4u, payload, 4u);
+	const uint8_t* pFilled = static_cast<const uint8_t*>(context.GetBufferData(filled));
+	CHECK(pFilled[3] == 9u && pFilled[4] == 1u && pFilled[7] == 4u && pFilled[8] == 9u);
+}
\ No newline at end of file
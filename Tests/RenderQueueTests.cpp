@@ -0,0 +1,72 @@
+#include "Test.hpp"
+#include "RenderQueue.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+	bool KeyLess(const SortEntry& a, const SortEntry& b) noexcept
+	{
+		return a.key < b.key;
+	}
+
+	bool SameOrder(const std::vector<SortEntry>& a, const std::vector<SortEntry>& b) noexcept
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const SortEntry& x, const SortEntry& y)
+		{
+			return x.key == y.key && x.item == y.item;
+		});
+	}
+}
+
+TEST_CASE(RadixSortMatchesStableSort)
+{
+	std::mt19937_64 rng(7u);
+	for (const uint64_t mask : { ~uint64_t(0), uint64_t(0xFF00FF00FF00FF00), uint64_t(0x0000000F0000000F) })
+	{
+		// masked keys collide a lot and leave whole digits equal, so stability and the skip both get exercised
+		std::vector<SortEntry> entries(50000u);
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			entries[i] = { rng() & mask,uint32_t(i) };
+		}
+		std::vector<SortEntry> expected = entries;
+		std::stable_sort(expected.begin(), expected.end(), KeyLess);
+
+		std::vector<SortEntry> scratch(entries.size());
+		RadixSort(entries.data(), scratch.data(), entries.size());
+		CHECK(std::is_sorted(entries.begin(), entries.end(), KeyLess));
+		CHECK(SameOrder(entries, expected));
+	}
+}
+
+TEST_CASE(RadixSortShortInputs)
+{
+	RadixSort(nullptr, nullptr, 0u);
+	SortEntry one = { 42u,7u };
+	RadixSort(&one, nullptr, 1u);
+	CHECK(one.key == 42u && one.item == 7u);
+
+	RenderQueue queue;
+	queue.Sort();
+	CHECK(queue.Empty());
+}
+
+TEST_CASE(RenderQueueSortsByKey)
+{
+	RenderQueue queue;
+	queue.Push(SortKey::Opaque(1u, 0.5f, 3u, 0u, 0u), 0u);
+	queue.Push(SortKey::Opaque(0u, 0.9f, 1u, 0u, 0u), 1u);
+	queue.Push(SortKey::Opaque(0u, 0.1f, 2u, 0u, 0u), 2u);
+	queue.Push(SortKey::Translucent(0u, 0.2f, 0u, 0u, 0u), 3u);
+	queue.Push(SortKey::Translucent(0u, 0.8f, 0u, 0u, 0u), 4u);
+	queue.Sort();
+	std::vector<uint32_t> items;
+	for (const SortEntry& e : queue)
+	{
+		items.push_back(e.item);
+	}
+	// pass first, opaque front-to-back before translucent back-to-front
+	CHECK((items == std::vector<uint32_t>{ 2u,1u,4u,3u,0u }));
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Test.hpp"
+#include "SceneSubmitter.hpp"
+#include "NullRenderContext.hpp"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// keeps a copy of the instance matrices every draw reads through input slot 1
+	class BatchChecker : public NullRenderContext
+	{
+	public:
+		void IASetVertexBuffer(unsigned int slot, BufferHandle buffer, unsigned int stride, unsigned int offset) override
+		{
+			if (slot == 1u)
+			{
+				instances = buffer;
+				instanceOffset = offset;
+			}
+		}
+		void VSSetConstantBuffer(unsigned int slot, BufferHandle, unsigned int, unsigned int) override
+		{
+			if (slot == SceneSubmitter::materialConstantSlot)
+			{
+				materialBinds++;
+			}
+		}
+		void DrawIndexedInstanced(unsigned int, unsigned int instanceCount, unsigned int, int, unsigned int) override
+		{
+			const char* pData = static_cast<const char*>(GetBufferData(instances)) + instanceOffset;
+			std::vector<Matrix4> draw(instanceCount);
+			std::memcpy(draw.data(), pData, instanceCount * sizeof(Matrix4));
+			draws.push_back(std::move(draw));
+		}
+	public:
+		BufferHandle instances = BufferHandle::Null;
+		unsigned int instanceOffset = 0u;
+		unsigned int materialBinds = 0u;
+		std::vector<std::vector<Matrix4>> draws;
+	};
+
+	SceneSubmitter::Resources MakeResources(NullRenderContext& context, bool batched)
+	{
+		const Matrix4 identity = Matrix4::Identity();
+		SceneSubmitter::Resources resources;
+		resources.identityInstances = context.CreateBuffer(sizeof(identity), &identity);
+		resources.constantRing = context.CreateBuffer(SceneSubmitter::constantRingSize);
+		if (batched)
+		{
+			resources.instanceRing = context.CreateBuffer(SceneSubmitter::instanceRingSize);
+		}
+		return resources;
+	}
+
+	// camera of NullGraphics, every cube near the origin is in view at the same depth
+	Matrix4 ViewProjection()
+	{
+		return Matrix4::LookAtLH({ 0.0f,0.0f,-5.0f }, { 0.0f,0.0f,0.0f }, { 0.0f,1.0f,0.0f }) *
+			Matrix4::PerspectiveLH(1.0f, 0.75f, 0.5f, SceneSubmitter::farZ);
+	}
+}
+
+TEST_CASE(SceneSubmitterBatchesMaterialRuns)
+{
+	BatchChecker context;
+	SceneSubmitter submitter(context, MakeResources(context, true));
+
+	// materials interleaved in queue order, the index goes into the translation to find each cube again
+	const unsigned int cubes = 30u;
+	for (unsigned int i = 0u; i < cubes; i++)
+	{
+		submitter.QueueCube(Matrix4::Translation(float(i) * 0.01f, 0.0f, 0.0f), false, uint16_t(i % 3u));
+	}
+	submitter.Flush(ViewProjection());
+	CHECK(context.draws.size() == 3u);
+	CHECK(context.materialBinds == 3u);
+
+	// every cube exactly once, each draw holds one material and no material is drawn twice
+	std::vector<int> seen(cubes, 0);
+	unsigned int materialsDrawn = 0u;
+	for (const auto& draw : context.draws)
+	{
+		CHECK(draw.size() == cubes / 3u);
+		const unsigned int material = unsigned(draw.front().m[3][0] * 100.0f + 0.5f) % 3u;
+		CHECK((materialsDrawn & (1u << material)) == 0u);
+		materialsDrawn |= 1u << material;
+		for (const Matrix4& m : draw)
+		{
+			const unsigned int i = unsigned(m.m[3][0] * 100.0f + 0.5f);
+			CHECK(i < cubes && i % 3u == material);
+			seen[i % cubes]++;
+		}
+	}
+	for (unsigned int i = 0u; i < cubes; i++)
+	{
+		CHECK(seen[i] == 1);
+	}
+}
+
+TEST_CASE(SceneSubmitterSplitsBatchesAtLimit)
+{
+	BatchChecker context;
+	SceneSubmitter submitter(context, MakeResources(context, true));
+	for (unsigned int i = 0u; i <= SceneSubmitter::maxBatchInstances; i++)
+	{
+		submitter.QueueCube(Matrix4::Identity(), false, 5u);
+	}
+	submitter.Flush(ViewProjection());
+	CHECK(context.draws.size() == 2u);
+	CHECK(context.draws.size() == 2u && context.draws[0].size() == SceneSubmitter::maxBatchInstances);
+	CHECK(context.draws.size() == 2u && context.draws[1].size() == 1u);
+	// the second half of the run keeps the tint that is already bound
+	CHECK(context.materialBinds == 1u);
+}
+
+TEST_CASE(SceneSubmitterDrawsObjectsWithoutInstanceRing)
+{
+	BatchChecker context;
+	SceneSubmitter submitter(context, MakeResources(context, false));
+	for (unsigned int i = 0u; i < 12u; i++)
+	{
+		submitter.QueueCube(Matrix4::Translation(float(i) * 0.01f, 0.0f, 0.0f), false, uint16_t(i % 3u));
+	}
+	submitter.Flush(ViewProjection());
+	CHECK(context.draws.size() == 12u);
+	CHECK(context.instances == submitter.GetResources().identityInstances);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "Test.hpp"
+#include "SoftwareRasterizer.hpp"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	constexpr unsigned int size = 16u;
+
+	// pixel coordinates of a size x size target to clip space at depth z
+	SoftwareRasterizer::Vertex At(float x, float y, float z = 0.5f, uint8_t b = 255u, uint8_t g = 255u, uint8_t r = 255u, uint8_t a = 255u)
+	{
+		return { { x / float(size) * 2.0f - 1.0f,1.0f - y / float(size) * 2.0f,z,1.0f },{ b,g,r,a } };
+	}
+
+	void DrawTriangle(SoftwareRasterizer& raster, const SoftwareRasterizer::Vertex& v0, const SoftwareRasterizer::Vertex& v1,
+		const SoftwareRasterizer::Vertex& v2)
+	{
+		const SoftwareRasterizer::Vertex vertices[] = { v0,v1,v2 };
+		const uint16_t indices[] = { 0u,1u,2u };
+		raster.DrawIndexed(vertices, indices, 3u);
+	}
+}
+
+TEST_CASE(RasterizerSharedEdgesCoverEachPixelOnce)
+{
+	// cell corners sit on pixel centers, so the shared horizontal, vertical and diagonal edges all run
+	// through centers and only the top-left rule decides who owns them
+	const float cuts[] = { 0.0f,4.5f,8.5f,16.0f };
+	SoftwareRasterizer raster(size, size);
+	std::vector<int> hits(size * size, 0);
+	const auto draw = [&](const SoftwareRasterizer::Vertex& v0, const SoftwareRasterizer::Vertex& v1, const SoftwareRasterizer::Vertex& v2)
+	{
+		raster.Clear(0u, 1.0f);
+		DrawTriangle(raster, v0, v1, v2);
+		raster.Flush();
+		for (size_t i = 0; i < hits.size(); i++)
+		{
+			hits[i] += raster.GetColorBuffer()[i] != 0u ? 1 : 0;
+		}
+	};
+	for (int j = 0; j < 3; j++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			const float x0 = cuts[i], x1 = cuts[i + 1], y0 = cuts[j], y1 = cuts[j + 1];
+			// clockwise on screen, split along the down-right diagonal
+			draw(At(x0, y0), At(x1, y0), At(x1, y1));
+			draw(At(x0, y0), At(x1, y1), At(x0, y1));
+		}
+	}
+	bool once = true;
+	for (const int h : hits)
+	{
+		once = once && h == 1;
+	}
+	CHECK(once);
+
+	// counter-clockwise is a back face and draws nothing
+	raster.Clear(0u, 1.0f);
+	DrawTriangle(raster, At(0.0f, 0.0f), At(16.0f, 16.0f), At(16.0f, 0.0f));
+	raster.Flush();
+	bool empty = true;
+	for (size_t i = 0; i < size * size; i++)
+	{
+		empty = empty && raster.GetColorBuffer()[i] == 0u;
+	}
+	CHECK(empty);
+}
+
+TEST_CASE(RasterizerDepthTestIsLess)
+{
+	SoftwareRasterizer raster(size, size);
+	raster.Clear(0u, 1.0f);
+	const auto fill = [&](float z, uint8_t red)
+	{
+		DrawTriangle(raster, At(0.0f, 0.0f, z, 0u, 0u, red), At(16.0f, 0.0f, z, 0u, 0u, red), At(0.0f, 16.0f, z, 0u, 0u, red));
+	};
+	// nearer wins, equal and farther lose
+	fill(0.5f, 10u);
+	fill(0.5f, 20u);
+	fill(0.7f, 30u);
+	fill(0.3f, 40u);
+	fill(0.4f, 50u);
+	raster.Flush();
+	const uint32_t pixel = raster.GetColorBuffer()[2u * size + 2u];
+	CHECK(((pixel >> 16u) & 0xFFu) == 40u);
+	CHECK(raster.GetDepthBuffer()[2u * size + 2u] == 0.3f);
+	// outside the triangle the clear values stay
+	CHECK(raster.GetColorBuffer()[15u * size + 15u] == 0u);
+	CHECK(raster.GetDepthBuffer()[15u * size + 15u] == 1.0f);
+}
+
+TEST_CASE(RasterizerWritesB8G8R8A8)
+{
+	// a target narrower than one tile, and a color with a different value in every channel
+	SoftwareRasterizer raster(3u, 2u);
+	raster.Clear(0x04030201u, 1.0f);
+	raster.Flush();
+	uint8_t bytes[4];
+	std::memcpy(bytes, raster.GetColorBuffer(), sizeof(bytes));
+	CHECK(bytes[0] == 1u && bytes[1] == 2u && bytes[2] == 3u && bytes[3] == 4u);
+
+	const SoftwareRasterizer::Vertex vertices[] = {
+		{ { -1.0f,1.0f,0.5f,1.0f },{ 10u,20u,30u,40u } },
+		{ { 3.0f,1.0f,0.5f,1.0f },{ 10u,20u,30u,40u } },
+		{ { -1.0f,-3.0f,0.5f,1.0f },{ 10u,20u,30u,40u } },
+	};
+	const uint32_t indices[] = { 0u,1u,2u };
+	raster.DrawIndexed(vertices, indices, 3u);
+	raster.Flush();
+	for (size_t i = 0; i < 6u; i++)
+	{
+		std::memcpy(bytes, raster.GetColorBuffer() + i, sizeof(bytes));
+		CHECK(bytes[0] == 10u && bytes[1] == 20u && bytes[2] == 30u && bytes[3] == 40u);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Test.hpp"
+#include "StateFilter.hpp"
+#include "RecordingRenderContext.hpp"
+#include "NullRenderContext.hpp"
+#include <vector>
+
+namespace
+{
+	using Op = RecordingRenderContext::Op;
+	using Call = StateFilter::Call;
+
+	std::vector<Op> RecordedOps(const RecordingRenderContext& recording)
+	{
+		std::vector<Op> ops;
+		for (const RecordingRenderContext::Call& c : recording.Decode())
+		{
+			ops.push_back(c.op);
+		}
+		return ops;
+	}
+}
+
+TEST_CASE(StateFilterForwardsOnlyChangedBinds)
+{
+	NullRenderContext context;
+	RecordingRenderContext recording(context);
+	StateFilter filter(recording);
+	const BufferHandle buffer = context.CreateBuffer(256u);
+	const BufferHandle ring = context.CreateBuffer(4096u);
+	const InputLayoutHandle layout = context.CreateHandle<InputLayoutHandle>();
+	const VertexShaderHandle vs = context.CreateHandle<VertexShaderHandle>();
+	const PixelShaderHandle ps = context.CreateHandle<PixelShaderHandle>();
+	const RenderTargetHandle target = context.CreateHandle<RenderTargetHandle>();
+	const DepthStencilViewHandle depth = context.CreateHandle<DepthStencilViewHandle>();
+	const DepthStencilStateHandle state = context.CreateHandle<DepthStencilStateHandle>();
+	const uint8_t payload[16] = {};
+
+	// every second call repeats the one before and has to be dropped
+	filter.IASetPrimitiveTopology(Topology::TriangleList);
+	filter.IASetPrimitiveTopology(Topology::TriangleList);
+	filter.IASetInputLayout(layout);
+	filter.IASetInputLayout(layout);
+	filter.IASetVertexBuffer(0u, buffer, 16u, 0u);
+	filter.IASetVertexBuffer(0u, buffer, 16u, 0u);
+	// another slot, and a new offset on the same slot, are changes
+	filter.IASetVertexBuffer(1u, buffer, 16u, 0u);
+	filter.IASetVertexBuffer(0u, buffer, 16u, 64u);
+	filter.IASetIndexBuffer(buffer, IndexFormat::Uint16, 0u);
+	filter.IASetIndexBuffer(buffer, IndexFormat::Uint16, 0u);
+	filter.IASetIndexBuffer(buffer, IndexFormat::Uint32, 0u);
+	filter.VSSetShader(vs);
+	filter.VSSetShader(vs);
+	filter.PSSetShader(ps);
+	filter.PSSetShader(ps);
+	// ring slices differ only in their range
+	filter.VSSetConstantBuffer(1u, ring, 0u, 4u);
+	filter.VSSetConstantBuffer(1u, ring, 0u, 4u);
+	filter.VSSetConstantBuffer(1u, ring, 16u, 4u);
+	filter.OMSetRenderTarget(target, depth);
+	filter.OMSetRenderTarget(target, depth);
+	filter.OMSetDepthStencilState(state, 0u);
+	filter.OMSetDepthStencilState(state, 1u);
+	filter.OMSetDepthStencilState(state, 1u);
+	// uploads, clears and draws always go through
+	filter.UpdateBuffer(ring, MapMode::WriteNoOverwrite, 256u, payload, sizeof(payload));
+	filter.ClearDepth(depth, 1.0f);
+	filter.DrawIndexed(36u, 0u, 0);
+	filter.DrawIndexedInstanced(36u, 10u, 0u, 0, 0u);
+
+	const std::vector<Op> expected = {
+		Op::Topology,Op::InputLayout,Op::VertexBuffer,Op::VertexBuffer,Op::VertexBuffer,
+		Op::IndexBuffer,Op::IndexBuffer,Op::VertexShader,Op::PixelShader,
+		Op::ConstantBuffer,Op::ConstantBuffer,Op::RenderTarget,Op::DepthStencilState,Op::DepthStencilState,
+		Op::UpdateBuffer,Op::ClearDepth,Op::DrawIndexed,Op::DrawIndexedInstanced
+	};
+	CHECK(RecordedOps(recording) == expected);
+	const std::vector<RecordingRenderContext::Call> calls = recording.Decode();
+	CHECK(calls[4].args[0] == 0u && calls[4].args[3] == 64u);
+	CHECK(calls[10].args[2] == 16u);
+
+	const StateFilter::Stats& stats = filter.GetFrameStats();
+	const unsigned int issued[] = { 1u,1u,3u,2u,1u,1u,2u,1u,2u };
+	const unsigned int elided[] = { 1u,1u,1u,1u,1u,1u,1u,1u,1u };
+	for (size_t i = 0; i < size_t(Call::Count); i++)
+	{
+		CHECK(stats.issued[i] == issued[i]);
+		CHECK(stats.elided[i] == elided[i]);
+	}
+	CHECK(stats.TotalIssued() == 14u);
+	CHECK(stats.TotalElided() == 9u);
+	CHECK(stats.draws == 2u);
+	CHECK(stats.triangles == 12u + 120u);
+	CHECK(stats.maps == 1u);
+}
+
+TEST_CASE(StateFilterKeepsStateAcrossFramesUntilInvalidated)
+{
+	NullRenderContext context;
+	RecordingRenderContext recording(context);
+	StateFilter filter(recording);
+	const VertexShaderHandle vs = context.CreateHandle<VertexShaderHandle>();
+	filter.VSSetShader(vs);
+	filter.DrawIndexed(3u, 0u, 0);
+	filter.EndFrame();
+	CHECK(filter.GetLastFrameStats().issued[size_t(Call::VertexShader)] == 1u);
+	CHECK(filter.GetLastFrameStats().draws == 1u);
+	CHECK(filter.GetFrameStats().TotalIssued() == 0u && filter.GetFrameStats().draws == 0u);
+
+	// the binding survives the frame boundary
+	filter.VSSetShader(vs);
+	CHECK(filter.GetFrameStats().elided[size_t(Call::VertexShader)] == 1u);
+	CHECK(recording.GetCallCount(Op::VertexShader) == 1u);
+
+	// after someone else touched the context the next bind goes through again
+	filter.Invalidate();
+	filter.VSSetShader(vs);
+	CHECK(filter.GetFrameStats().issued[size_t(Call::VertexShader)] == 1u);
+	CHECK(recording.GetCallCount(Op::VertexShader) == 2u);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// minimal self registering test cases for the CPU side of the engine, built as EngineTests and run by ctest;
+// a failed CHECK is reported and counted, the case keeps going
+namespace Test
+{
+	using Function = void(*)();
+	struct Case
+	{
+		const char* name;
+		Function function;
+	};
+	std::vector<Case>& GetCases();
+	struct Registrar
+	{
+		Registrar(const char* name, Function function)
+		{
+			GetCases().push_back({ name,function });
+		}
+	};
+	void Fail(const char* file, int line, const char* expression);
+}
+
+#define TEST_CASE(name) static void name(); static const Test::Registrar name##Registrar(#name, name); static void name()
+#define CHECK(expression) ((expression) ? (void)0 : Test::Fail(__FILE__, __LINE__, #expression))
\ No newline at end of file
@@ -0,0 +1,50 @@
+// usage: EngineTests [name...]
+// runs every registered case, or only those whose name is given; exits non-zero when a check failed
+#include "Test.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	unsigned int failures = 0u;
+}
+
+std::vector<Test::Case>& Test::GetCases()
+{
+	static std::vector<Case> cases;
+	return cases;
+}
+
+void Test::Fail(const char* file, int line, const char* expression)
+{
+	std::cout << file << "(" << line << "): CHECK(" << expression << ") failed" << std::endl;
+	failures++;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int run = 0u;
+	unsigned int failed = 0u;
+	for (const Test::Case& c : Test::GetCases())
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++)
+		{
+			selected = selected || std::strcmp(argv[i], c.name) == 0;
+		}
+		if (!selected)
+		{
+			continue;
+		}
+		const unsigned int before = failures;
+		c.function();
+		run++;
+		if (failures != before)
+		{
+			failed++;
+		}
+		std::cout << (failures == before ? "pass " : "FAIL ") << c.name << std::endl;
+	}
+	std::cout << run << " cases, " << failed << " failed" << std::endl;
+	return (failed == 0u && run > 0u) ? 0 : 1;
+}
\ No newline at end of file
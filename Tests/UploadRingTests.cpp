@@ -0,0 +1,141 @@
+#include "Test.hpp"
+#include "UploadRing.hpp"
+#include "SceneSubmitter.hpp"
+#include "NullRenderContext.hpp"
+#include "Geometry.hpp"
+#include <cstring>
+
+TEST_CASE(UploadRingAlignsSlices)
+{
+	UploadRing ring(1000u, 1u);
+	// capacity is rounded down to whole slices
+	CHECK(ring.GetCapacity() == 768u);
+	const auto a = ring.Allocate(1u);
+	const auto b = ring.Allocate(257u);
+	CHECK(a && a->offset == 0u && a->size == 256u);
+	CHECK(b && b->offset == 256u && b->size == 512u);
+	CHECK(!ring.Allocate(ring.GetCapacity() + 1u));
+}
+
+TEST_CASE(UploadRingDiscardsOnlyFirstSlice)
+{
+	UploadRing ring(4096u, 2u);
+	CHECK(ring.Allocate(64u)->discard);
+	CHECK(!ring.Allocate(64u)->discard);
+	ring.EndFrame();
+	CHECK(!ring.Allocate(64u)->discard);
+}
+
+TEST_CASE(UploadRingRetiresAfterFramesInFlight)
+{
+	UploadRing ring(1024u, 2u);
+	CHECK(ring.Allocate(512u));
+	ring.EndFrame();
+	CHECK(ring.Allocate(512u));
+	ring.EndFrame();
+	// both frames may still be read by the GPU
+	CHECK(ring.GetBytesInFlight() == 1024u);
+	CHECK(!ring.Allocate(256u));
+	// a third frame ending frees the first one
+	ring.EndFrame();
+	CHECK(ring.GetBytesInFlight() == 512u);
+	const auto a = ring.Allocate(256u);
+	CHECK(a && a->offset == 0u && !a->discard);
+	CHECK(ring.GetPeakFrameBytes() == 512u);
+}
+
+TEST_CASE(UploadRingWrapPadsToStart)
+{
+	UploadRing ring(1024u, 1u);
+	CHECK(ring.Allocate(768u));
+	ring.EndFrame();
+	// 512 bytes do not fit behind the 768 in flight, and a slice never straddles the end
+	CHECK(!ring.Allocate(512u));
+	ring.EndFrame();
+	const auto a = ring.Allocate(512u);
+	CHECK(a && a->offset == 0u);
+	// the padding at the end counts as in flight until the frame retires
+	CHECK(ring.GetBytesInFlight() == 768u);
+}
+
+TEST_CASE(UploadRingResetStartsOver)
+{
+	UploadRing ring(1024u, 3u);
+	for (int i = 0; i < 4; i++)
+	{
+		ring.Allocate(256u);
+	}
+	CHECK(!ring.Allocate(256u));
+	ring.Reset();
+	CHECK(ring.GetBytesInFlight() == 0u);
+	const auto a = ring.Allocate(256u);
+	CHECK(a && a->offset == 0u && a->discard);
+}
+
+namespace
+{
+	// a discard hands the driver a new copy of the buffer, here the old bytes turn into garbage so a slice
+	// still bound from before the discard reads wrong values; every draw checks what b0..b2 point at
+	class ConstantChecker : public NullRenderContext
+	{
+	public:
+		void UpdateBuffer(BufferHandle buffer, MapMode mode, size_t offset, const void* pData, size_t size) override
+		{
+			if (buffer == ring && mode == MapMode::WriteDiscard)
+			{
+				std::memset(Map(buffer, mode), 0xCD, SceneSubmitter::constantRingSize);
+				discards++;
+			}
+			NullRenderContext::UpdateBuffer(buffer, mode, offset, pData, size);
+		}
+		void VSSetConstantBuffer(unsigned int slot, BufferHandle buffer, unsigned int firstConstant, unsigned int) override
+		{
+			CHECK(buffer == ring);
+			bound[slot] = firstConstant * 16u;
+		}
+		void DrawIndexedInstanced(unsigned int, unsigned int, unsigned int, int, unsigned int) override
+		{
+			const char* pData = static_cast<const char*>(GetBufferData(ring));
+			if (std::memcmp(pData + bound[0], &expectedFrame, sizeof(expectedFrame)) != 0 ||
+				std::memcmp(pData + bound[1], &expectedObject, sizeof(expectedObject)) != 0 ||
+				std::memcmp(pData + bound[2], &expectedMaterial, sizeof(expectedMaterial)) != 0)
+			{
+				badDraws++;
+			}
+		}
+	public:
+		BufferHandle ring = CreateBuffer(SceneSubmitter::constantRingSize);
+		size_t bound[SceneSubmitter::constantSlotCount] = {};
+		Matrix4 expectedFrame = Matrix4::Identity();
+		Matrix4 expectedObject = Matrix4::Identity();
+		Float4 expectedMaterial = {};
+		unsigned int discards = 0u;
+		unsigned int badDraws = 0u;
+	};
+}
+
+TEST_CASE(SceneSubmitterRebindsAfterMidFrameDiscard)
+{
+	ConstantChecker context;
+	SceneSubmitter::Resources resources;
+	resources.constantRing = context.ring;
+	SceneSubmitter submitter(context, resources);
+
+	// more object slices in a frame than the ring holds, so it starts over twice mid-frame
+	const unsigned int draws = unsigned(2u * SceneSubmitter::constantRingSize / UploadRing::alignment + 100u);
+	for (int frame = 0; frame < 2; frame++)
+	{
+		submitter.BindFrameConstants(Matrix4::Identity());
+		context.expectedMaterial = Geometry::MaterialTint(1u);
+		submitter.BindConstants(SceneSubmitter::materialConstantSlot, &context.expectedMaterial, sizeof(Float4));
+		for (unsigned int i = 0u; i < draws; i++)
+		{
+			context.expectedObject.m[3][0] = float(i);
+			submitter.BindConstants(SceneSubmitter::objectConstantSlot, &context.expectedObject, sizeof(Matrix4));
+			context.DrawIndexedInstanced(36u, 1u, 0u, 0, 0u);
+		}
+		submitter.EndFrame();
+	}
+	CHECK(context.discards >= 4u);
+	CHECK(context.badDraws == 0u);
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "Test.hpp"
+#include "VertexQuantization.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace vq = VertexQuantization;
+
+namespace
+{
+	// random positions in a box, unit normals and uvs spanning several wraps
+	struct Streams
+	{
+		explicit Streams(size_t count)
+			:
+			positions(count),
+			normals(count),
+			uvs(count)
+		{
+			std::mt19937 rng(99u);
+			std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			for (size_t i = 0; i < count; i++)
+			{
+				positions[i] = { coord(rng),coord(rng) * 0.1f,coord(rng) * 3.0f };
+				normals[i] = Normalize({ unit(rng),unit(rng),unit(rng) });
+				uvs[i] = { unit(rng) * 4.0f,unit(rng) * 0.01f };
+			}
+			// axis aligned normals and the octahedron seams are where the folding can go wrong
+			const Float3 edges[] = {
+				{ 1.0f,0.0f,0.0f },{ -1.0f,0.0f,0.0f },{ 0.0f,1.0f,0.0f },
+				{ 0.0f,-1.0f,0.0f },{ 0.0f,0.0f,1.0f },{ 0.0f,0.0f,-1.0f },
+				Normalize({ 1.0f,1.0f,0.0f }),Normalize({ -1.0f,0.0f,-1.0f }),Normalize({ 0.0f,-1.0f,-1.0f })
+			};
+			std::copy(std::begin(edges), std::end(edges), normals.begin());
+		}
+		vq::VertexStreams Get() const noexcept
+		{
+			vq::VertexStreams s;
+			s.pPositions = positions.data();
+			s.pNormals = normals.data();
+			s.pUVs = uvs.data();
+			s.count = positions.size();
+			return s;
+		}
+		std::vector<Float3> positions;
+		std::vector<Float3> normals;
+		std::vector<Float2> uvs;
+	};
+
+	// atan2 of |cross| and dot in double, a float acos cannot resolve angles this small
+	float AngleDegrees(const Float3& a, const Float3& b) noexcept
+	{
+		const double cx = double(a.y) * b.z - double(a.z) * b.y;
+		const double cy = double(a.z) * b.x - double(a.x) * b.z;
+		const double cz = double(a.x) * b.y - double(a.y) * b.x;
+		const double dot = double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z;
+		return float(std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 180.0 / 3.14159265358979323846);
+	}
+
+	const vq::VertexFormat compact = { vq::PositionEncoding::Unorm16,vq::NormalEncoding::Octahedral16,vq::UVEncoding::Half16,false };
+
+	// runs body once per kernel the cpu supports and restores the best one
+	template<typename Body>
+	void ForEachKernel(Body&& body)
+	{
+		const vq::Kernel best = vq::GetKernel();
+		for (int k = 0; k <= int(best); k++)
+		{
+			vq::SetKernel(vq::Kernel(k));
+			body(vq::Kernel(k));
+		}
+		vq::SetKernel(best);
+	}
+}
+
+TEST_CASE(HalfRoundTripsEveryValue)
+{
+	for (uint32_t bits = 0u; bits <= 0xFFFFu; bits++)
+	{
+		const float f = vq::HalfToFloat(uint16_t(bits));
+		if (std::isnan(f))
+		{
+			CHECK(std::isnan(vq::HalfToFloat(vq::FloatToHalf(f))));
+			continue;
+		}
+		CHECK(vq::FloatToHalf(f) == bits);
+	}
+}
+
+TEST_CASE(HalfRoundsToNearestEven)
+{
+	// halfway between 1 and the next half rounds down to the even 1, halfway above that rounds up
+	CHECK(vq::HalfToFloat(vq::FloatToHalf(1.0f + std::ldexp(1.0f, -11))) == 1.0f);
+	CHECK(vq::HalfToFloat(vq::FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11))) == 1.0f + std::ldexp(1.0f, -9));
+	CHECK(vq::FloatToHalf(65520.0f) == 0x7C00u);
+	CHECK(vq::HalfToFloat(vq::FloatToHalf(std::ldexp(1.0f, -24))) == std::ldexp(1.0f, -24));
+	CHECK(vq::FloatToHalf(std::ldexp(1.0f, -26)) == 0u);
+	CHECK(vq::FloatToHalf(-0.0f) == 0x8000u);
+}
+
+TEST_CASE(KernelsMatchScalar)
+{
+	const Streams streams(10007u);
+	const vq::Bounds bounds = vq::ComputeBounds(streams.positions.data(), streams.positions.size());
+	std::vector<uint8_t> reference;
+	ForEachKernel([&](vq::Kernel k)
+	{
+		const std::vector<uint8_t> encoded = vq::Encode(streams.Get(), compact, bounds);
+		if (k == vq::Kernel::Scalar)
+		{
+			reference = encoded;
+		}
+		CHECK(encoded == reference);
+	});
+}
+
+TEST_CASE(PositionUnormRoundTripError)
+{
+	const Streams streams(10007u);
+	const size_t count = streams.positions.size();
+	const vq::Bounds bounds = vq::ComputeBounds(streams.positions.data(), count);
+	const vq::Layout layout = vq::GetLayout(compact);
+	// half a unorm16 step of the extent on each axis, plus a few float ulps of the coordinates for the decode
+	const auto tolerance = [](float min, float max)
+	{
+		return (max - min) / 65535.0f * 0.5f + 4.0f * std::numeric_limits<float>::epsilon() * std::max(std::abs(min), std::abs(max));
+	};
+	const Float3 maxError = {
+		tolerance(bounds.min.x, bounds.max.x),
+		tolerance(bounds.min.y, bounds.max.y),
+		tolerance(bounds.min.z, bounds.max.z)
+	};
+	ForEachKernel([&](vq::Kernel)
+	{
+		const std::vector<uint8_t> encoded = vq::Encode(streams.Get(), compact, bounds);
+		std::vector<Float3> decoded(count);
+		vq::DecodePositionsUnorm16(encoded.data() + layout.positionOffset, layout.stride, count, bounds, decoded.data());
+		size_t outside = 0u;
+		for (size_t i = 0; i < count; i++)
+		{
+			outside += std::abs(decoded[i].x - streams.positions[i].x) > maxError.x ||
+				std::abs(decoded[i].y - streams.positions[i].y) > maxError.y ||
+				std::abs(decoded[i].z - streams.positions[i].z) > maxError.z ? 1u : 0u;
+		}
+		CHECK(outside == 0u);
+	});
+}
+
+TEST_CASE(NormalSnormRoundTripError)
+{
+	const Streams streams(10007u);
+	const size_t count = streams.normals.size();
+	const vq::Layout layout = vq::GetLayout(compact);
+	const vq::Bounds bounds = vq::ComputeBounds(streams.positions.data(), count);
+	// octahedral snorm16 is good to a few thousandths of a degree, decoded normals stay unit length
+	constexpr float toleranceDegrees = 0.005f;
+	ForEachKernel([&](vq::Kernel)
+	{
+		const std::vector<uint8_t> encoded = vq::Encode(streams.Get(), compact, bounds);
+		std::vector<Float3> decoded(count);
+		vq::DecodeNormalsOctahedral16(encoded.data() + layout.normalOffset, layout.stride, count, decoded.data());
+		float maxDegrees = 0.0f;
+		float maxLengthError = 0.0f;
+		for (size_t i = 0; i < count; i++)
+		{
+			maxDegrees = std::max(maxDegrees, AngleDegrees(decoded[i], streams.normals[i]));
+			maxLengthError = std::max(maxLengthError, std::abs(std::sqrt(Dot(decoded[i], decoded[i])) - 1.0f));
+		}
+		CHECK(maxDegrees <= toleranceDegrees);
+		CHECK(maxLengthError <= 1e-5f);
+	});
+}
+
+TEST_CASE(UVHalfRoundTripError)
+{
+	const Streams streams(10007u);
+	const size_t count = streams.uvs.size();
+	const vq::Layout layout = vq::GetLayout(compact);
+	const vq::Bounds bounds = vq::ComputeBounds(streams.positions.data(), count);
+	// round to nearest: half an ulp of the 11 bit significand, relative to the value
+	const auto tolerance = [](float v)
+	{
+		return std::max(std::abs(v) * std::ldexp(1.0f, -11), std::ldexp(1.0f, -25));
+	};
+	ForEachKernel([&](vq::Kernel)
+	{
+		const std::vector<uint8_t> encoded = vq::Encode(streams.Get(), compact, bounds);
+		std::vector<Float2> decoded(count);
+		vq::DecodeUVsHalf(encoded.data() + layout.uvOffset, layout.stride, count, decoded.data());
+		size_t outside = 0u;
+		for (size_t i = 0; i < count; i++)
+		{
+			outside += std::abs(decoded[i].x - streams.uvs[i].x) > tolerance(streams.uvs[i].x) ||
+				std::abs(decoded[i].y - streams.uvs[i].y) > tolerance(streams.uvs[i].y) ? 1u : 0u;
+		}
+		CHECK(outside == 0u);
+	});
+}
\ No newline at end of file